@@ -32,6 +32,9 @@
  * 2010-11-10     Bernard      add IPC reset command implementation.
  * 2011-12-18     Bernard      add more parameter checking in message queue
  * 2013-09-14     Grissiom     add an option check in rt_event_recv
+ * 2026-10-19     agent        add priority index for RT_IPC_FLAG_PRIO lists
+ * 2026-10-19     agent        add zero-copy buffer mode of message queue
+ * 2026-10-19     agent        add batched send/receive of mailbox and message queue
  */
 
 #include <rtthread.h>
@@ -49,6 +52,161 @@ extern void (*rt_object_put_hook)(struct rt_object *object);
 
 /**@{*/
 
+#ifdef RT_USING_IPC_PRIO_INDEX
+#define RT_IPC_PRIO_INDEX(index)    (index)
+#else
+#define RT_IPC_PRIO_INDEX(index)    RT_NULL
+#endif
+
+#ifdef RT_USING_IPC_PRIO_INDEX
+/**
+ * This function will initialize the priority index of a suspended thread list
+ *
+ * @param index the priority index
+ * @param list the suspended thread list to be indexed
+ */
+rt_inline void rt_ipc_prio_index_init(struct rt_ipc_prio_index *index,
+                                      rt_list_t                *list)
+{
+    rt_memset(index, 0, sizeof(struct rt_ipc_prio_index));
+    index->list = list;
+}
+
+/*
+ * get the first thread in the index whose priority is lower than the
+ * specified priority, RT_NULL if there is no such thread.
+ */
+static struct rt_thread *_ipc_prio_index_lower(struct rt_ipc_prio_index *index,
+                                               rt_uint8_t                priority)
+{
+    register rt_ubase_t lower_priority;
+    rt_uint32_t group;
+
+    /* threads with RT_THREAD_PRIORITY_MAX (TT thread) are the lowest ones */
+    if (priority >= RT_THREAD_PRIORITY_MAX)
+        return RT_NULL;
+
+#if RT_THREAD_PRIORITY_MAX > 32
+    {
+        register rt_ubase_t number;
+        rt_uint32_t table;
+
+        number = priority >> 3;
+        table  = index->priority_table[number] &
+                 ~(((rt_uint32_t)2 << (priority & 0x07)) - 1);
+        if (table == 0)
+        {
+            /* looking for the next priority group */
+            group = index->priority_group &
+                    ~(((rt_uint32_t)2 << number) - 1);
+            if (group == 0)
+                return index->first[RT_THREAD_PRIORITY_MAX];
+
+            number = __rt_ffs(group) - 1;
+            table  = index->priority_table[number];
+        }
+        lower_priority = (number << 3) + __rt_ffs(table) - 1;
+    }
+#else
+    group = index->priority_group & ~(((rt_uint32_t)2 << priority) - 1);
+    if (group == 0)
+        return index->first[RT_THREAD_PRIORITY_MAX];
+
+    lower_priority = __rt_ffs(group) - 1;
+#endif
+
+    return index->first[lower_priority];
+}
+
+/*
+ * insert a thread to the indexed suspended thread list, the thread is put
+ * after all of threads with the same or higher priority.
+ */
+static void _ipc_prio_index_insert(struct rt_ipc_prio_index *index,
+                                   struct rt_thread         *thread)
+{
+    struct rt_thread *lower;
+    rt_uint8_t priority;
+
+    priority = thread->current_priority;
+    if (priority > RT_THREAD_PRIORITY_MAX)
+        priority = RT_THREAD_PRIORITY_MAX;
+
+    lower = _ipc_prio_index_lower(index, priority);
+    if (lower != RT_NULL)
+        rt_list_insert_before(&(lower->tlist), &(thread->tlist));
+    else
+        rt_list_insert_before(index->list, &(thread->tlist));
+
+    if (index->first[priority] == RT_NULL)
+    {
+        index->first[priority] = thread;
+
+        if (priority < RT_THREAD_PRIORITY_MAX)
+        {
+#if RT_THREAD_PRIORITY_MAX > 32
+            index->priority_table[priority >> 3] |= 1L << (priority & 0x07);
+            index->priority_group |= 1L << (priority >> 3);
+#else
+            index->priority_group |= 1L << priority;
+#endif
+        }
+    }
+
+    thread->suspend_index    = index;
+    thread->suspend_priority = priority;
+}
+
+/**
+ * This function will remove a thread from the priority index of the IPC list
+ * it suspended on. It must be invoked before the thread is removed from the
+ * suspended thread list, and it does nothing if the thread is not indexed.
+ *
+ * @param thread the thread to be removed
+ *
+ * @note Please do not invoke this function in user application.
+ */
+void rt_ipc_prio_index_remove(struct rt_thread *thread)
+{
+    struct rt_ipc_prio_index *index;
+    struct rt_thread *next;
+    rt_uint8_t priority;
+
+    index = thread->suspend_index;
+    if (index == RT_NULL)
+        return;
+
+    priority = thread->suspend_priority;
+    if (index->first[priority] == thread)
+    {
+        next = rt_list_entry(thread->tlist.next, struct rt_thread, tlist);
+        if (thread->tlist.next != index->list &&
+            next->suspend_priority == priority)
+        {
+            /* the next thread has the same priority */
+            index->first[priority] = next;
+        }
+        else
+        {
+            index->first[priority] = RT_NULL;
+
+            if (priority < RT_THREAD_PRIORITY_MAX)
+            {
+#if RT_THREAD_PRIORITY_MAX > 32
+                index->priority_table[priority >> 3] &= ~(1L << (priority & 0x07));
+                if (index->priority_table[priority >> 3] == 0)
+                    index->priority_group &= ~(1L << (priority >> 3));
+#else
+                index->priority_group &= ~(1L << priority);
+#endif
+            }
+        }
+    }
+
+    thread->suspend_index = RT_NULL;
+}
+#endif
+
 /**
  * This function will initialize an IPC object
  *
@@ -60,6 +218,9 @@ rt_inline rt_err_t rt_ipc_object_init(struct rt_ipc_object *ipc)
 {
     /* init ipc object */
     rt_list_init(&(ipc->suspend_thread));
+#ifdef RT_USING_IPC_PRIO_INDEX
+    rt_ipc_prio_index_init(&(ipc->suspend_index), &(ipc->suspend_thread));
+#endif
 
     return RT_EOK;
 }
@@ -69,15 +230,17 @@ rt_inline rt_err_t rt_ipc_object_init(struct rt_ipc_object *ipc)
  * double-queue object (mailbox etc.) contains this kind of list.
  *
  * @param list the IPC suspended thread list
+ * @param index the priority index of list, RT_NULL if the list is not indexed
  * @param thread the thread object to be suspended
  * @param flag the IPC object flag,
  *        which shall be RT_IPC_FLAG_FIFO/RT_IPC_FLAG_PRIO.
  *
  * @return the operation status, RT_EOK on successful
  */
-rt_inline rt_err_t rt_ipc_list_suspend(rt_list_t        *list,
-                                       struct rt_thread *thread,
-                                       rt_uint8_t        flag)
+rt_inline rt_err_t rt_ipc_list_suspend(rt_list_t                *list,
+                                       struct rt_ipc_prio_index *index,
+                                       struct rt_thread         *thread,
+                                       rt_uint8_t                flag)
 {
     /* suspend thread */
     rt_thread_suspend(thread);
@@ -89,6 +252,14 @@ rt_inline rt_err_t rt_ipc_list_suspend(rt_list_t        *list,
         break;
 
     case RT_IPC_FLAG_PRIO:
+#ifdef RT_USING_IPC_PRIO_INDEX
+        if (index != RT_NULL)
+        {
+            /* find the position from priority index */
+            _ipc_prio_index_insert(index, thread);
+            break;
+        }
+#endif
         {
             struct rt_list_node *n;
             struct rt_thread *sthread;
@@ -182,6 +353,133 @@ rt_inline rt_err_t rt_ipc_list_resume_all(rt_list_t *list)
     return RT_EOK;
 }
 
+/**
+ * This function will resume the first thread suspended on the receiving list
+ * of an IPC object which shall be resumed. A thread which waits for a batch
+ * of messages is only resumed when enough messages are ready, and it does not
+ * hold back the threads behind it which wait for less messages.
+ *
+ * @param ipc the IPC object
+ * @param entry the number of messages in the IPC object
+ *
+ * @return RT_TRUE if a receiving thread has been resumed
+ */
+rt_inline rt_bool_t rt_ipc_receiver_resume(struct rt_ipc_object *ipc,
+                                           rt_uint16_t           entry)
+{
+    struct rt_thread *thread;
+    struct rt_list_node *n;
+
+    for (n = ipc->suspend_thread.next; n != &(ipc->suspend_thread); n = n->next)
+    {
+        thread = rt_list_entry(n, struct rt_thread, tlist);
+#ifdef RT_USING_IPC_BATCH
+        if (thread->ipc_batch_count > entry)
+            continue;
+#endif
+
+        RT_DEBUG_LOG(RT_DEBUG_IPC, ("resume thread:%s\n", thread->name));
+
+        /* resume it */
+        rt_thread_resume(thread);
+
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+#if defined(RT_USING_MQ_BUFFER) || defined(RT_USING_IPC_BATCH)
+/*
+ * wait until there are at least count messages in an IPC object. It shall
+ * be invoked with interrupt disabled and returns with interrupt disabled.
+ */
+static rt_err_t _rt_ipc_wait_entry(struct rt_ipc_object *ipc,
+                                   volatile rt_uint16_t *entry,
+                                   rt_uint16_t           count,
+                                   rt_int32_t            timeout,
+                                   rt_base_t            *level)
+{
+    struct rt_thread *thread;
+    rt_uint32_t tick_delta;
+    rt_err_t result;
+
+    /* initialize delta tick */
+    tick_delta = 0;
+    /* get current thread */
+    thread = rt_thread_self();
+    result = RT_EOK;
+
+    while (*entry < count)
+    {
+        /* no waiting, return timeout */
+        if (timeout == 0)
+        {
+            result = -RT_ETIMEOUT;
+            break;
+        }
+
+        RT_DEBUG_IN_THREAD_CONTEXT;
+
+        /* reset error number in thread */
+        thread->error = RT_EOK;
+#ifdef RT_USING_IPC_BATCH
+        /* senders will not resume this thread until count messages ready */
+        thread->ipc_batch_count = count;
+#endif
+
+        /* suspend current thread */
+        rt_ipc_list_suspend(&(ipc->suspend_thread),
+                            RT_IPC_PRIO_INDEX(&(ipc->suspend_index)),
+                            thread,
+                            ipc->parent.flag);
+
+        /* has waiting time, start thread timer */
+        if (timeout > 0)
+        {
+            /* get the start tick of timer */
+            tick_delta = rt_tick_get();
+
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(*level);
+
+        /* re-schedule */
+        rt_schedule();
+
+        /* disable interrupt */
+        *level = rt_hw_interrupt_disable();
+
+#ifdef RT_USING_IPC_BATCH
+        thread->ipc_batch_count = 0;
+#endif
+
+        if (thread->error != RT_EOK)
+        {
+            result = thread->error;
+            break;
+        }
+
+        /* if it's not waiting forever and then re-calculate timeout tick */
+        if (timeout > 0)
+        {
+            tick_delta = rt_tick_get() - tick_delta;
+            timeout -= tick_delta;
+            if (timeout < 0)
+                timeout = 0;
+        }
+    }
+
+    return result;
+}
+#endif
+
 #ifdef RT_USING_SEMAPHORE
 /**
  * This function will initialize a semaphore and put it under control of
@@ -372,6 +670,7 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
 
             /* suspend thread */
             rt_ipc_list_suspend(&(sem->parent.suspend_thread),
+                                RT_IPC_PRIO_INDEX(&(sem->parent.suspend_index)),
                                 thread,
                                 sem->parent.parent.flag);
 
@@ -727,6 +1026,7 @@ __again:
 
                 /* suspend current thread */
                 rt_ipc_list_suspend(&(mutex->parent.suspend_thread),
+                                    RT_IPC_PRIO_INDEX(&(mutex->parent.suspend_index)),
                                     thread,
                                     mutex->parent.parent.flag);
 
@@ -1193,6 +1493,7 @@ rt_err_t rt_event_recv(rt_event_t   event,
 
         /* put thread to suspended thread list */
         rt_ipc_list_suspend(&(event->parent.suspend_thread),
+                            RT_IPC_PRIO_INDEX(&(event->parent.suspend_index)),
                             thread,
                             event->parent.parent.flag);
 
@@ -1315,6 +1616,10 @@ rt_err_t rt_mb_init(rt_mailbox_t mb,
 
     /* init an additional list of sender suspend thread */
     rt_list_init(&(mb->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_INDEX
+    rt_ipc_prio_index_init(&(mb->suspend_sender_index),
+                           &(mb->suspend_sender_thread));
+#endif
 
     return RT_EOK;
 }
@@ -1389,6 +1694,10 @@ rt_mailbox_t rt_mb_create(const char *name, rt_size_t size, rt_uint8_t flag)
 
     /* init an additional list of sender suspend thread */
     rt_list_init(&(mb->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_INDEX
+    rt_ipc_prio_index_init(&(mb->suspend_sender_index),
+                           &(mb->suspend_sender_thread));
+#endif
 
     return mb;
 }
@@ -1485,6 +1794,7 @@ rt_err_t rt_mb_send_wait(rt_mailbox_t mb,
         RT_DEBUG_IN_THREAD_CONTEXT;
         /* suspend current thread */
         rt_ipc_list_suspend(&(mb->suspend_sender_thread),
+                            RT_IPC_PRIO_INDEX(&(mb->suspend_sender_index)),
                             thread,
                             mb->parent.parent.flag);
 
@@ -1540,10 +1850,8 @@ rt_err_t rt_mb_send_wait(rt_mailbox_t mb,
     mb->entry ++;
 
     /* resume suspended thread */
-    if (!rt_list_isempty(&mb->parent.suspend_thread))
+    if (rt_ipc_receiver_resume(&(mb->parent), mb->entry))
     {
-        rt_ipc_list_resume(&(mb->parent.suspend_thread));
-
         /* enable interrupt */
         rt_hw_interrupt_enable(temp);
 
@@ -1633,6 +1941,7 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
         RT_DEBUG_IN_THREAD_CONTEXT;
         /* suspend current thread */
         rt_ipc_list_suspend(&(mb->parent.suspend_thread),
+                            RT_IPC_PRIO_INDEX(&(mb->parent.suspend_index)),
                             thread,
                             mb->parent.parent.flag);
 
@@ -1712,6 +2021,162 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
 }
 RTM_EXPORT(rt_mb_recv);
 
+#ifdef RT_USING_IPC_BATCH
+/**
+ * This function will send a batch of mails to mailbox object in one critical
+ * section. The threads suspended on mailbox object will be waked up once.
+ * This function will return immediately and sends as many mails as there is
+ * free space in mailbox.
+ *
+ * @param mb the mailbox object
+ * @param value the array of mails
+ * @param count the number of mails
+ *
+ * @return the number of mails have been sent
+ */
+rt_size_t rt_mb_send_batch(rt_mailbox_t mb, const rt_uint32_t *value, rt_size_t count)
+{
+    register rt_ubase_t temp;
+    rt_bool_t need_schedule;
+    rt_size_t sent, index;
+
+    /* parameter check */
+    RT_ASSERT(mb != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mb->parent.parent) == RT_Object_Class_MailBox);
+    RT_ASSERT(value != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mb->parent.parent)));
+
+    need_schedule = RT_FALSE;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    for (sent = 0; sent < count && mb->entry < mb->size; sent ++)
+    {
+        /* set ptr */
+        mb->msg_pool[mb->in_offset] = value[sent];
+        /* increase input offset */
+        ++ mb->in_offset;
+        if (mb->in_offset >= mb->size)
+            mb->in_offset = 0;
+        /* increase message entry */
+        mb->entry ++;
+    }
+
+    /* resume one suspended thread for each mail */
+    for (index = 0; index < sent; index ++)
+    {
+        if (!rt_ipc_receiver_resume(&(mb->parent), mb->entry))
+            break;
+
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+
+    return sent;
+}
+RTM_EXPORT(rt_mb_send_batch);
+
+/**
+ * This function will receive a batch of mails from mailbox object in one
+ * critical section. If there are less than min_count mails in mailbox, the
+ * thread shall wait for a specified time. On timeout, the mails which are
+ * available will be received.
+ *
+ * @param mb the mailbox object
+ * @param value the array to save received mails
+ * @param count the size of array
+ * @param min_count the minimum number of mails to wait for
+ * @param timeout the waiting time
+ *
+ * @return the number of received mails, 0 on timeout or error and the error
+ *         code is set to errno.
+ */
+rt_size_t rt_mb_recv_batch(rt_mailbox_t mb,
+                           rt_uint32_t *value,
+                           rt_size_t    count,
+                           rt_size_t    min_count,
+                           rt_int32_t   timeout)
+{
+    rt_base_t temp;
+    rt_bool_t need_schedule;
+    rt_size_t recved, index;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mb != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mb->parent.parent) == RT_Object_Class_MailBox);
+    RT_ASSERT(value != RT_NULL);
+    RT_ASSERT(count != 0);
+
+    /* the minimum count can not exceed the capacity of mailbox */
+    if (min_count > count)
+        min_count = count;
+    if (min_count > mb->size)
+        min_count = mb->size;
+    if (min_count == 0)
+        min_count = 1;
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mb->parent.parent)));
+
+    need_schedule = RT_FALSE;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    result = _rt_ipc_wait_entry(&(mb->parent), &(mb->entry), min_count, timeout, &temp);
+    if (result != RT_EOK && (result != -RT_ETIMEOUT || mb->entry == 0))
+    {
+        /* enable interrupt */
+        rt_hw_interrupt_enable(temp);
+
+        rt_set_errno(result);
+
+        return 0;
+    }
+
+    for (recved = 0; recved < count && mb->entry > 0; recved ++)
+    {
+        /* fill ptr */
+        value[recved] = mb->msg_pool[mb->out_offset];
+
+        /* increase output offset */
+        ++ mb->out_offset;
+        if (mb->out_offset >= mb->size)
+            mb->out_offset = 0;
+        /* decrease message entry */
+        mb->entry --;
+    }
+
+    /* resume one suspended sender for each mail */
+    for (index = 0; index < recved; index ++)
+    {
+        if (rt_list_isempty(&(mb->suspend_sender_thread)))
+            break;
+
+        rt_ipc_list_resume(&(mb->suspend_sender_thread));
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mb->parent.parent)));
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+
+    return recved;
+}
+RTM_EXPORT(rt_mb_recv_batch);
+#endif
+
 /**
  * This function can get or set some extra attributions of a mailbox object.
  *
@@ -1763,6 +2228,10 @@ struct rt_mq_message
     struct rt_mq_message *next;
 };
 
+#ifdef RT_USING_MQ_BUFFER
+static void _rt_mq_buf_drain(rt_mq_t mq);
+#endif
+
 /**
  * This function will initialize a message queue and put it under control of
  * resource management.
@@ -1821,6 +2290,9 @@ rt_err_t rt_mq_init(rt_mq_t     mq,
 
     /* the initial entry is zero */
     mq->entry = 0;
+#ifdef RT_USING_MQ_BUFFER
+    mq->buffer_mode = 0;
+#endif
 
     return RT_EOK;
 }
@@ -1840,6 +2312,11 @@ rt_err_t rt_mq_detach(rt_mq_t mq)
     RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
     RT_ASSERT(rt_object_is_systemobject(&mq->parent.parent));
 
+#ifdef RT_USING_MQ_BUFFER
+    /* drop the references of buffers in queue */
+    _rt_mq_buf_drain(mq);
+#endif
+
     /* resume all suspended thread */
     rt_ipc_list_resume_all(&mq->parent.suspend_thread);
 
@@ -1914,6 +2391,9 @@ rt_mq_t rt_mq_create(const char *name,
 
     /* the initial entry is zero */
     mq->entry = 0;
+#ifdef RT_USING_MQ_BUFFER
+    mq->buffer_mode = 0;
+#endif
 
     return mq;
 }
@@ -1935,6 +2415,11 @@ rt_err_t rt_mq_delete(rt_mq_t mq)
     RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
     RT_ASSERT(rt_object_is_systemobject(&mq->parent.parent) == RT_FALSE);
 
+#ifdef RT_USING_MQ_BUFFER
+    /* drop the references of buffers in queue */
+    _rt_mq_buf_drain(mq);
+#endif
+
     /* resume all suspended thread */
     rt_ipc_list_resume_all(&(mq->parent.suspend_thread));
 
@@ -1967,6 +2452,10 @@ rt_err_t rt_mq_send(rt_mq_t mq, void *buffer, rt_size_t size)
     /* parameter check */
     RT_ASSERT(mq != RT_NULL);
     RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+#ifdef RT_USING_MQ_BUFFER
+    /* the queue in buffer mode holds references, use rt_mq_*_buf instead */
+    RT_ASSERT(!mq->buffer_mode);
+#endif
     RT_ASSERT(buffer != RT_NULL);
     RT_ASSERT(size != 0);
 
@@ -2019,10 +2508,8 @@ rt_err_t rt_mq_send(rt_mq_t mq, void *buffer, rt_size_t size)
     mq->entry ++;
 
     /* resume suspended thread */
-    if (!rt_list_isempty(&mq->parent.suspend_thread))
+    if (rt_ipc_receiver_resume(&(mq->parent), mq->entry))
     {
-        rt_ipc_list_resume(&(mq->parent.suspend_thread));
-
         /* enable interrupt */
         rt_hw_interrupt_enable(temp);
 
@@ -2057,6 +2544,10 @@ rt_err_t rt_mq_urgent(rt_mq_t mq, void *buffer, rt_size_t size)
     /* parameter check */
     RT_ASSERT(mq != RT_NULL);
     RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+#ifdef RT_USING_MQ_BUFFER
+    /* the queue in buffer mode holds references, use rt_mq_*_buf instead */
+    RT_ASSERT(!mq->buffer_mode);
+#endif
     RT_ASSERT(buffer != RT_NULL);
     RT_ASSERT(size != 0);
 
@@ -2103,10 +2594,8 @@ rt_err_t rt_mq_urgent(rt_mq_t mq, void *buffer, rt_size_t size)
     mq->entry ++;
 
     /* resume suspended thread */
-    if (!rt_list_isempty(&mq->parent.suspend_thread))
+    if (rt_ipc_receiver_resume(&(mq->parent), mq->entry))
     {
-        rt_ipc_list_resume(&(mq->parent.suspend_thread));
-
         /* enable interrupt */
         rt_hw_interrupt_enable(temp);
 
@@ -2147,6 +2636,10 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     /* parameter check */
     RT_ASSERT(mq != RT_NULL);
     RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+#ifdef RT_USING_MQ_BUFFER
+    /* the queue in buffer mode holds references, use rt_mq_*_buf instead */
+    RT_ASSERT(!mq->buffer_mode);
+#endif
     RT_ASSERT(buffer != RT_NULL);
     RT_ASSERT(size != 0);
 
@@ -2188,6 +2681,7 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
 
         /* suspend current thread */
         rt_ipc_list_suspend(&(mq->parent.suspend_thread),
+                            RT_IPC_PRIO_INDEX(&(mq->parent.suspend_index)),
                             thread,
                             mq->parent.parent.flag);
 
@@ -2265,17 +2759,231 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
 }
 RTM_EXPORT(rt_mq_recv);
 
+#ifdef RT_USING_IPC_BATCH
 /**
- * This function can get or set some extra attributions of a message queue
- * object.
+ * This function will send a batch of messages to message queue object. The
+ * messages are laid out in buffer one after another, each of them is size
+ * bytes. The free messages are taken and the filled messages are linked to
+ * queue in one critical section respectively, and the threads suspended on
+ * message queue object will be waked up once. This function will return
+ * immediately.
  *
  * @param mq the message queue object
- * @param cmd the execution command
- * @param arg the execution argument
+ * @param buffer the messages
+ * @param size the size of each message
+ * @param count the number of messages
  *
- * @return the error code
+ * @return the number of messages have been sent
  */
-rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
+rt_size_t rt_mq_send_batch(rt_mq_t mq, const void *buffer, rt_size_t size, rt_size_t count)
+{
+    register rt_ubase_t temp;
+    struct rt_mq_message *head, *tail, *msg;
+    rt_bool_t need_schedule;
+    rt_size_t sent, index;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+#ifdef RT_USING_MQ_BUFFER
+    /* the queue in buffer mode holds references, use rt_mq_*_buf instead */
+    RT_ASSERT(!mq->buffer_mode);
+#endif
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return 0;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    need_schedule = RT_FALSE;
+    head = tail = RT_NULL;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    /* take free messages as a chain */
+    for (sent = 0; sent < count && mq->msg_queue_free != RT_NULL; sent ++)
+    {
+        msg = (struct rt_mq_message *)mq->msg_queue_free;
+        mq->msg_queue_free = msg->next;
+
+        if (tail != RT_NULL)
+            tail->next = msg;
+        else
+            head = msg;
+        tail = msg;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    /* message queue is full */
+    if (sent == 0)
+        return 0;
+
+    tail->next = RT_NULL;
+
+    /* copy buffers */
+    for (msg = head, index = 0; msg != RT_NULL; msg = msg->next, index ++)
+        rt_memcpy(msg + 1, (const rt_uint8_t *)buffer + index * size, size);
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    /* link the chain to message queue */
+    if (mq->msg_queue_tail != RT_NULL)
+        ((struct rt_mq_message *)mq->msg_queue_tail)->next = head;
+    mq->msg_queue_tail = tail;
+    if (mq->msg_queue_head == RT_NULL)
+        mq->msg_queue_head = head;
+
+    /* increase message entry */
+    mq->entry += sent;
+
+    /* resume one suspended thread for each message */
+    for (index = 0; index < sent; index ++)
+    {
+        if (!rt_ipc_receiver_resume(&(mq->parent), mq->entry))
+            break;
+
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+
+    return sent;
+}
+RTM_EXPORT(rt_mq_send_batch);
+
+/**
+ * This function will receive a batch of messages from message queue object.
+ * The messages are saved in buffer one after another, each of them takes
+ * size bytes. If there are less than min_count messages in queue, the thread
+ * shall wait for a specified time. On timeout, the messages which are
+ * available will be received.
+ *
+ * @param mq the message queue object
+ * @param buffer the received messages will be saved in
+ * @param size the size of each message in buffer
+ * @param count the maximum number of messages to receive
+ * @param min_count the minimum number of messages to wait for
+ * @param timeout the waiting time
+ *
+ * @return the number of received messages, 0 on timeout or error and the
+ *         error code is set to errno.
+ */
+rt_size_t rt_mq_recv_batch(rt_mq_t    mq,
+                           void      *buffer,
+                           rt_size_t  size,
+                           rt_size_t  count,
+                           rt_size_t  min_count,
+                           rt_int32_t timeout)
+{
+    rt_base_t temp;
+    struct rt_mq_message *head, *tail, *msg;
+    rt_size_t recved, index;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+#ifdef RT_USING_MQ_BUFFER
+    /* the queue in buffer mode holds references, use rt_mq_*_buf instead */
+    RT_ASSERT(!mq->buffer_mode);
+#endif
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+    RT_ASSERT(count != 0);
+
+    /* the minimum count can not exceed the capacity of message queue */
+    if (min_count > count)
+        min_count = count;
+    if (min_count > mq->max_msgs)
+        min_count = mq->max_msgs;
+    if (min_count == 0)
+        min_count = 1;
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    head = tail = RT_NULL;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    result = _rt_ipc_wait_entry(&(mq->parent), &(mq->entry), min_count, timeout, &temp);
+    if (result != RT_EOK && (result != -RT_ETIMEOUT || mq->entry == 0))
+    {
+        /* enable interrupt */
+        rt_hw_interrupt_enable(temp);
+
+        rt_set_errno(result);
+
+        return 0;
+    }
+
+    /* take messages from queue as a chain */
+    for (recved = 0; recved < count && mq->entry > 0; recved ++)
+    {
+        msg = (struct rt_mq_message *)mq->msg_queue_head;
+
+        /* move message queue head */
+        mq->msg_queue_head = msg->next;
+        /* reach queue tail, set to NULL */
+        if (mq->msg_queue_tail == msg)
+            mq->msg_queue_tail = RT_NULL;
+
+        /* decrease message entry */
+        mq->entry --;
+
+        if (tail != RT_NULL)
+            tail->next = msg;
+        else
+            head = msg;
+        tail = msg;
+    }
+    tail->next = RT_NULL;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    /* copy messages */
+    for (msg = head, index = 0; msg != RT_NULL; msg = msg->next, index ++)
+        rt_memcpy((rt_uint8_t *)buffer + index * size, msg + 1,
+                  size > mq->msg_size ? mq->msg_size : size);
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+    /* put the chain to free list */
+    tail->next = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = head;
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+    return recved;
+}
+RTM_EXPORT(rt_mq_recv_batch);
+#endif
+
+/**
+ * This function can get or set some extra attributions of a message queue
+ * object.
+ *
+ * @param mq the message queue object
+ * @param cmd the execution command
+ * @param arg the execution argument
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
 {
     rt_ubase_t level;
     struct rt_mq_message *msg;
@@ -2286,6 +2994,11 @@ rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
 
     if (cmd == RT_IPC_CMD_RESET)
     {
+#ifdef RT_USING_MQ_BUFFER
+        /* drop the references of buffers in queue */
+        _rt_mq_buf_drain(mq);
+#endif
+
         /* disable interrupt */
         level = rt_hw_interrupt_disable();
 
@@ -2323,6 +3036,357 @@ rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
     return -RT_ERROR;
 }
 RTM_EXPORT(rt_mq_control);
+
+#ifdef RT_USING_MQ_BUFFER
+/**
+ * This function will initialize a message queue in buffer mode. Each message
+ * of the queue is a reference of buffer allocated by rt_mq_buf_alloc, the
+ * payload is never copied in sending and receiving.
+ *
+ * @param mq the message object
+ * @param name the name of message queue
+ * @param msgpool the beginning address of buffer to save messages
+ * @param pool_size the size of buffer to save messages
+ * @param flag the flag of message queue
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_mq_init_buf(rt_mq_t     mq,
+                        const char *name,
+                        void       *msgpool,
+                        rt_size_t   pool_size,
+                        rt_uint8_t  flag)
+{
+    rt_err_t result;
+
+    result = rt_mq_init(mq, name, msgpool, sizeof(void *), pool_size, flag);
+    if (result == RT_EOK)
+        mq->buffer_mode = 1;
+
+    return result;
+}
+RTM_EXPORT(rt_mq_init_buf);
+
+#ifdef RT_USING_HEAP
+/**
+ * This function will create a message queue object in buffer mode.
+ *
+ * @param name the name of message queue
+ * @param max_msgs the maximum number of buffer in queue
+ * @param flag the flag of message queue
+ *
+ * @return the created message queue, RT_NULL on error happen
+ *
+ * @see rt_mq_init_buf
+ */
+rt_mq_t rt_mq_create_buf(const char *name, rt_size_t max_msgs, rt_uint8_t flag)
+{
+    rt_mq_t mq;
+
+    mq = rt_mq_create(name, sizeof(void *), max_msgs, flag);
+    if (mq != RT_NULL)
+        mq->buffer_mode = 1;
+
+    return mq;
+}
+RTM_EXPORT(rt_mq_create_buf);
+#endif
+
+/**
+ * This function will allocate a message buffer from memory pool. The block
+ * size of memory pool shall be RT_MQ_BUF_BLOCK_SIZE(payload size), and the
+ * allocated buffer holds one reference.
+ *
+ * @param mp the memory pool object
+ * @param time the waiting time
+ *
+ * @return the payload address of buffer, RT_NULL on allocated failed
+ */
+void *rt_mq_buf_alloc(rt_mp_t mp, rt_int32_t time)
+{
+    struct rt_mq_buf *header;
+
+    RT_ASSERT(mp != RT_NULL);
+    RT_ASSERT(mp->block_size > RT_MQ_BUF_HEADER_SIZE);
+
+    header = (struct rt_mq_buf *)rt_mp_alloc(mp, time);
+    if (header == RT_NULL)
+        return RT_NULL;
+
+    header->ref_count = 1;
+
+    return (rt_uint8_t *)header + RT_MQ_BUF_HEADER_SIZE;
+}
+RTM_EXPORT(rt_mq_buf_alloc);
+
+/**
+ * This function will take one more reference of a message buffer. The same
+ * buffer can be sent to several message queues by taking a reference for
+ * each of the additional receiver.
+ *
+ * @param buf the message buffer
+ */
+void rt_mq_buf_ref(void *buf)
+{
+    struct rt_mq_buf *header;
+    register rt_base_t level;
+
+    RT_ASSERT(buf != RT_NULL);
+
+    header = (struct rt_mq_buf *)((rt_uint8_t *)buf - RT_MQ_BUF_HEADER_SIZE);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    RT_ASSERT(header->ref_count > 0);
+    header->ref_count ++;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_mq_buf_ref);
+
+/**
+ * This function will release one reference of a message buffer, the buffer
+ * is freed to its memory pool when the last reference is released.
+ *
+ * @param buf the message buffer
+ */
+void rt_mq_buf_release(void *buf)
+{
+    struct rt_mq_buf *header;
+    register rt_base_t level;
+    rt_uint16_t ref_count;
+
+    RT_ASSERT(buf != RT_NULL);
+
+    header = (struct rt_mq_buf *)((rt_uint8_t *)buf - RT_MQ_BUF_HEADER_SIZE);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    RT_ASSERT(header->ref_count > 0);
+    ref_count = -- header->ref_count;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    if (ref_count == 0)
+        rt_mp_free(header);
+}
+RTM_EXPORT(rt_mq_buf_release);
+
+/**
+ * This function will send a batch of message buffers to a message queue in
+ * buffer mode. The reference held by caller is passed to the queue, so the
+ * caller shall not release the buffers which have been sent.
+ *
+ * @param mq the message queue object
+ * @param buf the array of message buffers
+ * @param count the number of message buffers
+ *
+ * @return the number of message buffers have been sent
+ */
+rt_size_t rt_mq_send_buf_batch(rt_mq_t mq, void *buf[], rt_size_t count)
+{
+    register rt_ubase_t temp;
+    struct rt_mq_message *msg;
+    rt_bool_t need_schedule;
+    rt_size_t sent, index;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(mq->buffer_mode);
+    RT_ASSERT(buf != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    need_schedule = RT_FALSE;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    for (sent = 0; sent < count; sent ++)
+    {
+        /* get a free list */
+        msg = (struct rt_mq_message *)mq->msg_queue_free;
+        /* message queue is full */
+        if (msg == RT_NULL)
+            break;
+
+        /* move free list pointer */
+        mq->msg_queue_free = msg->next;
+
+        /* only the reference is put to the message */
+        msg->next = RT_NULL;
+        *(void **)(msg + 1) = buf[sent];
+
+        /* link msg to message queue */
+        if (mq->msg_queue_tail != RT_NULL)
+            ((struct rt_mq_message *)mq->msg_queue_tail)->next = msg;
+        mq->msg_queue_tail = msg;
+        if (mq->msg_queue_head == RT_NULL)
+            mq->msg_queue_head = msg;
+
+        /* increase message entry */
+        mq->entry ++;
+    }
+
+    /* resume one suspended thread for each message */
+    for (index = 0; index < sent; index ++)
+    {
+        if (!rt_ipc_receiver_resume(&(mq->parent), mq->entry))
+            break;
+
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+
+    return sent;
+}
+RTM_EXPORT(rt_mq_send_buf_batch);
+
+/**
+ * This function will send a message buffer to a message queue in buffer mode.
+ *
+ * @param mq the message queue object
+ * @param buf the message buffer
+ *
+ * @return the error code
+ *
+ * @see rt_mq_send_buf_batch
+ */
+rt_err_t rt_mq_send_buf(rt_mq_t mq, void *buf)
+{
+    RT_ASSERT(buf != RT_NULL);
+
+    if (rt_mq_send_buf_batch(mq, &buf, 1) != 1)
+        return -RT_EFULL;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_send_buf);
+
+/**
+ * This function will receive a batch of message buffers from a message queue
+ * in buffer mode. If there is no message, the thread shall wait for a
+ * specified time, then all of available buffers (at most count) are received
+ * in one critical section. The receiver owns the references of received
+ * buffers and shall release them by rt_mq_buf_release.
+ *
+ * @param mq the message queue object
+ * @param buf the array to save received message buffers
+ * @param count the size of array
+ * @param timeout the waiting time
+ *
+ * @return the number of received message buffers, 0 on timeout or error and
+ *         the error code is set to errno.
+ */
+rt_size_t rt_mq_recv_buf_batch(rt_mq_t     mq,
+                               void       *buf[],
+                               rt_size_t   count,
+                               rt_int32_t  timeout)
+{
+    rt_base_t temp;
+    struct rt_mq_message *msg;
+    rt_size_t recved;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(mq->buffer_mode);
+    RT_ASSERT(buf != RT_NULL);
+    RT_ASSERT(count != 0);
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    result = _rt_ipc_wait_entry(&(mq->parent), &(mq->entry), 1, timeout, &temp);
+    if (result != RT_EOK)
+    {
+        /* enable interrupt */
+        rt_hw_interrupt_enable(temp);
+
+        rt_set_errno(result);
+
+        return 0;
+    }
+
+    for (recved = 0; recved < count && mq->entry > 0; recved ++)
+    {
+        /* get message from queue */
+        msg = (struct rt_mq_message *)mq->msg_queue_head;
+
+        /* move message queue head */
+        mq->msg_queue_head = msg->next;
+        /* reach queue tail, set to NULL */
+        if (mq->msg_queue_tail == msg)
+            mq->msg_queue_tail = RT_NULL;
+
+        /* decrease message entry */
+        mq->entry --;
+
+        /* take the reference away */
+        buf[recved] = *(void **)(msg + 1);
+
+        /* put message to free list */
+        msg->next = (struct rt_mq_message *)mq->msg_queue_free;
+        mq->msg_queue_free = msg;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+    return recved;
+}
+RTM_EXPORT(rt_mq_recv_buf_batch);
+
+/**
+ * This function will receive a message buffer from a message queue in buffer
+ * mode.
+ *
+ * @param mq the message queue object
+ * @param buf the received message buffer will be saved in
+ * @param timeout the waiting time
+ *
+ * @return the error code
+ *
+ * @see rt_mq_recv_buf_batch
+ */
+rt_err_t rt_mq_recv_buf(rt_mq_t mq, void **buf, rt_int32_t timeout)
+{
+    RT_ASSERT(buf != RT_NULL);
+
+    if (rt_mq_recv_buf_batch(mq, buf, 1, timeout) != 1)
+        return rt_get_errno();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_recv_buf);
+
+/* release all of buffers left in a message queue of buffer mode */
+static void _rt_mq_buf_drain(rt_mq_t mq)
+{
+    void *buf;
+
+    if (!mq->buffer_mode)
+        return;
+
+    while (rt_mq_recv_buf_batch(mq, &buf, 1, 0) == 1)
+        rt_mq_buf_release(buf);
+}
+#endif
 #endif /* end of RT_USING_MESSAGEQUEUE */
 
 /**@}*/
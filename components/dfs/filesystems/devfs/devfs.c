@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-02-11     Bernard      Ignore O_CREAT flag in open.
+ * 2026-10-19     agent        Add readv/writev.
  */
 
 #include <rtthread.h>
@@ -40,6 +41,10 @@ int dfs_device_fs_ioctl(struct dfs_fd *file, int cmd, void *args)
     dev_id = (rt_device_t)file->data;
     RT_ASSERT(dev_id != RT_NULL);
 
+    /* a device can't be truncated, don't let the driver take it as its own command */
+    if (cmd == DFS_FIOFTRUNCATE)
+        return -EINVAL;
+
     /* close device handler */
     result = rt_device_control(dev_id, cmd, args);
     if (result == RT_EOK)
@@ -84,6 +89,82 @@ int dfs_device_fs_write(struct dfs_fd *file, const void *buf, size_t count)
     return result;
 }
 
+/* try the vectored transfer of device, the size is untouched if it's not supported */
+static int dfs_device_fs_iov(rt_device_t dev_id, int cmd, struct dfs_fd *file,
+                             const struct iovec *iov, int iovcnt)
+{
+    struct rt_device_iov args;
+
+    args.pos    = file->pos;
+    args.iov    = iov;
+    args.iovcnt = iovcnt;
+    args.size   = (rt_size_t)-1;
+
+    if (rt_device_control(dev_id, cmd, &args) != RT_EOK ||
+        args.size == (rt_size_t)-1)
+        return -ENOSYS;
+
+    return args.size;
+}
+
+int dfs_device_fs_readv(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    int index, result, length = 0;
+    rt_device_t dev_id;
+
+    RT_ASSERT(file != RT_NULL);
+
+    /* get device handler */
+    dev_id = (rt_device_t)file->data;
+    RT_ASSERT(dev_id != RT_NULL);
+
+    length = dfs_device_fs_iov(dev_id, RT_DEVICE_CTRL_READV, file, iov, iovcnt);
+    if (length < 0)
+    {
+        /* read buffer by buffer */
+        for (index = 0, length = 0; index < iovcnt; index ++)
+        {
+            result = rt_device_read(dev_id, file->pos + length,
+                                    iov[index].iov_base, iov[index].iov_len);
+            length += result;
+            if ((size_t)result < iov[index].iov_len)
+                break;
+        }
+    }
+    file->pos += length;
+
+    return length;
+}
+
+int dfs_device_fs_writev(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    int index, result, length = 0;
+    rt_device_t dev_id;
+
+    RT_ASSERT(file != RT_NULL);
+
+    /* get device handler */
+    dev_id = (rt_device_t)file->data;
+    RT_ASSERT(dev_id != RT_NULL);
+
+    length = dfs_device_fs_iov(dev_id, RT_DEVICE_CTRL_WRITEV, file, iov, iovcnt);
+    if (length < 0)
+    {
+        /* write buffer by buffer */
+        for (index = 0, length = 0; index < iovcnt; index ++)
+        {
+            result = rt_device_write(dev_id, file->pos + length,
+                                     iov[index].iov_base, iov[index].iov_len);
+            length += result;
+            if ((size_t)result < iov[index].iov_len)
+                break;
+        }
+    }
+    file->pos += length;
+
+    return length;
+}
+
 int dfs_device_fs_close(struct dfs_fd *file)
 {
     rt_err_t result;
@@ -304,6 +385,9 @@ static const struct dfs_file_ops _device_fops =
     RT_NULL,                    /* lseek */
     dfs_device_fs_getdents,
     dfs_device_fs_poll,
+    RT_NULL,                    /* mmap */
+    dfs_device_fs_readv,
+    dfs_device_fs_writev,
 };
 
 static const struct dfs_filesystem_ops _device_fs =
@@ -15,6 +15,10 @@
  * 2017-02-13     Hichard      Update Fatfs version to 0.12b, support exFAT.
  * 2017-04-11     Bernard      fix the st_blksize issue.
  * 2017-05-26     Urey         fix f_mount error when mount more fats
+ * 2026-10-19     agent        access block device through block cache
+ * 2026-10-19     agent        cache the non-existent paths in path lookup cache
+ * 2026-10-19     agent        add readv/writev.
+ * 2026-10-19     agent        report the errors of sync in CTRL_SYNC
  */
 
 #include <rtthread.h>
@@ -28,6 +32,12 @@
 
 #include <dfs_fs.h>
 #include <dfs_file.h>
+#ifdef RT_USING_DFS_BCACHE
+#include <dfs_bcache.h>
+#endif
+#ifdef RT_USING_DFS_DENTRY_CACHE
+#include <dfs_dentry.h>
+#endif
 
 static rt_device_t disk[_VOLUMES] = {0};
 
@@ -128,6 +138,11 @@ int dfs_elm_mount(struct dfs_filesystem *fs, unsigned long rwflag, const void *d
         return -ENOMEM;
     }
 
+#ifdef RT_USING_DFS_BCACHE
+    /* the device is accessed directly if block cache is not available */
+    dfs_bcache_attach(fs->dev_id);
+#endif
+
     /* mount fatfs, always 0 logic driver */
     result = f_mount(fat, (const TCHAR *)logic_nbr, 1);
     if (result == FR_OK)
@@ -140,6 +155,9 @@ int dfs_elm_mount(struct dfs_filesystem *fs, unsigned long rwflag, const void *d
         if (dir == RT_NULL)
         {
             f_mount(RT_NULL, (const TCHAR *)logic_nbr, 1);
+#ifdef RT_USING_DFS_BCACHE
+            dfs_bcache_detach(fs->dev_id);
+#endif
             disk[index] = RT_NULL;
             rt_free(fat);
             return -ENOMEM;
@@ -158,6 +176,9 @@ int dfs_elm_mount(struct dfs_filesystem *fs, unsigned long rwflag, const void *d
 
 __err:
     f_mount(RT_NULL, (const TCHAR *)logic_nbr, 1);
+#ifdef RT_USING_DFS_BCACHE
+    dfs_bcache_detach(fs->dev_id);
+#endif
     disk[index] = RT_NULL;
     rt_free(fat);
     return elm_result_to_dfs(result);
@@ -184,6 +205,11 @@ int dfs_elm_unmount(struct dfs_filesystem *fs)
     if (result != FR_OK)
         return elm_result_to_dfs(result);
 
+#ifdef RT_USING_DFS_BCACHE
+    /* write back the dirty sectors */
+    dfs_bcache_detach(fs->dev_id);
+#endif
+
     fs->data = RT_NULL;
     disk[index] = RT_NULL;
     rt_free(fat);
@@ -435,6 +461,11 @@ int dfs_elm_open(struct dfs_fd *file)
         }
         else
         {
+#ifdef RT_USING_DFS_DENTRY_CACHE
+            /* remember the non-existent file to skip the next lookup on disk */
+            if (result == FR_NO_FILE || result == FR_NO_PATH)
+                dfs_dentry_insert_negative((struct dfs_filesystem *)file->data, file->path);
+#endif
             /* open failed, return */
             rt_free(fd);
             return elm_result_to_dfs(result);
@@ -528,6 +559,75 @@ int dfs_elm_write(struct dfs_fd *file, const void *buf, size_t len)
     return elm_result_to_dfs(result);
 }
 
+int dfs_elm_readv(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    FIL *fd;
+    FRESULT result = FR_OK;
+    UINT byte_read;
+    int index, length = 0;
+
+    if (file->type == FT_DIRECTORY)
+    {
+        return -EISDIR;
+    }
+
+    fd = (FIL *)(file->data);
+    RT_ASSERT(fd != RT_NULL);
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        result = f_read(fd, iov[index].iov_base, iov[index].iov_len, &byte_read);
+        if (result != FR_OK)
+            break;
+
+        length += byte_read;
+        /* reach the end of file */
+        if (byte_read < iov[index].iov_len)
+            break;
+    }
+    /* update position */
+    file->pos  = fd->fptr;
+    if (result == FR_OK || length > 0)
+        return length;
+
+    return elm_result_to_dfs(result);
+}
+
+int dfs_elm_writev(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    FIL *fd;
+    FRESULT result = FR_OK;
+    UINT byte_write;
+    int index, length = 0;
+
+    if (file->type == FT_DIRECTORY)
+    {
+        return -EISDIR;
+    }
+
+    fd = (FIL *)(file->data);
+    RT_ASSERT(fd != RT_NULL);
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        result = f_write(fd, iov[index].iov_base, iov[index].iov_len, &byte_write);
+        if (result != FR_OK)
+            break;
+
+        length += byte_write;
+        /* the volume is full */
+        if (byte_write < iov[index].iov_len)
+            break;
+    }
+    /* update position and file size */
+    file->pos  = fd->fptr;
+    file->size = f_size(fd);
+    if (result == FR_OK || length > 0)
+        return length;
+
+    return elm_result_to_dfs(result);
+}
+
 int dfs_elm_flush(struct dfs_fd *file)
 {
     FIL *fd;
@@ -776,6 +876,12 @@ int dfs_elm_stat(struct dfs_filesystem *fs, const char *path, struct stat *st)
             st->st_mtime = mktime(&tm_file);
         } /* get st_mtime. */
     }
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    else if (result == FR_NO_FILE || result == FR_NO_PATH)
+    {
+        dfs_dentry_insert_negative(fs, path);
+    }
+#endif
 
     return elm_result_to_dfs(result);
 }
@@ -791,6 +897,9 @@ static const struct dfs_file_ops dfs_elm_fops =
     dfs_elm_lseek,
     dfs_elm_getdents,
     RT_NULL, /* poll interface */
+    RT_NULL, /* mmap interface */
+    dfs_elm_readv,
+    dfs_elm_writev,
 };
 
 static const struct dfs_filesystem_ops dfs_elm =
@@ -841,7 +950,11 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
     rt_size_t result;
     rt_device_t device = disk[drv];
 
+#ifdef RT_USING_DFS_BCACHE
+    result = dfs_bcache_read(device, sector, buff, count);
+#else
     result = rt_device_read(device, sector, buff, count);
+#endif
     if (result == count)
     {
         return RES_OK;
@@ -856,7 +969,11 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
     rt_size_t result;
     rt_device_t device = disk[drv];
 
+#ifdef RT_USING_DFS_BCACHE
+    result = dfs_bcache_write(device, sector, buff, count);
+#else
     result = rt_device_write(device, sector, buff, count);
+#endif
     if (result == count)
     {
         return RES_OK;
@@ -904,7 +1021,16 @@ DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff)
     }
     else if (ctrl == CTRL_SYNC)
     {
-        rt_device_control(device, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+        rt_err_t result;
+
+#ifdef RT_USING_DFS_BCACHE
+        if (dfs_bcache_sync(device) != 0)
+            return RES_ERROR;
+#endif
+        /* the device without control is synchronized already */
+        result = rt_device_control(device, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+        if (result != RT_EOK && result != -RT_ENOSYS)
+            return RES_ERROR;
     }
     else if (ctrl == CTRL_TRIM)
     {
@@ -8,6 +8,10 @@
  * 2013-04-15     Bernard      the first version
  * 2013-05-05     Bernard      remove CRC for ramfs persistence
  * 2013-05-22     Bernard      fix the no entry issue.
+ * 2026-10-19     agent        look up the entries through path lookup cache.
+ * 2026-10-19     agent        add mmap file operation.
+ * 2026-10-19     agent        add readv/writev file operation.
+ * 2026-10-19     agent        remove mmap, the mapping dangles once the file grows.
  */
 
 #include <rtthread.h>
@@ -17,6 +21,10 @@
 
 #include "dfs_ramfs.h"
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+#include <dfs_dentry.h>
+#endif
+
 int dfs_ramfs_mount(struct dfs_filesystem *fs,
                     unsigned long          rwflag,
                     const void            *data)
@@ -92,6 +100,36 @@ struct ramfs_dirent *dfs_ramfs_lookup(struct dfs_ramfs *ramfs,
     return NULL;
 }
 
+static struct ramfs_dirent *dfs_ramfs_lookup_fs(struct dfs_filesystem *fs,
+                                                const char            *path,
+                                                rt_size_t             *size)
+{
+    struct ramfs_dirent *dirent;
+
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    switch (dfs_dentry_lookup(fs, path, (void **)&dirent))
+    {
+    case DFS_DENTRY_POSITIVE:
+        *size = dirent->size;
+        return dirent;
+
+    case DFS_DENTRY_NEGATIVE:
+        return NULL;
+    }
+#endif
+
+    dirent = dfs_ramfs_lookup((struct dfs_ramfs *)fs->data, path, size);
+
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    if (dirent != NULL)
+        dfs_dentry_insert(fs, path, dirent);
+    else
+        dfs_dentry_insert_negative(fs, path);
+#endif
+
+    return dirent;
+}
+
 int dfs_ramfs_read(struct dfs_fd *file, void *buf, size_t count)
 {
     rt_size_t length;
@@ -151,6 +189,73 @@ int dfs_ramfs_write(struct dfs_fd *fd, const void *buf, size_t count)
     return count;
 }
 
+int dfs_ramfs_readv(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    int index, result, length = 0;
+
+    for (index = 0; index < iovcnt && file->pos < file->size; index ++)
+    {
+        result = dfs_ramfs_read(file, iov[index].iov_base, iov[index].iov_len);
+        if (result < 0)
+        {
+            /* report the data read before the error */
+            return length > 0 ? length : result;
+        }
+
+        length += result;
+        if ((size_t)result < iov[index].iov_len)
+            break;
+    }
+
+    return length;
+}
+
+int dfs_ramfs_writev(struct dfs_fd *fd, const struct iovec *iov, int iovcnt)
+{
+    struct ramfs_dirent *dirent;
+    struct dfs_ramfs *ramfs;
+    size_t count = 0;
+    int index;
+
+    dirent = (struct ramfs_dirent *)fd->data;
+    RT_ASSERT(dirent != NULL);
+
+    ramfs = dirent->fs;
+    RT_ASSERT(ramfs != NULL);
+
+    for (index = 0; index < iovcnt; index ++)
+        count += iov[index].iov_len;
+
+    /* extend the file once for all of buffers */
+    if (count + fd->pos > fd->size)
+    {
+        rt_uint8_t *ptr;
+        ptr = rt_memheap_realloc(&(ramfs->memheap), dirent->data, fd->pos + count);
+        if (ptr == NULL)
+        {
+            rt_set_errno(-ENOMEM);
+
+            return 0;
+        }
+
+        /* update dirent and file size */
+        dirent->data = ptr;
+        dirent->size = fd->pos + count;
+        fd->size = dirent->size;
+    }
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len > 0)
+            memcpy(dirent->data + fd->pos, iov[index].iov_base, iov[index].iov_len);
+
+        /* update file current position */
+        fd->pos += iov[index].iov_len;
+    }
+
+    return count;
+}
+
 int dfs_ramfs_lseek(struct dfs_fd *file, off_t offset)
 {
     if (offset <= (off_t)file->size)
@@ -190,7 +295,7 @@ int dfs_ramfs_open(struct dfs_fd *file)
         }
 
         /* open directory */
-        dirent = dfs_ramfs_lookup(ramfs, file->path, &size);
+        dirent = dfs_ramfs_lookup_fs(fs, file->path, &size);
         if (dirent == NULL)
             return -ENOENT;
         if (dirent == &(ramfs->root)) /* it's root directory */
@@ -203,7 +308,7 @@ int dfs_ramfs_open(struct dfs_fd *file)
     }
     else
     {
-        dirent = dfs_ramfs_lookup(ramfs, file->path, &size);
+        dirent = dfs_ramfs_lookup_fs(fs, file->path, &size);
         if (dirent == &(ramfs->root)) /* it's root directory */
         {
             return -ENOENT;
@@ -237,6 +342,9 @@ int dfs_ramfs_open(struct dfs_fd *file)
 
                 /* add to the root directory */
                 rt_list_insert_after(&(ramfs->root.list), &(dirent->list));
+#ifdef RT_USING_DFS_DENTRY_CACHE
+                dfs_dentry_insert(fs, file->path, dirent);
+#endif
             }
             else
                 return -ENOENT;
@@ -272,10 +380,8 @@ int dfs_ramfs_stat(struct dfs_filesystem *fs,
 {
     rt_size_t size;
     struct ramfs_dirent *dirent;
-    struct dfs_ramfs *ramfs;
 
-    ramfs = (struct dfs_ramfs *)fs->data;
-    dirent = dfs_ramfs_lookup(ramfs, path, &size);
+    dirent = dfs_ramfs_lookup_fs(fs, path, &size);
 
     if (dirent == NULL)
         return -ENOENT;
@@ -345,10 +451,13 @@ int dfs_ramfs_unlink(struct dfs_filesystem *fs, const char *path)
     ramfs = (struct dfs_ramfs *)fs->data;
     RT_ASSERT(ramfs != NULL);
 
-    dirent = dfs_ramfs_lookup(ramfs, path, &size);
+    dirent = dfs_ramfs_lookup_fs(fs, path, &size);
     if (dirent == NULL)
         return -ENOENT;
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    dfs_dentry_remove(fs, path);
+#endif
     rt_list_remove(&(dirent->list));
     if (dirent->data != NULL)
         rt_memheap_free(dirent->data);
@@ -368,14 +477,19 @@ int dfs_ramfs_rename(struct dfs_filesystem *fs,
     ramfs = (struct dfs_ramfs *)fs->data;
     RT_ASSERT(ramfs != NULL);
 
-    dirent = dfs_ramfs_lookup(ramfs, newpath, &size);
+    dirent = dfs_ramfs_lookup_fs(fs, newpath, &size);
     if (dirent != NULL)
         return -EEXIST;
 
-    dirent = dfs_ramfs_lookup(ramfs, oldpath, &size);
+    dirent = dfs_ramfs_lookup_fs(fs, oldpath, &size);
     if (dirent == NULL)
         return -ENOENT;
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    dfs_dentry_remove(fs, oldpath);
+    dfs_dentry_remove(fs, newpath);
+#endif
+
     strncpy(dirent->name, newpath, RAMFS_NAME_MAX);
 
     return RT_EOK;
@@ -391,6 +505,10 @@ static const struct dfs_file_ops _ram_fops =
     NULL, /* flush */
     dfs_ramfs_lseek,
     dfs_ramfs_getdents,
+    NULL, /* poll */
+    NULL, /* mmap, the data is moved when the file grows */
+    dfs_ramfs_readv,
+    dfs_ramfs_writev,
 };
 
 static const struct dfs_filesystem_ops _ramfs =
@@ -5,6 +5,8 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     agent        add mmap file operation.
+ * 2026-10-19     agent        add compressed file.
  */
 
 #include <rtthread.h>
@@ -39,8 +41,11 @@ int dfs_romfs_ioctl(struct dfs_fd *file, int cmd, void *args)
 
 rt_inline int check_dirent(struct romfs_dirent *dirent)
 {
-    if ((dirent->type != ROMFS_DIRENT_FILE && dirent->type != ROMFS_DIRENT_DIR)
-        || dirent->size == ~0)
+    if ((dirent->type != ROMFS_DIRENT_FILE && dirent->type != ROMFS_DIRENT_DIR
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+         && dirent->type != ROMFS_DIRENT_ZFILE
+#endif
+        ) || dirent->size == ~0)
         return -1;
     return 0;
 }
@@ -146,6 +151,18 @@ int dfs_romfs_read(struct dfs_fd *file, void *buf, size_t count)
     else
         length = file->size - file->pos;
 
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+    if (dirent->type == ROMFS_DIRENT_ZFILE && length > 0)
+    {
+        int result;
+
+        result = romfs_zfile_read(dirent, file->pos, buf, length);
+        if (result < 0)
+            return result;
+        length = result;
+    }
+    else
+#endif
     if (length > 0)
         memcpy(buf, &(dirent->data[file->pos]), length);
 
@@ -166,6 +183,34 @@ int dfs_romfs_lseek(struct dfs_fd *file, off_t offset)
     return -EIO;
 }
 
+int dfs_romfs_mmap(struct dfs_fd *file, off_t offset, size_t length, int flags, void **addr)
+{
+    struct romfs_dirent *dirent;
+
+    dirent = (struct romfs_dirent *)file->data;
+    RT_ASSERT(dirent != NULL);
+
+    if (check_dirent(dirent) != 0)
+    {
+        return -EIO;
+    }
+
+    /* the content is in read only memory */
+    if (flags & DFS_MMAP_WRITE)
+        return -EACCES;
+
+    /* the compressed content can't be mapped */
+    if (dirent->type != ROMFS_DIRENT_FILE)
+        return -ENOSYS;
+
+    if (offset + length > dirent->size)
+        return -EINVAL;
+
+    *addr = (void *)&(dirent->data[offset]);
+
+    return 0;
+}
+
 int dfs_romfs_close(struct dfs_fd *file)
 {
     file->data = NULL;
@@ -203,6 +248,11 @@ int dfs_romfs_open(struct dfs_fd *file)
         /* entry is a file, but open it as a directory */
         if (file->flags & O_DIRECTORY)
             return -ENOENT;
+
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+        if (dirent->type == ROMFS_DIRENT_ZFILE && romfs_zfile_check(dirent) != 0)
+            return -EIO;
+#endif
     }
 
     file->data = dirent;
@@ -295,6 +345,8 @@ static const struct dfs_file_ops _rom_fops =
     NULL,
     dfs_romfs_lseek,
     dfs_romfs_getdents,
+    NULL, /* poll */
+    dfs_romfs_mmap,
 };
 static const struct dfs_filesystem_ops _romfs =
 {
@@ -314,6 +366,9 @@ static const struct dfs_filesystem_ops _romfs =
 
 int dfs_romfs_init(void)
 {
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+    romfs_zfile_init();
+#endif
     /* register rom file system */
     dfs_register(&_romfs);
     return 0;
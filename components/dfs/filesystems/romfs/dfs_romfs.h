@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019/01/13     Bernard      code cleanup
+ * 2026-10-19     agent        add compressed file
  */
 
 #ifndef __DFS_ROMFS_H__
@@ -15,6 +16,19 @@
 
 #define ROMFS_DIRENT_FILE   0x00
 #define ROMFS_DIRENT_DIR    0x01
+#define ROMFS_DIRENT_ZFILE  0x02    /* file compressed in blocks, the size is uncompressed size */
+
+/*
+ * The compressed file starts with a header, all of fields are 32 bits in
+ * little endian:
+ *
+ *   magic, block size, block number, offset[block number + 1]
+ *
+ * Block n is stored in [offset[n], offset[n + 1]) from the start of header.
+ * It's compressed in LZ4 block format, or stored as is when the length is
+ * the same as uncompressed block.
+ */
+#define ROMFS_ZFILE_MAGIC   0x5a4d4f52  /* "ROMZ" */
 
 struct romfs_dirent
 {
@@ -26,6 +40,12 @@ struct romfs_dirent
 };
 
 int dfs_romfs_init(void);
+
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+int romfs_zfile_init(void);
+int romfs_zfile_check(const struct romfs_dirent *dirent);
+int romfs_zfile_read(const struct romfs_dirent *dirent, rt_size_t pos, void *buf, rt_size_t count);
+#endif
 extern const struct romfs_dirent romfs_root;
 
 #endif
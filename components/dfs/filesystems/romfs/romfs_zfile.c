@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+/*
+ * The compressed file of romfs is made by tools/mkromfs.py --compress. The
+ * block of position is found by the offset table in header, and the recently
+ * used blocks are kept in a small cache after decompressed.
+ */
+
+#include <rtthread.h>
+#include <dfs.h>
+
+#include "dfs_romfs.h"
+
+#ifdef RT_USING_DFS_ROMFS_ZFILE
+
+#ifndef ROMFS_ZBLOCK_SIZE_MAX
+#define ROMFS_ZBLOCK_SIZE_MAX   4096
+#endif
+
+#ifndef ROMFS_ZCACHE_NUM
+#define ROMFS_ZCACHE_NUM        2
+#endif
+
+#define ZFILE_HEADER_SIZE       12  /* magic, block size, block number */
+
+struct romfs_zcache
+{
+    const rt_uint8_t *zfile;            /* header of compressed file */
+    rt_uint32_t block;
+    rt_uint32_t length;                 /* decompressed length */
+    rt_uint32_t age;
+
+    rt_uint8_t *data;
+};
+
+static struct rt_mutex _zcache_lock;
+static struct romfs_zcache _zcache[ROMFS_ZCACHE_NUM];
+static rt_uint32_t _zcache_age;
+
+/* the header may be not aligned in image */
+rt_inline rt_uint32_t _zfile_u32(const rt_uint8_t *ptr)
+{
+    return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((rt_uint32_t)ptr[3] << 24);
+}
+
+rt_inline rt_uint32_t _zfile_offset(const rt_uint8_t *zfile, rt_uint32_t block)
+{
+    return _zfile_u32(zfile + ZFILE_HEADER_SIZE + block * 4);
+}
+
+/* decompress the LZ4 block, return the decompressed length or -1 on corrupt data */
+static int _lz4_decompress(const rt_uint8_t *src, rt_size_t src_len,
+                           rt_uint8_t *dst, rt_size_t dst_len)
+{
+    const rt_uint8_t *ip = src, *iend = src + src_len;
+    rt_uint8_t *op = dst, *oend = dst + dst_len;
+    const rt_uint8_t *match;
+    rt_size_t length, offset;
+    rt_uint8_t token, byte;
+
+    while (ip < iend)
+    {
+        token = *ip ++;
+
+        /* literals */
+        length = token >> 4;
+        if (length == 15)
+        {
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                byte = *ip ++;
+                length += byte;
+            } while (byte == 255);
+        }
+        if (length > (rt_size_t)(iend - ip) || length > (rt_size_t)(oend - op))
+            return -1;
+        memcpy(op, ip, length);
+        op += length;
+        ip += length;
+
+        /* the last sequence has only literals */
+        if (ip >= iend)
+            break;
+
+        /* match */
+        if (iend - ip < 2)
+            return -1;
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (rt_size_t)(op - dst))
+            return -1;
+
+        length = token & 0x0f;
+        if (length == 15)
+        {
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                byte = *ip ++;
+                length += byte;
+            } while (byte == 255);
+        }
+        length += 4;
+        if (length > (rt_size_t)(oend - op))
+            return -1;
+
+        /* the match may overlap with output */
+        match = op - offset;
+        while (length --)
+            *op ++ = *match ++;
+    }
+
+    return op - dst;
+}
+
+/* get the block into buffer, which holds the whole uncompressed block */
+static int _zfile_load(const struct romfs_dirent *dirent, rt_uint32_t block, rt_uint8_t *buf)
+{
+    const rt_uint8_t *zfile = dirent->data;
+    rt_uint32_t block_size, start, end, length;
+
+    block_size = _zfile_u32(zfile + 4);
+    start = _zfile_offset(zfile, block);
+    end   = _zfile_offset(zfile, block + 1);
+
+    length = dirent->size - block * block_size;
+    if (length > block_size)
+        length = block_size;
+
+    if (end - start == length)
+    {
+        /* stored as is */
+        memcpy(buf, zfile + start, length);
+        return length;
+    }
+
+    if (_lz4_decompress(zfile + start, end - start, buf, length) != (int)length)
+        return -EIO;
+
+    return length;
+}
+
+/* find the block in cache, or decompress it into the least recently used entry */
+static struct romfs_zcache *_zcache_get(const struct romfs_dirent *dirent, rt_uint32_t block)
+{
+    struct romfs_zcache *entry, *victim = RT_NULL;
+    int index, length;
+
+    for (index = 0; index < ROMFS_ZCACHE_NUM; index ++)
+    {
+        entry = &_zcache[index];
+        if (entry->zfile == dirent->data && entry->block == block)
+        {
+            entry->age = ++ _zcache_age;
+            return entry;
+        }
+
+        if (victim == RT_NULL || entry->age < victim->age)
+            victim = entry;
+    }
+
+    if (victim->data == RT_NULL)
+    {
+        victim->data = (rt_uint8_t *)rt_malloc(ROMFS_ZBLOCK_SIZE_MAX);
+        if (victim->data == RT_NULL)
+            return RT_NULL;
+    }
+
+    victim->zfile = RT_NULL;
+    length = _zfile_load(dirent, block, victim->data);
+    if (length < 0)
+        return RT_NULL;
+
+    victim->zfile  = dirent->data;
+    victim->block  = block;
+    victim->length = length;
+    victim->age    = ++ _zcache_age;
+
+    return victim;
+}
+
+int romfs_zfile_init(void)
+{
+    rt_mutex_init(&_zcache_lock, "romfs", RT_IPC_FLAG_FIFO);
+
+    return 0;
+}
+
+/**
+ * This function checks the header of compressed file.
+ *
+ * @param dirent the dirent of compressed file.
+ *
+ * @return 0 on the header is valid, -1 on failed.
+ */
+int romfs_zfile_check(const struct romfs_dirent *dirent)
+{
+    const rt_uint8_t *zfile = dirent->data;
+    rt_uint32_t block_size, blocks;
+
+    if (dirent->size == 0)
+        return 0;
+
+    if (zfile == RT_NULL || _zfile_u32(zfile) != ROMFS_ZFILE_MAGIC)
+        return -1;
+
+    block_size = _zfile_u32(zfile + 4);
+    blocks = _zfile_u32(zfile + 8);
+    if (block_size == 0 || block_size > ROMFS_ZBLOCK_SIZE_MAX ||
+        blocks != (dirent->size + block_size - 1) / block_size)
+        return -1;
+
+    return 0;
+}
+
+/**
+ * This function reads the content of compressed file.
+ *
+ * @param dirent the dirent of compressed file.
+ * @param pos the position in uncompressed content.
+ * @param buf the buffer to save the content.
+ * @param count the length to read, it doesn't exceed the end of file.
+ *
+ * @return the length read, or the negative error code.
+ */
+int romfs_zfile_read(const struct romfs_dirent *dirent, rt_size_t pos, void *buf, rt_size_t count)
+{
+    const rt_uint8_t *zfile = dirent->data;
+    struct romfs_zcache *entry;
+    rt_uint32_t block_size, block, offset;
+    rt_size_t index, length;
+    int result = 0;
+
+    block_size = _zfile_u32(zfile + 4);
+
+    rt_mutex_take(&_zcache_lock, RT_WAITING_FOREVER);
+    for (index = 0; index < count; index += length)
+    {
+        block  = (pos + index) / block_size;
+        offset = (pos + index) % block_size;
+
+        length = dirent->size - block * block_size;
+        if (length > block_size)
+            length = block_size;
+
+        if (offset == 0 && count - index >= length)
+        {
+            /* the whole block is read, decompress it into buffer directly */
+            result = _zfile_load(dirent, block, (rt_uint8_t *)buf + index);
+            if (result < 0)
+                break;
+        }
+        else
+        {
+            entry = _zcache_get(dirent, block);
+            if (entry == RT_NULL)
+            {
+                result = -EIO;
+                break;
+            }
+
+            length = entry->length - offset;
+            if (length > count - index)
+                length = count - index;
+            memcpy((rt_uint8_t *)buf + index, entry->data + offset, length);
+        }
+    }
+    rt_mutex_release(&_zcache_lock);
+
+    if (index == 0 && count > 0)
+        return result;
+
+    return index;
+}
+
+#endif /* RT_USING_DFS_ROMFS_ZFILE */
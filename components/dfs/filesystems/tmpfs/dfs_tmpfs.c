@@ -0,0 +1,793 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        allocate the chunks of file extended by truncate
+ */
+
+/*
+ * tmpfs keeps the files in system heap with real directories. The children of
+ * directory are looked up in hash buckets, the content of file is stored in
+ * chunks of DFS_TMPFS_CHUNK_SIZE bytes, so appending to a file doesn't move
+ * the data written before.
+ */
+
+#include <rtthread.h>
+#include <dfs.h>
+#include <dfs_fs.h>
+#include <dfs_file.h>
+
+#include "dfs_tmpfs.h"
+
+#define TMPFS_CHUNK_INDEX(pos)      ((pos) / DFS_TMPFS_CHUNK_SIZE)
+#define TMPFS_CHUNK_OFFSET(pos)     ((pos) % DFS_TMPFS_CHUNK_SIZE)
+#define TMPFS_CHUNK_NUM(size)       (((size) + DFS_TMPFS_CHUNK_SIZE - 1) / DFS_TMPFS_CHUNK_SIZE)
+
+static rt_uint32_t _tmpfs_hash(const char *name, rt_size_t len)
+{
+    rt_uint32_t hash = 0;
+
+    while (len --)
+        hash = hash * 131 + *name ++;
+
+    return hash;
+}
+
+static struct tmpfs_node *_tmpfs_find_child(struct tmpfs_node *dir,
+                                            const char *name, rt_size_t len)
+{
+    rt_uint32_t hash;
+    rt_list_t *bucket, *node;
+    struct tmpfs_node *child;
+
+    hash = _tmpfs_hash(name, len);
+    bucket = &(dir->u.buckets[hash % DFS_TMPFS_HASH_SIZE]);
+    for (node = bucket->next; node != bucket; node = node->next)
+    {
+        child = rt_list_entry(node, struct tmpfs_node, sibling);
+        if (child->hash == hash && strncmp(child->name, name, len) == 0 &&
+            child->name[len] == '\0')
+        {
+            return child;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/**
+ * This function looks up the node of path. When the node isn't found but its
+ * parent directory is, the parent and the last name in path are returned.
+ */
+static struct tmpfs_node *_tmpfs_lookup(struct dfs_tmpfs *tmpfs, const char *path,
+                                        struct tmpfs_node **parent,
+                                        const char **name, rt_size_t *len)
+{
+    struct tmpfs_node *node, *child;
+    const char *end;
+
+    node = &(tmpfs->root);
+    *parent = RT_NULL;
+
+    while (1)
+    {
+        while (*path == '/')
+            path ++;
+        if (*path == '\0')
+            return node;
+
+        for (end = path; *end != '/' && *end != '\0'; end ++);
+
+        if (node->type != TMPFS_TYPE_DIR)
+            return RT_NULL;
+
+        child = _tmpfs_find_child(node, path, end - path);
+        if (child == RT_NULL)
+        {
+            /* the parent is found only if it's the last name in path */
+            while (*end == '/')
+                end ++;
+            if (*end == '\0')
+            {
+                *parent = node;
+                *name = path;
+                *len  = strcspn(path, "/");
+            }
+
+            return RT_NULL;
+        }
+
+        node = child;
+        path = end;
+    }
+}
+
+static void _tmpfs_link(struct tmpfs_node *dir, struct tmpfs_node *node)
+{
+    node->parent = dir;
+    rt_list_insert_after(&(dir->u.buckets[node->hash % DFS_TMPFS_HASH_SIZE]),
+                         &(node->sibling));
+    dir->size ++;
+}
+
+static void _tmpfs_unlink(struct tmpfs_node *node)
+{
+    rt_list_remove(&(node->sibling));
+    node->parent->size --;
+    node->parent = RT_NULL;
+}
+
+static int _tmpfs_set_name(struct tmpfs_node *node, const char *name, rt_size_t len)
+{
+    char *ptr;
+
+    ptr = (char *)rt_malloc(len + 1);
+    if (ptr == RT_NULL)
+        return -ENOMEM;
+
+    memcpy(ptr, name, len);
+    ptr[len] = '\0';
+
+    rt_free(node->name);
+    node->name = ptr;
+    node->hash = _tmpfs_hash(name, len);
+
+    return 0;
+}
+
+static struct tmpfs_node *_tmpfs_node_create(struct tmpfs_node *dir, const char *name,
+                                             rt_size_t len, rt_uint8_t type)
+{
+    struct tmpfs_node *node;
+    int index;
+
+    node = (struct tmpfs_node *)rt_calloc(1, sizeof(struct tmpfs_node));
+    if (node == RT_NULL)
+        return RT_NULL;
+
+    node->type = type;
+    if (_tmpfs_set_name(node, name, len) < 0)
+    {
+        rt_free(node);
+        return RT_NULL;
+    }
+
+    if (type == TMPFS_TYPE_DIR)
+    {
+        node->u.buckets = (rt_list_t *)rt_malloc(sizeof(rt_list_t) * DFS_TMPFS_HASH_SIZE);
+        if (node->u.buckets == RT_NULL)
+        {
+            rt_free(node->name);
+            rt_free(node);
+            return RT_NULL;
+        }
+
+        for (index = 0; index < DFS_TMPFS_HASH_SIZE; index ++)
+            rt_list_init(&(node->u.buckets[index]));
+    }
+
+    _tmpfs_link(dir, node);
+
+    return node;
+}
+
+/* make sure the chunk array can hold the chunks of size */
+static int _tmpfs_file_reserve(struct tmpfs_node *node, rt_size_t size)
+{
+    rt_uint8_t **chunks;
+    rt_size_t nchunks;
+
+    if (TMPFS_CHUNK_NUM(size) <= node->u.file.nchunks)
+        return 0;
+
+    nchunks = node->u.file.nchunks ? node->u.file.nchunks : 4;
+    while (nchunks < TMPFS_CHUNK_NUM(size))
+        nchunks *= 2;
+
+    chunks = (rt_uint8_t **)rt_realloc(node->u.file.chunks, sizeof(rt_uint8_t *) * nchunks);
+    if (chunks == RT_NULL)
+        return -ENOMEM;
+
+    memset(chunks + node->u.file.nchunks, 0,
+           sizeof(rt_uint8_t *) * (nchunks - node->u.file.nchunks));
+    node->u.file.chunks  = chunks;
+    node->u.file.nchunks = nchunks;
+
+    return 0;
+}
+
+static int _tmpfs_file_truncate(struct dfs_tmpfs *tmpfs, struct tmpfs_node *node, rt_size_t size)
+{
+    rt_size_t index, count;
+    rt_uint8_t *chunk;
+
+    if (size > node->size)
+    {
+        /* the extended part is allocated now, so the later writes in it
+         * never fail for the space */
+        if (_tmpfs_file_reserve(node, size) < 0)
+            return -ENOMEM;
+
+        count = 0;
+        for (index = TMPFS_CHUNK_INDEX(node->size); index < TMPFS_CHUNK_NUM(size); index ++)
+        {
+            if (node->u.file.chunks[index] == RT_NULL)
+                count ++;
+        }
+        if (count * DFS_TMPFS_CHUNK_SIZE > tmpfs->size_max - tmpfs->size_used)
+            return -ENOSPC;
+
+        for (index = TMPFS_CHUNK_INDEX(node->size); index < TMPFS_CHUNK_NUM(size); index ++)
+        {
+            if (node->u.file.chunks[index] != RT_NULL)
+                continue;
+
+            chunk = (rt_uint8_t *)rt_malloc(DFS_TMPFS_CHUNK_SIZE);
+            if (chunk == RT_NULL)
+            {
+                /* the chunks beyond the size are the ones allocated here */
+                while (index -- > TMPFS_CHUNK_NUM(node->size))
+                {
+                    rt_free(node->u.file.chunks[index]);
+                    node->u.file.chunks[index] = RT_NULL;
+                    tmpfs->size_used -= DFS_TMPFS_CHUNK_SIZE;
+                }
+                return -ENOMEM;
+            }
+            memset(chunk, 0, DFS_TMPFS_CHUNK_SIZE);
+            node->u.file.chunks[index] = chunk;
+            tmpfs->size_used += DFS_TMPFS_CHUNK_SIZE;
+        }
+        node->size = size;
+
+        return 0;
+    }
+
+    for (index = TMPFS_CHUNK_NUM(size); index < TMPFS_CHUNK_NUM(node->size); index ++)
+    {
+        if (node->u.file.chunks[index] != RT_NULL)
+        {
+            rt_free(node->u.file.chunks[index]);
+            node->u.file.chunks[index] = RT_NULL;
+            tmpfs->size_used -= DFS_TMPFS_CHUNK_SIZE;
+        }
+    }
+
+    /* clear the tail of last chunk, it's read as zero if the file is extended again */
+    if (TMPFS_CHUNK_OFFSET(size))
+    {
+        chunk = node->u.file.chunks[TMPFS_CHUNK_INDEX(size)];
+        if (chunk != RT_NULL)
+            memset(chunk + TMPFS_CHUNK_OFFSET(size), 0,
+                   DFS_TMPFS_CHUNK_SIZE - TMPFS_CHUNK_OFFSET(size));
+    }
+
+    if (size == 0)
+    {
+        rt_free(node->u.file.chunks);
+        node->u.file.chunks  = RT_NULL;
+        node->u.file.nchunks = 0;
+    }
+    node->size = size;
+
+    return 0;
+}
+
+static void _tmpfs_node_free(struct dfs_tmpfs *tmpfs, struct tmpfs_node *node)
+{
+    struct tmpfs_node *child;
+    int index;
+
+    if (node->type == TMPFS_TYPE_DIR)
+    {
+        for (index = 0; index < DFS_TMPFS_HASH_SIZE; index ++)
+        {
+            while (!rt_list_isempty(&(node->u.buckets[index])))
+            {
+                child = rt_list_entry(node->u.buckets[index].next, struct tmpfs_node, sibling);
+                _tmpfs_unlink(child);
+                _tmpfs_node_free(tmpfs, child);
+            }
+        }
+        rt_free(node->u.buckets);
+    }
+    else
+    {
+        _tmpfs_file_truncate(tmpfs, node, 0);
+    }
+
+    rt_free(node->name);
+    if (node != &(tmpfs->root))
+        rt_free(node);
+}
+
+int dfs_tmpfs_mount(struct dfs_filesystem *fs,
+                    unsigned long          rwflag,
+                    const void            *data)
+{
+    struct dfs_tmpfs *tmpfs;
+    int index;
+
+    tmpfs = (struct dfs_tmpfs *)rt_calloc(1, sizeof(struct dfs_tmpfs));
+    if (tmpfs == RT_NULL)
+        return -ENOMEM;
+
+    tmpfs->root.u.buckets = (rt_list_t *)rt_malloc(sizeof(rt_list_t) * DFS_TMPFS_HASH_SIZE);
+    if (tmpfs->root.u.buckets == RT_NULL)
+    {
+        rt_free(tmpfs);
+        return -ENOMEM;
+    }
+    for (index = 0; index < DFS_TMPFS_HASH_SIZE; index ++)
+        rt_list_init(&(tmpfs->root.u.buckets[index]));
+    tmpfs->root.type = TMPFS_TYPE_DIR;
+
+    tmpfs->magic = TMPFS_MAGIC;
+    /* the capacity in bytes can be specified by the data of mount */
+    tmpfs->size_max = data ? *(const rt_size_t *)data : DFS_TMPFS_SIZE_MAX;
+    rt_mutex_init(&(tmpfs->lock), "tmpfs", RT_IPC_FLAG_FIFO);
+
+    fs->data = tmpfs;
+
+    return RT_EOK;
+}
+
+int dfs_tmpfs_unmount(struct dfs_filesystem *fs)
+{
+    struct dfs_tmpfs *tmpfs;
+
+    tmpfs = (struct dfs_tmpfs *)fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+
+    _tmpfs_node_free(tmpfs, &(tmpfs->root));
+    rt_mutex_detach(&(tmpfs->lock));
+    rt_free(tmpfs);
+    fs->data = RT_NULL;
+
+    return RT_EOK;
+}
+
+int dfs_tmpfs_statfs(struct dfs_filesystem *fs, struct statfs *buf)
+{
+    struct dfs_tmpfs *tmpfs;
+
+    tmpfs = (struct dfs_tmpfs *)fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+    RT_ASSERT(buf != RT_NULL);
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    buf->f_bsize  = DFS_TMPFS_CHUNK_SIZE;
+    buf->f_blocks = tmpfs->size_max / DFS_TMPFS_CHUNK_SIZE;
+    buf->f_bfree  = (tmpfs->size_max - tmpfs->size_used) / DFS_TMPFS_CHUNK_SIZE;
+    rt_mutex_release(&(tmpfs->lock));
+
+    return RT_EOK;
+}
+
+int dfs_tmpfs_ioctl(struct dfs_fd *file, int cmd, void *args)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node;
+    int result;
+
+    if (cmd != DFS_FIOFTRUNCATE)
+        return -EIO;
+
+    node  = (struct tmpfs_node *)file->data;
+    tmpfs = (struct dfs_tmpfs *)file->fs->data;
+    if (node->type != TMPFS_TYPE_FILE)
+        return -EISDIR;
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    result = _tmpfs_file_truncate(tmpfs, node, *(off_t *)args);
+    file->size = node->size;
+    rt_mutex_release(&(tmpfs->lock));
+
+    return result;
+}
+
+int dfs_tmpfs_read(struct dfs_fd *file, void *buf, size_t count)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node;
+    rt_uint8_t *chunk;
+    rt_size_t length, offset;
+    size_t index;
+
+    node  = (struct tmpfs_node *)file->data;
+    tmpfs = (struct dfs_tmpfs *)file->fs->data;
+    RT_ASSERT(node != RT_NULL);
+
+    if (node->type != TMPFS_TYPE_FILE)
+        return -EISDIR;
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    if ((rt_size_t)file->pos >= node->size)
+        count = 0;
+    else if (count > node->size - file->pos)
+        count = node->size - file->pos;
+
+    for (index = 0; index < count; index += length)
+    {
+        offset = TMPFS_CHUNK_OFFSET(file->pos);
+        length = DFS_TMPFS_CHUNK_SIZE - offset;
+        if (length > count - index)
+            length = count - index;
+
+        chunk = node->u.file.chunks[TMPFS_CHUNK_INDEX(file->pos)];
+        if (chunk != RT_NULL)
+            memcpy((rt_uint8_t *)buf + index, chunk + offset, length);
+        else
+            memset((rt_uint8_t *)buf + index, 0, length);
+
+        /* update file current position */
+        file->pos += length;
+    }
+    rt_mutex_release(&(tmpfs->lock));
+
+    return count;
+}
+
+int dfs_tmpfs_write(struct dfs_fd *file, const void *buf, size_t count)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node;
+    rt_uint8_t **chunk;
+    rt_size_t length, offset;
+    size_t index;
+    int result = -ENOSPC;
+
+    node  = (struct tmpfs_node *)file->data;
+    tmpfs = (struct dfs_tmpfs *)file->fs->data;
+    RT_ASSERT(node != RT_NULL);
+
+    if (node->type != TMPFS_TYPE_FILE)
+        return -EISDIR;
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    if (file->flags & O_APPEND)
+        file->pos = node->size;
+
+    /* don't grow the chunk array beyond the capacity */
+    if ((rt_size_t)file->pos >= tmpfs->size_max)
+    {
+        rt_mutex_release(&(tmpfs->lock));
+        return count > 0 ? -ENOSPC : 0;
+    }
+    if (count > tmpfs->size_max - file->pos)
+        count = tmpfs->size_max - file->pos;
+
+    if (_tmpfs_file_reserve(node, file->pos + count) < 0)
+    {
+        rt_mutex_release(&(tmpfs->lock));
+        return -ENOMEM;
+    }
+
+    for (index = 0; index < count; index += length)
+    {
+        offset = TMPFS_CHUNK_OFFSET(file->pos);
+        length = DFS_TMPFS_CHUNK_SIZE - offset;
+        if (length > count - index)
+            length = count - index;
+
+        chunk = &(node->u.file.chunks[TMPFS_CHUNK_INDEX(file->pos)]);
+        if (*chunk == RT_NULL)
+        {
+            if (tmpfs->size_used + DFS_TMPFS_CHUNK_SIZE > tmpfs->size_max)
+                break;
+
+            *chunk = (rt_uint8_t *)rt_malloc(DFS_TMPFS_CHUNK_SIZE);
+            if (*chunk == RT_NULL)
+            {
+                result = -ENOMEM;
+                break;
+            }
+            memset(*chunk, 0, DFS_TMPFS_CHUNK_SIZE);
+            tmpfs->size_used += DFS_TMPFS_CHUNK_SIZE;
+        }
+        memcpy(*chunk + offset, (const rt_uint8_t *)buf + index, length);
+
+        /* update file current position */
+        file->pos += length;
+        if ((rt_size_t)file->pos > node->size)
+            node->size = file->pos;
+    }
+    file->size = node->size;
+    rt_mutex_release(&(tmpfs->lock));
+
+    if (index == 0 && count > 0)
+        return result;
+
+    return index;
+}
+
+int dfs_tmpfs_lseek(struct dfs_fd *file, off_t offset)
+{
+    if (offset < 0)
+        return -EINVAL;
+
+    /* it's allowed to seek beyond the end of file, the hole is zero */
+    file->pos = offset;
+
+    return file->pos;
+}
+
+int dfs_tmpfs_close(struct dfs_fd *file)
+{
+    file->data = RT_NULL;
+
+    return RT_EOK;
+}
+
+int dfs_tmpfs_open(struct dfs_fd *file)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node, *parent;
+    const char *name;
+    rt_size_t len;
+    int result = 0;
+
+    tmpfs = (struct dfs_tmpfs *)file->fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    node = _tmpfs_lookup(tmpfs, file->path, &parent, &name, &len);
+    if (node != RT_NULL)
+    {
+        if ((file->flags & O_CREAT) && (file->flags & O_EXCL))
+            result = -EEXIST;
+        else if ((file->flags & O_DIRECTORY) && node->type != TMPFS_TYPE_DIR)
+            result = -ENOTDIR;
+        else if (!(file->flags & O_DIRECTORY) && node->type == TMPFS_TYPE_DIR)
+            result = -EISDIR;
+        else if ((file->flags & O_DIRECTORY) && (file->flags & O_CREAT))
+            result = -EEXIST;
+        else if (file->flags & O_TRUNC)
+            result = _tmpfs_file_truncate(tmpfs, node, 0);
+    }
+    else if (!(file->flags & O_CREAT) || parent == RT_NULL)
+    {
+        result = -ENOENT;
+    }
+    else
+    {
+        node = _tmpfs_node_create(parent, name, len,
+                                  (file->flags & O_DIRECTORY) ? TMPFS_TYPE_DIR : TMPFS_TYPE_FILE);
+        if (node == RT_NULL)
+            result = -ENOMEM;
+    }
+
+    if (result == 0)
+    {
+        file->data = node;
+        file->size = node->size;
+        if (file->flags & O_APPEND)
+            file->pos = file->size;
+        else
+            file->pos = 0;
+    }
+    rt_mutex_release(&(tmpfs->lock));
+
+    return result;
+}
+
+int dfs_tmpfs_stat(struct dfs_filesystem *fs,
+                   const char            *path,
+                   struct stat           *st)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node, *parent;
+    const char *name;
+    rt_size_t len;
+
+    tmpfs = (struct dfs_tmpfs *)fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    node = _tmpfs_lookup(tmpfs, path, &parent, &name, &len);
+    if (node == RT_NULL)
+    {
+        rt_mutex_release(&(tmpfs->lock));
+        return -ENOENT;
+    }
+
+    st->st_dev = 0;
+    st->st_mode = S_IRUSR | S_IRGRP | S_IROTH |
+                  S_IWUSR | S_IWGRP | S_IWOTH;
+    if (node->type == TMPFS_TYPE_DIR)
+    {
+        st->st_mode |= S_IFDIR | S_IXUSR | S_IXGRP | S_IXOTH;
+        st->st_size = 0;
+    }
+    else
+    {
+        st->st_mode |= S_IFREG;
+        st->st_size = node->size;
+    }
+    st->st_mtime = 0;
+    rt_mutex_release(&(tmpfs->lock));
+
+    return RT_EOK;
+}
+
+int dfs_tmpfs_getdents(struct dfs_fd *file,
+                       struct dirent *dirp,
+                       uint32_t    count)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node, *child;
+    rt_list_t *list;
+    rt_size_t index, end;
+    struct dirent *d;
+    int bucket;
+
+    node  = (struct tmpfs_node *)file->data;
+    tmpfs = (struct dfs_tmpfs *)file->fs->data;
+    if (node->type != TMPFS_TYPE_DIR)
+        return -EINVAL;
+
+    /* make integer count */
+    count = (count / sizeof(struct dirent));
+    if (count == 0)
+        return -EINVAL;
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    end = file->pos + count;
+    index = 0;
+    count = 0;
+    for (bucket = 0; bucket < DFS_TMPFS_HASH_SIZE && index < end; bucket ++)
+    {
+        for (list = node->u.buckets[bucket].next;
+             list != &(node->u.buckets[bucket]) && index < end;
+             list = list->next)
+        {
+            if (index >= (rt_size_t)file->pos)
+            {
+                child = rt_list_entry(list, struct tmpfs_node, sibling);
+
+                d = dirp + count;
+                d->d_type = (child->type == TMPFS_TYPE_DIR) ? DT_DIR : DT_REG;
+                d->d_namlen = (rt_uint8_t)rt_strlen(child->name);
+                d->d_reclen = (rt_uint16_t)sizeof(struct dirent);
+                rt_strncpy(d->d_name, child->name, DFS_PATH_MAX);
+
+                count += 1;
+                file->pos += 1;
+            }
+            index += 1;
+        }
+    }
+    rt_mutex_release(&(tmpfs->lock));
+
+    return count * sizeof(struct dirent);
+}
+
+int dfs_tmpfs_unlink(struct dfs_filesystem *fs, const char *path)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node, *parent;
+    const char *name;
+    rt_size_t len;
+    int result = RT_EOK;
+
+    tmpfs = (struct dfs_tmpfs *)fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    node = _tmpfs_lookup(tmpfs, path, &parent, &name, &len);
+    if (node == RT_NULL)
+        result = -ENOENT;
+    else if (node == &(tmpfs->root))
+        result = -EBUSY;
+    else if (node->type == TMPFS_TYPE_DIR && node->size > 0)
+        result = -ENOTEMPTY;
+    else
+    {
+        _tmpfs_unlink(node);
+        _tmpfs_node_free(tmpfs, node);
+    }
+    rt_mutex_release(&(tmpfs->lock));
+
+    return result;
+}
+
+int dfs_tmpfs_rename(struct dfs_filesystem *fs,
+                     const char            *oldpath,
+                     const char            *newpath)
+{
+    struct dfs_tmpfs *tmpfs;
+    struct tmpfs_node *node, *parent, *dir;
+    const char *name;
+    rt_size_t len;
+    int result = RT_EOK;
+
+    tmpfs = (struct dfs_tmpfs *)fs->data;
+    RT_ASSERT(tmpfs != RT_NULL);
+
+    rt_mutex_take(&(tmpfs->lock), RT_WAITING_FOREVER);
+    node = _tmpfs_lookup(tmpfs, oldpath, &parent, &name, &len);
+    if (node == RT_NULL)
+    {
+        result = -ENOENT;
+        goto __exit;
+    }
+    if (node == &(tmpfs->root))
+    {
+        result = -EBUSY;
+        goto __exit;
+    }
+
+    if (_tmpfs_lookup(tmpfs, newpath, &parent, &name, &len) != RT_NULL)
+    {
+        result = -EEXIST;
+        goto __exit;
+    }
+    if (parent == RT_NULL)
+    {
+        result = -ENOENT;
+        goto __exit;
+    }
+
+    /* a directory can't be moved into itself */
+    for (dir = parent; dir != RT_NULL; dir = dir->parent)
+    {
+        if (dir == node)
+        {
+            result = -EINVAL;
+            goto __exit;
+        }
+    }
+
+    result = _tmpfs_set_name(node, name, len);
+    if (result == 0)
+    {
+        _tmpfs_unlink(node);
+        _tmpfs_link(parent, node);
+    }
+
+__exit:
+    rt_mutex_release(&(tmpfs->lock));
+
+    return result;
+}
+
+static const struct dfs_file_ops _tmp_fops =
+{
+    dfs_tmpfs_open,
+    dfs_tmpfs_close,
+    dfs_tmpfs_ioctl,
+    dfs_tmpfs_read,
+    dfs_tmpfs_write,
+    NULL, /* flush */
+    dfs_tmpfs_lseek,
+    dfs_tmpfs_getdents,
+};
+
+static const struct dfs_filesystem_ops _tmpfs =
+{
+    "tmp",
+    DFS_FS_FLAG_DEFAULT,
+    &_tmp_fops,
+
+    dfs_tmpfs_mount,
+    dfs_tmpfs_unmount,
+    NULL, /* mkfs */
+    dfs_tmpfs_statfs,
+
+    dfs_tmpfs_unlink,
+    dfs_tmpfs_stat,
+    dfs_tmpfs_rename,
+};
+
+int dfs_tmpfs_init(void)
+{
+    /* register tmp file system */
+    dfs_register(&_tmpfs);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(dfs_tmpfs_init);
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+#ifndef __DFS_TMPFS_H__
+#define __DFS_TMPFS_H__
+
+#include <rtthread.h>
+#include <rtservice.h>
+
+#ifndef DFS_TMPFS_CHUNK_SIZE
+#define DFS_TMPFS_CHUNK_SIZE    512
+#endif
+
+#ifndef DFS_TMPFS_HASH_SIZE
+#define DFS_TMPFS_HASH_SIZE     8
+#endif
+
+#ifndef DFS_TMPFS_SIZE_MAX
+#define DFS_TMPFS_SIZE_MAX      (64 * 1024)
+#endif
+
+#define TMPFS_MAGIC             0x0B0B0B0B
+
+#define TMPFS_TYPE_FILE         0x00
+#define TMPFS_TYPE_DIR          0x01
+
+/**
+ * The node of file or directory. A directory keeps its children in hash
+ * buckets, a file keeps its content in chunks, the chunk which is never
+ * written is NULL and read as zero.
+ */
+struct tmpfs_node
+{
+    rt_list_t sibling;                  /* node in the bucket of parent */
+    struct tmpfs_node *parent;
+
+    rt_uint32_t hash;                   /* hash value of name */
+    rt_uint8_t type;                    /* file or directory */
+    char *name;
+
+    rt_size_t size;                     /* file size or number of children */
+    union
+    {
+        rt_list_t *buckets;             /* children of directory */
+        struct
+        {
+            rt_uint8_t **chunks;        /* content of file */
+            rt_size_t nchunks;          /* size of chunk array */
+        } file;
+    } u;
+};
+
+/**
+ * DFS tmpfs object
+ */
+struct dfs_tmpfs
+{
+    rt_uint32_t magic;
+    struct rt_mutex lock;
+
+    rt_size_t size_max;                 /* capacity in bytes */
+    rt_size_t size_used;                /* bytes used by chunks */
+
+    struct tmpfs_node root;
+};
+
+int dfs_tmpfs_init(void);
+
+#endif
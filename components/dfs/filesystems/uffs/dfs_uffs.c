@@ -9,6 +9,7 @@
  * 2012-03-28     prife        use mtd device interface
  * 2012-04-05     prife        update uffs with official repo and use uffs_UnMount/Mount
  * 2017-04-12     lizhen9880   fix the f_bsize and f_blocks issue in function dfs_uffs_statfs
+ * 2026-10-19     agent        flush dirty buffers and check erased blocks in MTD Nand service
  */
 
 #include <rtthread.h>
@@ -23,6 +24,8 @@
 #include "uffs/uffs_mtb.h"
 #include "uffs/uffs_mem.h"
 #include "uffs/uffs_utils.h"
+#include "uffs/uffs_buf.h"
+#include "uffs/uffs_flash.h"
 
 /*
  * RT-Thread DFS Interface for uffs
@@ -140,6 +143,57 @@ static int init_uffs_fs(
     return uffs_Mount(nand_part->mount_path) == U_SUCC ? 0 : -1;
 }
 
+#ifdef RT_MTD_NAND_USING_SERVICE
+/*
+ * The garbage collection in the service thread of MTD Nand. It flushes the
+ * most dirty buffer group, or checks a block in erased list which is checked
+ * before used, so the writer does less work on flash.
+ */
+static rt_err_t _uffs_nand_gc(struct rt_mtd_nand_device *nand, void *param)
+{
+    uffs_Device *dev = (uffs_Device *)param;
+    TreeNode *node;
+    rt_err_t result = -RT_EEMPTY;
+    int slot;
+
+    uffs_GlobalFsLockLock();
+    uffs_DeviceLock(dev);
+
+    for (slot = 0; slot < dev->cfg.dirty_groups; slot++)
+    {
+        if (dev->buf.dirtyGroup[slot].dirty && dev->buf.dirtyGroup[slot].lock == 0)
+            break;
+    }
+
+    if (slot < dev->cfg.dirty_groups)
+    {
+        if (uffs_BufFlushMostDirtyGroup(dev) == U_SUCC)
+            result = RT_EOK;
+    }
+    else
+    {
+        for (node = dev->tree.erased; node; node = node->u.list.next)
+        {
+            if (node->u.list.u.need_check)
+                break;
+        }
+
+        if (node)
+        {
+            if (uffs_FlashCheckErasedBlock(dev, node->u.list.block) != U_SUCC)
+                uffs_FlashEraseBlock(dev, node->u.list.block);
+            node->u.list.u.need_check = 0;
+            result = RT_EOK;
+        }
+    }
+
+    uffs_DeviceUnLock(dev);
+    uffs_GlobalFsLockUnlock();
+
+    return result;
+}
+#endif
+
 static int dfs_uffs_mount(
     struct dfs_filesystem *fs,
     unsigned long rwflag,
@@ -181,6 +235,12 @@ static int dfs_uffs_mount(
     {
         return uffs_result_to_dfs(uffs_get_error());
     }
+
+#ifdef RT_MTD_NAND_USING_SERVICE
+    /*4. do garbage collection in the slack time of device */
+    if (dev->service)
+        rt_mtd_nand_set_gc(dev, _uffs_nand_gc, mount_part->dev, RT_TICK_PER_SECOND);
+#endif
     return 0;
 }
 
@@ -195,6 +255,10 @@ static int dfs_uffs_unmount(struct dfs_filesystem *fs)
         if (nand_part[index].dev == RT_MTD_NAND_DEVICE(fs->dev_id))
         {
             nand_part[index].dev = RT_NULL;
+#ifdef RT_MTD_NAND_USING_SERVICE
+            if (RT_MTD_NAND_DEVICE(fs->dev_id)->service)
+                rt_mtd_nand_set_gc(RT_MTD_NAND_DEVICE(fs->dev_id), RT_NULL, RT_NULL, RT_WAITING_FOREVER);
+#endif
             result = uffs_UnMount(nand_part[index].mount_path);
             if (result != U_SUCC)
                 break;
@@ -226,8 +290,12 @@ static int dfs_uffs_mkfs(rt_device_t dev_id)
     }
 
     /*2. then unmount the partition */
-    uffs_UnMount(nand_part[index].mount_path);
     mtd = nand_part[index].dev;
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (mtd->service)
+        rt_mtd_nand_set_gc(mtd, RT_NULL, RT_NULL, RT_WAITING_FOREVER);
+#endif
+    uffs_UnMount(nand_part[index].mount_path);
 
     /*3. erase all blocks on the partition */
     block = mtd->block_start;
@@ -248,6 +316,10 @@ static int dfs_uffs_mkfs(rt_device_t dev_id)
     {
         return uffs_result_to_dfs(uffs_get_error());
     }
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (mtd->service)
+        rt_mtd_nand_set_gc(mtd, _uffs_nand_gc, &nand_part[index].uffs_dev, RT_TICK_PER_SECOND);
+#endif
     return RT_EOK;
 }
 
@@ -85,6 +85,7 @@ struct dfs_fdtable
 {
     uint32_t maxfd;
     struct dfs_fd **fds;
+    uint32_t *bitmap;         /* bitmap of the used fd entries, follows fds in memory */
 };
 
 /* Initialization of dfs */
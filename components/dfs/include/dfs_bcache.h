@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+#ifndef DFS_BCACHE_H__
+#define DFS_BCACHE_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* statistics of block cache on a device, in unit of sector */
+struct dfs_bcache_stat
+{
+    rt_uint32_t read_hit;                   /* sectors read from cache */
+    rt_uint32_t read_miss;                  /* sectors read from device */
+    rt_uint32_t read_ahead;                 /* sectors read ahead */
+    rt_uint32_t write_cached;               /* sectors written to cache */
+    rt_uint32_t write_through;              /* sectors written to device directly */
+    rt_uint32_t write_back;                 /* dirty sectors written back */
+    rt_uint32_t dev_read;                   /* read transfers of device */
+    rt_uint32_t dev_write;                  /* write transfers of device */
+};
+
+int dfs_bcache_init(void);
+
+int dfs_bcache_attach(rt_device_t dev);
+int dfs_bcache_detach(rt_device_t dev);
+
+rt_size_t dfs_bcache_read(rt_device_t dev, rt_off_t sector, void *buffer, rt_size_t count);
+rt_size_t dfs_bcache_write(rt_device_t dev, rt_off_t sector, const void *buffer, rt_size_t count);
+int dfs_bcache_sync(rt_device_t dev);
+
+int dfs_bcache_get_stat(rt_device_t dev, struct dfs_bcache_stat *stat);
+void dfs_bcache_reset_stat(void);
+void dfs_bcache_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+#ifndef DFS_DENTRY_H__
+#define DFS_DENTRY_H__
+
+#include <dfs_fs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the result of dentry lookup */
+#define DFS_DENTRY_MISS         (-1)    /* not cached */
+#define DFS_DENTRY_NEGATIVE     0       /* cached as non-existent */
+#define DFS_DENTRY_POSITIVE     1       /* cached as existent */
+
+/* statistics of path lookup cache */
+struct dfs_dentry_stat
+{
+    rt_uint32_t mount_hit;              /* mount point found in cache */
+    rt_uint32_t mount_miss;             /* mount table scanned */
+    rt_uint32_t node_hit;               /* file system node found in cache */
+    rt_uint32_t negative_hit;           /* non-existent path found in cache */
+    rt_uint32_t node_miss;              /* file system lookup done */
+    rt_uint32_t replace;                /* entries replaced */
+};
+
+int dfs_dentry_init(void);
+
+/* used by DFS with the normalized full path */
+struct dfs_filesystem *dfs_dentry_lookup_fs(const char *fullpath);
+void dfs_dentry_insert_fs(const char *fullpath, struct dfs_filesystem *fs);
+void dfs_dentry_invalidate(const char *fullpath);
+void dfs_dentry_invalidate_fs(struct dfs_filesystem *fs);
+
+/* used by file systems with the path in file system */
+int  dfs_dentry_lookup(struct dfs_filesystem *fs, const char *path, void **node);
+void dfs_dentry_insert(struct dfs_filesystem *fs, const char *path, void *node);
+void dfs_dentry_insert_negative(struct dfs_filesystem *fs, const char *path);
+void dfs_dentry_remove(struct dfs_filesystem *fs, const char *path);
+
+void dfs_dentry_get_stat(struct dfs_dentry_stat *stat);
+void dfs_dentry_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2005-01-26     Bernard      The first version.
+ * 2026-10-19     agent        Add mmap file operation.
+ * 2026-10-19     agent        Add readv/writev file operations.
+ * 2026-10-19     agent        Add ftruncate through ioctl.
  */
 
 #ifndef __DFS_FILE_H__
@@ -20,6 +23,12 @@ extern "C" {
 
 struct rt_pollreq;
 
+/* flags of mmap file operation */
+#define DFS_MMAP_WRITE   0x01    /* the mapping is writable and shared with file */
+
+/* ioctl command to truncate file, the argument is the pointer of new size (off_t) */
+#define DFS_FIOFTRUNCATE 0x52540000
+
 struct dfs_file_ops
 {
     int (*open)     (struct dfs_fd *fd);
@@ -32,6 +41,9 @@ struct dfs_file_ops
     int (*getdents) (struct dfs_fd *fd, struct dirent *dirp, uint32_t count);
 
     int (*poll)     (struct dfs_fd *fd, struct rt_pollreq *req);
+    int (*mmap)     (struct dfs_fd *fd, off_t offset, size_t length, int flags, void **addr);
+    int (*readv)    (struct dfs_fd *fd, const struct iovec *iov, int iovcnt);
+    int (*writev)   (struct dfs_fd *fd, const struct iovec *iov, int iovcnt);
 };
 
 /* file descriptor */
@@ -43,6 +55,7 @@ struct dfs_fd
 
     char *path;                  /* Name (below mount point) */
     int ref_count;               /* Descriptor reference count */
+    int idx;                     /* Index in the fd table */
 
     struct dfs_filesystem *fs;
     const struct dfs_file_ops *fops;
@@ -63,6 +76,12 @@ int dfs_file_unlink(const char *path);
 int dfs_file_write(struct dfs_fd *fd, const void *buf, size_t len);
 int dfs_file_flush(struct dfs_fd *fd);
 int dfs_file_lseek(struct dfs_fd *fd, off_t offset);
+int dfs_file_ftruncate(struct dfs_fd *fd, off_t length);
+int dfs_file_mmap(struct dfs_fd *fd, off_t offset, size_t length, int flags, void **addr);
+int dfs_file_readv(struct dfs_fd *fd, const struct iovec *iov, int iovcnt);
+int dfs_file_writev(struct dfs_fd *fd, const struct iovec *iov, int iovcnt);
+int dfs_file_preadv(struct dfs_fd *fd, const struct iovec *iov, int iovcnt, off_t offset);
+int dfs_file_pwritev(struct dfs_fd *fd, const struct iovec *iov, int iovcnt, off_t offset);
 
 int dfs_file_stat(const char *path, struct stat *buf);
 int dfs_file_rename(const char *oldpath, const char *newpath);
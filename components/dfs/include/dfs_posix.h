@@ -10,6 +10,8 @@
  * 2011-05-16     Yi.qiu       Change parameter name of rename, "new" is C++ key word.
  * 2017-12-27     Bernard      Add fcntl API.
  * 2018-02-07     Bernard      Change the 3rd parameter of open/fcntl/ioctl to '...'
+ * 2026-10-19     agent        Add readv/writev/preadv/pwritev API.
+ * 2026-10-19     agent        Add ftruncate API.
  */
 
 #ifndef __DFS_POSIX_H__
@@ -49,6 +51,10 @@ _READ_WRITE_RETURN_TYPE _EXFUN(write, (int __fd, const void *__buf, size_t __nby
 int read(int fd, void *buf, size_t len);
 int write(int fd, const void *buf, size_t len);
 #endif
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+ssize_t preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+ssize_t pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset);
 
 off_t lseek(int fd, off_t offset, int whence);
 int rename(const char *from, const char *to);
@@ -56,6 +62,7 @@ int unlink(const char *pathname);
 int stat(const char *file, struct stat *buf);
 int fstat(int fildes, struct stat *buf);
 int fsync(int fildes);
+int ftruncate(int fd, off_t length);
 int fcntl(int fildes, int cmd, ...);
 int ioctl(int fildes, int cmd, ...);
 
@@ -8,8 +8,10 @@
  * 2005-02-22     Bernard      The first version.
  * 2017-12-11     Bernard      Use rt_free to instead of free in fd_is_open().
  * 2018-03-20     Heyuanjie    dynamic allocation FD
+ * 2026-10-19     agent        allocate fd by bitmap and lookup fd without lock
  */
 
+#include <rthw.h>
 #include <dfs.h>
 #include <dfs_fs.h>
 #include <dfs_file.h>
@@ -34,7 +36,6 @@ char working_directory[DFS_PATH_MAX] = {"/"};
 #endif
 
 static struct dfs_fdtable _fdtab;
-static int  fd_alloc(struct dfs_fdtable *fdt, int startfd);
 
 /**
  * @addtogroup DFS
@@ -118,52 +119,115 @@ void dfs_unlock(void)
     rt_mutex_release(&fslock);
 }
 
-static int fd_alloc(struct dfs_fdtable *fdt, int startfd)
+/* the number of bitmap words for the fd table */
+#define FDT_BITMAP_WORDS(maxfd)     (((maxfd) + 31) / 32)
+
+/*
+ * The fd table is changed with interrupt disabled, so the lookup of fd doesn't
+ * take the filesystem lock. The filesystem lock only serializes the expanding
+ * of table.
+ */
+
+/* find an empty fd entry in bitmap and mark it used, it's called with interrupt disabled */
+static int fd_alloc(struct dfs_fdtable *fdt)
 {
-    int idx;
+    int word, bit, idx;
 
-    /* find an empty fd entry */
-    for (idx = startfd; idx < (int)fdt->maxfd; idx++)
+    for (word = 0; word < FDT_BITMAP_WORDS(fdt->maxfd); word ++)
     {
-        if (fdt->fds[idx] == RT_NULL)
-            break;
-        if (fdt->fds[idx]->ref_count == 0)
+        if (fdt->bitmap[word] == 0xffffffff)
+            continue;
+
+        bit = __rt_ffs(~fdt->bitmap[word]) - 1;
+        idx = word * 32 + bit;
+        if (idx >= (int)fdt->maxfd)
             break;
+
+        fdt->bitmap[word] |= 1ul << bit;
+        return idx;
     }
 
-    /* allocate a larger FD container */
-    if (idx == fdt->maxfd && fdt->maxfd < DFS_FD_MAX)
-    {
-        int cnt, index;
-        struct dfs_fd **fds;
+    return -1;
+}
 
-        /* increase the number of FD with 4 step length */
-        cnt = fdt->maxfd + 4;
-        cnt = cnt > DFS_FD_MAX ? DFS_FD_MAX : cnt;
+/* release the fd entry, it's called with interrupt disabled */
+rt_inline void fd_release(struct dfs_fdtable *fdt, int idx)
+{
+    fdt->fds[idx] = RT_NULL;
+    fdt->bitmap[idx / 32] &= ~(1ul << (idx % 32));
+}
 
-        fds = (struct dfs_fd **)rt_realloc(fdt->fds, cnt * sizeof(struct dfs_fd *));
-        if (fds == NULL) goto __exit; /* return fdt->maxfd */
+/* double the size of fd table, the fd entries and bitmap are in one memory block */
+static int fd_expand(struct dfs_fdtable *fdt, uint32_t maxfd)
+{
+    struct dfs_fd **fds, **old_fds;
+    uint32_t *bitmap;
+    rt_base_t level;
+    int cnt, result = 0;
 
-        /* clean the new allocated fds */
-        for (index = fdt->maxfd; index < cnt; index ++)
-        {
-            fds[index] = NULL;
-        }
+    dfs_lock();
+
+    /* it has been expanded by other thread */
+    if (fdt->maxfd != maxfd)
+        goto __exit;
+
+    if (maxfd >= DFS_FD_MAX)
+    {
+        result = -1;
+        goto __exit;
+    }
+
+    cnt = maxfd ? maxfd * 2 : 4;
+    cnt = cnt > DFS_FD_MAX ? DFS_FD_MAX : cnt;
 
-        fdt->fds   = fds;
-        fdt->maxfd = cnt;
+    fds = (struct dfs_fd **)rt_calloc(1, cnt * sizeof(struct dfs_fd *) +
+                                      FDT_BITMAP_WORDS(cnt) * sizeof(uint32_t));
+    if (fds == RT_NULL)
+    {
+        result = -1;
+        goto __exit;
     }
+    bitmap = (uint32_t *)(fds + cnt);
 
-    /* allocate  'struct dfs_fd' */
-    if (idx < (int)fdt->maxfd && fdt->fds[idx] == RT_NULL)
+    level = rt_hw_interrupt_disable();
+    old_fds = fdt->fds;
+    if (maxfd > 0)
     {
-        fdt->fds[idx] = (struct dfs_fd *)rt_calloc(1, sizeof(struct dfs_fd));
-        if (fdt->fds[idx] == RT_NULL)
-            idx = fdt->maxfd;
+        memcpy(fds, old_fds, maxfd * sizeof(struct dfs_fd *));
+        memcpy(bitmap, fdt->bitmap, FDT_BITMAP_WORDS(maxfd) * sizeof(uint32_t));
     }
+    fdt->fds    = fds;
+    fdt->bitmap = bitmap;
+    fdt->maxfd  = cnt;
+    rt_hw_interrupt_enable(level);
+
+    rt_free(old_fds);
 
 __exit:
-    return idx;
+    dfs_unlock();
+    return result;
+}
+
+/* get the fd entry with a reference, or NULL if it's empty or being closed */
+static struct dfs_fd *fd_ref(struct dfs_fdtable *fdt, int idx)
+{
+    struct dfs_fd *d = RT_NULL;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (idx < (int)fdt->maxfd)
+    {
+        d = fdt->fds[idx];
+
+        /* check dfs_fd valid or not */
+        if (d != RT_NULL && d->magic == DFS_FD_MAGIC)
+            d->ref_count ++;
+        else
+            d = RT_NULL;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return d;
 }
 
 /**
@@ -175,30 +239,46 @@ __exit:
 int fd_new(void)
 {
     struct dfs_fd *d;
-    int idx;
     struct dfs_fdtable *fdt;
+    rt_base_t level;
+    uint32_t maxfd;
+    int idx;
 
     fdt = dfs_fdtable_get();
-    /* lock filesystem */
-    dfs_lock();
 
-    /* find an empty fd entry */
-    idx = fd_alloc(fdt, 0);
-
-    /* can't find an empty fd entry */
-    if (idx == fdt->maxfd)
+    d = (struct dfs_fd *)rt_calloc(1, sizeof(struct dfs_fd));
+    if (d == RT_NULL)
     {
-        idx = -(1 + DFS_FD_OFFSET);
-        LOG_E("DFS fd new is failed! Could not found an empty fd entry.");
-        goto __result;
+        LOG_E("DFS fd new is failed! No memory for fd.");
+        return -1;
     }
-
-    d = fdt->fds[idx];
     d->ref_count = 1;
     d->magic = DFS_FD_MAGIC;
 
-__result:
-    dfs_unlock();
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        idx = fd_alloc(fdt);
+        if (idx >= 0)
+        {
+            d->idx = idx;
+            fdt->fds[idx] = d;
+        }
+        maxfd = fdt->maxfd;
+        rt_hw_interrupt_enable(level);
+
+        if (idx >= 0)
+            break;
+
+        /* can't find an empty fd entry */
+        if (fd_expand(fdt, maxfd) != 0)
+        {
+            rt_free(d);
+            LOG_E("DFS fd new is failed! Could not found an empty fd entry.");
+            return -1;
+        }
+    }
+
     return idx + DFS_FD_OFFSET;
 }
 
@@ -213,34 +293,16 @@ __result:
  */
 struct dfs_fd *fd_get(int fd)
 {
-    struct dfs_fd *d;
-    struct dfs_fdtable *fdt;
-
 #if defined(RT_USING_DFS_DEVFS) && defined(RT_USING_POSIX)
     if ((0 <= fd) && (fd <= 2))
         fd = libc_stdio_get_console();
 #endif
 
-    fdt = dfs_fdtable_get();
     fd = fd - DFS_FD_OFFSET;
-    if (fd < 0 || fd >= (int)fdt->maxfd)
+    if (fd < 0)
         return NULL;
 
-    dfs_lock();
-    d = fdt->fds[fd];
-
-    /* check dfs_fd valid or not */
-    if ((d == NULL) || (d->magic != DFS_FD_MAGIC))
-    {
-        dfs_unlock();
-        return NULL;
-    }
-
-    /* increase the reference count */
-    d->ref_count ++;
-    dfs_unlock();
-
-    return d;
+    return fd_ref(dfs_fdtable_get(), fd);
 }
 
 /**
@@ -250,30 +312,31 @@ struct dfs_fd *fd_get(int fd)
  */
 void fd_put(struct dfs_fd *fd)
 {
+    rt_base_t level;
+
     RT_ASSERT(fd != NULL);
 
-    dfs_lock();
+    level = rt_hw_interrupt_disable();
 
     fd->ref_count --;
 
     /* clear this fd entry */
     if (fd->ref_count == 0)
     {
-        int index;
         struct dfs_fdtable *fdt;
 
+        /* the entry is found by the index saved in fd_new, the table only
+         * grows, so the index is kept */
         fdt = dfs_fdtable_get();
-        for (index = 0; index < (int)fdt->maxfd; index ++)
-        {
-            if (fdt->fds[index] == fd)
-            {
-                rt_free(fd);
-                fdt->fds[index] = 0;
-                break;
-            }
-        }
+        if (fd->idx < (int)fdt->maxfd && fdt->fds[fd->idx] == fd)
+            fd_release(fdt, fd->idx);
+        fd->magic = 0;
+        rt_hw_interrupt_enable(level);
+
+        rt_free(fd);
+        return;
     }
-    dfs_unlock();
+    rt_hw_interrupt_enable(level);
 }
 
 /**
@@ -292,6 +355,7 @@ int fd_is_open(const char *pathname)
     struct dfs_filesystem *fs;
     struct dfs_fd *fd;
     struct dfs_fdtable *fdt;
+    int result = -1;
 
     fdt = dfs_fdtable_get();
     fullpath = dfs_normalize_path(NULL, pathname);
@@ -313,28 +377,25 @@ int fd_is_open(const char *pathname)
         else
             mountpath = fullpath + strlen(fs->path);
 
-        dfs_lock();
-
-        for (index = 0; index < fdt->maxfd; index++)
+        for (index = 0; index < fdt->maxfd && result != 0; index++)
         {
-            fd = fdt->fds[index];
-            if (fd == NULL || fd->fops == NULL || fd->path == NULL) continue;
+            /* hold the entry, it may be closed by other thread */
+            fd = fd_ref(fdt, index);
+            if (fd == NULL)
+                continue;
 
-            if (fd->fs == fs && strcmp(fd->path, mountpath) == 0)
-            {
-                /* found file in file descriptor table */
-                rt_free(fullpath);
-                dfs_unlock();
+            /* found file in file descriptor table */
+            if (fd->fops != NULL && fd->path != NULL &&
+                fd->fs == fs && strcmp(fd->path, mountpath) == 0)
+                result = 0;
 
-                return 0;
-            }
+            fd_put(fd);
         }
-        dfs_unlock();
 
         rt_free(fullpath);
     }
 
-    return -1;
+    return result;
 }
 
 /**
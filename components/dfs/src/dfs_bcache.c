@@ -0,0 +1,762 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        keep the blocks failed to write back dirty
+ * 2026-10-19     agent        pack the sectors staged by the sector size of device
+ */
+
+/*
+ * Block cache between file systems and block devices.
+ *
+ * The sectors are cached in a pool of blocks shared by all of the attached
+ * devices. The blocks are looked up by hash and replaced in LRU order. The
+ * sequential reading is detected and the following sectors are read ahead in
+ * one device transfer. The writing is delayed, the dirty sectors are written
+ * back in contiguous runs by the flusher thread, on sync or on replacement.
+ */
+
+#include <dfs.h>
+#include <dfs_bcache.h>
+
+#define DBG_TAG    "DFS.bcache"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+#ifndef DFS_BCACHE_BLOCKS
+#define DFS_BCACHE_BLOCKS               16
+#endif
+
+#ifndef DFS_BCACHE_SECTOR_SIZE
+#define DFS_BCACHE_SECTOR_SIZE          SECTOR_SIZE
+#endif
+
+#ifndef DFS_BCACHE_READ_AHEAD
+#define DFS_BCACHE_READ_AHEAD           4
+#endif
+
+#ifndef DFS_BCACHE_FLUSH_PERIOD
+#define DFS_BCACHE_FLUSH_PERIOD         1000
+#endif
+
+#ifndef DFS_BCACHE_THREAD_STACK_SIZE
+#define DFS_BCACHE_THREAD_STACK_SIZE    1024
+#endif
+
+#if !defined(DFS_BCACHE_THREAD_PRIORITY) || DFS_BCACHE_THREAD_PRIORITY >= RT_THREAD_PRIORITY_MAX
+#undef  DFS_BCACHE_THREAD_PRIORITY
+#define DFS_BCACHE_THREAD_PRIORITY      (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+#define DFS_BCACHE_HASH_SIZE            16
+
+/* the transfers larger than read ahead window bypass the cache */
+#define DFS_BCACHE_BYPASS_COUNT         DFS_BCACHE_READ_AHEAD
+
+struct dfs_bcache_dev
+{
+    rt_list_t   list;                       /* node of device list */
+    rt_device_t dev;
+
+    rt_uint32_t sector_count;
+    rt_uint32_t sector_size;
+    rt_uint32_t next_sector;                /* the sector follows the last read */
+
+    struct dfs_bcache_stat stat;
+};
+
+struct dfs_bcache_block
+{
+    rt_list_t   lru;                        /* node of LRU list, the recent one is at head */
+    rt_list_t   hash;                       /* node of hash list */
+
+    struct dfs_bcache_dev *cdev;            /* RT_NULL if the block is free */
+    rt_uint32_t sector;
+    rt_uint32_t dirty;
+
+    rt_uint8_t *data;
+};
+
+static struct rt_mutex bcache_lock;
+static rt_list_t bcache_dev_list;
+static rt_list_t bcache_lru;
+static rt_list_t bcache_hash[DFS_BCACHE_HASH_SIZE];
+static rt_uint32_t bcache_dirty;
+
+static struct dfs_bcache_block bcache_block[DFS_BCACHE_BLOCKS];
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t bcache_data[DFS_BCACHE_BLOCKS][DFS_BCACHE_SECTOR_SIZE];
+/* the buffer of multi-sector transfer, packed by the sector size of device */
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t bcache_stage[DFS_BCACHE_READ_AHEAD * DFS_BCACHE_SECTOR_SIZE];
+
+static struct rt_thread bcache_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t bcache_thread_stack[DFS_BCACHE_THREAD_STACK_SIZE];
+
+rt_inline rt_list_t *_bcache_bucket(struct dfs_bcache_dev *cdev, rt_uint32_t sector)
+{
+    return &bcache_hash[(sector ^ ((rt_ubase_t)cdev >> 4)) % DFS_BCACHE_HASH_SIZE];
+}
+
+static struct dfs_bcache_dev *_bcache_find_dev(rt_device_t dev)
+{
+    rt_list_t *node;
+    struct dfs_bcache_dev *cdev;
+
+    for (node = bcache_dev_list.next; node != &bcache_dev_list; node = node->next)
+    {
+        cdev = rt_list_entry(node, struct dfs_bcache_dev, list);
+        if (cdev->dev == dev)
+            return cdev;
+    }
+
+    return RT_NULL;
+}
+
+static struct dfs_bcache_block *_bcache_lookup(struct dfs_bcache_dev *cdev, rt_uint32_t sector)
+{
+    rt_list_t *bucket, *node;
+    struct dfs_bcache_block *block;
+
+    bucket = _bcache_bucket(cdev, sector);
+    for (node = bucket->next; node != bucket; node = node->next)
+    {
+        block = rt_list_entry(node, struct dfs_bcache_block, hash);
+        if (block->cdev == cdev && block->sector == sector)
+            return block;
+    }
+
+    return RT_NULL;
+}
+
+rt_inline void _bcache_touch(struct dfs_bcache_block *block)
+{
+    rt_list_remove(&block->lru);
+    rt_list_insert_after(&bcache_lru, &block->lru);
+}
+
+rt_inline void _bcache_set_dirty(struct dfs_bcache_block *block, rt_uint32_t dirty)
+{
+    if (block->dirty != dirty)
+    {
+        block->dirty = dirty;
+        if (dirty) bcache_dirty ++;
+        else bcache_dirty --;
+    }
+}
+
+/* write back a dirty block, together with the dirty blocks following it */
+static int _bcache_flush_run(struct dfs_bcache_block *block, rt_bool_t single)
+{
+    struct dfs_bcache_dev *cdev = block->cdev;
+    struct dfs_bcache_block *run[DFS_BCACHE_READ_AHEAD];
+    struct dfs_bcache_block *prev;
+    rt_size_t count, index;
+    const void *buffer;
+
+    /* start from the first dirty block of the run */
+    while (!single && block->sector > 0)
+    {
+        prev = _bcache_lookup(cdev, block->sector - 1);
+        if (prev == RT_NULL || !prev->dirty)
+            break;
+        block = prev;
+    }
+
+    run[0] = block;
+    count = 1;
+    while (!single && count < DFS_BCACHE_READ_AHEAD)
+    {
+        run[count] = _bcache_lookup(cdev, block->sector + count);
+        if (run[count] == RT_NULL || !run[count]->dirty)
+            break;
+        count ++;
+    }
+
+    if (count == 1)
+    {
+        buffer = block->data;
+    }
+    else
+    {
+        for (index = 0; index < count; index ++)
+            rt_memcpy(bcache_stage + index * cdev->sector_size, run[index]->data,
+                      cdev->sector_size);
+        buffer = bcache_stage;
+    }
+
+    cdev->stat.dev_write ++;
+    if (rt_device_write(cdev->dev, block->sector, buffer, count) != count)
+    {
+        LOG_E("write back sector %d of %s failed", block->sector, cdev->dev->parent.name);
+        return -EIO;
+    }
+
+    cdev->stat.write_back += count;
+    for (index = 0; index < count; index ++)
+        _bcache_set_dirty(run[index], 0);
+
+    return 0;
+}
+
+/*
+ * take the least recently used block for a sector. The dirty block failed to
+ * be written back is kept dirty and the next one is tried, RT_NULL is
+ * returned if none of the blocks could be reused.
+ */
+static struct dfs_bcache_block *_bcache_alloc(struct dfs_bcache_dev *cdev, rt_uint32_t sector)
+{
+    struct dfs_bcache_block *block;
+    rt_list_t *node;
+
+    for (node = bcache_lru.prev; node != &bcache_lru; node = node->prev)
+    {
+        block = rt_list_entry(node, struct dfs_bcache_block, lru);
+
+        /* the staging buffer may be in use, write back this block only */
+        if (!block->dirty || _bcache_flush_run(block, RT_TRUE) == 0)
+            break;
+    }
+    if (node == &bcache_lru)
+        return RT_NULL;
+
+    rt_list_remove(&block->hash);
+    block->cdev   = cdev;
+    block->sector = sector;
+    rt_list_insert_after(_bcache_bucket(cdev, sector), &block->hash);
+    _bcache_touch(block);
+
+    return block;
+}
+
+static void _bcache_free(struct dfs_bcache_block *block)
+{
+    _bcache_set_dirty(block, 0);
+    block->cdev = RT_NULL;
+    rt_list_remove(&block->hash);
+
+    /* put to the tail of LRU list to be reused firstly */
+    rt_list_remove(&block->lru);
+    rt_list_insert_before(&bcache_lru, &block->lru);
+}
+
+/* write back all of the dirty blocks, the error of the first failed one is returned */
+static int _bcache_sync(struct dfs_bcache_dev *cdev)
+{
+    int index, result = 0;
+    struct dfs_bcache_block *block;
+
+    for (index = 0; index < DFS_BCACHE_BLOCKS && bcache_dirty > 0; index ++)
+    {
+        block = &bcache_block[index];
+        if (block->dirty && (cdev == RT_NULL || block->cdev == cdev))
+        {
+            if (_bcache_flush_run(block, RT_FALSE) != 0 && result == 0)
+                result = -EIO;
+        }
+    }
+
+    return result;
+}
+
+static void _bcache_thread_entry(void *parameter)
+{
+    while (1)
+    {
+        rt_thread_mdelay(DFS_BCACHE_FLUSH_PERIOD);
+
+        if (bcache_dirty == 0)
+            continue;
+
+        rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+        _bcache_sync(RT_NULL);
+        rt_mutex_release(&bcache_lock);
+    }
+}
+
+/**
+ * this function will initialize the block cache and start the flusher thread.
+ *
+ * @return 0 on successful
+ */
+int dfs_bcache_init(void)
+{
+    int index;
+
+    rt_mutex_init(&bcache_lock, "bcache", RT_IPC_FLAG_FIFO);
+    rt_list_init(&bcache_dev_list);
+    rt_list_init(&bcache_lru);
+    for (index = 0; index < DFS_BCACHE_HASH_SIZE; index ++)
+        rt_list_init(&bcache_hash[index]);
+
+    for (index = 0; index < DFS_BCACHE_BLOCKS; index ++)
+    {
+        bcache_block[index].cdev  = RT_NULL;
+        bcache_block[index].dirty = 0;
+        bcache_block[index].data  = bcache_data[index];
+        rt_list_init(&bcache_block[index].hash);
+        rt_list_insert_before(&bcache_lru, &bcache_block[index].lru);
+    }
+    bcache_dirty = 0;
+
+    rt_thread_init(&bcache_thread, "bcache", _bcache_thread_entry, RT_NULL,
+                   bcache_thread_stack, sizeof(bcache_thread_stack),
+                   DFS_BCACHE_THREAD_PRIORITY, 10);
+    rt_thread_startup(&bcache_thread);
+
+    return 0;
+}
+INIT_PREV_EXPORT(dfs_bcache_init);
+
+/**
+ * this function will enable block cache on a block device.
+ *
+ * @param dev the block device
+ *
+ * @return 0 on successful, -1 on failed and the errno is set.
+ */
+int dfs_bcache_attach(rt_device_t dev)
+{
+    struct rt_device_blk_geometry geometry;
+    struct dfs_bcache_dev *cdev;
+
+    RT_ASSERT(dev != RT_NULL);
+
+    rt_memset(&geometry, 0, sizeof(geometry));
+    if (rt_device_control(dev, RT_DEVICE_CTRL_BLK_GETGEOME, &geometry) != RT_EOK ||
+        geometry.bytes_per_sector == 0 ||
+        geometry.bytes_per_sector > DFS_BCACHE_SECTOR_SIZE)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    if (_bcache_find_dev(dev) != RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        return 0;
+    }
+
+    cdev = (struct dfs_bcache_dev *)rt_calloc(1, sizeof(struct dfs_bcache_dev));
+    if (cdev == RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    cdev->dev          = dev;
+    cdev->sector_count = geometry.sector_count;
+    cdev->sector_size  = geometry.bytes_per_sector;
+    cdev->next_sector  = 0;
+    rt_list_insert_after(&bcache_dev_list, &cdev->list);
+
+    rt_mutex_release(&bcache_lock);
+
+    return 0;
+}
+RTM_EXPORT(dfs_bcache_attach);
+
+/**
+ * this function will write back the dirty sectors of a block device and
+ * disable the block cache on it.
+ *
+ * @param dev the block device
+ *
+ * @return 0 on successful, -1 on failed and the errno is set. The block cache
+ * is disabled even if the dirty sectors failed to be written back, and the
+ * errno is -EIO.
+ */
+int dfs_bcache_detach(rt_device_t dev)
+{
+    int index, result;
+    struct dfs_bcache_dev *cdev;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    cdev = _bcache_find_dev(dev);
+    if (cdev == RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        rt_set_errno(-ENODEV);
+        return -1;
+    }
+
+    result = _bcache_sync(cdev);
+    if (result != 0)
+        LOG_E("the dirty sectors of %s are lost", dev->parent.name);
+
+    for (index = 0; index < DFS_BCACHE_BLOCKS; index ++)
+    {
+        if (bcache_block[index].cdev == cdev)
+            _bcache_free(&bcache_block[index]);
+    }
+
+    rt_list_remove(&cdev->list);
+    rt_free(cdev);
+
+    rt_mutex_release(&bcache_lock);
+
+    if (result != 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    return 0;
+}
+RTM_EXPORT(dfs_bcache_detach);
+
+/**
+ * this function will read sectors from a block device through block cache.
+ * The device is read directly if block cache is not enabled on it.
+ *
+ * @param dev the block device
+ * @param sector the start sector
+ * @param buffer the buffer to save the data
+ * @param count the number of sectors
+ *
+ * @return the number of sectors read, which is less than count if the end of
+ *         device is reached, 0 on failed.
+ */
+rt_size_t dfs_bcache_read(rt_device_t dev, rt_off_t sector, void *buffer, rt_size_t count)
+{
+    struct dfs_bcache_dev *cdev;
+    struct dfs_bcache_block *block;
+    rt_uint8_t *ptr = (rt_uint8_t *)buffer;
+    rt_size_t index, fetch, take, offset;
+    rt_bool_t sequential;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    cdev = _bcache_find_dev(dev);
+    if (cdev == RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        return rt_device_read(dev, sector, buffer, count);
+    }
+
+    /* the sectors beyond the end of device are not read */
+    if (cdev->sector_count)
+    {
+        if ((rt_uint32_t)sector >= cdev->sector_count)
+        {
+            rt_mutex_release(&bcache_lock);
+            return 0;
+        }
+        if (count > cdev->sector_count - sector)
+            count = cdev->sector_count - sector;
+    }
+
+    sequential = (sector == cdev->next_sector);
+    cdev->next_sector = sector + count;
+
+    if (count > DFS_BCACHE_BYPASS_COUNT)
+    {
+        /* large transfer, read from device and apply the dirty sectors */
+        cdev->stat.dev_read ++;
+        if (rt_device_read(dev, sector, buffer, count) != count)
+        {
+            rt_mutex_release(&bcache_lock);
+            return 0;
+        }
+        cdev->stat.read_miss += count;
+
+        for (index = 0; index < count && bcache_dirty > 0; index ++)
+        {
+            block = _bcache_lookup(cdev, sector + index);
+            if (block != RT_NULL && block->dirty)
+                rt_memcpy(ptr + index * cdev->sector_size, block->data, cdev->sector_size);
+        }
+
+        rt_mutex_release(&bcache_lock);
+        return count;
+    }
+
+    index = 0;
+    while (index < count)
+    {
+        block = _bcache_lookup(cdev, sector + index);
+        if (block != RT_NULL)
+        {
+            rt_memcpy(ptr + index * cdev->sector_size, block->data, cdev->sector_size);
+            _bcache_touch(block);
+            cdev->stat.read_hit ++;
+            index ++;
+            continue;
+        }
+
+        /* read the missed sectors, and the following ones if it's sequential */
+        take  = count - index;
+        fetch = sequential ? DFS_BCACHE_READ_AHEAD : take;
+        if (fetch < take)
+            fetch = take;
+        if (cdev->sector_count && fetch > cdev->sector_count - (sector + index))
+            fetch = cdev->sector_count - (sector + index);
+
+        cdev->stat.dev_read ++;
+        if (rt_device_read(dev, sector + index, bcache_stage, fetch) != fetch)
+        {
+            rt_mutex_release(&bcache_lock);
+            return 0;
+        }
+
+        /* keep the cached sectors in range from being replaced in filling */
+        for (offset = 1; offset < fetch; offset ++)
+        {
+            block = _bcache_lookup(cdev, sector + index + offset);
+            if (block != RT_NULL)
+                _bcache_touch(block);
+        }
+
+        for (offset = 0; offset < fetch; offset ++)
+        {
+            const rt_uint8_t *data = bcache_stage + offset * cdev->sector_size;
+
+            block = _bcache_lookup(cdev, sector + index + offset);
+            if (block == RT_NULL)
+            {
+                /* the sector is not cached if all of the blocks are stuck dirty */
+                block = _bcache_alloc(cdev, sector + index + offset);
+                if (block != RT_NULL)
+                    rt_memcpy(block->data, data, cdev->sector_size);
+            }
+            if (block != RT_NULL)
+                data = block->data;
+
+            if (offset < take)
+                rt_memcpy(ptr + (index + offset) * cdev->sector_size, data,
+                          cdev->sector_size);
+        }
+
+        take = take < fetch ? take : fetch;
+        cdev->stat.read_miss  += take;
+        cdev->stat.read_ahead += fetch - take;
+        index += take;
+    }
+
+    rt_mutex_release(&bcache_lock);
+
+    return count;
+}
+RTM_EXPORT(dfs_bcache_read);
+
+/**
+ * this function will write sectors to a block device through block cache. The
+ * small writes are delayed and written back later, the large ones are written
+ * to device directly. The device is written directly if block cache is not
+ * enabled on it.
+ *
+ * @param dev the block device
+ * @param sector the start sector
+ * @param buffer the data to be written
+ * @param count the number of sectors
+ *
+ * @return the number of sectors written, 0 on failed.
+ */
+rt_size_t dfs_bcache_write(rt_device_t dev, rt_off_t sector, const void *buffer, rt_size_t count)
+{
+    struct dfs_bcache_dev *cdev;
+    struct dfs_bcache_block *block;
+    const rt_uint8_t *ptr = (const rt_uint8_t *)buffer;
+    rt_size_t index;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    cdev = _bcache_find_dev(dev);
+    if (cdev == RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        return rt_device_write(dev, sector, buffer, count);
+    }
+
+    if (count > DFS_BCACHE_BYPASS_COUNT)
+    {
+        /* large transfer, write to device and update the cached sectors */
+        cdev->stat.dev_write ++;
+        if (rt_device_write(dev, sector, buffer, count) != count)
+        {
+            rt_mutex_release(&bcache_lock);
+            return 0;
+        }
+        cdev->stat.write_through += count;
+
+        for (index = 0; index < count; index ++)
+        {
+            block = _bcache_lookup(cdev, sector + index);
+            if (block != RT_NULL)
+            {
+                rt_memcpy(block->data, ptr + index * cdev->sector_size, cdev->sector_size);
+                _bcache_set_dirty(block, 0);
+            }
+        }
+
+        rt_mutex_release(&bcache_lock);
+        return count;
+    }
+
+    for (index = 0; index < count; index ++)
+    {
+        block = _bcache_lookup(cdev, sector + index);
+        if (block == RT_NULL)
+            block = _bcache_alloc(cdev, sector + index);
+        else
+            _bcache_touch(block);
+
+        if (block == RT_NULL)
+        {
+            /* all of the blocks are stuck dirty, write to device directly */
+            cdev->stat.dev_write ++;
+            if (rt_device_write(dev, sector + index, ptr + index * cdev->sector_size, 1) != 1)
+                break;
+            cdev->stat.write_through ++;
+            continue;
+        }
+
+        rt_memcpy(block->data, ptr + index * cdev->sector_size, cdev->sector_size);
+        _bcache_set_dirty(block, 1);
+        cdev->stat.write_cached ++;
+    }
+
+    rt_mutex_release(&bcache_lock);
+
+    return index;
+}
+RTM_EXPORT(dfs_bcache_write);
+
+/**
+ * this function will write back the dirty sectors of a block device.
+ *
+ * @param dev the block device, RT_NULL for all of the devices.
+ *
+ * @return 0 on successful, -1 on failed and the errno is set. The sectors
+ * failed to be written back are kept dirty and retried later.
+ */
+int dfs_bcache_sync(rt_device_t dev)
+{
+    struct dfs_bcache_dev *cdev = RT_NULL;
+    int result;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    if (dev != RT_NULL)
+    {
+        cdev = _bcache_find_dev(dev);
+        if (cdev == RT_NULL)
+        {
+            rt_mutex_release(&bcache_lock);
+            return 0;
+        }
+    }
+    result = _bcache_sync(cdev);
+
+    rt_mutex_release(&bcache_lock);
+
+    if (result != 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    return 0;
+}
+RTM_EXPORT(dfs_bcache_sync);
+
+/**
+ * this function will get the statistics of block cache on a block device.
+ *
+ * @param dev the block device
+ * @param stat the buffer to save the statistics
+ *
+ * @return 0 on successful, -1 on failed and the errno is set.
+ */
+int dfs_bcache_get_stat(rt_device_t dev, struct dfs_bcache_stat *stat)
+{
+    struct dfs_bcache_dev *cdev;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    cdev = _bcache_find_dev(dev);
+    if (cdev == RT_NULL)
+    {
+        rt_mutex_release(&bcache_lock);
+        rt_set_errno(-ENODEV);
+        return -1;
+    }
+    *stat = cdev->stat;
+
+    rt_mutex_release(&bcache_lock);
+
+    return 0;
+}
+RTM_EXPORT(dfs_bcache_get_stat);
+
+/**
+ * this function will clear the statistics of block cache on all devices.
+ */
+void dfs_bcache_reset_stat(void)
+{
+    rt_list_t *node;
+    struct dfs_bcache_dev *cdev;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    for (node = bcache_dev_list.next; node != &bcache_dev_list; node = node->next)
+    {
+        cdev = rt_list_entry(node, struct dfs_bcache_dev, list);
+        rt_memset(&cdev->stat, 0, sizeof(cdev->stat));
+    }
+
+    rt_mutex_release(&bcache_lock);
+}
+RTM_EXPORT(dfs_bcache_reset_stat);
+
+/**
+ * this function will show the statistics of block cache on all devices.
+ */
+void dfs_bcache_dump(void)
+{
+    rt_list_t *node;
+    struct dfs_bcache_dev *cdev;
+
+    rt_mutex_take(&bcache_lock, RT_WAITING_FOREVER);
+
+    rt_kprintf("device   hit      miss     ahead    cached   through  back     rd_io    wr_io\n");
+    rt_kprintf("-------- -------- -------- -------- -------- -------- -------- -------- --------\n");
+    for (node = bcache_dev_list.next; node != &bcache_dev_list; node = node->next)
+    {
+        cdev = rt_list_entry(node, struct dfs_bcache_dev, list);
+        rt_kprintf("%-8.*s %-8d %-8d %-8d %-8d %-8d %-8d %-8d %-8d\n",
+                   RT_NAME_MAX, cdev->dev->parent.name,
+                   cdev->stat.read_hit, cdev->stat.read_miss, cdev->stat.read_ahead,
+                   cdev->stat.write_cached, cdev->stat.write_through,
+                   cdev->stat.write_back, cdev->stat.dev_read, cdev->stat.dev_write);
+    }
+    rt_kprintf("dirty blocks: %d/%d\n", bcache_dirty, DFS_BCACHE_BLOCKS);
+
+    rt_mutex_release(&bcache_lock);
+}
+RTM_EXPORT(dfs_bcache_dump);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static int bcache(int argc, char **argv)
+{
+    if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+        dfs_bcache_reset_stat();
+    else if (argc > 1 && rt_strcmp(argv[1], "sync") == 0)
+        dfs_bcache_sync(RT_NULL);
+    else
+        dfs_bcache_dump();
+
+    return 0;
+}
+MSH_CMD_EXPORT(bcache, show block cache statistics: bcache [reset|sync]);
+#endif
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+/*
+ * Path lookup cache of DFS.
+ *
+ * The entries are keyed by the normalized full path. Each entry records the
+ * mounted file system of the path and, when the file system provides it, the
+ * node of the path in that file system, or that the path does not exist. The
+ * entries are looked up by hash and replaced in LRU order. The file systems
+ * see the path relative to their mount point, which is joined with the mount
+ * path on the fly without building the full path.
+ */
+
+#include <dfs.h>
+#include <dfs_fs.h>
+#include <dfs_dentry.h>
+
+#define DBG_TAG    "DFS.dentry"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+#ifndef DFS_DENTRY_CACHE_SIZE
+#define DFS_DENTRY_CACHE_SIZE   32
+#endif
+
+#define DFS_DENTRY_HASH_SIZE    16
+
+#define DENTRY_STATE_UNKNOWN    0       /* only the mounted file system is known */
+#define DENTRY_STATE_POSITIVE   1
+#define DENTRY_STATE_NEGATIVE   2
+
+struct dfs_dentry
+{
+    rt_list_t   lru;                    /* node of LRU list, the recent one is at head */
+    rt_list_t   hash;                   /* node of hash list */
+
+    char       *path;                   /* RT_NULL if the entry is free */
+    rt_uint32_t hash_value;
+
+    struct dfs_filesystem *fs;
+    void       *node;                   /* the node in file system */
+    rt_uint8_t  state;
+};
+
+static struct rt_mutex dentry_lock;
+static rt_list_t dentry_lru;
+static rt_list_t dentry_hash[DFS_DENTRY_HASH_SIZE];
+static struct dfs_dentry dentry_pool[DFS_DENTRY_CACHE_SIZE];
+static struct dfs_dentry_stat dentry_stat;
+
+/* get the full path of a file system path as a prefix and a suffix */
+static void _dentry_split(struct dfs_filesystem *fs, const char *path,
+                          const char **prefix, const char **suffix)
+{
+    if (fs == RT_NULL || (fs->ops->flags & DFS_FS_FLAG_FULLPATH) ||
+        (fs->path[0] == '/' && fs->path[1] == '\0'))
+    {
+        *prefix = path;
+        *suffix = RT_NULL;
+    }
+    else
+    {
+        *prefix = fs->path;
+        /* the root directory of file system is the mount point */
+        *suffix = (path[0] == '/' && path[1] == '\0') ? RT_NULL : path;
+    }
+}
+
+static rt_uint32_t _dentry_hash(const char *prefix, const char *suffix)
+{
+    rt_uint32_t hash = 0;
+
+    while (*prefix)
+        hash = hash * 131 + *prefix ++;
+    if (suffix)
+    {
+        while (*suffix)
+            hash = hash * 131 + *suffix ++;
+    }
+
+    return hash;
+}
+
+/* return the rest of path after the prefix and suffix, or RT_NULL if mismatch */
+static const char *_dentry_match(const char *path, const char *prefix, const char *suffix)
+{
+    while (*prefix)
+    {
+        if (*path ++ != *prefix ++)
+            return RT_NULL;
+    }
+    if (suffix)
+    {
+        while (*suffix)
+        {
+            if (*path ++ != *suffix ++)
+                return RT_NULL;
+        }
+    }
+
+    return path;
+}
+
+static struct dfs_dentry *_dentry_find(const char *prefix, const char *suffix, rt_uint32_t hash)
+{
+    rt_list_t *bucket, *node;
+    struct dfs_dentry *dentry;
+    const char *rest;
+
+    bucket = &dentry_hash[hash % DFS_DENTRY_HASH_SIZE];
+    for (node = bucket->next; node != bucket; node = node->next)
+    {
+        dentry = rt_list_entry(node, struct dfs_dentry, hash);
+        if (dentry->hash_value != hash)
+            continue;
+
+        rest = _dentry_match(dentry->path, prefix, suffix);
+        if (rest != RT_NULL && *rest == '\0')
+        {
+            /* move to the head of LRU list */
+            rt_list_remove(&dentry->lru);
+            rt_list_insert_after(&dentry_lru, &dentry->lru);
+
+            return dentry;
+        }
+    }
+
+    return RT_NULL;
+}
+
+static void _dentry_free(struct dfs_dentry *dentry)
+{
+    rt_list_remove(&dentry->hash);
+    rt_list_init(&dentry->hash);
+    rt_free(dentry->path);
+    dentry->path = RT_NULL;
+    dentry->fs = RT_NULL;
+    dentry->node = RT_NULL;
+
+    /* the free entries are reused first */
+    rt_list_remove(&dentry->lru);
+    rt_list_insert_before(&dentry_lru, &dentry->lru);
+}
+
+/* find the entry of path or replace the least recently used one for it */
+static struct dfs_dentry *_dentry_get(const char *prefix, const char *suffix)
+{
+    struct dfs_dentry *dentry;
+    rt_uint32_t hash;
+    rt_size_t length;
+    char *path;
+
+    hash = _dentry_hash(prefix, suffix);
+    dentry = _dentry_find(prefix, suffix, hash);
+    if (dentry != RT_NULL)
+        return dentry;
+
+    length = rt_strlen(prefix);
+    path = (char *)rt_malloc(length + (suffix ? rt_strlen(suffix) : 0) + 1);
+    if (path == RT_NULL)
+        return RT_NULL;
+    rt_strncpy(path, prefix, length + 1);
+    if (suffix)
+        rt_strncpy(path + length, suffix, rt_strlen(suffix) + 1);
+
+    dentry = rt_list_entry(dentry_lru.prev, struct dfs_dentry, lru);
+    if (dentry->path != RT_NULL)
+    {
+        dentry_stat.replace ++;
+        _dentry_free(dentry);
+    }
+
+    dentry->path = path;
+    dentry->hash_value = hash;
+    dentry->state = DENTRY_STATE_UNKNOWN;
+    rt_list_insert_after(&dentry_hash[hash % DFS_DENTRY_HASH_SIZE], &dentry->hash);
+    rt_list_remove(&dentry->lru);
+    rt_list_insert_after(&dentry_lru, &dentry->lru);
+
+    return dentry;
+}
+
+/* remove the entries of path and the paths under it */
+static void _dentry_invalidate(const char *prefix, const char *suffix)
+{
+    struct dfs_dentry *dentry;
+    const char *rest;
+    int index;
+
+    for (index = 0; index < DFS_DENTRY_CACHE_SIZE; index ++)
+    {
+        dentry = &dentry_pool[index];
+        if (dentry->path == RT_NULL)
+            continue;
+
+        rest = _dentry_match(dentry->path, prefix, suffix);
+        if (rest == RT_NULL)
+            continue;
+
+        /* the root directory covers all of paths */
+        if (*rest == '\0' || *rest == '/' ||
+            (prefix[0] == '/' && prefix[1] == '\0' && suffix == RT_NULL))
+        {
+            _dentry_free(dentry);
+        }
+    }
+}
+
+/**
+ * this function will initialize the path lookup cache.
+ *
+ * @return 0 on successful.
+ */
+int dfs_dentry_init(void)
+{
+    int index;
+
+    rt_mutex_init(&dentry_lock, "dentry", RT_IPC_FLAG_FIFO);
+    rt_list_init(&dentry_lru);
+    for (index = 0; index < DFS_DENTRY_HASH_SIZE; index ++)
+        rt_list_init(&dentry_hash[index]);
+
+    for (index = 0; index < DFS_DENTRY_CACHE_SIZE; index ++)
+    {
+        rt_memset(&dentry_pool[index], 0, sizeof(struct dfs_dentry));
+        rt_list_init(&dentry_pool[index].hash);
+        rt_list_insert_before(&dentry_lru, &dentry_pool[index].lru);
+    }
+
+    return 0;
+}
+INIT_PREV_EXPORT(dfs_dentry_init);
+
+/**
+ * this function will look up the mounted file system of a path in cache.
+ *
+ * @param fullpath the normalized full path.
+ *
+ * @return the mounted file system or RT_NULL if not cached.
+ */
+struct dfs_filesystem *dfs_dentry_lookup_fs(const char *fullpath)
+{
+    struct dfs_dentry *dentry;
+    struct dfs_filesystem *fs = RT_NULL;
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    dentry = _dentry_find(fullpath, RT_NULL, _dentry_hash(fullpath, RT_NULL));
+    if (dentry != RT_NULL && dentry->fs != RT_NULL)
+    {
+        fs = dentry->fs;
+        dentry_stat.mount_hit ++;
+    }
+    else
+    {
+        dentry_stat.mount_miss ++;
+    }
+
+    rt_mutex_release(&dentry_lock);
+
+    return fs;
+}
+RTM_EXPORT(dfs_dentry_lookup_fs);
+
+/**
+ * this function will save the mounted file system of a path in cache.
+ *
+ * @param fullpath the normalized full path.
+ * @param fs the mounted file system of path.
+ */
+void dfs_dentry_insert_fs(const char *fullpath, struct dfs_filesystem *fs)
+{
+    struct dfs_dentry *dentry;
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    dentry = _dentry_get(fullpath, RT_NULL);
+    if (dentry != RT_NULL)
+        dentry->fs = fs;
+
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_insert_fs);
+
+/**
+ * this function will remove a path and the paths under it from cache, it
+ * should be invoked when the path is created, removed or renamed.
+ *
+ * @param fullpath the normalized full path.
+ */
+void dfs_dentry_invalidate(const char *fullpath)
+{
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+    _dentry_invalidate(fullpath, RT_NULL);
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_invalidate);
+
+/**
+ * this function will remove the paths of a file system from cache.
+ *
+ * @param fs the file system, RT_NULL for all of paths.
+ */
+void dfs_dentry_invalidate_fs(struct dfs_filesystem *fs)
+{
+    struct dfs_dentry *dentry;
+    int index;
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    for (index = 0; index < DFS_DENTRY_CACHE_SIZE; index ++)
+    {
+        dentry = &dentry_pool[index];
+        if (dentry->path != RT_NULL && (fs == RT_NULL || dentry->fs == fs))
+            _dentry_free(dentry);
+    }
+
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_invalidate_fs);
+
+/**
+ * this function will look up the node of a path in cache.
+ *
+ * @param fs the file system.
+ * @param path the path in file system.
+ * @param node the node saved by file system.
+ *
+ * @return DFS_DENTRY_POSITIVE if the node is cached, DFS_DENTRY_NEGATIVE if the
+ * path is cached as non-existent, otherwise DFS_DENTRY_MISS.
+ */
+int dfs_dentry_lookup(struct dfs_filesystem *fs, const char *path, void **node)
+{
+    struct dfs_dentry *dentry;
+    const char *prefix, *suffix;
+    int result = DFS_DENTRY_MISS;
+
+    _dentry_split(fs, path, &prefix, &suffix);
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    dentry = _dentry_find(prefix, suffix, _dentry_hash(prefix, suffix));
+    if (dentry != RT_NULL && dentry->fs == fs)
+    {
+        if (dentry->state == DENTRY_STATE_POSITIVE)
+        {
+            if (node) *node = dentry->node;
+            result = DFS_DENTRY_POSITIVE;
+            dentry_stat.node_hit ++;
+        }
+        else if (dentry->state == DENTRY_STATE_NEGATIVE)
+        {
+            result = DFS_DENTRY_NEGATIVE;
+            dentry_stat.negative_hit ++;
+        }
+    }
+    if (result == DFS_DENTRY_MISS)
+        dentry_stat.node_miss ++;
+
+    rt_mutex_release(&dentry_lock);
+
+    return result;
+}
+RTM_EXPORT(dfs_dentry_lookup);
+
+static void _dentry_set(struct dfs_filesystem *fs, const char *path,
+                        void *node, rt_uint8_t state)
+{
+    struct dfs_dentry *dentry;
+    const char *prefix, *suffix;
+
+    _dentry_split(fs, path, &prefix, &suffix);
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    dentry = _dentry_get(prefix, suffix);
+    if (dentry != RT_NULL)
+    {
+        dentry->fs = fs;
+        dentry->node = node;
+        dentry->state = state;
+    }
+
+    rt_mutex_release(&dentry_lock);
+}
+
+/**
+ * this function will save the node of an existent path in cache.
+ *
+ * @param fs the file system.
+ * @param path the path in file system.
+ * @param node the node of path in file system, it's kept until the path is
+ * removed from cache.
+ */
+void dfs_dentry_insert(struct dfs_filesystem *fs, const char *path, void *node)
+{
+    _dentry_set(fs, path, node, DENTRY_STATE_POSITIVE);
+}
+RTM_EXPORT(dfs_dentry_insert);
+
+/**
+ * this function will save a non-existent path in cache.
+ *
+ * @param fs the file system.
+ * @param path the path in file system.
+ */
+void dfs_dentry_insert_negative(struct dfs_filesystem *fs, const char *path)
+{
+    _dentry_set(fs, path, RT_NULL, DENTRY_STATE_NEGATIVE);
+}
+RTM_EXPORT(dfs_dentry_insert_negative);
+
+/**
+ * this function will remove a path and the paths under it from cache, the
+ * file system should invoke it before the node of path is released.
+ *
+ * @param fs the file system.
+ * @param path the path in file system.
+ */
+void dfs_dentry_remove(struct dfs_filesystem *fs, const char *path)
+{
+    const char *prefix, *suffix;
+
+    _dentry_split(fs, path, &prefix, &suffix);
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+    _dentry_invalidate(prefix, suffix);
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_remove);
+
+/**
+ * this function will get the statistics of path lookup cache.
+ *
+ * @param stat the buffer to save the statistics.
+ */
+void dfs_dentry_get_stat(struct dfs_dentry_stat *stat)
+{
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+    rt_memcpy(stat, &dentry_stat, sizeof(struct dfs_dentry_stat));
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_get_stat);
+
+/**
+ * this function will show the cached paths and the statistics.
+ */
+void dfs_dentry_dump(void)
+{
+    struct dfs_dentry *dentry;
+    rt_list_t *node;
+
+    rt_mutex_take(&dentry_lock, RT_WAITING_FOREVER);
+
+    rt_kprintf("state    mount    path\n");
+    rt_kprintf("-------- -------- ----------------\n");
+    for (node = dentry_lru.next; node != &dentry_lru; node = node->next)
+    {
+        dentry = rt_list_entry(node, struct dfs_dentry, lru);
+        if (dentry->path == RT_NULL)
+            break;
+
+        rt_kprintf("%-8s %-8s %s\n",
+                   dentry->state == DENTRY_STATE_POSITIVE ? "exist" :
+                   dentry->state == DENTRY_STATE_NEGATIVE ? "noent" : "-",
+                   dentry->fs ? dentry->fs->path : "-", dentry->path);
+    }
+    rt_kprintf("mount hit/miss: %d/%d, node hit/negative/miss: %d/%d/%d, replace: %d\n",
+               dentry_stat.mount_hit, dentry_stat.mount_miss,
+               dentry_stat.node_hit, dentry_stat.negative_hit, dentry_stat.node_miss,
+               dentry_stat.replace);
+
+    rt_mutex_release(&dentry_lock);
+}
+RTM_EXPORT(dfs_dentry_dump);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static int dentry(int argc, char **argv)
+{
+    if (argc > 1 && rt_strcmp(argv[1], "flush") == 0)
+        dfs_dentry_invalidate_fs(RT_NULL);
+    else
+        dfs_dentry_dump();
+
+    return 0;
+}
+MSH_CMD_EXPORT(dentry, show path lookup cache: dentry [flush]);
+#endif
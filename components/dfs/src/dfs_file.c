@@ -9,11 +9,22 @@
  * 2011-12-08     Bernard      Merges rename patch from iamcacy.
  * 2015-05-27     Bernard      Fix the fd clear issue.
  * 2019-01-24     Bernard      Remove file repeatedly open check.
+ * 2026-10-19     agent        Check and invalidate the path lookup cache.
+ * 2026-10-19     agent        Add mmap file operation.
+ * 2026-10-19     agent        Add vectored read and write.
+ * 2026-10-19     agent        Remove the closed file from epoll instances.
+ * 2026-10-19     agent        Add ftruncate.
  */
 
 #include <dfs.h>
 #include <dfs_file.h>
 #include <dfs_private.h>
+#ifdef RT_USING_DFS_DENTRY_CACHE
+#include <dfs_dentry.h>
+#endif
+#ifdef RT_USING_POSIX_EPOLL
+#include <dfs_epoll.h>
+#endif
 
 /**
  * @addtogroup FileApi
@@ -93,6 +104,25 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
         return -ENOSYS;
     }
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    if (dfs_dentry_lookup(fs, fd->path, NULL) == DFS_DENTRY_NEGATIVE)
+    {
+        if ((flags & O_CREAT) || (flags & O_ACCMODE) != O_RDONLY)
+        {
+            /* the file may be created by file system */
+            dfs_dentry_remove(fs, fd->path);
+        }
+        else
+        {
+            /* clear fd */
+            rt_free(fd->path);
+            fd->path = NULL;
+
+            return -ENOENT;
+        }
+    }
+#endif
+
     if ((result = fd->fops->open(fd)) < 0)
     {
         /* clear fd */
@@ -129,6 +159,10 @@ int dfs_file_close(struct dfs_fd *fd)
     if (fd == NULL)
         return -ENXIO;
 
+#ifdef RT_USING_POSIX_EPOLL
+    dfs_epoll_release(fd);
+#endif
+
     if (fd->fops->close != NULL)
         result = fd->fops->close(fd);
 
@@ -190,7 +224,8 @@ int dfs_file_ioctl(struct dfs_fd *fd, int cmd, void *args)
  * @param buf the buffer to save the read data.
  * @param len the length of data buffer to be read.
  *
- * @return the actual read data bytes or 0 on end of file or failed.
+ * @return the actual read data bytes, 0 on end of file, negative error code on
+ * failed.
  */
 int dfs_file_read(struct dfs_fd *fd, void *buf, size_t len)
 {
@@ -274,6 +309,10 @@ int dfs_file_unlink(const char *path)
         }
         else
             result = fs->ops->unlink(fs, fullpath);
+
+#ifdef RT_USING_DFS_DENTRY_CACHE
+        dfs_dentry_invalidate(fullpath);
+#endif
     }
     else result = -ENOSYS;
 
@@ -347,6 +386,239 @@ int dfs_file_lseek(struct dfs_fd *fd, off_t offset)
     return result;
 }
 
+/**
+ * this function will truncate or extend the file to the specified length.
+ *
+ * @param fd the file descriptor.
+ * @param length the new length of file.
+ *
+ * @return 0 on successful, -1 on failed.
+ */
+int dfs_file_ftruncate(struct dfs_fd *fd, off_t length)
+{
+    int result;
+
+    if (fd == NULL || fd->type != FT_REGULAR || length < 0)
+        return -EINVAL;
+
+    if ((fd->flags & O_ACCMODE) == O_RDONLY)
+        return -EBADF;
+
+    /* the file operations are replaced by the device, such as serial */
+    if (fd->fs == NULL || fd->fops != fd->fs->ops->fops)
+        return -EINVAL;
+
+    if (fd->fops->ioctl == NULL)
+        return -ENOSYS;
+
+    result = fd->fops->ioctl(fd, DFS_FIOFTRUNCATE, (void *)&length);
+    /* the file system doesn't support truncate */
+    if (result == -EIO)
+        result = -ENOSYS;
+
+    return result;
+}
+
+static int dfs_file_check_iov(const struct iovec *iov, int iovcnt)
+{
+    size_t total = 0;
+    int index;
+
+    if (iov == NULL || iovcnt < 0)
+        return -EINVAL;
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        /* the total length should fit in the returned value */
+        if (iov[index].iov_len > (size_t)INT32_MAX - total)
+            return -EINVAL;
+        total += iov[index].iov_len;
+    }
+
+    return 0;
+}
+
+/**
+ * this function will read data into scattered buffers from a file descriptor.
+ * The buffers are filled in order, the file system without vectored read is
+ * read buffer by buffer.
+ *
+ * @param fd the file descriptor.
+ * @param iov the buffers to save the read data.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual read data bytes, 0 on end of file, negative error code on
+ * failed.
+ */
+int dfs_file_readv(struct dfs_fd *fd, const struct iovec *iov, int iovcnt)
+{
+    int index, result, length = 0;
+
+    if (fd == NULL)
+        return -EINVAL;
+
+    result = dfs_file_check_iov(iov, iovcnt);
+    if (result < 0)
+        return result;
+
+    if (fd->fops->readv != NULL)
+    {
+        if ((result = fd->fops->readv(fd, iov, iovcnt)) < 0)
+            fd->flags |= DFS_F_EOF;
+
+        return result;
+    }
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        result = dfs_file_read(fd, iov[index].iov_base, iov[index].iov_len);
+        if (result < 0)
+            return length > 0 ? length : result;
+
+        length += result;
+        if ((size_t)result < iov[index].iov_len)
+            break;
+    }
+
+    return length;
+}
+
+/**
+ * this function will write data from scattered buffers to a file descriptor.
+ * The buffers are written in order, the file system without vectored write is
+ * written buffer by buffer.
+ *
+ * @param fd the file descriptor.
+ * @param iov the buffers of data to be written.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual written data bytes, negative error code on failed.
+ */
+int dfs_file_writev(struct dfs_fd *fd, const struct iovec *iov, int iovcnt)
+{
+    int index, result, length = 0;
+
+    if (fd == NULL)
+        return -EINVAL;
+
+    result = dfs_file_check_iov(iov, iovcnt);
+    if (result < 0)
+        return result;
+
+    if (fd->fops->writev != NULL)
+        return fd->fops->writev(fd, iov, iovcnt);
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        result = dfs_file_write(fd, iov[index].iov_base, iov[index].iov_len);
+        if (result < 0)
+            return length > 0 ? length : result;
+
+        length += result;
+        if ((size_t)result < iov[index].iov_len)
+            break;
+    }
+
+    return length;
+}
+
+/**
+ * this function will read data into scattered buffers from specified offset
+ * of a file descriptor, the current position of file descriptor is kept.
+ *
+ * @param fd the file descriptor.
+ * @param iov the buffers to save the read data.
+ * @param iovcnt the number of buffers.
+ * @param offset the offset to read from.
+ *
+ * @return the actual read data bytes, negative error code on failed.
+ */
+int dfs_file_preadv(struct dfs_fd *fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    off_t pos;
+    int result;
+
+    if (fd == NULL || offset < 0)
+        return -EINVAL;
+
+    pos = fd->pos;
+    result = dfs_file_lseek(fd, offset);
+    if (result < 0)
+        return result == -ENOSYS ? -ESPIPE : result;
+
+    result = dfs_file_readv(fd, iov, iovcnt);
+    dfs_file_lseek(fd, pos);
+
+    return result;
+}
+
+/**
+ * this function will write data from scattered buffers to specified offset
+ * of a file descriptor, the current position of file descriptor is kept.
+ *
+ * @param fd the file descriptor.
+ * @param iov the buffers of data to be written.
+ * @param iovcnt the number of buffers.
+ * @param offset the offset to write to.
+ *
+ * @return the actual written data bytes, negative error code on failed.
+ */
+int dfs_file_pwritev(struct dfs_fd *fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    off_t pos;
+    int result;
+
+    if (fd == NULL || offset < 0)
+        return -EINVAL;
+
+    pos = fd->pos;
+    result = dfs_file_lseek(fd, offset);
+    if (result < 0)
+        return result == -ENOSYS ? -ESPIPE : result;
+
+    result = dfs_file_writev(fd, iov, iovcnt);
+    dfs_file_lseek(fd, pos);
+
+    return result;
+}
+
+/**
+ * this function will map the content of a file into memory without copy. The
+ * file system returns the address where the file content is stored, it keeps
+ * valid until the file is resized or removed.
+ *
+ * @param fd the file descriptor.
+ * @param offset the offset in file.
+ * @param length the length of mapping.
+ * @param flags the flags of mapping, DFS_MMAP_WRITE for writable mapping.
+ * @param addr the returned address of mapping.
+ *
+ * @return 0 on successful, -ENOSYS if file system doesn't support mapping,
+ * other negative error code on failed.
+ */
+int dfs_file_mmap(struct dfs_fd *fd, off_t offset, size_t length, int flags, void **addr)
+{
+    if (fd == NULL || fd->type != FT_REGULAR || addr == NULL)
+        return -EINVAL;
+
+    if (fd->fops->mmap == NULL)
+        return -ENOSYS;
+
+    if (offset < 0 || length == 0)
+        return -EINVAL;
+
+    if ((flags & DFS_MMAP_WRITE) && (fd->flags & O_ACCMODE) == O_RDONLY)
+        return -EACCES;
+
+    return fd->fops->mmap(fd, offset, length, flags, addr);
+}
+
 /**
  * this function will get file information.
  *
@@ -405,6 +677,16 @@ int dfs_file_stat(const char *path, struct stat *buf)
             return -ENOSYS;
         }
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+        if (dfs_dentry_lookup(fs, (fs->ops->flags & DFS_FS_FLAG_FULLPATH) ?
+                              fullpath : dfs_subdir(fs->path, fullpath), NULL) == DFS_DENTRY_NEGATIVE)
+        {
+            rt_free(fullpath);
+
+            return -ENOENT;
+        }
+#endif
+
         /* get the real file path and get file stat */
         if (fs->ops->flags & DFS_FS_FLAG_FULLPATH)
             result = fs->ops->stat(fs, fullpath, buf);
@@ -467,6 +749,11 @@ int dfs_file_rename(const char *oldpath, const char *newpath)
                 result = oldfs->ops->rename(oldfs,
                                             dfs_subdir(oldfs->path, oldfullpath),
                                             dfs_subdir(newfs->path, newfullpath));
+
+#ifdef RT_USING_DFS_DENTRY_CACHE
+            dfs_dentry_invalidate(oldfullpath);
+            dfs_dentry_invalidate(newfullpath);
+#endif
         }
     }
     else
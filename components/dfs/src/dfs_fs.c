@@ -10,11 +10,15 @@
  * 2011-03-12     Bernard      fix the filesystem lookup issue.
  * 2017-11-30     Bernard      fix the filesystem_operation_table issue.
  * 2017-12-05     Bernard      fix the fs type search issue in mkfs.
+ * 2026-10-19     agent        look up the mounted file system in path lookup cache.
  */
 
 #include <dfs_fs.h>
 #include <dfs_file.h>
 #include "dfs_private.h"
+#ifdef RT_USING_DFS_DENTRY_CACHE
+#include <dfs_dentry.h>
+#endif
 
 /**
  * @addtogroup FsApi
@@ -88,6 +92,16 @@ struct dfs_filesystem *dfs_filesystem_lookup(const char *path)
     /* lock filesystem */
     dfs_lock();
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    fs = dfs_dentry_lookup_fs(path);
+    if (fs != NULL)
+    {
+        dfs_unlock();
+
+        return fs;
+    }
+#endif
+
     /* lookup it in the filesystem table */
     for (iter = &filesystem_table[0];
             iter < &filesystem_table[DFS_FILESYSTEMS_MAX]; iter++)
@@ -108,6 +122,11 @@ struct dfs_filesystem *dfs_filesystem_lookup(const char *path)
         prefixlen = fspath;
     }
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    if (fs != NULL)
+        dfs_dentry_insert_fs(path, fs);
+#endif
+
     dfs_unlock();
 
     return fs;
@@ -312,6 +331,10 @@ int dfs_mount(const char   *device_name,
     fs->path   = fullpath;
     fs->ops    = *ops;
     fs->dev_id = dev_id;
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    /* the paths under mount point belong to the new file system */
+    dfs_dentry_invalidate_fs(NULL);
+#endif
     /* release filesystem_table lock */
     dfs_unlock();
 
@@ -323,6 +346,9 @@ int dfs_mount(const char   *device_name,
         {
             /* The underlaying device has error, clear the entry. */
             dfs_lock();
+#ifdef RT_USING_DFS_DENTRY_CACHE
+            dfs_dentry_invalidate_fs(fs);
+#endif
             memset(fs, 0, sizeof(struct dfs_filesystem));
 
             goto err1;
@@ -338,6 +364,9 @@ int dfs_mount(const char   *device_name,
 
         /* mount failed */
         dfs_lock();
+#ifdef RT_USING_DFS_DENTRY_CACHE
+        dfs_dentry_invalidate_fs(fs);
+#endif
         /* clear filesystem table entry */
         memset(fs, 0, sizeof(struct dfs_filesystem));
 
@@ -402,6 +431,10 @@ int dfs_unmount(const char *specialfile)
     if (fs->path != NULL)
         rt_free(fs->path);
 
+#ifdef RT_USING_DFS_DENTRY_CACHE
+    dfs_dentry_invalidate_fs(fs);
+#endif
+
     /* clear this filesystem table entry */
     memset(fs, 0, sizeof(struct dfs_filesystem));
 
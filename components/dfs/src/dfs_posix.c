@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2009-05-27     Yi.qiu       The first version
  * 2018-02-07     Bernard      Change the 3rd parameter of open/fcntl/ioctl to '...'
+ * 2026-10-19     agent        Add readv/writev/preadv/pwritev.
+ * 2026-10-19     agent        Add ftruncate.
  */
 
 #include <dfs.h>
@@ -188,6 +190,168 @@ int write(int fd, const void *buf, size_t len)
 }
 RTM_EXPORT(write);
 
+/**
+ * this function is a POSIX compliant version, which will read data into multiple buffers
+ * for an open file descriptor.
+ *
+ * @param fd the file descriptor.
+ * @param iov the array of buffers.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual read data length, -1 on failed.
+ */
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    int result;
+    struct dfs_fd *d;
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    result = dfs_file_readv(d, iov, iovcnt);
+    if (result < 0)
+    {
+        fd_put(d);
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return result;
+}
+RTM_EXPORT(readv);
+
+/**
+ * this function is a POSIX compliant version, which will write data from multiple buffers
+ * to an open file descriptor.
+ *
+ * @param fd the file descriptor.
+ * @param iov the array of buffers.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual written data length, -1 on failed.
+ */
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    int result;
+    struct dfs_fd *d;
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    result = dfs_file_writev(d, iov, iovcnt);
+    if (result < 0)
+    {
+        fd_put(d);
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return result;
+}
+RTM_EXPORT(writev);
+
+/**
+ * this function is a POSIX compliant version, which will read data into multiple buffers
+ * from the given offset, the file position is not changed.
+ *
+ * @param fd the file descriptor.
+ * @param iov the array of buffers.
+ * @param iovcnt the number of buffers.
+ * @param offset the offset in file to start at.
+ *
+ * @return the actual read data length, -1 on failed.
+ */
+ssize_t preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    int result;
+    struct dfs_fd *d;
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    result = dfs_file_preadv(d, iov, iovcnt, offset);
+    if (result < 0)
+    {
+        fd_put(d);
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return result;
+}
+RTM_EXPORT(preadv);
+
+/**
+ * this function is a POSIX compliant version, which will write data from multiple buffers
+ * to the given offset, the file position is not changed.
+ *
+ * @param fd the file descriptor.
+ * @param iov the array of buffers.
+ * @param iovcnt the number of buffers.
+ * @param offset the offset in file to start at.
+ *
+ * @return the actual written data length, -1 on failed.
+ */
+ssize_t pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    int result;
+    struct dfs_fd *d;
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    result = dfs_file_pwritev(d, iov, iovcnt, offset);
+    if (result < 0)
+    {
+        fd_put(d);
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return result;
+}
+RTM_EXPORT(pwritev);
+
 /**
  * this function is a POSIX compliant version, which will seek the offset for
  * an open file descriptor.
@@ -402,6 +566,45 @@ int fsync(int fildes)
 }
 RTM_EXPORT(fsync);
 
+/**
+ * this function is a POSIX compliant version, which will truncate or extend
+ * the file to the specified length.
+ *
+ * @param fd the file descriptor.
+ * @param length the new length of file.
+ *
+ * @return 0 on successful, -1 on failed.
+ */
+int ftruncate(int fd, off_t length)
+{
+    int result;
+    struct dfs_fd *d;
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    result = dfs_file_ftruncate(d, length);
+    if (result < 0)
+    {
+        fd_put(d);
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return 0;
+}
+RTM_EXPORT(ftruncate);
+
 /**
  * this function is a POSIX compliant version, which shall perform a variety of
  * control functions on devices.
@@ -0,0 +1,697 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+#include <stdint.h>
+
+#include <rthw.h>
+#include <rtdevice.h>
+#include <rtthread.h>
+
+#include <dfs.h>
+#include <dfs_file.h>
+#include <dfs_posix.h>
+#include <dfs_poll.h>
+#include <dfs_epoll.h>
+
+#define EPOLL_HASH_SIZE     16  /* buckets of interest list */
+#define EPOLL_WQUEUE_MAX    2   /* wait queues registered by one file, such as pipe */
+#define EPOLL_NESTS_MAX     4   /* depth of epoll instances nested in interest lists */
+
+/* the events which are always reported */
+#define EPOLL_EVENTS_ALWAYS (EPOLLERR | EPOLLHUP)
+#define EPOLL_EVENTS_MODE   (EPOLLET | EPOLLONESHOT)
+
+struct eventpoll;
+struct epitem;
+
+struct epoll_wqueue_node
+{
+    struct rt_wqueue_node wqn;
+    struct epitem *item;
+};
+
+/* a file in interest list of epoll instance */
+struct epitem
+{
+    rt_list_t list;                     /* node in interest list */
+    rt_list_t rdllink;                  /* node in ready list */
+    rt_uint8_t ready;                   /* it's in ready list */
+    rt_uint8_t nwait;                   /* number of wait queues registered */
+
+    struct eventpoll *ep;
+    struct dfs_fd *file;
+    struct epoll_event event;
+
+    rt_pollreq_t req;
+    struct epoll_wqueue_node wait[EPOLL_WQUEUE_MAX];
+};
+
+struct eventpoll
+{
+    rt_list_t list;                     /* node in epoll instance list */
+    struct rt_mutex lock;               /* protect the interest list */
+
+    rt_list_t items[EPOLL_HASH_SIZE];   /* interest list hashed by file */
+    rt_list_t rdllist;                  /* ready list, protected by interrupt lock */
+    rt_wqueue_t wq;                     /* the threads wait on epoll_wait */
+};
+
+static struct rt_mutex _epoll_lock;
+static rt_list_t _epoll_list = RT_LIST_OBJECT_INIT(_epoll_list);
+static rt_uint32_t _epoll_item_count = 0;
+
+rt_inline rt_list_t *_epoll_bucket(struct eventpoll *ep, struct dfs_fd *file)
+{
+    return &(ep->items[((rt_ubase_t)file >> 3) % EPOLL_HASH_SIZE]);
+}
+
+static struct epitem *_epoll_find(struct eventpoll *ep, struct dfs_fd *file)
+{
+    rt_list_t *bucket, *node;
+    struct epitem *item;
+
+    bucket = _epoll_bucket(ep, file);
+    for (node = bucket->next; node != bucket; node = node->next)
+    {
+        item = rt_list_entry(node, struct epitem, list);
+        if (item->file == file)
+            return item;
+    }
+
+    return RT_NULL;
+}
+
+/* put the item to ready list and wake up the waiting thread, it's invoked with interrupt disabled */
+static void _epoll_ready(struct epitem *item)
+{
+    if (!item->ready)
+    {
+        item->ready = 1;
+        rt_list_insert_before(&(item->ep->rdllist), &(item->rdllink));
+
+        rt_wqueue_wakeup(&(item->ep->wq), (void *)POLLIN);
+    }
+}
+
+static int _epoll_wqueue_callback(struct rt_wqueue_node *wait, void *key)
+{
+    struct epitem *item;
+
+    item = ((struct epoll_wqueue_node *)wait)->item;
+    if (!(item->event.events & ~EPOLL_EVENTS_MODE))
+        return -1; /* disabled by one shot */
+
+    if (key && !((rt_ubase_t)key & (item->event.events | EPOLL_EVENTS_ALWAYS)))
+        return -1;
+
+    _epoll_ready(item);
+
+    /* keep the node in wait queue and don't wake the polling thread */
+    return -1;
+}
+
+static void _epoll_queue_proc(rt_wqueue_t *wq, rt_pollreq_t *req)
+{
+    struct epitem *item;
+    struct epoll_wqueue_node *node;
+    rt_base_t level;
+
+    item = rt_container_of(req, struct epitem, req);
+    if (item->nwait >= EPOLL_WQUEUE_MAX)
+        return;
+
+    node = &(item->wait[item->nwait ++]);
+    node->item = item;
+    node->wqn.polling_thread = RT_NULL;
+    node->wqn.wakeup = _epoll_wqueue_callback;
+    node->wqn.key = req->_key;
+    rt_list_init(&(node->wqn.list));
+
+    /* rt_wqueue_wakeup stops at the first node which wakes its thread, so the
+     * node is put before the polling threads, it never wakes one. */
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_after(&(wq->waiting_list), &(node->wqn.list));
+    rt_hw_interrupt_enable(level);
+}
+
+/* get the current events of file, and register to its wait queue when req has proc */
+static int _epoll_poll_file(struct epitem *item, rt_pollreq_t *req)
+{
+    int mask;
+
+    req->_key = (item->event.events & ~EPOLL_EVENTS_MODE) | EPOLL_EVENTS_ALWAYS;
+    mask = item->file->fops->poll(item->file, req);
+    if (mask < 0)
+        mask = POLLERR;
+
+    return mask & ((item->event.events & ~EPOLL_EVENTS_MODE) | EPOLL_EVENTS_ALWAYS);
+}
+
+static void _epoll_item_remove(struct epitem *item)
+{
+    rt_base_t level;
+    int index;
+
+    for (index = 0; index < item->nwait; index ++)
+        rt_wqueue_remove(&(item->wait[index].wqn));
+
+    level = rt_hw_interrupt_disable();
+    if (item->ready)
+        rt_list_remove(&(item->rdllink));
+    _epoll_item_count --;
+    rt_hw_interrupt_enable(level);
+
+    rt_list_remove(&(item->list));
+    rt_free(item);
+}
+
+static int _epoll_insert(struct eventpoll *ep, struct dfs_fd *file, struct epoll_event *event)
+{
+    struct epitem *item;
+    rt_base_t level;
+    int mask;
+
+    item = (struct epitem *)rt_calloc(1, sizeof(struct epitem));
+    if (item == RT_NULL)
+        return -ENOMEM;
+
+    rt_list_init(&(item->rdllink));
+    item->ep = ep;
+    item->file = file;
+    item->event = *event;
+    item->req._proc = _epoll_queue_proc;
+
+    rt_list_insert_before(_epoll_bucket(ep, file), &(item->list));
+    level = rt_hw_interrupt_disable();
+    _epoll_item_count ++;
+    rt_hw_interrupt_enable(level);
+
+    /* register to the wait queue of file, then check the events which are ready already */
+    mask = _epoll_poll_file(item, &(item->req));
+    item->req._proc = RT_NULL;
+    if (mask)
+    {
+        level = rt_hw_interrupt_disable();
+        _epoll_ready(item);
+        rt_hw_interrupt_enable(level);
+    }
+
+    return 0;
+}
+
+static int _epoll_modify(struct epitem *item, struct epoll_event *event)
+{
+    rt_base_t level;
+    int index, mask;
+
+    level = rt_hw_interrupt_disable();
+    item->event = *event;
+    for (index = 0; index < item->nwait; index ++)
+        item->wait[index].wqn.key = (event->events & ~EPOLL_EVENTS_MODE) | EPOLL_EVENTS_ALWAYS;
+    rt_hw_interrupt_enable(level);
+
+    mask = _epoll_poll_file(item, &(item->req));
+    if (mask)
+    {
+        level = rt_hw_interrupt_disable();
+        _epoll_ready(item);
+        rt_hw_interrupt_enable(level);
+    }
+
+    return 0;
+}
+
+/* collect the ready events, the level triggered items are put back to ready list */
+static int _epoll_harvest(struct eventpoll *ep, struct epoll_event *events, int maxevents)
+{
+    rt_list_t relist;
+    struct epitem *item;
+    rt_base_t level;
+    int count = 0, mask;
+
+    rt_list_init(&relist);
+
+    while (count < maxevents)
+    {
+        level = rt_hw_interrupt_disable();
+        if (rt_list_isempty(&(ep->rdllist)))
+        {
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+        item = rt_list_entry(ep->rdllist.next, struct epitem, rdllink);
+        rt_list_remove(&(item->rdllink));
+        item->ready = 0;
+        rt_hw_interrupt_enable(level);
+
+        /* it's disabled by one shot */
+        if (!(item->event.events & ~EPOLL_EVENTS_MODE))
+            continue;
+
+        /* the event may be consumed before harvest */
+        mask = _epoll_poll_file(item, &(item->req));
+        if (mask == 0)
+            continue;
+
+        events[count].events = mask;
+        events[count].data = item->event.data;
+        count ++;
+
+        level = rt_hw_interrupt_disable();
+        if (item->event.events & EPOLLONESHOT)
+        {
+            item->event.events &= EPOLL_EVENTS_MODE;
+        }
+        else if (!(item->event.events & EPOLLET) && !item->ready)
+        {
+            /* check it again in next epoll_wait */
+            item->ready = 1;
+            rt_list_insert_before(&relist, &(item->rdllink));
+        }
+        rt_hw_interrupt_enable(level);
+    }
+
+    if (!rt_list_isempty(&relist))
+    {
+        level = rt_hw_interrupt_disable();
+        /* splice the level triggered items to the tail of ready list */
+        relist.next->prev = ep->rdllist.prev;
+        ep->rdllist.prev->next = relist.next;
+        relist.prev->next = &(ep->rdllist);
+        ep->rdllist.prev = relist.prev;
+        rt_hw_interrupt_enable(level);
+    }
+
+    return count;
+}
+
+static void _epoll_free(struct eventpoll *ep)
+{
+    struct epitem *item;
+    int index;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    rt_list_remove(&(ep->list));
+    rt_mutex_release(&_epoll_lock);
+
+    rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+    for (index = 0; index < EPOLL_HASH_SIZE; index ++)
+    {
+        while (!rt_list_isempty(&(ep->items[index])))
+        {
+            item = rt_list_entry(ep->items[index].next, struct epitem, list);
+            _epoll_item_remove(item);
+        }
+    }
+    rt_mutex_release(&(ep->lock));
+
+    rt_mutex_detach(&(ep->lock));
+    rt_free(ep);
+}
+
+static int epoll_fops_close(struct dfs_fd *file)
+{
+    _epoll_free((struct eventpoll *)file->data);
+    file->data = RT_NULL;
+
+    return 0;
+}
+
+static int epoll_fops_poll(struct dfs_fd *file, struct rt_pollreq *req)
+{
+    struct eventpoll *ep;
+    int mask = 0;
+
+    ep = (struct eventpoll *)file->data;
+    rt_poll_add(&(ep->wq), req);
+
+    if (!rt_list_isempty(&(ep->rdllist)))
+        mask |= POLLIN;
+
+    return mask;
+}
+
+static const struct dfs_file_ops _epoll_fops =
+{
+    RT_NULL,            /* open */
+    epoll_fops_close,
+    RT_NULL,            /* ioctl */
+    RT_NULL,            /* read */
+    RT_NULL,            /* write */
+    RT_NULL,            /* flush */
+    RT_NULL,            /* lseek */
+    RT_NULL,            /* getdents */
+    epoll_fops_poll,
+};
+
+/* get the epoll instance of fd, the fd should be put after used */
+static struct eventpoll *_epoll_get(int epfd, struct dfs_fd **d)
+{
+    *d = fd_get(epfd);
+    if (*d == RT_NULL)
+        return RT_NULL;
+
+    if ((*d)->fops != &_epoll_fops)
+    {
+        fd_put(*d);
+        *d = RT_NULL;
+
+        return RT_NULL;
+    }
+
+    return (struct eventpoll *)(*d)->data;
+}
+
+/* check whether the epoll instance @to is reached from @from through the epoll
+ * instances in interest lists, it's invoked with _epoll_lock held. */
+static int _epoll_loop_check(struct eventpoll *from, struct eventpoll *to, int depth)
+{
+    struct eventpoll *nested;
+    struct epitem *item;
+    rt_list_t *node;
+    int index, result = 0;
+
+    if (depth > EPOLL_NESTS_MAX)
+        return -ELOOP;
+
+    rt_mutex_take(&(from->lock), RT_WAITING_FOREVER);
+    for (index = 0; index < EPOLL_HASH_SIZE && result == 0; index ++)
+    {
+        for (node = from->items[index].next;
+             node != &(from->items[index]) && result == 0;
+             node = node->next)
+        {
+            item = rt_list_entry(node, struct epitem, list);
+            if (item->file->fops != &_epoll_fops)
+                continue;
+
+            nested = (struct eventpoll *)item->file->data;
+            if (nested == to)
+                result = -ELOOP;
+            else
+                result = _epoll_loop_check(nested, to, depth + 1);
+        }
+    }
+    rt_mutex_release(&(from->lock));
+
+    return result;
+}
+
+static int epoll_init(void)
+{
+    rt_mutex_init(&_epoll_lock, "epoll", RT_IPC_FLAG_FIFO);
+
+    return 0;
+}
+INIT_PREV_EXPORT(epoll_init);
+
+/**
+ * this function will remove the file from all of epoll instances, it should
+ * be invoked before the file is closed.
+ *
+ * @param fd the file to be closed.
+ */
+void dfs_epoll_release(struct dfs_fd *fd)
+{
+    rt_list_t *node;
+    struct eventpoll *ep;
+    struct epitem *item;
+
+    if (_epoll_item_count == 0)
+        return;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    for (node = _epoll_list.next; node != &_epoll_list; node = node->next)
+    {
+        ep = rt_list_entry(node, struct eventpoll, list);
+
+        rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+        item = _epoll_find(ep, fd);
+        if (item != RT_NULL)
+            _epoll_item_remove(item);
+        rt_mutex_release(&(ep->lock));
+    }
+    rt_mutex_release(&_epoll_lock);
+}
+
+/**
+ * this function is a POSIX compliant version, which will create an epoll
+ * instance.
+ *
+ * @param flags the flags of epoll instance, only EPOLL_CLOEXEC is accepted.
+ *
+ * @return the file descriptor of epoll instance, -1 on failed.
+ */
+int epoll_create1(int flags)
+{
+    struct eventpoll *ep;
+    struct dfs_fd *d;
+    int fd, index;
+
+    if (flags & ~EPOLL_CLOEXEC)
+    {
+        rt_set_errno(-EINVAL);
+
+        return -1;
+    }
+
+    ep = (struct eventpoll *)rt_calloc(1, sizeof(struct eventpoll));
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(-ENOMEM);
+
+        return -1;
+    }
+
+    /* allocate a fd */
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_free(ep);
+        rt_set_errno(-ENOMEM);
+
+        return -1;
+    }
+    d = fd_get(fd);
+
+    rt_mutex_init(&(ep->lock), "epoll", RT_IPC_FLAG_FIFO);
+    for (index = 0; index < EPOLL_HASH_SIZE; index ++)
+        rt_list_init(&(ep->items[index]));
+    rt_list_init(&(ep->rdllist));
+    rt_wqueue_init(&(ep->wq));
+
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &_epoll_fops;
+    d->flags = O_RDWR;
+    d->size = 0;
+    d->pos = 0;
+    d->data = ep;
+
+    rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+    rt_list_insert_after(&_epoll_list, &(ep->list));
+    rt_mutex_release(&_epoll_lock);
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return fd;
+}
+RTM_EXPORT(epoll_create1);
+
+/**
+ * this function is a POSIX compliant version, which will create an epoll
+ * instance.
+ *
+ * @param size the hint of file number, it should be greater than zero.
+ *
+ * @return the file descriptor of epoll instance, -1 on failed.
+ */
+int epoll_create(int size)
+{
+    if (size <= 0)
+    {
+        rt_set_errno(-EINVAL);
+
+        return -1;
+    }
+
+    return epoll_create1(0);
+}
+RTM_EXPORT(epoll_create);
+
+/**
+ * this function is a POSIX compliant version, which will add, modify or
+ * remove a file in the interest list of epoll instance.
+ *
+ * @param epfd the file descriptor of epoll instance.
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL.
+ * @param fd the file descriptor to be operated.
+ * @param event the events and user data of file, it's ignored by EPOLL_CTL_DEL.
+ *
+ * @return 0 on successful, -1 on failed.
+ */
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    struct eventpoll *ep;
+    struct epitem *item;
+    struct dfs_fd *d, *file;
+    int result = 0, nested;
+
+    ep = _epoll_get(epfd, &d);
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(d == RT_NULL ? -EBADF : -EINVAL);
+
+        return -1;
+    }
+
+    file = fd_get(fd);
+    if (file == RT_NULL)
+    {
+        fd_put(d);
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    if (file == d || file->fops->poll == RT_NULL)
+    {
+        result = -EPERM;
+        goto __exit;
+    }
+
+    if (op != EPOLL_CTL_DEL && event == RT_NULL)
+    {
+        result = -EFAULT;
+        goto __exit;
+    }
+
+    /* the epoll instances are added to others with the global lock held, so
+     * two of them can't be added to each other at the same time */
+    nested = (op == EPOLL_CTL_ADD && file->fops == &_epoll_fops);
+    if (nested)
+        rt_mutex_take(&_epoll_lock, RT_WAITING_FOREVER);
+
+    rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+    item = _epoll_find(ep, file);
+    switch (op)
+    {
+    case EPOLL_CTL_ADD:
+        if (item != RT_NULL)
+            result = -EEXIST;
+        else if (nested)
+            result = _epoll_loop_check((struct eventpoll *)file->data, ep, 1);
+
+        if (result == 0)
+            result = _epoll_insert(ep, file, event);
+        break;
+
+    case EPOLL_CTL_MOD:
+        if (item != RT_NULL)
+            result = _epoll_modify(item, event);
+        else
+            result = -ENOENT;
+        break;
+
+    case EPOLL_CTL_DEL:
+        if (item != RT_NULL)
+            _epoll_item_remove(item);
+        else
+            result = -ENOENT;
+        break;
+
+    default:
+        result = -EINVAL;
+        break;
+    }
+    rt_mutex_release(&(ep->lock));
+
+    if (nested)
+        rt_mutex_release(&_epoll_lock);
+
+__exit:
+    fd_put(file);
+    fd_put(d);
+
+    if (result < 0)
+    {
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    return 0;
+}
+RTM_EXPORT(epoll_ctl);
+
+/**
+ * this function is a POSIX compliant version, which will wait for the events
+ * of files in the interest list of epoll instance.
+ *
+ * @param epfd the file descriptor of epoll instance.
+ * @param events the buffer to save the ready events.
+ * @param maxevents the maximal number of events.
+ * @param timeout the timeout in millisecond, -1 for waiting forever.
+ *
+ * @return the number of ready events, 0 on timeout, -1 on failed.
+ */
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    struct eventpoll *ep;
+    struct dfs_fd *d;
+    rt_tick_t deadline = 0, now;
+    int count, msec = timeout;
+
+    if (events == RT_NULL || maxevents <= 0)
+    {
+        rt_set_errno(-EINVAL);
+
+        return -1;
+    }
+
+    ep = _epoll_get(epfd, &d);
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(d == RT_NULL ? -EBADF : -EINVAL);
+
+        return -1;
+    }
+
+    if (timeout > 0)
+        deadline = rt_tick_get() + rt_tick_from_millisecond(timeout);
+
+    while (1)
+    {
+        rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+        count = _epoll_harvest(ep, events, maxevents);
+        rt_mutex_release(&(ep->lock));
+
+        if (count > 0 || timeout == 0)
+            break;
+
+        if (timeout > 0)
+        {
+            now = rt_tick_get();
+            if ((rt_int32_t)(deadline - now) <= 0)
+                break;
+            msec = (deadline - now) * 1000 / RT_TICK_PER_SECOND;
+            if (msec == 0)
+                msec = 1;
+        }
+
+        /* it's waked up by the file in interest list or timeout */
+        rt_wqueue_wait(&(ep->wq), !rt_list_isempty(&(ep->rdllist)), msec);
+    }
+
+    fd_put(d);
+
+    return count;
+}
+RTM_EXPORT(epoll_wait);
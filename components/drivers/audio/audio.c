@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2017-05-09     Urey         first version
  * 2019-07-09     Zero-Free    improve device ops interface and data flows
+ * 2026-10-19     agent        add render callback and replay statistics
  */
 
 #include <stdio.h>
@@ -28,6 +29,43 @@ enum
     REPLAY_EVT_STOP  = 0x02,
 };
 
+/* render the block into DMA buffer by the callback of producer */
+static rt_err_t _audio_render_replay_frame(struct rt_audio_device *audio)
+{
+    struct rt_audio_replay *replay = audio->replay;
+    rt_uint8_t *buffer = &replay->buf_info.buffer[replay->pos];
+    rt_size_t dst_size, size = 0;
+
+    dst_size = replay->buf_info.block_size;
+
+    if (replay->event & REPLAY_EVT_STOP)
+    {
+        /* ack stop event, the producer is not called any more */
+        rt_completion_done(&replay->cmp);
+    }
+    else
+    {
+        size = replay->render.render(audio, buffer, dst_size, replay->render.param);
+        if (size > dst_size)
+            size = dst_size;
+    }
+
+    if (size < dst_size)
+    {
+        memset(buffer + size, 0, dst_size - size);
+
+        if (size == 0)
+            replay->stat.silences ++;
+        else
+            replay->stat.underruns ++;
+    }
+
+    replay->pos += dst_size;
+    replay->pos %= replay->buf_info.total_size;
+
+    return RT_EOK;
+}
+
 static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
 {
     rt_err_t result = RT_EOK;
@@ -43,12 +81,18 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
     position = audio->replay->pos;
     dst_size = buf_info->block_size;
 
+    if (audio->replay->render.render != RT_NULL)
+    {
+        result = _audio_render_replay_frame(audio);
+    }
     /* check repaly queue is empty */
-    if (rt_data_queue_peak(&audio->replay->queue, (const void **)&data, &src_size) != RT_EOK)
+    else if (rt_data_queue_peak(&audio->replay->queue, (const void **)&data, &src_size) != RT_EOK)
     {
         /* ack stop event */
         if (audio->replay->event & REPLAY_EVT_STOP)
             rt_completion_done(&audio->replay->cmp);
+        else
+            audio->replay->stat.silences ++;
 
         /* send zero frames */
         memset(&buf_info->buffer[audio->replay->pos], 0, dst_size);
@@ -71,6 +115,7 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
                 audio->replay->pos += dst_size;
                 audio->replay->pos %= buf_info->total_size;
                 audio->replay->read_index = 0;
+                audio->replay->stat.underruns ++;
                 result = -RT_EEMPTY;
                 break;
             }
@@ -80,6 +125,7 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
                    &data[audio->replay->read_index], remain_bytes);
 
             index += remain_bytes;
+            audio->replay->queued -= remain_bytes;
             audio->replay->read_index += remain_bytes;
             audio->replay->pos += remain_bytes;
             audio->replay->pos %= buf_info->total_size;
@@ -98,6 +144,12 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
         }
     }
 
+    /* the bytes queued and in DMA buffer are played before the next written one */
+    audio->replay->stat.blocks ++;
+    audio->replay->stat.buffered = audio->replay->queued + buf_info->total_size;
+    if (audio->replay->stat.buffered > audio->replay->stat.buffered_max)
+        audio->replay->stat.buffered_max = audio->replay->stat.buffered;
+
     if (audio->ops->transmit != RT_NULL)
     {
         if (audio->ops->transmit(audio, &buf_info->buffer[position], RT_NULL, dst_size) != dst_size)
@@ -107,16 +159,42 @@ static rt_err_t _audio_send_replay_frame(struct rt_audio_device *audio)
     return result;
 }
 
+/* convert the bytes of replay data to us by the configure of output */
+static rt_uint32_t _audio_replay_latency(struct rt_audio_device *audio, rt_uint32_t bytes)
+{
+    struct rt_audio_configure *config = &audio->replay->config;
+    rt_uint32_t rate;
+
+    rate = config->samplerate * config->channels * (config->samplebits / 8);
+    if (rate == 0)
+        return 0;
+
+    return (rt_uint32_t)((rt_uint64_t)bytes * 1000000 / rate);
+}
+
 static rt_err_t _audio_flush_replay_frame(struct rt_audio_device *audio)
 {
     rt_err_t result = RT_EOK;
 
     if (audio->replay->write_index)
     {
+        rt_base_t level;
+
+        level = rt_hw_interrupt_disable();
+        audio->replay->queued += audio->replay->write_index;
+        rt_hw_interrupt_enable(level);
+
         result = rt_data_queue_push(&audio->replay->queue,
                                     (const void **)audio->replay->write_data,
                                     audio->replay->write_index,
                                     RT_WAITING_FOREVER);
+        if (result != RT_EOK)
+        {
+            level = rt_hw_interrupt_disable();
+            audio->replay->queued -= audio->replay->write_index;
+            rt_hw_interrupt_enable(level);
+            rt_mp_free(audio->replay->write_data);
+        }
 
         audio->replay->write_index = 0;
     }
@@ -312,6 +390,7 @@ static rt_err_t _audio_dev_open(struct rt_device *dev, rt_uint16_t oflag)
             audio->replay->write_index = 0;
             audio->replay->read_index = 0;
             audio->replay->pos = 0;
+            audio->replay->queued = 0;
             audio->replay->event = REPLAY_EVT_NONE;
         }
         dev->open_flag |= RT_DEVICE_OFLAG_WRONLY;
@@ -386,6 +465,15 @@ static rt_size_t _audio_dev_write(struct rt_device *dev, rt_off_t pos, const voi
     block_size = RT_AUDIO_REPLAY_MP_BLOCK_SIZE;
 
     rt_mutex_take(&audio->replay->lock, RT_WAITING_FOREVER);
+
+    /* the data is rendered by the callback */
+    if (audio->replay->render.render != RT_NULL)
+    {
+        rt_mutex_release(&audio->replay->lock);
+        rt_set_errno(-RT_EBUSY);
+        return 0;
+    }
+
     while (index < size)
     {
         /* request buffer from replay memory pool */
@@ -405,10 +493,26 @@ static rt_size_t _audio_dev_write(struct rt_device *dev, rt_off_t pos, const voi
 
         if (audio->replay->write_index == 0)
         {
-            rt_data_queue_push(&audio->replay->queue,
-                               audio->replay->write_data,
-                               block_size,
-                               RT_WAITING_FOREVER);
+            rt_base_t level;
+
+            level = rt_hw_interrupt_disable();
+            audio->replay->queued += block_size;
+            rt_hw_interrupt_enable(level);
+
+            if (rt_data_queue_push(&audio->replay->queue,
+                                   audio->replay->write_data,
+                                   block_size,
+                                   RT_WAITING_FOREVER) != RT_EOK)
+            {
+                level = rt_hw_interrupt_disable();
+                audio->replay->queued -= block_size;
+                rt_hw_interrupt_enable(level);
+                rt_mp_free(audio->replay->write_data);
+
+                /* the bytes of this write in the block are dropped */
+                index -= MIN(index, block_size);
+                break;
+            }
         }
     }
     rt_mutex_release(&audio->replay->lock);
@@ -456,6 +560,30 @@ static rt_err_t _audio_dev_control(struct rt_device *dev, int cmd, void *args)
             result = audio->ops->configure(audio, caps);
         }
 
+        /* keep the configure of output for latency */
+        if (result == RT_EOK && caps->main_type == AUDIO_TYPE_OUTPUT && audio->replay != RT_NULL)
+        {
+            struct rt_audio_configure *config = &audio->replay->config;
+
+            switch (caps->sub_type)
+            {
+            case AUDIO_DSP_PARAM:
+                *config = caps->udata.config;
+                break;
+            case AUDIO_DSP_SAMPLERATE:
+                config->samplerate = caps->udata.config.samplerate;
+                break;
+            case AUDIO_DSP_CHANNELS:
+                config->channels = caps->udata.config.channels;
+                break;
+            case AUDIO_DSP_SAMPLEBITS:
+                config->samplebits = caps->udata.config.samplebits;
+                break;
+            default:
+                break;
+            }
+        }
+
         break;
     }
 
@@ -493,6 +621,69 @@ static rt_err_t _audio_dev_control(struct rt_device *dev, int cmd, void *args)
         break;
     }
 
+    case AUDIO_CTL_SETRENDER:
+    {
+        struct rt_audio_render *render = (struct rt_audio_render *) args;
+        rt_base_t level;
+
+        if (audio->replay == RT_NULL)
+            return -RT_EIO;
+
+        /* the written data must be played out before the render takes over,
+         * otherwise the blocks are left in queue and the writer waits forever */
+        rt_mutex_take(&audio->replay->lock, RT_WAITING_FOREVER);
+        level = rt_hw_interrupt_disable();
+        if (render != RT_NULL && (audio->replay->queued || audio->replay->write_index))
+        {
+            result = -RT_EBUSY;
+        }
+        else if (render != RT_NULL)
+        {
+            /* the render is used in the context of rt_audio_tx_complete */
+            audio->replay->render = *render;
+        }
+        else
+        {
+            audio->replay->render.render = RT_NULL;
+        }
+        rt_hw_interrupt_enable(level);
+        rt_mutex_release(&audio->replay->lock);
+
+        break;
+    }
+
+    case AUDIO_CTL_GETSTAT:
+    {
+        struct rt_audio_replay_stat *stat = (struct rt_audio_replay_stat *) args;
+        rt_base_t level;
+
+        if (audio->replay == RT_NULL)
+            return -RT_EIO;
+
+        level = rt_hw_interrupt_disable();
+        *stat = audio->replay->stat;
+        rt_hw_interrupt_enable(level);
+
+        stat->latency = _audio_replay_latency(audio, stat->buffered);
+        stat->latency_max = _audio_replay_latency(audio, stat->buffered_max);
+
+        break;
+    }
+
+    case AUDIO_CTL_RESETSTAT:
+    {
+        rt_base_t level;
+
+        if (audio->replay == RT_NULL)
+            return -RT_EIO;
+
+        level = rt_hw_interrupt_disable();
+        memset(&audio->replay->stat, 0, sizeof(audio->replay->stat));
+        rt_hw_interrupt_enable(level);
+
+        break;
+    }
+
     default:
         break;
     }
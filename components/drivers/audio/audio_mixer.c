@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        wake up the writers when the mixer is detached
+ */
+
+/*
+ * The mixer of replay streams. Each stream is a lock-free ring of signed 16
+ * bits interleaved samples, which is resampled to the rate of codec by linear
+ * interpolation in Q16 and mixed into a 32 bits accumulator. The block is
+ * saturated into the DMA buffer by the render callback of audio device, so the
+ * samples are copied once from stream to codec.
+ *
+ * The loops work on flat arrays without branch in body, which are vectorized
+ * or turned into saturating instructions by compiler.
+ */
+
+#include <string.h>
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef RT_AUDIO_USING_MIXER
+
+#define MIXER_ONE            (1UL << 16)
+#define MIXER_FRAME_SIZE(channels)  ((channels) * sizeof(rt_int16_t))
+
+/* mix the stream of same rate and channels, the samples are added in place */
+static rt_uint32_t _mixer_stream_copy(struct rt_audio_mixer_stream *stream, rt_int32_t *accum,
+                                      rt_uint32_t count)
+{
+    rt_int32_t gain = stream->gain;
+    rt_int16_t *samples;
+    rt_uint32_t index, length, total = 0;
+
+    /* the data may wrap around the end of ring */
+    while (total < count)
+    {
+        length = rt_spsc_ringbuffer_get_peek(&stream->ring, (rt_uint8_t **)&samples) / sizeof(rt_int16_t);
+        if (length == 0)
+            break;
+        if (length > count - total)
+            length = count - total;
+
+        if (gain == RT_AUDIO_MIXER_GAIN_UNITY)
+        {
+            for (index = 0; index < length; index ++)
+                accum[total + index] += samples[index];
+        }
+        else
+        {
+            for (index = 0; index < length; index ++)
+                accum[total + index] += (samples[index] * gain) >> 15;
+        }
+
+        rt_spsc_ringbuffer_get_commit(&stream->ring, length * sizeof(rt_int16_t));
+        total += length;
+    }
+
+    return total / stream->mixer->channels;
+}
+
+/* get the next input frame, the mono frame is duplicated to both channels */
+static rt_bool_t _mixer_stream_fetch(struct rt_audio_mixer_stream *stream, rt_int16_t *frame)
+{
+    if (rt_spsc_ringbuffer_get(&stream->ring, (rt_uint8_t *)frame,
+                               MIXER_FRAME_SIZE(stream->channels)) == 0)
+        return RT_FALSE;
+
+    if (stream->channels == 1)
+        frame[1] = frame[0];
+
+    return RT_TRUE;
+}
+
+/* resample the stream by linear interpolation and mix it */
+static rt_uint32_t _mixer_stream_resample(struct rt_audio_mixer_stream *stream, rt_int32_t *accum,
+                                          rt_uint32_t frames)
+{
+    rt_uint16_t channels = stream->mixer->channels;
+    rt_int16_t (*frame)[2] = stream->frame;
+    rt_int16_t next[2];
+    rt_int32_t sample[2], fraction;
+    rt_uint32_t index;
+
+    for (index = 0; index < frames; index ++)
+    {
+        /* the phase is kept when starved, the stream goes on with next block */
+        while (stream->phase >= MIXER_ONE)
+        {
+            if (_mixer_stream_fetch(stream, next) == RT_FALSE)
+                return index;
+
+            stream->phase -= MIXER_ONE;
+            frame[0][0] = frame[1][0];
+            frame[0][1] = frame[1][1];
+            frame[1][0] = next[0];
+            frame[1][1] = next[1];
+        }
+
+        /* Q15 fraction keeps the product in 32 bits */
+        fraction = stream->phase >> 1;
+        sample[0] = frame[0][0] + (((frame[1][0] - frame[0][0]) * fraction) >> 15);
+        sample[1] = frame[0][1] + (((frame[1][1] - frame[0][1]) * fraction) >> 15);
+
+        if (channels == 1)
+        {
+            accum[index] += (((sample[0] + sample[1]) >> 1) * stream->gain) >> 15;
+        }
+        else
+        {
+            accum[index * 2] += (sample[0] * stream->gain) >> 15;
+            accum[index * 2 + 1] += (sample[1] * stream->gain) >> 15;
+        }
+
+        stream->phase += stream->step;
+    }
+
+    return frames;
+}
+
+static void _mixer_stream_mix(struct rt_audio_mixer_stream *stream, rt_int32_t *accum, rt_uint32_t frames)
+{
+    rt_uint32_t mixed;
+
+    if (stream->step == MIXER_ONE && stream->channels == stream->mixer->channels)
+        mixed = _mixer_stream_copy(stream, accum, frames * stream->channels);
+    else
+        mixed = _mixer_stream_resample(stream, accum, frames);
+
+    if (mixed == frames)
+    {
+        stream->running = RT_TRUE;
+    }
+    else if (stream->running || mixed > 0)
+    {
+        /* the stream was drained in block */
+        stream->underruns ++;
+        stream->running = RT_FALSE;
+    }
+
+    /* wake up the writer for the space */
+    if (mixed > 0 && stream->waiting > 0)
+    {
+        stream->waiting --;
+        rt_sem_release(&stream->sem);
+    }
+}
+
+/* saturate the accumulator into 16 bits samples */
+static void _mixer_saturate(const rt_int32_t *accum, rt_int16_t *samples, rt_uint32_t count)
+{
+    rt_uint32_t index;
+    rt_int32_t value;
+
+    for (index = 0; index < count; index ++)
+    {
+        value = accum[index];
+        value = value > 32767 ? 32767 : value;
+        value = value < -32768 ? -32768 : value;
+        samples[index] = (rt_int16_t)value;
+    }
+}
+
+static rt_size_t _mixer_render(struct rt_audio_device *audio, void *buffer, rt_size_t size, void *param)
+{
+    struct rt_audio_mixer *mixer = (struct rt_audio_mixer *)param;
+    struct rt_audio_mixer_stream *stream;
+    rt_uint32_t frames, count;
+    rt_list_t *node;
+
+    frames = size / MIXER_FRAME_SIZE(mixer->channels);
+    if (frames > mixer->frames)
+        frames = mixer->frames;
+    count = frames * mixer->channels;
+
+    if (rt_list_isempty(&mixer->streams))
+        return 0;
+
+    memset(mixer->accum, 0, count * sizeof(rt_int32_t));
+    rt_list_for_each(node, &mixer->streams)
+    {
+        stream = rt_list_entry(node, struct rt_audio_mixer_stream, list);
+        _mixer_stream_mix(stream, mixer->accum, frames);
+    }
+    _mixer_saturate(mixer->accum, (rt_int16_t *)buffer, count);
+
+    return count * sizeof(rt_int16_t);
+}
+
+/**
+ * This function initializes the mixer and sets it as the render of audio
+ * device, the replay is started by AUDIO_CTL_START.
+ *
+ * @param mixer the mixer.
+ * @param audio the audio device opened for replay.
+ * @param samplerate the sample rate configured to codec.
+ * @param channels the channels configured to codec, 1 or 2.
+ *
+ * @return RT_EOK on successful, -RT_EINVAL on invalid format or -RT_ENOMEM on
+ *         failed to allocate accumulator.
+ */
+rt_err_t rt_audio_mixer_init(struct rt_audio_mixer *mixer, struct rt_audio_device *audio,
+                             rt_uint32_t samplerate, rt_uint16_t channels)
+{
+    struct rt_audio_render render;
+    rt_err_t result;
+
+    RT_ASSERT(mixer != RT_NULL);
+    RT_ASSERT(audio != RT_NULL);
+
+    if (audio->replay == RT_NULL || samplerate == 0 || channels < 1 || channels > 2)
+        return -RT_EINVAL;
+
+    mixer->audio = audio;
+    mixer->samplerate = samplerate;
+    mixer->channels = channels;
+    rt_list_init(&mixer->streams);
+
+    /* the accumulator holds a block of DMA buffer */
+    mixer->frames = audio->replay->buf_info.block_size / MIXER_FRAME_SIZE(channels);
+    mixer->accum = (rt_int32_t *)rt_malloc(mixer->frames * channels * sizeof(rt_int32_t));
+    if (mixer->accum == RT_NULL)
+        return -RT_ENOMEM;
+
+    render.render = _mixer_render;
+    render.param = mixer;
+    result = rt_device_control(&audio->parent, AUDIO_CTL_SETRENDER, &render);
+    if (result != RT_EOK)
+    {
+        rt_free(mixer->accum);
+        mixer->accum = RT_NULL;
+    }
+
+    return result;
+}
+RTM_EXPORT(rt_audio_mixer_init);
+
+/**
+ * This function removes the mixer from audio device, the streams attached are
+ * not mixed any more and the writers waiting are woken up.
+ *
+ * @param mixer the mixer.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_audio_mixer_detach(struct rt_audio_mixer *mixer)
+{
+    struct rt_audio_mixer_stream *stream;
+    rt_base_t level;
+
+    RT_ASSERT(mixer != RT_NULL);
+
+    rt_device_control(&mixer->audio->parent, AUDIO_CTL_SETRENDER, RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    while (!rt_list_isempty(&mixer->streams))
+    {
+        stream = rt_list_entry(mixer->streams.next, struct rt_audio_mixer_stream, list);
+        rt_list_remove(&stream->list);
+        stream->mixer = RT_NULL;
+
+        /* the blocked writers return for the stream is detached */
+        while (stream->waiting > 0)
+        {
+            stream->waiting --;
+            rt_sem_release(&stream->sem);
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    rt_free(mixer->accum);
+    mixer->accum = RT_NULL;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_audio_mixer_detach);
+
+/**
+ * This function initializes the stream of signed 16 bits interleaved samples.
+ *
+ * @param stream the stream.
+ * @param samplerate the sample rate of stream.
+ * @param channels the channels of stream, 1 or 2.
+ * @param pool the buffer of ring.
+ * @param size the size of pool, it's rounded down to the frames.
+ *
+ * @return RT_EOK on successful, -RT_EINVAL on invalid format.
+ */
+rt_err_t rt_audio_mixer_stream_init(struct rt_audio_mixer_stream *stream,
+                                    rt_uint32_t samplerate, rt_uint16_t channels,
+                                    rt_uint8_t *pool, rt_uint32_t size)
+{
+    RT_ASSERT(stream != RT_NULL);
+    RT_ASSERT(pool != RT_NULL);
+
+    if (samplerate == 0 || channels < 1 || channels > 2)
+        return -RT_EINVAL;
+
+    /* the ring never wraps inside a frame */
+    size -= size % MIXER_FRAME_SIZE(channels);
+    if (size == 0)
+        return -RT_EINVAL;
+
+    rt_memset(stream, 0, sizeof(struct rt_audio_mixer_stream));
+    rt_list_init(&stream->list);
+    rt_spsc_ringbuffer_init(&stream->ring, pool, size);
+    rt_sem_init(&stream->sem, "mixer", 0, RT_IPC_FLAG_FIFO);
+
+    stream->samplerate = samplerate;
+    stream->channels = channels;
+    stream->gain = RT_AUDIO_MIXER_GAIN_UNITY;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_audio_mixer_stream_init);
+
+/**
+ * This function sets the gain of stream.
+ *
+ * @param stream the stream.
+ * @param gain the gain in Q15, RT_AUDIO_MIXER_GAIN_UNITY keeps the samples.
+ * It's limited to 0 ~ RT_AUDIO_MIXER_GAIN_MAX.
+ */
+void rt_audio_mixer_stream_set_gain(struct rt_audio_mixer_stream *stream, rt_int32_t gain)
+{
+    RT_ASSERT(stream != RT_NULL);
+
+    if (gain < 0)
+        gain = 0;
+    if (gain > RT_AUDIO_MIXER_GAIN_MAX)
+        gain = RT_AUDIO_MIXER_GAIN_MAX;
+    stream->gain = gain;
+}
+RTM_EXPORT(rt_audio_mixer_stream_set_gain);
+
+/**
+ * This function attaches the stream to mixer, the samples in stream are
+ * played from the next block.
+ *
+ * @param mixer the mixer.
+ * @param stream the stream.
+ *
+ * @return RT_EOK on successful, -RT_EBUSY on the stream has been attached.
+ */
+rt_err_t rt_audio_mixer_stream_attach(struct rt_audio_mixer *mixer, struct rt_audio_mixer_stream *stream)
+{
+    rt_base_t level;
+
+    RT_ASSERT(mixer != RT_NULL);
+    RT_ASSERT(stream != RT_NULL);
+
+    if (stream->mixer != RT_NULL)
+        return -RT_EBUSY;
+
+    /* step of input frames in Q16, two frames are fetched for the first output */
+    stream->step = (rt_uint32_t)(((rt_uint64_t)stream->samplerate << 16) / mixer->samplerate);
+    stream->phase = 2 * MIXER_ONE;
+    stream->running = RT_FALSE;
+    rt_memset(stream->frame, 0, sizeof(stream->frame));
+
+    level = rt_hw_interrupt_disable();
+    stream->mixer = mixer;
+    rt_list_insert_before(&mixer->streams, &stream->list);
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_audio_mixer_stream_attach);
+
+/**
+ * This function detaches the stream from mixer, the writer waiting is woken up.
+ *
+ * @param stream the stream.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_audio_mixer_stream_detach(struct rt_audio_mixer_stream *stream)
+{
+    rt_base_t level;
+
+    RT_ASSERT(stream != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_remove(&stream->list);
+    stream->mixer = RT_NULL;
+    while (stream->waiting > 0)
+    {
+        stream->waiting --;
+        rt_sem_release(&stream->sem);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_audio_mixer_stream_detach);
+
+/**
+ * This function writes the samples into stream, the writer waits for the
+ * space when the ring is full.
+ *
+ * @param stream the stream.
+ * @param buffer the interleaved samples.
+ * @param size the size of samples, it's rounded down to the frames.
+ * @param timeout the waiting time for each space, RT_WAITING_NO for no waiting.
+ *
+ * @return the bytes written.
+ */
+rt_size_t rt_audio_mixer_stream_write(struct rt_audio_mixer_stream *stream,
+                                      const void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    rt_uint32_t frame_size, length;
+    rt_size_t index = 0;
+    rt_base_t level;
+
+    RT_ASSERT(stream != RT_NULL);
+
+    frame_size = MIXER_FRAME_SIZE(stream->channels);
+    size -= size % frame_size;
+
+    while (index < size)
+    {
+        /* the frame is never split by the end of ring */
+        length = rt_spsc_ringbuffer_space_len(&stream->ring);
+        length -= length % frame_size;
+        if (length > size - index)
+            length = size - index;
+
+        if (length > 0)
+        {
+            index += rt_spsc_ringbuffer_put(&stream->ring, (const rt_uint8_t *)buffer + index, length);
+            continue;
+        }
+
+        if (timeout == RT_WAITING_NO)
+            break;
+
+        level = rt_hw_interrupt_disable();
+        /* the detach wakes up the writers waiting only */
+        if (stream->mixer == RT_NULL)
+        {
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+        if (rt_spsc_ringbuffer_space_len(&stream->ring) >= frame_size)
+        {
+            rt_hw_interrupt_enable(level);
+            continue;
+        }
+        stream->waiting ++;
+        rt_hw_interrupt_enable(level);
+
+        if (rt_sem_take(&stream->sem, timeout) != RT_EOK)
+        {
+            /* the release may come after timeout */
+            level = rt_hw_interrupt_disable();
+            if (stream->waiting > 0)
+                stream->waiting --;
+            else
+                rt_sem_take(&stream->sem, RT_WAITING_NO);
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+    }
+
+    return index;
+}
+RTM_EXPORT(rt_audio_mixer_stream_write);
+
+#endif /* RT_AUDIO_USING_MIXER */
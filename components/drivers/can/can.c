@@ -7,6 +7,7 @@
  * Date           Author            Notes
  * 2015-05-14     aubrcool@qq.com   first version
  * 2015-07-06     Bernard           code cleanup and remove RT_CAN_USING_LED;
+ * 2026-10-19     agent             add rx mailbox with ID hash
  */
 
 #include <rthw.h>
@@ -40,6 +41,230 @@ static rt_err_t rt_can_init(struct rt_device *dev)
     return result;
 }
 
+#ifdef RT_CAN_USING_MAILBOX
+rt_inline int _can_mailbox_hash(rt_uint32_t id, rt_uint8_t ide)
+{
+    return (id ^ (id >> 11) ^ ide) % RT_CAN_MAILBOX_HASH_SIZE;
+}
+
+rt_inline rt_uint32_t _can_timestamp(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static void _can_mailbox_put(struct rt_can_mailbox *mb, const struct rt_can_msg *msg, rt_uint32_t timestamp)
+{
+    volatile struct rt_can_frame *latest = &mb->latest;
+    struct rt_can_frame frame;
+
+    mb->received ++;
+
+    if (rt_spsc_ringbuffer_get_size(&mb->ring) == 0)
+    {
+        /* the reader retries if the sequence changes during copying */
+        mb->sequence ++;
+        latest->msg = *msg;
+        latest->timestamp = timestamp;
+        mb->sequence ++;
+    }
+    else if (rt_spsc_ringbuffer_space_len(&mb->ring) >= sizeof(struct rt_can_frame))
+    {
+        frame.msg = *msg;
+        frame.timestamp = timestamp;
+        rt_spsc_ringbuffer_put(&mb->ring, (const rt_uint8_t *)&frame, sizeof(struct rt_can_frame));
+    }
+    else
+    {
+        mb->dropped ++;
+        return;
+    }
+
+    if (mb->indicate != RT_NULL)
+        mb->indicate(mb, mb->args);
+}
+
+/* dispatch the frame to mailboxes, return the number of mailboxes received it */
+static int _can_mailbox_dispatch(struct rt_can_device *can, const struct rt_can_msg *msg)
+{
+    struct rt_can_mailbox *mb;
+    rt_uint32_t timestamp;
+    int count = 0;
+
+    timestamp = _can_timestamp();
+
+    for (mb = can->mailbox_hash[_can_mailbox_hash(msg->id, msg->ide)]; mb != RT_NULL; mb = mb->next)
+    {
+        if (mb->id == msg->id && mb->ide == msg->ide)
+        {
+            _can_mailbox_put(mb, msg, timestamp);
+            count ++;
+        }
+    }
+
+    for (mb = can->mailbox_mask; mb != RT_NULL; mb = mb->next)
+    {
+        if (((mb->id ^ msg->id) & mb->mask) == 0 && mb->ide == msg->ide)
+        {
+            _can_mailbox_put(mb, msg, timestamp);
+            count ++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function initializes the CAN rx mailbox.
+ *
+ * @param mb the mailbox.
+ * @param id the ID to receive.
+ * @param mask the mask of ID, RT_CAN_MAILBOX_ID_MASK for exact ID.
+ * @param ide RT_CAN_STDID or RT_CAN_EXTID.
+ * @param frames the ring of frames, or RT_NULL for latest value mode.
+ * @param size the number of frames in ring.
+ */
+void rt_can_mailbox_init(struct rt_can_mailbox *mb, rt_uint32_t id, rt_uint32_t mask, rt_uint8_t ide,
+                         struct rt_can_frame *frames, rt_size_t size)
+{
+    RT_ASSERT(mb != RT_NULL);
+
+    rt_memset(mb, 0, sizeof(struct rt_can_mailbox));
+    mb->mask = mask & RT_CAN_MAILBOX_ID_MASK;
+    mb->id   = id & mb->mask;
+    mb->ide  = ide;
+
+    if (frames != RT_NULL && size > 0)
+        rt_spsc_ringbuffer_init(&mb->ring, (rt_uint8_t *)frames, size * sizeof(struct rt_can_frame));
+}
+RTM_EXPORT(rt_can_mailbox_init);
+
+/**
+ * This function sets the callback invoked in ISR after a frame received.
+ */
+void rt_can_mailbox_set_indicate(struct rt_can_mailbox *mb, rt_can_mailbox_ind indicate, void *args)
+{
+    rt_base_t level;
+
+    RT_ASSERT(mb != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    mb->indicate = indicate;
+    mb->args = args;
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_can_mailbox_set_indicate);
+
+/**
+ * This function attaches the mailbox to CAN device, the frames matched are
+ * received by mailbox instead of the rx fifo.
+ */
+rt_err_t rt_can_mailbox_attach(rt_device_t dev, struct rt_can_mailbox *mb)
+{
+    struct rt_can_device *can = (struct rt_can_device *)dev;
+    struct rt_can_mailbox **head;
+    rt_base_t level;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(mb != RT_NULL);
+
+    if (mb->mask == RT_CAN_MAILBOX_ID_MASK)
+        head = &can->mailbox_hash[_can_mailbox_hash(mb->id, mb->ide)];
+    else
+        head = &can->mailbox_mask;
+
+    level = rt_hw_interrupt_disable();
+    mb->next = *head;
+    *head = mb;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_can_mailbox_attach);
+
+/**
+ * This function detaches the mailbox from CAN device.
+ */
+rt_err_t rt_can_mailbox_detach(rt_device_t dev, struct rt_can_mailbox *mb)
+{
+    struct rt_can_device *can = (struct rt_can_device *)dev;
+    struct rt_can_mailbox **node;
+    rt_err_t result = -RT_ERROR;
+    rt_base_t level;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(mb != RT_NULL);
+
+    if (mb->mask == RT_CAN_MAILBOX_ID_MASK)
+        node = &can->mailbox_hash[_can_mailbox_hash(mb->id, mb->ide)];
+    else
+        node = &can->mailbox_mask;
+
+    level = rt_hw_interrupt_disable();
+    for (; *node != RT_NULL; node = &(*node)->next)
+    {
+        if (*node == mb)
+        {
+            *node = mb->next;
+            mb->next = RT_NULL;
+            result = RT_EOK;
+            break;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+RTM_EXPORT(rt_can_mailbox_detach);
+
+/**
+ * This function reads the frames from mailbox, it's called by one reader.
+ *
+ * @param mb the mailbox.
+ * @param frames the buffer of frames.
+ * @param count the number of frames can be read.
+ *
+ * @return the number of frames read. In latest value mode, it's 1 if a new
+ * frame received since last read, or 0.
+ */
+rt_size_t rt_can_mailbox_read(struct rt_can_mailbox *mb, struct rt_can_frame *frames, rt_size_t count)
+{
+    volatile struct rt_can_frame *latest = &mb->latest;
+    rt_uint32_t sequence;
+
+    RT_ASSERT(mb != RT_NULL);
+    RT_ASSERT(frames != RT_NULL);
+
+    if (count == 0)
+        return 0;
+
+    if (rt_spsc_ringbuffer_get_size(&mb->ring) != 0)
+    {
+        /* the ring holds the whole frames only */
+        return rt_spsc_ringbuffer_get(&mb->ring, (rt_uint8_t *)frames,
+                                      count * sizeof(struct rt_can_frame)) / sizeof(struct rt_can_frame);
+    }
+
+    do
+    {
+        sequence = mb->sequence;
+        if (sequence == mb->sequence_read)
+            return 0;
+
+        frames->msg = latest->msg;
+        frames->timestamp = latest->timestamp;
+    } while ((sequence & 0x01) || sequence != mb->sequence);
+
+    mb->sequence_read = sequence;
+
+    return 1;
+}
+RTM_EXPORT(rt_can_mailbox_read);
+#endif /*RT_CAN_USING_MAILBOX*/
+
 /*
  * can interrupt routines
  */
@@ -738,6 +963,10 @@ rt_err_t rt_hw_can_register(struct rt_can_device    *can,
     can->status_indicate.ind  = RT_NULL;
     can->status_indicate.args = RT_NULL;
     rt_memset(&can->status, 0, sizeof(can->status));
+#ifdef RT_CAN_USING_MAILBOX
+    rt_memset(can->mailbox_hash, 0, sizeof(can->mailbox_hash));
+    can->mailbox_mask = RT_NULL;
+#endif
 
     device->user_data   = data;
 
@@ -785,6 +1014,18 @@ void rt_hw_can_isr(struct rt_can_device *can, int event)
         ch = can->ops->recvmsg(can, &tmpmsg, no);
         if (ch == -1) break;
 
+#ifdef RT_CAN_USING_MAILBOX
+        /* the frame received by mailbox doesn't go to rx fifo */
+        if (_can_mailbox_dispatch(can, &tmpmsg) > 0)
+        {
+            level = rt_hw_interrupt_disable();
+            can->status.rcvpkg++;
+            can->status.rcvchange = 1;
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+#endif
+
         /* disable interrupt */
         level = rt_hw_interrupt_disable();
         can->status.rcvpkg++;
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2017-05-09     Urey         first version
  * 2019-07-09     Zero-Free    improve device ops interface and data flows
+ * 2026-10-19     agent        add render callback, replay statistics and mixer
  *
  */
 
@@ -23,6 +24,9 @@
 #define AUDIO_CTL_START                     _AUDIO_CTL(3)
 #define AUDIO_CTL_STOP                      _AUDIO_CTL(4)
 #define AUDIO_CTL_GETBUFFERINFO             _AUDIO_CTL(5)
+#define AUDIO_CTL_SETRENDER                 _AUDIO_CTL(6)
+#define AUDIO_CTL_GETSTAT                   _AUDIO_CTL(7)
+#define AUDIO_CTL_RESETSTAT                 _AUDIO_CTL(8)
 
 /* Audio Device Types */
 #define AUDIO_TYPE_QUERY                    0x00
@@ -130,6 +134,32 @@ struct rt_audio_caps
     } udata;
 };
 
+/*
+ * render the replay data into the DMA buffer directly, it's invoked in the
+ * context of rt_audio_tx_complete and returns the bytes rendered, the rest of
+ * block is filled with silence. AUDIO_CTL_SETRENDER fails with -RT_EBUSY
+ * while the written data isn't played out, and the write fails with
+ * RT_EBUSY while the render is set.
+ */
+typedef rt_size_t (*rt_audio_render_t)(struct rt_audio_device *audio, void *buffer, rt_size_t size, void *param);
+
+struct rt_audio_render
+{
+    rt_audio_render_t render;
+    void *param;
+};
+
+struct rt_audio_replay_stat
+{
+    rt_uint32_t blocks;                 /* blocks sent to codec */
+    rt_uint32_t underruns;              /* blocks filled with silence partly */
+    rt_uint32_t silences;               /* blocks of silence for no data */
+    rt_uint32_t buffered;               /* bytes queued and in DMA buffer */
+    rt_uint32_t buffered_max;
+    rt_uint32_t latency;                /* us of the buffered bytes */
+    rt_uint32_t latency_max;
+};
+
 struct rt_audio_replay
 {
     struct rt_mempool *mp;
@@ -143,6 +173,11 @@ struct rt_audio_replay
     rt_uint32_t pos;
     rt_uint8_t event;
     rt_bool_t activated;
+
+    struct rt_audio_render render;
+    struct rt_audio_configure config;   /* the configure of output */
+    rt_uint32_t queued;                 /* bytes in replay queue */
+    struct rt_audio_replay_stat stat;
 };
 
 struct rt_audio_record
@@ -163,6 +198,56 @@ rt_err_t    rt_audio_register(struct rt_audio_device *audio, const char *name, r
 void        rt_audio_tx_complete(struct rt_audio_device *audio);
 void        rt_audio_rx_done(struct rt_audio_device *audio, rt_uint8_t *pbuf, rt_size_t len);
 
+#ifdef RT_AUDIO_USING_MIXER
+#define RT_AUDIO_MIXER_GAIN_UNITY   (1 << 15)   /* gain in Q15 */
+#define RT_AUDIO_MIXER_GAIN_MAX     (2 << 15)   /* the product of sample and gain fits in 32 bits */
+
+struct rt_audio_mixer
+{
+    struct rt_audio_device *audio;
+    rt_list_t streams;
+
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_uint16_t frames;                 /* frames of accumulator */
+    rt_int32_t *accum;
+};
+
+/* the stream of signed 16 bits interleaved samples */
+struct rt_audio_mixer_stream
+{
+    rt_list_t list;
+    struct rt_audio_mixer *mixer;
+    struct rt_spsc_ringbuffer ring;
+
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_bool_t running;
+    rt_int32_t gain;
+
+    rt_uint32_t step;                   /* input frames per output frame in Q16 */
+    rt_uint32_t phase;                  /* position between frames in Q16 */
+    rt_int16_t frame[2][2];             /* the input frames around phase */
+
+    rt_uint16_t waiting;
+    struct rt_semaphore sem;
+
+    rt_uint32_t underruns;
+};
+
+rt_err_t rt_audio_mixer_init(struct rt_audio_mixer *mixer, struct rt_audio_device *audio,
+                             rt_uint32_t samplerate, rt_uint16_t channels);
+rt_err_t rt_audio_mixer_detach(struct rt_audio_mixer *mixer);
+rt_err_t rt_audio_mixer_stream_init(struct rt_audio_mixer_stream *stream,
+                                    rt_uint32_t samplerate, rt_uint16_t channels,
+                                    rt_uint8_t *pool, rt_uint32_t size);
+void     rt_audio_mixer_stream_set_gain(struct rt_audio_mixer_stream *stream, rt_int32_t gain);
+rt_err_t rt_audio_mixer_stream_attach(struct rt_audio_mixer *mixer, struct rt_audio_mixer_stream *stream);
+rt_err_t rt_audio_mixer_stream_detach(struct rt_audio_mixer_stream *stream);
+rt_size_t rt_audio_mixer_stream_write(struct rt_audio_mixer_stream *stream,
+                                      const void *buffer, rt_size_t size, rt_int32_t timeout);
+#endif /* RT_AUDIO_USING_MIXER */
+
 /* Device Control Commands */
 #define CODEC_CMD_RESET             0
 #define CODEC_CMD_SET_VOLUME        1
@@ -7,6 +7,7 @@
  * Date           Author            Notes
  * 2015-05-14     aubrcool@qq.com   first version
  * 2015-07-06     Bernard           remove RT_CAN_USING_LED.
+ * 2026-10-19     agent             add rx mailbox with ID hash
  */
 
 #ifndef CAN_H_
@@ -20,6 +21,9 @@
 #ifndef RT_CANSND_BOX_NUM
 #define RT_CANSND_BOX_NUM   1
 #endif
+#ifndef RT_CAN_MAILBOX_HASH_SIZE
+#define RT_CAN_MAILBOX_HASH_SIZE    32
+#endif
 
 enum CANBAUD
 {
@@ -183,6 +187,7 @@ typedef struct rt_can_status_ind_type
     void *args;
 } *rt_can_status_ind_type_t;
 typedef void (*rt_can_bus_hook)(struct rt_can_device *);
+struct rt_can_mailbox;
 struct rt_can_device
 {
     struct rt_device parent;
@@ -201,6 +206,10 @@ struct rt_can_device
 #ifdef RT_CAN_USING_BUS_HOOK
     rt_can_bus_hook bus_hook;
 #endif /*RT_CAN_USING_BUS_HOOK*/
+#ifdef RT_CAN_USING_MAILBOX
+    struct rt_can_mailbox *mailbox_hash[RT_CAN_MAILBOX_HASH_SIZE];  /* the mailboxes of exact ID */
+    struct rt_can_mailbox *mailbox_mask;                            /* the mailboxes of masked ID */
+#endif
     struct rt_mutex lock;
     void *can_rx;
     void *can_tx;
@@ -227,6 +236,46 @@ struct rt_can_msg
 };
 typedef struct rt_can_msg *rt_can_msg_t;
 
+#ifdef RT_CAN_USING_MAILBOX
+/* the frame received with timestamp */
+struct rt_can_frame
+{
+    struct rt_can_msg msg;
+    rt_uint32_t timestamp;              /* OS tick, or CPU time with RT_USING_CPUTIME */
+};
+
+typedef void (*rt_can_mailbox_ind)(struct rt_can_mailbox *mb, void *args);
+
+/**
+ * The mailbox receives the frames of an ID, or the IDs matched by mask. The
+ * frames are put into the lock-free ring of mailbox in ISR and read by one
+ * reader without disabling interrupt. In latest value mode, the mailbox keeps
+ * the last frame only, which suits the periodic signals.
+ */
+struct rt_can_mailbox
+{
+    struct rt_can_mailbox *next;
+
+    rt_uint32_t id;
+    rt_uint32_t mask;                   /* 0x1FFFFFFF for exact ID */
+    rt_uint8_t ide;
+
+    struct rt_spsc_ringbuffer ring;     /* the frames, empty in latest value mode */
+
+    volatile rt_uint32_t sequence;      /* odd while latest is being written */
+    rt_uint32_t sequence_read;
+    struct rt_can_frame latest;
+
+    rt_can_mailbox_ind indicate;        /* invoked in ISR after received */
+    void *args;
+
+    rt_uint32_t received;
+    rt_uint32_t dropped;                /* the frames dropped on ring full */
+};
+
+#define RT_CAN_MAILBOX_ID_MASK      0x1FFFFFFF
+#endif
+
 struct rt_can_msg_list
 {
     struct rt_list_node list;
@@ -283,5 +332,14 @@ rt_err_t rt_hw_can_register(struct rt_can_device    *can,
                             const struct rt_can_ops *ops,
                             void                    *data);
 void rt_hw_can_isr(struct rt_can_device *can, int event);
+
+#ifdef RT_CAN_USING_MAILBOX
+void rt_can_mailbox_init(struct rt_can_mailbox *mb, rt_uint32_t id, rt_uint32_t mask, rt_uint8_t ide,
+                         struct rt_can_frame *frames, rt_size_t size);
+void rt_can_mailbox_set_indicate(struct rt_can_mailbox *mb, rt_can_mailbox_ind indicate, void *args);
+rt_err_t rt_can_mailbox_attach(rt_device_t dev, struct rt_can_mailbox *mb);
+rt_err_t rt_can_mailbox_detach(rt_device_t dev, struct rt_can_mailbox *mb);
+rt_size_t rt_can_mailbox_read(struct rt_can_mailbox *mb, struct rt_can_frame *frames, rt_size_t count);
+#endif
 #endif /*_CAN_H*/
 
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author		Notes
  * 2011-07-25     weety		first version
+ * 2026-10-19     agent		add pre-erase command
  */
 
 #ifndef __CMD_H__
@@ -82,6 +83,7 @@ extern "C" {
   /* Application commands */
 #define SD_APP_SET_BUS_WIDTH      6   /* ac   [1:0] bus width    R1  */
 #define SD_APP_SEND_NUM_WR_BLKS  22   /* adtc                    R1  */
+#define SD_APP_SET_WR_BLK_ERASE_COUNT 23 /* ac [22:0] blocks     R1  */
 #define SD_APP_OP_COND           41   /* bcr  [31:0] OCR         R3  */
 #define SD_APP_SEND_SCR          51   /* adtc                    R1  */
 
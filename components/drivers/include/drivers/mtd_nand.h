@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2011-12-05     Bernard      the first version
  * 2011-04-02     prife        add mark_badblock and check_block
+ * 2026-10-19     agent        add background service, statistics and RAM simulated device
+ * 2026-10-19     agent        add programming pages in batch
  */
 
 /*
@@ -29,6 +31,36 @@ struct rt_mtd_nand_driver_ops;
 #define RT_MTD_ESRC         105   /* source issue */
 #define RT_MTD_EECC_CORRECT 106   /* ECC error but correct */
 
+#ifdef RT_MTD_NAND_USING_SERVICE
+/* the operations counted in statistics */
+#define RT_MTD_NAND_OP_READ     0
+#define RT_MTD_NAND_OP_WRITE    1
+#define RT_MTD_NAND_OP_MOVE     2
+#define RT_MTD_NAND_OP_ERASE    3
+#define RT_MTD_NAND_OP_BATCH    4
+
+struct rt_mtd_nand_service;
+
+/**
+ * The statistics of MTD Nand device. The write amplification is
+ * (page_write + page_gc + page_move) / page_write, page_gc is the pages
+ * written by the garbage collection which runs in background service.
+ */
+struct rt_mtd_nand_stat
+{
+    rt_uint32_t page_read;
+    rt_uint32_t page_write;         /* pages written by users */
+    rt_uint32_t page_gc;            /* pages written by garbage collection */
+    rt_uint32_t page_move;          /* pages moved by copy back */
+    rt_uint32_t batch_write;        /* operations programming pages in batch */
+    rt_uint32_t block_erase;
+    rt_uint32_t error;              /* failed write, move and erase */
+
+    rt_uint32_t block_num;
+    const rt_uint32_t *erase_count; /* erase count of each block */
+};
+#endif
+
 struct rt_mtd_nand_device
 {
     struct rt_device parent;
@@ -47,6 +79,21 @@ struct rt_mtd_nand_device
 
     /* operations interface */
     const struct rt_mtd_nand_driver_ops *ops;
+
+#ifdef RT_MTD_NAND_USING_SERVICE
+    struct rt_mtd_nand_service *service;
+    struct rt_mutex lock;           /* serialize the operations of service and other callers */
+#endif
+};
+
+/* the page programmed in batch */
+struct rt_mtd_nand_page
+{
+    rt_off_t page;
+    const rt_uint8_t *data;
+    rt_uint32_t data_len;
+    const rt_uint8_t *spare;
+    rt_uint32_t spare_len;
 };
 
 struct rt_mtd_nand_driver_ops
@@ -67,10 +114,53 @@ struct rt_mtd_nand_driver_ops
     rt_err_t (*erase_block)(struct rt_mtd_nand_device *device, rt_uint32_t block);
     rt_err_t (*check_block)(struct rt_mtd_nand_device *device, rt_uint32_t block);
     rt_err_t (*mark_badblock)(struct rt_mtd_nand_device *device, rt_uint32_t block);
+
+    /* optional, program the continuous pages in one block by one operation,
+     * such as the cache program */
+    rt_err_t (*write_pages)(struct rt_mtd_nand_device *device,
+                            const struct rt_mtd_nand_page *pages, rt_uint32_t count);
 };
 
 rt_err_t rt_mtd_nand_register_device(const char *name, struct rt_mtd_nand_device *device);
 
+#ifdef RT_MTD_NAND_USING_SERVICE
+rt_err_t rt_mtd_nand_service_init(struct rt_mtd_nand_device *device, rt_uint32_t queue_num, rt_uint8_t priority);
+void rt_mtd_nand_service_kick(struct rt_mtd_nand_device *device);
+rt_err_t rt_mtd_nand_set_gc(struct rt_mtd_nand_device *device,
+                            rt_err_t (*gc)(struct rt_mtd_nand_device *device, void *param),
+                            void *param, rt_int32_t period);
+
+rt_err_t rt_mtd_nand_write_async(struct rt_mtd_nand_device *device,
+                                 rt_off_t page,
+                                 const rt_uint8_t *data, rt_uint32_t data_len,
+                                 const rt_uint8_t *spare, rt_uint32_t spare_len);
+rt_err_t rt_mtd_nand_erase_async(struct rt_mtd_nand_device *device, rt_uint32_t block);
+rt_err_t rt_mtd_nand_read_sync(struct rt_mtd_nand_device *device,
+                               rt_off_t page,
+                               rt_uint8_t *data, rt_uint32_t data_len,
+                               rt_uint8_t *spare, rt_uint32_t spare_len);
+rt_err_t rt_mtd_nand_sync(struct rt_mtd_nand_device *device);
+
+rt_err_t rt_mtd_nand_get_stat(struct rt_mtd_nand_device *device, struct rt_mtd_nand_stat *stat);
+rt_uint32_t rt_mtd_nand_erase_count(struct rt_mtd_nand_device *device, rt_uint32_t block);
+void rt_mtd_nand_stat_update(struct rt_mtd_nand_device *device, int op, rt_uint32_t index, rt_err_t result);
+#endif
+
+#ifdef RT_MTD_NAND_USING_RAM
+struct rt_mtd_nand_device *rt_mtd_nand_ram_create(const char *name,
+                                                 rt_uint16_t page_size, rt_uint16_t oob_size,
+                                                 rt_uint32_t pages_per_block, rt_uint16_t block_total);
+#endif
+
+/* the lock of operations, it's only used in this file */
+#ifdef RT_MTD_NAND_USING_SERVICE
+#define MTD_NAND_LOCK(device)       rt_mutex_take(&((device)->lock), RT_WAITING_FOREVER)
+#define MTD_NAND_UNLOCK(device)     rt_mutex_release(&((device)->lock))
+#else
+#define MTD_NAND_LOCK(device)
+#define MTD_NAND_UNLOCK(device)
+#endif
+
 rt_inline rt_uint32_t rt_mtd_nand_read_id(struct rt_mtd_nand_device *device)
 {
     RT_ASSERT(device->ops->read_id);
@@ -83,8 +173,18 @@ rt_inline rt_err_t rt_mtd_nand_read(
     rt_uint8_t *data, rt_uint32_t data_len,
     rt_uint8_t *spare, rt_uint32_t spare_len)
 {
+    rt_err_t result;
+
     RT_ASSERT(device->ops->read_page);
-    return device->ops->read_page(device, page, data, data_len, spare, spare_len);
+    MTD_NAND_LOCK(device);
+    result = device->ops->read_page(device, page, data, data_len, spare, spare_len);
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (device->service)
+        rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_READ, page, result);
+#endif
+    MTD_NAND_UNLOCK(device);
+
+    return result;
 }
 
 rt_inline rt_err_t rt_mtd_nand_write(
@@ -93,28 +193,103 @@ rt_inline rt_err_t rt_mtd_nand_write(
     const rt_uint8_t *data, rt_uint32_t data_len,
     const rt_uint8_t *spare, rt_uint32_t spare_len)
 {
+    rt_err_t result;
+
     RT_ASSERT(device->ops->write_page);
-    return device->ops->write_page(device, page, data, data_len, spare, spare_len);
+    MTD_NAND_LOCK(device);
+    result = device->ops->write_page(device, page, data, data_len, spare, spare_len);
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (device->service)
+        rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_WRITE, page, result);
+#endif
+    MTD_NAND_UNLOCK(device);
+
+    return result;
+}
+
+/* program the continuous pages in one block, stop at the first failed */
+rt_inline rt_err_t rt_mtd_nand_write_pages(struct rt_mtd_nand_device *device,
+                                           const struct rt_mtd_nand_page *pages, rt_uint32_t count)
+{
+    rt_err_t result = RT_EOK;
+    rt_uint32_t index;
+
+    RT_ASSERT(device->ops->write_page);
+    MTD_NAND_LOCK(device);
+    if (device->ops->write_pages && count > 1)
+    {
+        result = device->ops->write_pages(device, pages, count);
+#ifdef RT_MTD_NAND_USING_SERVICE
+        if (device->service)
+        {
+            for (index = 0; index < count; index ++)
+                rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_WRITE, pages[index].page, result);
+            rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_BATCH, pages[0].page, result);
+        }
+#endif
+    }
+    else
+    {
+        for (index = 0; index < count && result == RT_EOK; index ++)
+        {
+            result = device->ops->write_page(device, pages[index].page,
+                                             pages[index].data, pages[index].data_len,
+                                             pages[index].spare, pages[index].spare_len);
+#ifdef RT_MTD_NAND_USING_SERVICE
+            if (device->service)
+                rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_WRITE, pages[index].page, result);
+#endif
+        }
+    }
+    MTD_NAND_UNLOCK(device);
+
+    return result;
 }
 
 rt_inline rt_err_t rt_mtd_nand_move_page(struct rt_mtd_nand_device *device,
         rt_off_t src_page, rt_off_t dst_page)
 {
+    rt_err_t result;
+
     RT_ASSERT(device->ops->move_page);
-    return device->ops->move_page(device, src_page, dst_page);
+    MTD_NAND_LOCK(device);
+    result = device->ops->move_page(device, src_page, dst_page);
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (device->service)
+        rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_MOVE, dst_page, result);
+#endif
+    MTD_NAND_UNLOCK(device);
+
+    return result;
 }
 
 rt_inline rt_err_t rt_mtd_nand_erase_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
 {
+    rt_err_t result;
+
     RT_ASSERT(device->ops->erase_block);
-    return device->ops->erase_block(device, block);
+    MTD_NAND_LOCK(device);
+    result = device->ops->erase_block(device, block);
+#ifdef RT_MTD_NAND_USING_SERVICE
+    if (device->service)
+        rt_mtd_nand_stat_update(device, RT_MTD_NAND_OP_ERASE, block, result);
+#endif
+    MTD_NAND_UNLOCK(device);
+
+    return result;
 }
 
 rt_inline rt_err_t rt_mtd_nand_check_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
 {
+    rt_err_t result;
+
     if (device->ops->check_block)
     {
-        return device->ops->check_block(device, block);
+        MTD_NAND_LOCK(device);
+        result = device->ops->check_block(device, block);
+        MTD_NAND_UNLOCK(device);
+
+        return result;
     }
     else
     {
@@ -124,9 +299,15 @@ rt_inline rt_err_t rt_mtd_nand_check_block(struct rt_mtd_nand_device *device, rt
 
 rt_inline rt_err_t rt_mtd_nand_mark_badblock(struct rt_mtd_nand_device *device, rt_uint32_t block)
 {
+    rt_err_t result;
+
     if (device->ops->mark_badblock)
     {
-        return device->ops->mark_badblock(device, block);
+        MTD_NAND_LOCK(device);
+        result = device->ops->mark_badblock(device, block);
+        MTD_NAND_UNLOCK(device);
+
+        return result;
     }
     else
     {
@@ -134,4 +315,7 @@ rt_inline rt_err_t rt_mtd_nand_mark_badblock(struct rt_mtd_nand_device *device,
     }
 }
 
+#undef MTD_NAND_LOCK
+#undef MTD_NAND_UNLOCK
+
 #endif /* MTD_NAND_H_ */
@@ -9,6 +9,9 @@
  * 2012-05-28     bernard      change interfaces
  * 2013-02-20     bernard      use RT_SERIAL_RB_BUFSZ to define
  *                             the size of ring buffer.
+ * 2026-10-19     agent        add rx statistics and overrun event
+ * 2026-10-19     agent        add DMA tx request queue with coalescing and scatter-gather
+ * 2026-10-19     agent        check the DMA tx sizes, add waiting for bounce buffer
  */
 
 #ifndef __SERIAL_H__
@@ -63,6 +66,7 @@
 #define RT_SERIAL_EVENT_RX_DMADONE      0x03    /* Rx DMA transfer done */
 #define RT_SERIAL_EVENT_TX_DMADONE      0x04    /* Tx DMA transfer done */
 #define RT_SERIAL_EVENT_RX_TIMEOUT      0x05    /* Rx timeout    */
+#define RT_SERIAL_EVENT_RX_OVERRUN      0x06    /* Rx hardware overrun */
 
 #define RT_SERIAL_DMA_RX                0x01
 #define RT_SERIAL_DMA_TX                0x02
@@ -74,6 +78,49 @@
 #define RT_SERIAL_ERR_FRAMING           0x02
 #define RT_SERIAL_ERR_PARITY            0x03
 
+#define RT_SERIAL_CTRL_GET_RX_STAT      0x20    /* get struct rt_serial_rx_stat */
+
+/* the number of bytes got from hardware before pushed into fifo */
+#ifndef RT_SERIAL_RX_BATCH
+#define RT_SERIAL_RX_BATCH              16
+#endif
+
+/* the max bytes copied from fifo with interrupt disabled */
+#ifndef RT_SERIAL_RX_COPY_MAX
+#define RT_SERIAL_RX_COPY_MAX           128
+#endif
+
+/* the number of DMA tx requests can be queued, it should be power of 2 */
+#ifndef RT_SERIAL_DMA_TX_QUEUE
+#define RT_SERIAL_DMA_TX_QUEUE          16
+#endif
+
+/* the small writes are copied into this buffer and sent in one DMA transfer,
+ * it should be power of 2 */
+#ifndef RT_SERIAL_DMA_TX_BUFSZ
+#define RT_SERIAL_DMA_TX_BUFSZ          256
+#endif
+
+/* the max size of write to be copied */
+#ifndef RT_SERIAL_DMA_TX_COALESCE
+#define RT_SERIAL_DMA_TX_COALESCE       64
+#endif
+
+#if (RT_SERIAL_DMA_TX_QUEUE & (RT_SERIAL_DMA_TX_QUEUE - 1)) != 0
+#error "RT_SERIAL_DMA_TX_QUEUE must be power of 2"
+#endif
+#if (RT_SERIAL_DMA_TX_BUFSZ & (RT_SERIAL_DMA_TX_BUFSZ - 1)) != 0
+#error "RT_SERIAL_DMA_TX_BUFSZ must be power of 2"
+#endif
+#if RT_SERIAL_DMA_TX_COALESCE > RT_SERIAL_DMA_TX_BUFSZ
+#error "RT_SERIAL_DMA_TX_COALESCE must not be larger than RT_SERIAL_DMA_TX_BUFSZ"
+#endif
+
+/* the max segments of a scatter-gather DMA transfer */
+#ifndef RT_SERIAL_DMA_TX_SG_MAX
+#define RT_SERIAL_DMA_TX_SG_MAX         4
+#endif
+
 #define RT_SERIAL_TX_DATAQUEUE_SIZE     2048
 #define RT_SERIAL_TX_DATAQUEUE_LWM      30
 
@@ -116,6 +163,14 @@ struct rt_serial_rx_fifo
     rt_bool_t is_full;
 };
 
+struct rt_serial_rx_stat
+{
+    rt_uint32_t rx_bytes;               /* bytes received */
+    rt_uint32_t fifo_overrun;           /* bytes discarded on software fifo full */
+    rt_uint32_t hw_overrun;             /* overrun reported by hardware */
+    rt_uint32_t events;                 /* rx interrupt, DMA and idle events */
+};
+
 struct rt_serial_tx_fifo
 {
     struct rt_completion completion;
@@ -129,10 +184,43 @@ struct rt_serial_rx_dma
     rt_bool_t activated;
 };
 
+struct rt_serial_device;
+
+/* the completion of tx request, it's invoked in ISR */
+typedef void (*rt_serial_tx_done_t)(struct rt_serial_device *serial, const void *buffer, void *param);
+
+struct rt_serial_dma_sg
+{
+    rt_uint8_t *buf;
+    rt_size_t size;
+};
+
+struct rt_serial_tx_req
+{
+    const rt_uint8_t *data;             /* the buffer of writer */
+    rt_uint8_t *dma_buf;                /* the data copied in bounce buffer, or the buffer of writer */
+    rt_size_t size;
+    rt_size_t bounce_end;               /* the end of data in bounce buffer */
+
+    rt_serial_tx_done_t done;           /* RT_NULL to invoke tx_complete of device */
+    void *param;
+};
+
 struct rt_serial_tx_dma
 {
     rt_bool_t activated;
-    struct rt_data_queue data_queue;
+
+    struct rt_semaphore free_sem;       /* the free requests */
+    struct rt_serial_tx_req reqs[RT_SERIAL_DMA_TX_QUEUE];
+    rt_uint16_t put_index, get_index;   /* free running index of requests */
+    rt_uint16_t inflight;               /* the requests in DMA transfer */
+
+    struct rt_serial_dma_sg sg[RT_SERIAL_DMA_TX_SG_MAX];
+
+    rt_size_t bounce_put, bounce_get;   /* free running offset of bounce buffer */
+    rt_uint8_t bounce[RT_SERIAL_DMA_TX_BUFSZ];
+    struct rt_semaphore bounce_sem;     /* the writers waiting for bounce buffer */
+    rt_uint16_t bounce_waiting;
 };
 
 struct rt_serial_device
@@ -144,6 +232,8 @@ struct rt_serial_device
 
     void *serial_rx;
     void *serial_tx;
+
+    struct rt_serial_rx_stat rx_stat;
 };
 typedef struct rt_serial_device rt_serial_t;
 
@@ -159,10 +249,17 @@ struct rt_uart_ops
     int (*getc)(struct rt_serial_device *serial);
 
     rt_size_t (*dma_transmit)(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction);
+    /* optional, transmit the segments in one DMA transfer, the sg list is valid until done */
+    rt_size_t (*dma_transmit_sg)(struct rt_serial_device *serial, const struct rt_serial_dma_sg *sg, int sg_num);
 };
 
 void rt_hw_serial_isr(struct rt_serial_device *serial, int event);
 
+#ifdef RT_SERIAL_USING_DMA
+rt_err_t rt_serial_write_async(struct rt_serial_device *serial, const void *buffer, rt_size_t size,
+                               rt_serial_tx_done_t done, void *param);
+#endif
+
 rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
                                const char              *name,
                                rt_uint32_t              flag,
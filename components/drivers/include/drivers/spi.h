@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2012-11-23     Bernard      Add extern "C"
+ * 2026-10-19     agent        add asynchronous transfer queue and loopback bus
  */
 
 #ifndef __SPI_H__
@@ -80,6 +81,7 @@ struct rt_spi_configuration
 };
 
 struct rt_spi_ops;
+struct rt_spi_async_queue;
 struct rt_spi_bus
 {
     struct rt_device parent;
@@ -88,6 +90,10 @@ struct rt_spi_bus
 
     struct rt_mutex lock;
     struct rt_spi_device *owner;
+
+#ifdef RT_SPI_USING_ASYNC
+    struct rt_spi_async_queue *async;
+#endif
 };
 
 /**
@@ -111,6 +117,49 @@ struct rt_spi_device
     void   *user_data;
 };
 
+#ifdef RT_SPI_USING_ASYNC
+struct rt_completion;
+struct rt_spi_async;
+
+typedef void (*rt_spi_async_done_t)(struct rt_spi_async *async);
+
+/**
+ * SPI asynchronous transfer, it's owned by the queue from submitted until done.
+ */
+struct rt_spi_async
+{
+    rt_list_t list;
+
+    struct rt_spi_device *device;
+    struct rt_spi_message *message;
+
+    rt_spi_async_done_t done;           /* invoked in the queue thread */
+    struct rt_completion *completion;   /* notified after done invoked */
+    void *user_data;
+
+    rt_err_t result;
+    struct rt_spi_message *failed;      /* the message failed, RT_NULL on success */
+};
+
+struct rt_spi_async_stat
+{
+    rt_uint32_t submitted;
+    rt_uint32_t completed;
+    rt_uint32_t batched;                /* run without releasing bus after the previous */
+    rt_uint32_t configured;             /* the bus reconfigured for another device */
+};
+#endif
+
+#ifdef RT_SPI_USING_LOOPBACK
+struct rt_spi_loopback_stat
+{
+    rt_uint32_t configured;
+    rt_uint32_t cs_taken;
+    rt_uint32_t messages;
+    rt_uint32_t bytes;
+};
+#endif
+
 struct rt_qspi_message
 {
     struct rt_spi_message parent;
@@ -308,6 +357,60 @@ rt_inline void rt_spi_message_append(struct rt_spi_message *list,
     message->next = RT_NULL;
 }
 
+#ifdef RT_SPI_USING_ASYNC
+/**
+ * This function starts the asynchronous transfer queue of SPI bus.
+ *
+ * @param bus the SPI bus.
+ * @param priority the priority of queue thread.
+ *
+ * @return RT_EOK on successful, -RT_ENOMEM on out of memory.
+ */
+rt_err_t rt_spi_bus_async_init(struct rt_spi_bus *bus, rt_uint8_t priority);
+
+/**
+ * This function gets the statistics of asynchronous transfer queue.
+ *
+ * @param bus the SPI bus.
+ * @param stat the statistics.
+ *
+ * @return RT_EOK on successful, -RT_ENOSYS on the queue isn't started.
+ */
+rt_err_t rt_spi_bus_async_stat(struct rt_spi_bus *bus, struct rt_spi_async_stat *stat);
+
+/**
+ * This function initializes the asynchronous transfer.
+ *
+ * @param async the asynchronous transfer.
+ * @param message the message list to be transmitted.
+ * @param done the callback invoked after transmitted, or RT_NULL.
+ * @param user_data the user data of callback.
+ */
+void rt_spi_async_init(struct rt_spi_async   *async,
+                       struct rt_spi_message *message,
+                       rt_spi_async_done_t    done,
+                       void                  *user_data);
+
+/**
+ * This function submits the message list to the queue of SPI bus and returns
+ * immediately, it can be invoked in ISR. The message lists of same device are
+ * transmitted in order.
+ *
+ * @param device the SPI device attached to SPI bus.
+ * @param async the asynchronous transfer, it's kept until done.
+ *
+ * @return RT_EOK on submitted, -RT_ENOSYS on the queue isn't started.
+ */
+rt_err_t rt_spi_transfer_async(struct rt_spi_device *device,
+                               struct rt_spi_async  *async);
+#endif
+
+#ifdef RT_SPI_USING_LOOPBACK
+/* create a SPI bus which receives the data it sends */
+struct rt_spi_bus *rt_spi_loopback_create(const char *name);
+void rt_spi_loopback_get_stat(struct rt_spi_bus *bus, struct rt_spi_loopback_stat *stat);
+#endif
+
 /**
  * This function can set configuration on QSPI device.
  *
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        add the irq thread drained in slack time
+ */
+#ifndef IRQ_THREAD_H__
+#define IRQ_THREAD_H__
+
+#include <rtthread.h>
+
+/*
+ * The interrupt events are deferred to a thread in batch. The ISR (or the
+ * rx_indicate callback of device) posts the event of source instead of
+ * releasing semaphore, the events of source are coalesced until the threshold
+ * is reached or the timeout is expired, then the handler is invoked once in
+ * the thread for all of them.
+ *
+ * The irq thread created by rt_irq_thread_create_slack() has no thread of its
+ * own, the handlers are invoked in the idle hook, that is the slack time out of
+ * the windows of TT threads.
+ */
+
+struct rt_irq_source;
+typedef void (*rt_irq_handler_t)(struct rt_irq_source *source, rt_uint32_t events, rt_uint32_t value);
+
+struct rt_irq_source_stat
+{
+    rt_uint32_t posted;                 /* events posted */
+    rt_uint32_t batches;                /* handler invoked */
+    rt_uint32_t batch_max;              /* max events in a batch */
+    rt_uint32_t rate;                   /* events per second */
+    rt_tick_t latency_max;              /* max ticks from event to handler */
+};
+
+struct rt_irq_thread
+{
+    rt_list_t sources;
+    rt_list_t pending;                  /* the sources with events */
+
+    rt_bool_t signaled;
+    struct rt_semaphore sem;
+    struct rt_timer timer;              /* timeout of coalescing */
+    rt_tick_t deadline;
+
+    rt_thread_t thread;                 /* RT_NULL for the one drained in slack */
+#ifdef RT_IRQ_THREAD_USING_SLACK
+    rt_list_t slack;                    /* node in the list of idle hook */
+    rt_bool_t defunct;                  /* destroyed, freed in idle hook */
+#endif
+};
+
+struct rt_irq_source
+{
+    rt_list_t node;                     /* node in sources of thread */
+    rt_list_t list;                     /* node in pending of thread */
+    struct rt_irq_thread *irq_thread;
+
+    const char *name;
+    rt_irq_handler_t handler;
+    void *user_data;
+
+    rt_uint32_t threshold;              /* events to invoke handler */
+    rt_tick_t timeout;                  /* ticks to invoke handler for less events */
+
+    rt_uint32_t events;
+    rt_uint32_t value;                  /* value of the latest event */
+    rt_tick_t first;                    /* tick of the first event */
+
+    rt_tick_t window;                   /* start of rate window */
+    rt_uint32_t window_posted;
+    struct rt_irq_source_stat stat;
+};
+
+#ifdef RT_USING_HEAP
+struct rt_irq_thread *rt_irq_thread_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority);
+rt_err_t rt_irq_thread_destroy(struct rt_irq_thread *irq_thread);
+#ifdef RT_IRQ_THREAD_USING_SLACK
+struct rt_irq_thread *rt_irq_thread_create_slack(void);
+#endif
+
+void rt_irq_source_init(struct rt_irq_source *source, const char *name,
+                        rt_irq_handler_t handler, void *user_data);
+void rt_irq_source_set_coalesce(struct rt_irq_source *source, rt_uint32_t threshold, rt_tick_t timeout);
+rt_err_t rt_irq_source_attach(struct rt_irq_thread *irq_thread, struct rt_irq_source *source);
+rt_err_t rt_irq_source_detach(struct rt_irq_source *source);
+void rt_irq_source_post(struct rt_irq_source *source, rt_uint32_t value);
+void rt_irq_source_get_stat(struct rt_irq_source *source, struct rt_irq_source_stat *stat);
+#endif
+
+#endif
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     agent        add lock-free single producer single consumer ring buffer
  */
 #ifndef RINGBUFFER_H__
 #define RINGBUFFER_H__
@@ -88,6 +89,57 @@ rt_inline rt_uint16_t rt_ringbuffer_get_size(struct rt_ringbuffer *rb)
 /** return the size of empty space in rb */
 #define rt_ringbuffer_space_len(rb) ((rb)->buffer_size - rt_ringbuffer_data_len(rb))
 
+/*
+ * The lock-free ring buffer for single producer and single consumer, such as
+ * an ISR and a thread. The producer only writes write_index and the consumer
+ * only writes read_index, so neither side disables interrupt.
+ *
+ * The index runs in [0, 2 * buffer_size), the upper half works as the mirror of
+ * rt_ringbuffer, so all of the buffer could be used and the size isn't limited
+ * to power of 2.
+ *
+ * Besides the copy API, the peek/commit API exposes the contiguous region in
+ * buffer, it could be filled by DMA or parsed in place:
+ *
+ *     len = rt_spsc_ringbuffer_get_peek(rb, &ptr);
+ *     parse(ptr, len);
+ *     rt_spsc_ringbuffer_get_commit(rb, len);
+ */
+struct rt_spsc_ringbuffer
+{
+    rt_uint8_t *buffer_ptr;
+    rt_uint32_t buffer_size;
+
+    volatile rt_uint32_t read_index;    /* written by consumer only */
+    volatile rt_uint32_t write_index;   /* written by producer only */
+};
+
+void rt_spsc_ringbuffer_init(struct rt_spsc_ringbuffer *rb, rt_uint8_t *pool, rt_uint32_t size);
+void rt_spsc_ringbuffer_reset(struct rt_spsc_ringbuffer *rb);
+rt_size_t rt_spsc_ringbuffer_data_len(struct rt_spsc_ringbuffer *rb);
+rt_size_t rt_spsc_ringbuffer_space_len(struct rt_spsc_ringbuffer *rb);
+
+/* producer side */
+rt_size_t rt_spsc_ringbuffer_put(struct rt_spsc_ringbuffer *rb, const rt_uint8_t *ptr, rt_size_t length);
+rt_size_t rt_spsc_ringbuffer_put_peek(struct rt_spsc_ringbuffer *rb, rt_uint8_t **ptr);
+void rt_spsc_ringbuffer_put_commit(struct rt_spsc_ringbuffer *rb, rt_size_t length);
+
+/* consumer side */
+rt_size_t rt_spsc_ringbuffer_get(struct rt_spsc_ringbuffer *rb, rt_uint8_t *ptr, rt_size_t length);
+rt_size_t rt_spsc_ringbuffer_get_peek(struct rt_spsc_ringbuffer *rb, rt_uint8_t **ptr);
+void rt_spsc_ringbuffer_get_commit(struct rt_spsc_ringbuffer *rb, rt_size_t length);
+
+#ifdef RT_USING_HEAP
+struct rt_spsc_ringbuffer *rt_spsc_ringbuffer_create(rt_uint32_t size);
+void rt_spsc_ringbuffer_destroy(struct rt_spsc_ringbuffer *rb);
+#endif
+
+rt_inline rt_uint32_t rt_spsc_ringbuffer_get_size(struct rt_spsc_ringbuffer *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+    return rb->buffer_size;
+}
+
 
 #ifdef __cplusplus
 }
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2012-01-08     bernard      first version.
  * 2014-07-12     bernard      Add workqueue implementation.
+ * 2026-10-19     agent        Add irq thread.
  */
 
 #ifndef __RT_DEVICE_H__
@@ -22,6 +23,7 @@
 #include "ipc/pipe.h"
 #include "ipc/poll.h"
 #include "ipc/ringblk_buf.h"
+#include "ipc/irq_thread.h"
 
 #ifdef __cplusplus
 extern "C" {
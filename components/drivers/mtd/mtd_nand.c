@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2011-12-05     Bernard      the first version
+ * 2026-10-19     agent        init the service and lock of device on register
  */
 
 /*
@@ -91,6 +92,11 @@ rt_err_t rt_mtd_nand_register_device(const char                *name,
     dev->rx_indicate = RT_NULL;
     dev->tx_complete = RT_NULL;
 
+#ifdef RT_MTD_NAND_USING_SERVICE
+    device->service  = RT_NULL;
+    rt_mutex_init(&(device->lock), name, RT_IPC_FLAG_FIFO);
+#endif
+
     /* register to RT-Thread device system */
     return rt_device_register(dev, name, RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE);
 }
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        add programming pages in batch
+ */
+
+/*
+ * The Nand device simulated in RAM, it works as Nand Flash: the program only
+ * clears bits and the erase sets the whole block to 0xff. It's used to run the
+ * file system and MTD service on simulator.
+ */
+
+#include <rtthread.h>
+#include <drivers/mtd_nand.h>
+
+#ifdef RT_MTD_NAND_USING_RAM
+
+struct mtd_nand_ram
+{
+    struct rt_mtd_nand_device parent;
+
+    rt_uint8_t *mem;                    /* pages with spare */
+    rt_uint8_t *bad;                    /* bad block flags */
+};
+
+#define NAND_RAM(device)            ((struct mtd_nand_ram *)(device))
+#define NAND_RAM_PAGE_SIZE(device)  ((device)->page_size + (device)->oob_size)
+
+static rt_uint8_t *_ram_page(struct rt_mtd_nand_device *device, rt_off_t page)
+{
+    if (page < 0 || page >= (rt_off_t)(device->pages_per_block * device->block_total))
+        return RT_NULL;
+
+    return NAND_RAM(device)->mem + page * NAND_RAM_PAGE_SIZE(device);
+}
+
+/* program the page, the bit can be cleared only */
+static void _ram_program(rt_uint8_t *dst, const rt_uint8_t *src, rt_uint32_t len)
+{
+    while (len --)
+        *dst ++ &= *src ++;
+}
+
+static rt_err_t _ram_read_id(struct rt_mtd_nand_device *device)
+{
+    return RT_EOK;
+}
+
+static rt_err_t _ram_read_page(struct rt_mtd_nand_device *device,
+                               rt_off_t page,
+                               rt_uint8_t *data, rt_uint32_t data_len,
+                               rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    rt_uint8_t *ptr = _ram_page(device, page);
+
+    if (ptr == RT_NULL || data_len > device->page_size || spare_len > device->oob_size)
+        return -RT_MTD_EIO;
+
+    if (data)
+        rt_memcpy(data, ptr, data_len);
+    if (spare)
+        rt_memcpy(spare, ptr + device->page_size, spare_len);
+
+    return RT_EOK;
+}
+
+static rt_err_t _ram_write_page(struct rt_mtd_nand_device *device,
+                                rt_off_t page,
+                                const rt_uint8_t *data, rt_uint32_t data_len,
+                                const rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    rt_uint8_t *ptr = _ram_page(device, page);
+
+    if (ptr == RT_NULL || data_len > device->page_size || spare_len > device->oob_size)
+        return -RT_MTD_EIO;
+
+    if (data)
+        _ram_program(ptr, data, data_len);
+    if (spare)
+        _ram_program(ptr + device->page_size, spare, spare_len);
+
+    return RT_EOK;
+}
+
+static rt_err_t _ram_write_pages(struct rt_mtd_nand_device *device,
+                                 const struct rt_mtd_nand_page *pages, rt_uint32_t count)
+{
+    rt_err_t result = RT_EOK;
+    rt_uint32_t index;
+
+    for (index = 0; index < count && result == RT_EOK; index ++)
+        result = _ram_write_page(device, pages[index].page,
+                                 pages[index].data, pages[index].data_len,
+                                 pages[index].spare, pages[index].spare_len);
+
+    return result;
+}
+
+static rt_err_t _ram_move_page(struct rt_mtd_nand_device *device, rt_off_t src_page, rt_off_t dst_page)
+{
+    rt_uint8_t *src = _ram_page(device, src_page);
+    rt_uint8_t *dst = _ram_page(device, dst_page);
+
+    if (src == RT_NULL || dst == RT_NULL)
+        return -RT_MTD_EIO;
+
+    _ram_program(dst, src, NAND_RAM_PAGE_SIZE(device));
+
+    return RT_EOK;
+}
+
+static rt_err_t _ram_erase_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    rt_uint32_t block_size = device->pages_per_block * NAND_RAM_PAGE_SIZE(device);
+
+    if (block >= device->block_total || NAND_RAM(device)->bad[block])
+        return -RT_MTD_EIO;
+
+    rt_memset(NAND_RAM(device)->mem + block * block_size, 0xff, block_size);
+
+    return RT_EOK;
+}
+
+static rt_err_t _ram_check_block(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    if (block >= device->block_total || NAND_RAM(device)->bad[block])
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
+static rt_err_t _ram_mark_badblock(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    if (block >= device->block_total)
+        return -RT_ERROR;
+
+    NAND_RAM(device)->bad[block] = 1;
+
+    return RT_EOK;
+}
+
+const static struct rt_mtd_nand_driver_ops _ram_ops =
+{
+    _ram_read_id,
+    _ram_read_page,
+    _ram_write_page,
+    _ram_move_page,
+    _ram_erase_block,
+    _ram_check_block,
+    _ram_mark_badblock,
+    _ram_write_pages,
+};
+
+/**
+ * This function creates a Nand device simulated in RAM, all of blocks are
+ * erased.
+ *
+ * @param name the device name.
+ * @param page_size the page size.
+ * @param oob_size the spare size of page.
+ * @param pages_per_block the number of page in a block.
+ * @param block_total the number of block.
+ *
+ * @return the Nand device, or RT_NULL on failed.
+ */
+struct rt_mtd_nand_device *rt_mtd_nand_ram_create(const char *name,
+                                                 rt_uint16_t page_size, rt_uint16_t oob_size,
+                                                 rt_uint32_t pages_per_block, rt_uint16_t block_total)
+{
+    struct mtd_nand_ram *nand;
+    rt_size_t size;
+
+    nand = (struct mtd_nand_ram *)rt_calloc(1, sizeof(struct mtd_nand_ram));
+    if (nand == RT_NULL)
+        return RT_NULL;
+
+    size = (rt_size_t)(page_size + oob_size) * pages_per_block * block_total;
+    nand->mem = (rt_uint8_t *)rt_malloc(size);
+    nand->bad = (rt_uint8_t *)rt_calloc(block_total, 1);
+    if (nand->mem == RT_NULL || nand->bad == RT_NULL)
+        goto __failed;
+    rt_memset(nand->mem, 0xff, size);
+
+    nand->parent.page_size       = page_size;
+    nand->parent.oob_size        = oob_size;
+    nand->parent.oob_free        = oob_size;
+    nand->parent.plane_num       = 1;
+    nand->parent.pages_per_block = pages_per_block;
+    nand->parent.block_total     = block_total;
+    nand->parent.block_start     = 0;
+    nand->parent.block_end       = block_total;
+    nand->parent.ops             = &_ram_ops;
+
+    if (rt_mtd_nand_register_device(name, &nand->parent) != RT_EOK)
+        goto __failed;
+
+    return &nand->parent;
+
+__failed:
+    rt_free(nand->mem);
+    rt_free(nand->bad);
+    rt_free(nand);
+    return RT_NULL;
+}
+RTM_EXPORT(rt_mtd_nand_ram_create);
+
+#endif /* RT_MTD_NAND_USING_RAM */
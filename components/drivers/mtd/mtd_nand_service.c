@@ -0,0 +1,661 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        program the continuous pages in batch, run the async APIs
+ *                             in place in the service thread
+ */
+
+/*
+ * The background service of MTD Nand device. The pages written and blocks
+ * erased by async APIs are queued and done by the service thread in order,
+ * so the writer only copies the page into queue. The queued writes of the
+ * continuous pages in one block are programmed in batch. When the queue is
+ * empty, the garbage collection hooked by file system runs in the service
+ * thread, the async APIs invoked by it are done in place.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <drivers/mtd_nand.h>
+
+#ifdef RT_MTD_NAND_USING_SERVICE
+
+#ifndef RT_MTD_NAND_SERVICE_STACK_SIZE
+#define RT_MTD_NAND_SERVICE_STACK_SIZE  1024
+#endif
+
+#ifndef RT_MTD_NAND_SERVICE_BATCH
+#define RT_MTD_NAND_SERVICE_BATCH       8
+#endif
+
+#define MTD_REQ_WRITE       0
+#define MTD_REQ_ERASE       1
+#define MTD_REQ_BARRIER     2
+
+struct mtd_nand_req
+{
+    rt_list_t list;
+
+    rt_uint8_t type;
+    rt_uint32_t index;                  /* page of write or block of erase */
+
+    rt_uint8_t *data;
+    rt_uint32_t data_len;
+    rt_uint8_t *spare;
+    rt_uint32_t spare_len;
+
+    rt_uint8_t *buf;                    /* page and spare */
+    struct rt_semaphore *done;          /* barrier */
+};
+
+struct rt_mtd_nand_service
+{
+    struct rt_mtd_nand_device *device;
+    struct rt_mtd_nand_stat stat;
+    rt_uint32_t *erase_count;
+
+    struct rt_mutex lock;
+    struct rt_semaphore free_sem;       /* number of free requests */
+    struct rt_semaphore work_sem;       /* wake up the service thread */
+    rt_list_t free_list;
+    rt_list_t pending_list;             /* the head is being done */
+    struct mtd_nand_req *reqs;
+
+    rt_err_t error;                     /* the first error of queued operations */
+
+    rt_err_t (*gc)(struct rt_mtd_nand_device *device, void *param);
+    void *gc_param;
+    rt_int32_t gc_period;
+    rt_bool_t in_gc;
+
+    rt_thread_t thread;
+};
+
+static struct mtd_nand_req *_req_alloc(struct rt_mtd_nand_service *svc)
+{
+    struct mtd_nand_req *req;
+
+    rt_sem_take(&svc->free_sem, RT_WAITING_FOREVER);
+
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    req = rt_list_entry(svc->free_list.next, struct mtd_nand_req, list);
+    rt_list_remove(&req->list);
+    rt_mutex_release(&svc->lock);
+
+    return req;
+}
+
+static void _req_submit(struct rt_mtd_nand_service *svc, struct mtd_nand_req *req)
+{
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    rt_list_insert_before(&svc->pending_list, &req->list);
+    rt_mutex_release(&svc->lock);
+
+    rt_sem_release(&svc->work_sem);
+}
+
+/* the service thread runs the operations itself, it never waits for queue */
+#define _service_self(svc)  (rt_thread_self() == (svc)->thread)
+
+/* wait for the queued operations done */
+static void _service_flush(struct rt_mtd_nand_service *svc)
+{
+    struct mtd_nand_req req;
+    struct rt_semaphore done;
+
+    /* the queue is empty when garbage collection runs */
+    if (_service_self(svc))
+        return;
+
+    rt_sem_init(&done, "mtdsync", 0, RT_IPC_FLAG_FIFO);
+
+    rt_memset(&req, 0, sizeof(req));
+    req.type = MTD_REQ_BARRIER;
+    req.done = &done;
+    _req_submit(svc, &req);
+
+    rt_sem_take(&done, RT_WAITING_FOREVER);
+    rt_sem_detach(&done);
+}
+
+/* check whether the page is touched by the queued operations */
+static rt_bool_t _service_pending(struct rt_mtd_nand_service *svc, rt_off_t page)
+{
+    struct mtd_nand_req *req;
+    rt_list_t *node;
+    rt_bool_t pending = RT_FALSE;
+
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    rt_list_for_each(node, &svc->pending_list)
+    {
+        req = rt_list_entry(node, struct mtd_nand_req, list);
+        if ((req->type == MTD_REQ_WRITE && req->index == page) ||
+            (req->type == MTD_REQ_ERASE && req->index == page / svc->device->pages_per_block))
+        {
+            pending = RT_TRUE;
+            break;
+        }
+    }
+    rt_mutex_release(&svc->lock);
+
+    return pending;
+}
+
+/* collect the queued writes following @req on the continuous pages of block */
+static rt_uint32_t _service_batch(struct rt_mtd_nand_service *svc, struct mtd_nand_req *req,
+                                  struct rt_mtd_nand_page *pages)
+{
+    rt_uint32_t ppb = svc->device->pages_per_block;
+    rt_uint32_t count = 0;
+    rt_list_t *node = &req->list;
+
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    while (count < RT_MTD_NAND_SERVICE_BATCH)
+    {
+        if (count > 0)
+        {
+            node = node->next;
+            if (node == &svc->pending_list)
+                break;
+            req = rt_list_entry(node, struct mtd_nand_req, list);
+            if (req->type != MTD_REQ_WRITE || req->index != pages[count - 1].page + 1 ||
+                req->index / ppb != pages[0].page / ppb)
+                break;
+        }
+
+        pages[count].page      = req->index;
+        pages[count].data      = req->data;
+        pages[count].data_len  = req->data_len;
+        pages[count].spare     = req->spare;
+        pages[count].spare_len = req->spare_len;
+        count ++;
+    }
+    rt_mutex_release(&svc->lock);
+
+    return count;
+}
+
+static void _service_entry(void *parameter)
+{
+    struct rt_mtd_nand_service *svc = (struct rt_mtd_nand_service *)parameter;
+    struct rt_mtd_nand_device *device = svc->device;
+    struct rt_mtd_nand_page pages[RT_MTD_NAND_SERVICE_BATCH];
+    struct mtd_nand_req *req;
+    rt_err_t (*gc)(struct rt_mtd_nand_device *device, void *param);
+    void *gc_param;
+    rt_int32_t gc_period;
+    rt_bool_t gc_more = RT_TRUE;
+    rt_uint32_t count, index;
+    rt_err_t result;
+
+    while (1)
+    {
+        rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+        if (rt_list_isempty(&svc->pending_list))
+            req = RT_NULL;
+        else
+            req = rt_list_entry(svc->pending_list.next, struct mtd_nand_req, list);
+        gc        = svc->gc;
+        gc_param  = svc->gc_param;
+        gc_period = svc->gc_period;
+        rt_mutex_release(&svc->lock);
+
+        if (req == RT_NULL)
+        {
+            /* the queue is empty, it's the time for garbage collection */
+            if (gc && gc_more)
+            {
+                svc->in_gc = RT_TRUE;
+                gc_more = (gc(device, gc_param) == RT_EOK);
+                svc->in_gc = RT_FALSE;
+                continue;
+            }
+
+            if (rt_sem_take(&svc->work_sem, gc ? gc_period : RT_WAITING_FOREVER) != RT_EOK)
+                gc_more = RT_TRUE;
+            continue;
+        }
+
+        count = 1;
+        switch (req->type)
+        {
+        case MTD_REQ_WRITE:
+            count  = _service_batch(svc, req, pages);
+            result = rt_mtd_nand_write_pages(device, pages, count);
+            break;
+
+        case MTD_REQ_ERASE:
+            result = rt_mtd_nand_erase_block(device, req->index);
+            break;
+
+        default:
+            result = RT_EOK;
+            break;
+        }
+
+        /* consume the wake up of the requests done */
+        for (index = 0; index < count; index ++)
+            rt_sem_trytake(&svc->work_sem);
+
+        if (req->type == MTD_REQ_BARRIER)
+        {
+            rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+            rt_list_remove(&req->list);
+            rt_mutex_release(&svc->lock);
+
+            rt_sem_release(req->done);
+            continue;
+        }
+
+        /* the batch is the head of queue */
+        rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+        if (result != RT_EOK && svc->error == RT_EOK)
+            svc->error = result;
+        for (index = 0; index < count; index ++)
+        {
+            req = rt_list_entry(svc->pending_list.next, struct mtd_nand_req, list);
+            rt_list_remove(&req->list);
+            rt_list_insert_before(&svc->free_list, &req->list);
+        }
+        rt_mutex_release(&svc->lock);
+
+        for (index = 0; index < count; index ++)
+            rt_sem_release(&svc->free_sem);
+        gc_more = RT_TRUE;
+    }
+}
+
+/**
+ * This function initializes the background service of MTD Nand device.
+ *
+ * @param device the MTD Nand device.
+ * @param queue_num the number of pages can be queued.
+ * @param priority the priority of service thread, it should be lower than
+ * the writers to run in the slack time.
+ *
+ * @return RT_EOK on successful, -RT_ENOMEM on out of memory.
+ */
+rt_err_t rt_mtd_nand_service_init(struct rt_mtd_nand_device *device, rt_uint32_t queue_num, rt_uint8_t priority)
+{
+    struct rt_mtd_nand_service *svc;
+    rt_uint32_t block_num, page_size, index;
+    rt_uint8_t *buf;
+
+    RT_ASSERT(device != RT_NULL);
+    RT_ASSERT(queue_num > 0);
+
+    if (device->service)
+        return RT_EOK;
+
+    block_num = device->block_end - device->block_start;
+    if (block_num == 0)
+        block_num = device->block_total;
+    page_size = device->page_size + device->oob_size;
+
+    svc = (struct rt_mtd_nand_service *)rt_calloc(1, sizeof(struct rt_mtd_nand_service));
+    if (svc == RT_NULL)
+        return -RT_ENOMEM;
+
+    svc->erase_count = (rt_uint32_t *)rt_calloc(block_num, sizeof(rt_uint32_t));
+    svc->reqs = (struct mtd_nand_req *)rt_calloc(queue_num, sizeof(struct mtd_nand_req) + page_size);
+    if (svc->erase_count == RT_NULL || svc->reqs == RT_NULL)
+        goto __nomem;
+
+    svc->thread = rt_thread_create(device->parent.parent.name, _service_entry, svc,
+                                   RT_MTD_NAND_SERVICE_STACK_SIZE, priority, 10);
+    if (svc->thread == RT_NULL)
+        goto __nomem;
+
+    svc->device = device;
+    svc->stat.block_num = block_num;
+    svc->stat.erase_count = svc->erase_count;
+    rt_mutex_init(&svc->lock, "mtdsvc", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&svc->free_sem, "mtdfree", queue_num, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&svc->work_sem, "mtdwork", 0, RT_IPC_FLAG_FIFO);
+    rt_list_init(&svc->free_list);
+    rt_list_init(&svc->pending_list);
+    svc->gc_period = RT_WAITING_FOREVER;
+
+    /* the page buffers follow the requests */
+    buf = (rt_uint8_t *)(svc->reqs + queue_num);
+    for (index = 0; index < queue_num; index ++)
+    {
+        svc->reqs[index].buf = buf + index * page_size;
+        rt_list_insert_before(&svc->free_list, &svc->reqs[index].list);
+    }
+
+    device->service = svc;
+    rt_thread_startup(svc->thread);
+
+    return RT_EOK;
+
+__nomem:
+    rt_free(svc->reqs);
+    rt_free(svc->erase_count);
+    rt_free(svc);
+    return -RT_ENOMEM;
+}
+RTM_EXPORT(rt_mtd_nand_service_init);
+
+/**
+ * This function wakes up the service to do garbage collection, it can be
+ * invoked at the beginning of slack time.
+ *
+ * @param device the MTD Nand device.
+ */
+void rt_mtd_nand_service_kick(struct rt_mtd_nand_device *device)
+{
+    RT_ASSERT(device != RT_NULL);
+
+    if (device->service)
+        rt_sem_release(&device->service->work_sem);
+}
+RTM_EXPORT(rt_mtd_nand_service_kick);
+
+/**
+ * This function sets the garbage collection of file system, which runs in
+ * the service thread when the queue is empty.
+ *
+ * @param device the MTD Nand device.
+ * @param gc the garbage collection, it returns RT_EOK when there is more
+ * work to do, otherwise it's not invoked until the next operation done, the
+ * kick or the period expired.
+ * @param param the parameter of garbage collection.
+ * @param period the period in ticks to retry the garbage collection,
+ * RT_WAITING_FOREVER on no retry.
+ *
+ * @return RT_EOK on successful, -RT_ERROR on the service isn't initialized.
+ *
+ * @note the old hook isn't running when this function returns, so the file
+ * system can release the parameter of hook after unset it.
+ */
+rt_err_t rt_mtd_nand_set_gc(struct rt_mtd_nand_device *device,
+                            rt_err_t (*gc)(struct rt_mtd_nand_device *device, void *param),
+                            void *param, rt_int32_t period)
+{
+    struct rt_mtd_nand_service *svc;
+
+    RT_ASSERT(device != RT_NULL);
+
+    svc = device->service;
+    if (svc == RT_NULL)
+        return -RT_ERROR;
+
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    svc->gc_param  = param;
+    svc->gc_period = period;
+    svc->gc        = gc;
+    rt_mutex_release(&svc->lock);
+
+    /* the garbage collection in progress is done with the old hook */
+    _service_flush(svc);
+
+    return RT_EOK;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_nand_set_gc);
+
+/**
+ * This function queues a page to write, it returns after the page is copied
+ * into queue, and blocks when the queue is full. The page is written in place
+ * when it's invoked by the garbage collection in service thread.
+ *
+ * @return RT_EOK on queued, -RT_ERROR on the service isn't initialized,
+ * -RT_EINVAL on the length is out of page, or the error of write in place.
+ *
+ * @note the error of queued write is returned by rt_mtd_nand_sync.
+ */
+rt_err_t rt_mtd_nand_write_async(struct rt_mtd_nand_device *device,
+                                 rt_off_t page,
+                                 const rt_uint8_t *data, rt_uint32_t data_len,
+                                 const rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    struct rt_mtd_nand_service *svc;
+    struct mtd_nand_req *req;
+
+    RT_ASSERT(device != RT_NULL);
+
+    svc = device->service;
+    if (svc == RT_NULL)
+        return -RT_ERROR;
+    if ((data && data_len > device->page_size) || (spare && spare_len > device->oob_size))
+        return -RT_EINVAL;
+
+    /* the queue can't be drained by the service thread itself */
+    if (_service_self(svc))
+        return rt_mtd_nand_write(device, page, data, data_len, spare, spare_len);
+
+    req = _req_alloc(svc);
+    req->type  = MTD_REQ_WRITE;
+    req->index = page;
+
+    req->data = RT_NULL;
+    req->data_len = data_len;
+    if (data)
+    {
+        req->data = req->buf;
+        rt_memcpy(req->data, data, data_len);
+    }
+
+    req->spare = RT_NULL;
+    req->spare_len = spare_len;
+    if (spare)
+    {
+        req->spare = req->buf + device->page_size;
+        rt_memcpy(req->spare, spare, spare_len);
+    }
+
+    _req_submit(svc, req);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_nand_write_async);
+
+/**
+ * This function queues a block to erase, the block is erased in place when
+ * it's invoked by the garbage collection in service thread.
+ *
+ * @return RT_EOK on queued, -RT_ERROR on the service isn't initialized, or
+ * the error of erase in place.
+ *
+ * @note the error of queued erase is returned by rt_mtd_nand_sync.
+ */
+rt_err_t rt_mtd_nand_erase_async(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    struct rt_mtd_nand_service *svc;
+    struct mtd_nand_req *req;
+
+    RT_ASSERT(device != RT_NULL);
+
+    svc = device->service;
+    if (svc == RT_NULL)
+        return -RT_ERROR;
+
+    if (_service_self(svc))
+        return rt_mtd_nand_erase_block(device, block);
+
+    req = _req_alloc(svc);
+    req->type  = MTD_REQ_ERASE;
+    req->index = block;
+    _req_submit(svc, req);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_nand_erase_async);
+
+/**
+ * This function reads a page, the queued operations on this page are done
+ * before read.
+ */
+rt_err_t rt_mtd_nand_read_sync(struct rt_mtd_nand_device *device,
+                               rt_off_t page,
+                               rt_uint8_t *data, rt_uint32_t data_len,
+                               rt_uint8_t *spare, rt_uint32_t spare_len)
+{
+    RT_ASSERT(device != RT_NULL);
+
+    if (device->service && _service_pending(device->service, page))
+        _service_flush(device->service);
+
+    return rt_mtd_nand_read(device, page, data, data_len, spare, spare_len);
+}
+RTM_EXPORT(rt_mtd_nand_read_sync);
+
+/**
+ * This function waits for the queued operations done.
+ *
+ * @return RT_EOK on all of operations done successfully, or the error of the
+ * first failed operation since last sync.
+ */
+rt_err_t rt_mtd_nand_sync(struct rt_mtd_nand_device *device)
+{
+    struct rt_mtd_nand_service *svc;
+    rt_err_t result;
+
+    RT_ASSERT(device != RT_NULL);
+
+    svc = device->service;
+    if (svc == RT_NULL)
+        return RT_EOK;
+
+    _service_flush(svc);
+
+    rt_mutex_take(&svc->lock, RT_WAITING_FOREVER);
+    result = svc->error;
+    svc->error = RT_EOK;
+    rt_mutex_release(&svc->lock);
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_nand_sync);
+
+/**
+ * This function gets the statistics of MTD Nand device.
+ *
+ * @return RT_EOK on successful, -RT_ERROR on the service isn't initialized.
+ */
+rt_err_t rt_mtd_nand_get_stat(struct rt_mtd_nand_device *device, struct rt_mtd_nand_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(device != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    if (device->service == RT_NULL)
+        return -RT_ERROR;
+
+    level = rt_hw_interrupt_disable();
+    *stat = device->service->stat;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_nand_get_stat);
+
+/**
+ * This function gets the erase count of block, which can be used by the
+ * block allocator of file system for wear leveling.
+ */
+rt_uint32_t rt_mtd_nand_erase_count(struct rt_mtd_nand_device *device, rt_uint32_t block)
+{
+    RT_ASSERT(device != RT_NULL);
+
+    if (device->service == RT_NULL || block >= device->service->stat.block_num)
+        return 0;
+
+    return device->service->erase_count[block];
+}
+RTM_EXPORT(rt_mtd_nand_erase_count);
+
+/* it's invoked by the operations of device to update statistics */
+void rt_mtd_nand_stat_update(struct rt_mtd_nand_device *device, int op, rt_uint32_t index, rt_err_t result)
+{
+    struct rt_mtd_nand_service *svc = device->service;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    switch (op)
+    {
+    case RT_MTD_NAND_OP_READ:
+        svc->stat.page_read ++;
+        break;
+
+    case RT_MTD_NAND_OP_WRITE:
+        /* the pages written by garbage collection in service thread */
+        if (svc->in_gc && rt_thread_self() == svc->thread)
+            svc->stat.page_gc ++;
+        else
+            svc->stat.page_write ++;
+        break;
+
+    case RT_MTD_NAND_OP_MOVE:
+        svc->stat.page_move ++;
+        break;
+
+    case RT_MTD_NAND_OP_ERASE:
+        svc->stat.block_erase ++;
+        if (result == RT_EOK && index < svc->stat.block_num)
+            svc->erase_count[index] ++;
+        break;
+
+    case RT_MTD_NAND_OP_BATCH:
+        /* the pages of batch are counted by RT_MTD_NAND_OP_WRITE */
+        svc->stat.batch_write ++;
+        break;
+    }
+
+    if (result != RT_EOK && op != RT_MTD_NAND_OP_READ && op != RT_MTD_NAND_OP_BATCH)
+        svc->stat.error ++;
+    rt_hw_interrupt_enable(level);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void mtd_nand_stat(int argc, char **argv)
+{
+    struct rt_mtd_nand_device *nand;
+    struct rt_mtd_nand_stat stat;
+    rt_uint32_t index, min, max, amp;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: mtd_nand_stat <name>\n");
+        return;
+    }
+
+    nand = RT_MTD_NAND_DEVICE(rt_device_find(argv[1]));
+    if (nand == RT_NULL || rt_mtd_nand_get_stat(nand, &stat) != RT_EOK)
+    {
+        rt_kprintf("no nand device or service found!\n");
+        return;
+    }
+
+    min = max = stat.block_num ? stat.erase_count[0] : 0;
+    for (index = 1; index < stat.block_num; index ++)
+    {
+        if (stat.erase_count[index] < min) min = stat.erase_count[index];
+        if (stat.erase_count[index] > max) max = stat.erase_count[index];
+    }
+
+    /* write amplification in percent */
+    amp = stat.page_write ? (rt_uint32_t)(((rt_uint64_t)stat.page_write + stat.page_gc + stat.page_move)
+                                          * 100 / stat.page_write) : 0;
+
+    rt_kprintf("page read : %d\n", stat.page_read);
+    rt_kprintf("page write: %d, gc: %d, move: %d\n", stat.page_write, stat.page_gc, stat.page_move);
+    rt_kprintf("batch write: %d\n", stat.batch_write);
+    rt_kprintf("write amplification: %d.%02d\n", amp / 100, amp % 100);
+    rt_kprintf("block erase: %d, erase count min: %d, max: %d\n", stat.block_erase, min, max);
+    rt_kprintf("error: %d\n", stat.error);
+}
+MSH_CMD_EXPORT(mtd_nand_stat, show statistics of MTD nand device);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_MTD_NAND_USING_SERVICE */
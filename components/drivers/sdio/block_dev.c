@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author        Notes
  * 2011-07-25     weety     first version
+ * 2026-10-19     agent     add write queue, pre-erase and closed-ended transfer
+ * 2026-10-19     agent     write synchronously if the write queue isn't created
  */
 
 #include <rtthread.h>
@@ -33,6 +35,10 @@ struct mmcsd_blk_device
     struct dfs_partition part;
     struct rt_device_blk_geometry geometry;
     rt_size_t max_req_size;
+
+#ifdef RT_MMCSD_USING_QUEUE
+    struct mmcsd_blk_queue *queue;
+#endif
 };
 
 #ifndef RT_MMCSD_MAX_PARTITION
@@ -100,6 +106,54 @@ rt_int32_t mmcsd_num_wr_blocks(struct rt_mmcsd_card *card)
     return blocks;
 }
 
+/* tell the SD card the number of blocks to be written, so it can erase them in advance */
+static void mmcsd_pre_erase(struct rt_mmcsd_card *card, rt_size_t blks)
+{
+    struct rt_mmcsd_cmd cmd;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = APP_CMD;
+    cmd.arg = card->rca << 16;
+    cmd.flags = RESP_SPI_R1 | RESP_R1 | CMD_AC;
+
+    if (mmcsd_send_cmd(card->host, &cmd, 0))
+        return;
+    if (!controller_is_spi(card->host) && !(cmd.resp[0] & R1_APP_CMD))
+        return;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = SD_APP_SET_WR_BLK_ERASE_COUNT;
+    cmd.arg = blks & 0x7fffff;
+    cmd.flags = RESP_SPI_R1 | RESP_R1 | CMD_AC;
+
+    /* it's only a hint, the write works without it */
+    mmcsd_send_cmd(card->host, &cmd, 0);
+}
+
+/* set the number of blocks of next transfer on MMC card, which needs no stop command */
+static rt_err_t mmcsd_set_block_count(struct rt_mmcsd_card *card, rt_size_t blks)
+{
+    struct rt_mmcsd_cmd cmd;
+
+    /* SET_BLOCK_COUNT is supported since MMC 3.1, the version is CSD[125:122] */
+    if (card->card_type != CARD_TYPE_MMC || controller_is_spi(card->host) ||
+        ((card->resp_csd[0] >> 26) & 0x0f) < 3 || blks > 0xffff)
+        return -RT_ENOSYS;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = SET_BLOCK_COUNT;
+    cmd.arg = blks & 0xffff;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    if (mmcsd_send_cmd(card->host, &cmd, 0))
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
 static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
                                  rt_uint32_t           sector,
                                  void                 *buf,
@@ -141,6 +195,13 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
         }
         r_cmd = READ_MULTIPLE_BLOCK;
         w_cmd = WRITE_MULTIPLE_BLOCK;
+
+        if (dir && card->card_type == CARD_TYPE_SD)
+            mmcsd_pre_erase(card, blks);
+
+        /* the closed-ended transfer stops by itself */
+        if (mmcsd_set_block_count(card, blks) == RT_EOK)
+            req.stop = RT_NULL;
     }
     else
     {
@@ -202,6 +263,295 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
     return RT_EOK;
 }
 
+#ifdef RT_MMCSD_USING_QUEUE
+
+#ifndef RT_MMCSD_QUEUE_SECTORS
+#define RT_MMCSD_QUEUE_SECTORS      32
+#endif
+
+#ifndef RT_MMCSD_QUEUE_DEPTH
+#define RT_MMCSD_QUEUE_DEPTH        16
+#endif
+
+#ifndef RT_MMCSD_QUEUE_STACK_SIZE
+#define RT_MMCSD_QUEUE_STACK_SIZE   1024
+#endif
+
+#if !defined(RT_MMCSD_QUEUE_PRIORITY) || RT_MMCSD_QUEUE_PRIORITY >= RT_THREAD_PRIORITY_MAX
+#undef  RT_MMCSD_QUEUE_PRIORITY
+#define RT_MMCSD_QUEUE_PRIORITY     (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+/*
+ * The write queue of block device. The small writes are copied into the
+ * sector buffer and written by the queue thread in order, the write of the
+ * sectors following the last queued request is merged into it, and the write
+ * of the sectors covered by a pending request is absorbed in place, so the
+ * file system issues many small writes but the card sees a few long multiple
+ * block writes. The request doesn't wrap around in sector buffer, it's sent
+ * to card directly.
+ */
+struct mmcsd_blk_req
+{
+    rt_uint32_t sector;                 /* the first sector on card */
+    rt_uint32_t count;
+    rt_uint32_t slot;                   /* free running sector in buffer */
+    const void *buffer;                 /* the buffer of the last writer */
+};
+
+struct mmcsd_blk_queue
+{
+    struct rt_mutex lock;
+    struct rt_semaphore work_sem;       /* wake up the queue thread */
+    struct rt_semaphore wait_sem;       /* wake up the writers waiting for queue */
+    rt_uint16_t waiting;
+
+    struct mmcsd_blk_req reqs[RT_MMCSD_QUEUE_DEPTH];
+    rt_uint16_t put_index, get_index;   /* free running index of requests */
+    rt_bool_t busy;                     /* the head is being written */
+
+    rt_uint32_t slot_put, slot_get;     /* free running sector in buffer */
+    rt_uint8_t *buffer;
+
+    rt_err_t error;                     /* the first error of queued writes */
+    rt_thread_t thread;
+};
+
+rt_inline rt_uint8_t *mmcsd_queue_slot(struct mmcsd_blk_queue *queue, rt_uint32_t slot)
+{
+    return queue->buffer + (slot % RT_MMCSD_QUEUE_SECTORS) * SECTOR_SIZE;
+}
+
+/* wait for the queue changed, it's called with lock taken */
+static void mmcsd_queue_wait(struct mmcsd_blk_queue *queue)
+{
+    queue->waiting ++;
+    rt_mutex_release(&queue->lock);
+    rt_sem_take(&queue->wait_sem, RT_WAITING_FOREVER);
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+}
+
+static void mmcsd_queue_entry(void *parameter)
+{
+    struct mmcsd_blk_device *blk_dev = (struct mmcsd_blk_device *)parameter;
+    struct mmcsd_blk_queue *queue = blk_dev->queue;
+    struct mmcsd_blk_req req;
+    rt_err_t err;
+
+    while (1)
+    {
+        rt_sem_take(&queue->work_sem, RT_WAITING_FOREVER);
+
+        rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+        while (queue->get_index != queue->put_index)
+        {
+            /* the head isn't merged or absorbed while it's being written */
+            req = queue->reqs[queue->get_index % RT_MMCSD_QUEUE_DEPTH];
+            queue->busy = RT_TRUE;
+            rt_mutex_release(&queue->lock);
+
+            err = rt_mmcsd_req_blk(blk_dev->card, req.sector, mmcsd_queue_slot(queue, req.slot), req.count, 1);
+
+            rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+            if (err != RT_EOK && queue->error == RT_EOK)
+                queue->error = err;
+
+            queue->slot_get = req.slot + req.count;
+            queue->get_index ++;
+
+            if (blk_dev->dev.tx_complete != RT_NULL)
+            {
+                rt_mutex_release(&queue->lock);
+                blk_dev->dev.tx_complete(&blk_dev->dev, (void *)req.buffer);
+                rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+            }
+
+            /* the queue is idle after the completion invoked */
+            queue->busy = RT_FALSE;
+            for (; queue->waiting > 0; queue->waiting --)
+                rt_sem_release(&queue->wait_sem);
+        }
+        rt_mutex_release(&queue->lock);
+    }
+}
+
+/* queue the write, return RT_EOK on queued */
+static rt_err_t mmcsd_queue_write(struct mmcsd_blk_device *blk_dev, rt_uint32_t sector,
+                                  const void *buffer, rt_size_t count)
+{
+    struct mmcsd_blk_queue *queue = blk_dev->queue;
+    struct mmcsd_blk_req *req;
+    rt_uint32_t offset, skip;
+    rt_uint16_t index;
+    rt_err_t err;
+
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+
+    /* report the error of previous writes */
+    err = queue->error;
+    queue->error = RT_EOK;
+
+    while (err == RT_EOK)
+    {
+        /* the latest pending request overlapping the sectors */
+        for (index = queue->put_index; index != queue->get_index; index --)
+        {
+            req = &queue->reqs[(rt_uint16_t)(index - 1) % RT_MMCSD_QUEUE_DEPTH];
+            if (req->sector < sector + count && sector < req->sector + req->count)
+                break;
+        }
+
+        if (index != queue->get_index)
+        {
+            /* absorb the write covered by the request */
+            if (sector >= req->sector && sector + count <= req->sector + req->count &&
+                !(queue->busy && (rt_uint16_t)(index - 1) == queue->get_index))
+            {
+                rt_memcpy(mmcsd_queue_slot(queue, req->slot + sector - req->sector), buffer, count * SECTOR_SIZE);
+                req->buffer = buffer;
+                break;
+            }
+        }
+        else if (queue->put_index != queue->get_index)
+        {
+            /* merge the write following the last request */
+            req = &queue->reqs[(rt_uint16_t)(queue->put_index - 1) % RT_MMCSD_QUEUE_DEPTH];
+            offset = req->slot % RT_MMCSD_QUEUE_SECTORS + req->count;
+            if (req->sector + req->count == sector && req->slot + req->count == queue->slot_put &&
+                req->count + count <= blk_dev->max_req_size && offset + count <= RT_MMCSD_QUEUE_SECTORS &&
+                queue->slot_put + count - queue->slot_get <= RT_MMCSD_QUEUE_SECTORS &&
+                !(queue->busy && (rt_uint16_t)(queue->put_index - 1) == queue->get_index))
+            {
+                rt_memcpy(mmcsd_queue_slot(queue, queue->slot_put), buffer, count * SECTOR_SIZE);
+                req->count += count;
+                req->buffer = buffer;
+                queue->slot_put += count;
+                break;
+            }
+        }
+
+        /* the request doesn't wrap around in buffer */
+        offset = queue->slot_put % RT_MMCSD_QUEUE_SECTORS;
+        skip = (offset + count > RT_MMCSD_QUEUE_SECTORS) ? RT_MMCSD_QUEUE_SECTORS - offset : 0;
+
+        if ((rt_uint16_t)(queue->put_index - queue->get_index) < RT_MMCSD_QUEUE_DEPTH &&
+            queue->slot_put + skip + count - queue->slot_get <= RT_MMCSD_QUEUE_SECTORS)
+        {
+            queue->slot_put += skip;
+
+            req = &queue->reqs[queue->put_index % RT_MMCSD_QUEUE_DEPTH];
+            req->sector = sector;
+            req->count  = count;
+            req->slot   = queue->slot_put;
+            req->buffer = buffer;
+            rt_memcpy(mmcsd_queue_slot(queue, req->slot), buffer, count * SECTOR_SIZE);
+
+            queue->slot_put += count;
+            queue->put_index ++;
+
+            rt_sem_release(&queue->work_sem);
+            break;
+        }
+
+        /* the queue is full */
+        mmcsd_queue_wait(queue);
+    }
+
+    rt_mutex_release(&queue->lock);
+
+    return err;
+}
+
+/* wait for the queued writes done, only the ones overlapping the sectors if
+ * count isn't 0, it's called with lock taken */
+static void mmcsd_queue_drain(struct mmcsd_blk_queue *queue, rt_uint32_t sector, rt_size_t count)
+{
+    struct mmcsd_blk_req *req;
+    rt_uint16_t index;
+
+    while (queue->get_index != queue->put_index || queue->busy)
+    {
+        if (count != 0)
+        {
+            for (index = queue->get_index; index != queue->put_index; index ++)
+            {
+                req = &queue->reqs[index % RT_MMCSD_QUEUE_DEPTH];
+                if (req->sector < sector + count && sector < req->sector + req->count)
+                    break;
+            }
+
+            if (index == queue->put_index)
+                break;
+        }
+
+        mmcsd_queue_wait(queue);
+    }
+}
+
+/* wait for all of queued writes done, and report the error of them */
+static rt_err_t mmcsd_queue_flush(struct mmcsd_blk_device *blk_dev)
+{
+    struct mmcsd_blk_queue *queue = blk_dev->queue;
+    rt_err_t err;
+
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    mmcsd_queue_drain(queue, 0, 0);
+
+    err = queue->error;
+    queue->error = RT_EOK;
+    rt_mutex_release(&queue->lock);
+
+    return err;
+}
+
+static rt_err_t mmcsd_queue_init(struct mmcsd_blk_device *blk_dev)
+{
+    struct mmcsd_blk_queue *queue;
+
+    queue = (struct mmcsd_blk_queue *)rt_calloc(1, sizeof(struct mmcsd_blk_queue) +
+                                                RT_MMCSD_QUEUE_SECTORS * SECTOR_SIZE);
+    if (queue == RT_NULL)
+        return -RT_ENOMEM;
+
+    queue->thread = rt_thread_create(blk_dev->dev.parent.name, mmcsd_queue_entry, blk_dev,
+                                     RT_MMCSD_QUEUE_STACK_SIZE, RT_MMCSD_QUEUE_PRIORITY, 20);
+    if (queue->thread == RT_NULL)
+    {
+        rt_free(queue);
+        return -RT_ENOMEM;
+    }
+
+    /* the sector buffer follows the queue */
+    queue->buffer = (rt_uint8_t *)(queue + 1);
+    rt_mutex_init(&queue->lock, "mmcsdq", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&queue->work_sem, "mmcsdq", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&queue->wait_sem, "mmcsdw", 0, RT_IPC_FLAG_FIFO);
+
+    blk_dev->queue = queue;
+    rt_thread_startup(queue->thread);
+
+    return RT_EOK;
+}
+
+static void mmcsd_queue_deinit(struct mmcsd_blk_device *blk_dev)
+{
+    struct mmcsd_blk_queue *queue = blk_dev->queue;
+
+    if (queue == RT_NULL)
+        return;
+
+    mmcsd_queue_flush(blk_dev);
+
+    rt_thread_delete(queue->thread);
+    rt_mutex_detach(&queue->lock);
+    rt_sem_detach(&queue->work_sem);
+    rt_sem_detach(&queue->wait_sem);
+    rt_free(queue);
+    blk_dev->queue = RT_NULL;
+}
+
+#endif /* RT_MMCSD_USING_QUEUE */
+
 static rt_err_t rt_mmcsd_init(rt_device_t dev)
 {
     return RT_EOK;
@@ -225,6 +575,12 @@ static rt_err_t rt_mmcsd_control(rt_device_t dev, int cmd, void *args)
     case RT_DEVICE_CTRL_BLK_GETGEOME:
         rt_memcpy(args, &blk_dev->geometry, sizeof(struct rt_device_blk_geometry));
         break;
+#ifdef RT_MMCSD_USING_QUEUE
+    case RT_DEVICE_CTRL_BLK_SYNC:
+        if (blk_dev->queue != RT_NULL)
+            return mmcsd_queue_flush(blk_dev);
+        break;
+#endif
     default:
         break;
     }
@@ -250,6 +606,17 @@ static rt_size_t rt_mmcsd_read(rt_device_t dev,
         return 0;
     }
 
+#ifdef RT_MMCSD_USING_QUEUE
+    /* the queued writes of these sectors go first, the error of them is
+     * left to the next write or sync */
+    if (blk_dev->queue != RT_NULL)
+    {
+        rt_mutex_take(&blk_dev->queue->lock, RT_WAITING_FOREVER);
+        mmcsd_queue_drain(blk_dev->queue, part->offset + pos, size);
+        rt_mutex_release(&blk_dev->queue->lock);
+    }
+#endif
+
     rt_sem_take(part->lock, RT_WAITING_FOREVER);
     while (remain_size)
     {
@@ -291,6 +658,26 @@ static rt_size_t rt_mmcsd_write(rt_device_t dev,
         return 0;
     }
 
+#ifdef RT_MMCSD_USING_QUEUE
+    if (blk_dev->queue != RT_NULL)
+    {
+        /* the small write is queued, the large one is written after the queue */
+        if (size <= RT_MMCSD_QUEUE_SECTORS / 2)
+            err = mmcsd_queue_write(blk_dev, part->offset + pos, buffer, size);
+        else
+            err = mmcsd_queue_flush(blk_dev);
+
+        if (err)
+        {
+            rt_set_errno(-EIO);
+            return 0;
+        }
+
+        if (size <= RT_MMCSD_QUEUE_SECTORS / 2)
+            return size;
+    }
+#endif
+
     rt_sem_take(part->lock, RT_WAITING_FOREVER);
     while (remain_size)
     {
@@ -426,6 +813,11 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
                 rt_device_register(&blk_dev->dev, dname,
                     RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_REMOVABLE | RT_DEVICE_FLAG_STANDALONE);
                 rt_list_insert_after(&blk_devices, &blk_dev->list);
+#ifdef RT_MMCSD_USING_QUEUE
+                /* the writes go to card directly without queue */
+                if (mmcsd_queue_init(blk_dev) != RT_EOK)
+                    LOG_W("%s: create write queue failed, write synchronously", dname);
+#endif
             }
             else
             {
@@ -460,7 +852,11 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
                     rt_device_register(&blk_dev->dev, "sd0",
                         RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_REMOVABLE | RT_DEVICE_FLAG_STANDALONE);
                     rt_list_insert_after(&blk_devices, &blk_dev->list);
-    
+#ifdef RT_MMCSD_USING_QUEUE
+                    if (mmcsd_queue_init(blk_dev) != RT_EOK)
+                        LOG_W("sd0: create write queue failed, write synchronously");
+#endif
+
                     break;
                 }
                 else
@@ -510,6 +906,9 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
         		dfs_unmount(mounted_path);
         	}
 
+#ifdef RT_MMCSD_USING_QUEUE
+            mmcsd_queue_deinit(blk_dev);
+#endif
             rt_device_unregister(&blk_dev->dev);
             rt_list_remove(&blk_dev->list);
             rt_free(blk_dev);
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     agent        invoke irq_handle for stream mode
  */
 
 #include "sensor.h"
@@ -40,6 +41,18 @@ static char *const sensor_name_str[] =
  */
 void rt_sensor_cb(rt_sensor_t sen)
 {
+#ifdef RT_SENSOR_USING_STREAM
+    /* The driver writes the fifo into stream and the readers are notified on commit */
+    if (sen->stream != RT_NULL)
+    {
+        if (sen->irq_handle != RT_NULL)
+        {
+            sen->irq_handle(sen);
+        }
+        return;
+    }
+#endif
+
     if (sen->parent.rx_indicate == RT_NULL)
     {
         return;
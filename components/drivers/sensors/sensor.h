@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     agent        add stream mode
  */
 
 #ifndef __SENSOR_H__
@@ -138,6 +139,10 @@ struct rt_sensor_config
 
 typedef struct rt_sensor_device *rt_sensor_t;
 
+#ifdef RT_SENSOR_USING_STREAM
+struct rt_sensor_cursor;
+#endif
+
 struct rt_sensor_device
 {
     struct rt_device             parent;    /* The standard device */
@@ -153,6 +158,10 @@ struct rt_sensor_device
     struct rt_sensor_module     *module;    /* The sensor module */
     
     rt_err_t (*irq_handle)(rt_sensor_t sensor);             /* Called when an interrupt is generated, registered by the driver */
+
+#ifdef RT_SENSOR_USING_STREAM
+    struct rt_sensor_stream     *stream;    /* The ring shared by cursors in stream mode */
+#endif
 };
 
 struct rt_sensor_module
@@ -193,6 +202,39 @@ struct rt_sensor_data
     } data;
 };
 
+#ifdef RT_SENSOR_USING_STREAM
+/*
+ * The stream is a ring of data written by driver and read by cursors in place.
+ * The old data is overwritten when the ring is full, the cursor behind is moved
+ * forward and counts the overruns.
+ */
+struct rt_sensor_stream
+{
+    struct rt_sensor_data       *buffer;
+    rt_uint32_t                  size;      /* The number of data, power of 2 */
+    volatile rt_uint32_t         head;      /* The index of next data */
+    rt_uint32_t                  reserved;  /* The data being written by driver */
+
+    rt_uint32_t                  ts_last;   /* The timestamp of the latest data, unit: us */
+    rt_uint32_t                  ts_cpu;    /* The cputime of ts_last */
+    rt_tick_t                    ts_tick;   /* The tick of ts_last */
+
+    rt_list_t                    cursors;
+};
+
+struct rt_sensor_cursor
+{
+    rt_list_t                    list;
+    rt_sensor_t                  sensor;
+    rt_uint32_t                  tail;      /* The index of next data to read */
+    rt_uint32_t                  overruns;  /* The number of data lost */
+
+    rt_uint32_t                  watermark; /* The data available to indicate */
+    void (*indicate)(struct rt_sensor_cursor *cursor, rt_size_t count);
+    void                        *user_data;
+};
+#endif /* RT_SENSOR_USING_STREAM */
+
 struct rt_sensor_ops
 {
     rt_size_t (*fetch_data)(struct rt_sensor_device *sensor, void *buf, rt_size_t len);
@@ -204,6 +246,25 @@ int rt_hw_sensor_register(rt_sensor_t sensor,
                           rt_uint32_t              flag,
                           void                    *data);
 
+#ifdef RT_SENSOR_USING_STREAM
+rt_err_t rt_sensor_stream_init(rt_sensor_t sensor, rt_uint32_t size);
+void     rt_sensor_stream_deinit(rt_sensor_t sensor);
+
+/* API for the driver to write the data */
+struct rt_sensor_data *rt_sensor_stream_reserve(rt_sensor_t sensor, rt_size_t *count);
+void     rt_sensor_stream_commit(rt_sensor_t sensor, rt_size_t count);
+
+/* API for the reader */
+rt_err_t rt_sensor_cursor_attach(rt_sensor_t sensor, struct rt_sensor_cursor *cursor);
+void     rt_sensor_cursor_detach(struct rt_sensor_cursor *cursor);
+void     rt_sensor_cursor_set_indicate(struct rt_sensor_cursor *cursor, rt_uint32_t watermark,
+                                       void (*indicate)(struct rt_sensor_cursor *cursor, rt_size_t count),
+                                       void *user_data);
+rt_size_t rt_sensor_cursor_peek(struct rt_sensor_cursor *cursor, struct rt_sensor_data **data);
+rt_err_t rt_sensor_cursor_advance(struct rt_sensor_cursor *cursor, rt_size_t count);
+rt_size_t rt_sensor_cursor_read(struct rt_sensor_cursor *cursor, struct rt_sensor_data *data, rt_size_t count);
+#endif /* RT_SENSOR_USING_STREAM */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+/*
+ * The stream mode of sensor. The driver reserves the slots in ring and reads
+ * the hardware fifo into them by DMA, then commits the batch in ISR. The batch
+ * is stamped with the time of commit in microsecond, and the timestamps of
+ * earlier data are interpolated by the sample period. Every reader has its own
+ * cursor and reads the data in place.
+ */
+
+#include <rthw.h>
+#include "sensor.h"
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#define DBG_TAG  "sensor.stream"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#include <string.h>
+
+#define STREAM_INDEX(stream, index)  ((index) & ((stream)->size - 1))
+
+/* the time in microsecond, the cputime counter is used in one second between calls */
+static rt_uint32_t _stream_time(struct rt_sensor_stream *stream)
+{
+    rt_tick_t tick = rt_tick_get();
+    rt_uint32_t elapsed;
+#ifdef RT_USING_CPUTIME
+    float unit = clock_cpu_getres();
+
+    /* the resolution is 0 if the cputime isn't provided by BSP, use the tick */
+    if (unit > 0)
+    {
+        if (tick - stream->ts_tick < RT_TICK_PER_SECOND)
+        {
+            rt_uint32_t cpu = clock_cpu_gettime();
+
+            /* the fraction of microsecond is kept in the counter */
+            elapsed = clock_cpu_microsecond(cpu - stream->ts_cpu);
+            stream->ts_cpu += (rt_uint32_t)(elapsed * 1000 / unit);
+            stream->ts_tick = tick;
+            stream->ts_last += elapsed;
+
+            return stream->ts_last;
+        }
+        stream->ts_cpu = clock_cpu_gettime();
+    }
+#endif
+
+    elapsed = (rt_uint32_t)((rt_uint64_t)(tick - stream->ts_tick) * 1000000 / RT_TICK_PER_SECOND);
+    stream->ts_tick = tick;
+    stream->ts_last += elapsed;
+
+    return stream->ts_last;
+}
+
+/*
+ * the period between data. The measured one keeps the timestamps after the
+ * previous batch, the one of ODR is used after the sensor has been idle.
+ */
+static rt_uint32_t _stream_period(rt_sensor_t sensor, rt_uint32_t elapsed, rt_size_t count)
+{
+    rt_uint32_t expected = 0, measured;
+
+    if (sensor->config.odr > 0)
+        expected = 1000000 / sensor->config.odr;
+
+    measured = elapsed / count;
+    if (expected > 0 && measured > expected * 2)
+        return expected;
+
+    return measured;
+}
+
+/**
+ * This function initializes the stream mode of sensor, the data written by
+ * driver is kept in the ring.
+ *
+ * @param sensor the sensor device.
+ * @param size the number of data in ring, it must be power of 2.
+ *
+ * @return RT_EOK on successful, -RT_EBUSY on stream has been initialized or
+ *         -RT_ENOMEM on failed to allocate.
+ */
+rt_err_t rt_sensor_stream_init(rt_sensor_t sensor, rt_uint32_t size)
+{
+    struct rt_sensor_stream *stream;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(size > 0 && (size & (size - 1)) == 0);
+
+    if (sensor->stream != RT_NULL)
+        return -RT_EBUSY;
+
+    stream = (struct rt_sensor_stream *)rt_calloc(1, sizeof(struct rt_sensor_stream));
+    if (stream == RT_NULL)
+        return -RT_ENOMEM;
+
+    stream->buffer = (struct rt_sensor_data *)rt_calloc(size, sizeof(struct rt_sensor_data));
+    if (stream->buffer == RT_NULL)
+    {
+        rt_free(stream);
+        return -RT_ENOMEM;
+    }
+
+    stream->size = size;
+    stream->ts_tick = rt_tick_get();
+#ifdef RT_USING_CPUTIME
+    stream->ts_cpu = clock_cpu_gettime();
+#endif
+    rt_list_init(&stream->cursors);
+
+    sensor->stream = stream;
+    LOG_D("stream of %d data", size);
+
+    return RT_EOK;
+}
+
+/**
+ * This function deinitializes the stream mode of sensor, the cursors are
+ * detached.
+ *
+ * @param sensor the sensor device.
+ */
+void rt_sensor_stream_deinit(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream;
+    struct rt_sensor_cursor *cursor;
+    rt_base_t level;
+
+    RT_ASSERT(sensor != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    stream = sensor->stream;
+    sensor->stream = RT_NULL;
+    if (stream != RT_NULL)
+    {
+        while (!rt_list_isempty(&stream->cursors))
+        {
+            cursor = rt_list_entry(stream->cursors.next, struct rt_sensor_cursor, list);
+            rt_list_remove(&cursor->list);
+            cursor->sensor = RT_NULL;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (stream != RT_NULL)
+    {
+        rt_free(stream->buffer);
+        rt_free(stream);
+    }
+}
+
+/**
+ * This function reserves the slots in ring for the driver, the data is written
+ * into them and committed by rt_sensor_stream_commit. It's used in ISR or the
+ * thread of driver. It can be called again before commit to reserve the slots
+ * after the end of ring, so the fifo is committed in one batch.
+ *
+ * @param sensor the sensor device.
+ * @param count the number of data wanted, it's set to the number of slots
+ *        reserved, which are contiguous in ring.
+ *
+ * @return the first slot reserved, or RT_NULL on stream mode is not used.
+ */
+struct rt_sensor_data *rt_sensor_stream_reserve(rt_sensor_t sensor, rt_size_t *count)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    rt_uint32_t index, length;
+    rt_base_t level;
+
+    RT_ASSERT(count != RT_NULL);
+
+    if (stream == RT_NULL)
+    {
+        *count = 0;
+        return RT_NULL;
+    }
+
+    index = STREAM_INDEX(stream, stream->head + stream->reserved);
+    length = stream->size - index;
+    if (length > stream->size - stream->reserved)
+        length = stream->size - stream->reserved;
+    if (*count > length)
+        *count = length;
+
+    /* the readers check the reservation for the data overwritten */
+    level = rt_hw_interrupt_disable();
+    stream->reserved += *count;
+    rt_hw_interrupt_enable(level);
+
+    return &stream->buffer[index];
+}
+
+/**
+ * This function commits the data written into the slots reserved. The data are
+ * stamped with the current time for the latest one, and the cursors reach the
+ * watermark are indicated.
+ *
+ * @param sensor the sensor device.
+ * @param count the number of data written, it doesn't exceed the reservation,
+ *        and the rest of reservation is released.
+ */
+void rt_sensor_stream_commit(rt_sensor_t sensor, rt_size_t count)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    struct rt_sensor_data *data;
+    struct rt_sensor_cursor *cursor;
+    rt_uint32_t last, now, period, index;
+    rt_size_t available;
+    rt_list_t *node;
+    rt_base_t level;
+
+    if (stream == RT_NULL)
+        return;
+
+    RT_ASSERT(count <= stream->reserved);
+
+    if (count > 0)
+    {
+        /* interpolate the timestamps across the batch */
+        last = stream->ts_last;
+        now = _stream_time(stream);
+        period = _stream_period(sensor, now - last, count);
+
+        for (index = 0; index < count; index ++)
+        {
+            data = &stream->buffer[STREAM_INDEX(stream, stream->head + index)];
+            data->timestamp = now - (count - 1 - index) * period;
+            data->type = sensor->info.type;
+        }
+    }
+
+    level = rt_hw_interrupt_disable();
+    stream->head += count;
+    stream->reserved = 0;
+    rt_hw_interrupt_enable(level);
+
+    if (count == 0)
+        return;
+
+    rt_list_for_each(node, &stream->cursors)
+    {
+        cursor = rt_list_entry(node, struct rt_sensor_cursor, list);
+        if (cursor->indicate == RT_NULL)
+            continue;
+
+        available = stream->head - cursor->tail;
+        if (available > stream->size)
+            available = stream->size;
+        if (available >= cursor->watermark)
+            cursor->indicate(cursor, available);
+    }
+
+    if (sensor->parent.rx_indicate != RT_NULL)
+        sensor->parent.rx_indicate(&sensor->parent, count);
+}
+
+/**
+ * This function attaches the cursor to the stream of sensor, it reads the data
+ * committed later.
+ *
+ * @param sensor the sensor device.
+ * @param cursor the cursor.
+ *
+ * @return RT_EOK on successful, -RT_ERROR on stream mode is not used.
+ */
+rt_err_t rt_sensor_cursor_attach(rt_sensor_t sensor, struct rt_sensor_cursor *cursor)
+{
+    rt_base_t level;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(cursor != RT_NULL);
+
+    rt_memset(cursor, 0, sizeof(struct rt_sensor_cursor));
+    rt_list_init(&cursor->list);
+    cursor->watermark = 1;
+
+    level = rt_hw_interrupt_disable();
+    if (sensor->stream == RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_ERROR;
+    }
+
+    cursor->sensor = sensor;
+    cursor->tail = sensor->stream->head;
+    rt_list_insert_before(&sensor->stream->cursors, &cursor->list);
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * This function detaches the cursor from the stream.
+ *
+ * @param cursor the cursor.
+ */
+void rt_sensor_cursor_detach(struct rt_sensor_cursor *cursor)
+{
+    rt_base_t level;
+
+    RT_ASSERT(cursor != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_remove(&cursor->list);
+    cursor->sensor = RT_NULL;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function sets the callback invoked on commit, when the data available
+ * for the cursor reach the watermark.
+ *
+ * @param cursor the cursor.
+ * @param watermark the number of data available.
+ * @param indicate the callback, it's invoked in ISR generally.
+ * @param user_data the user data of cursor.
+ */
+void rt_sensor_cursor_set_indicate(struct rt_sensor_cursor *cursor, rt_uint32_t watermark,
+                                   void (*indicate)(struct rt_sensor_cursor *cursor, rt_size_t count),
+                                   void *user_data)
+{
+    rt_base_t level;
+
+    RT_ASSERT(cursor != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    cursor->watermark = watermark > 0 ? watermark : 1;
+    cursor->indicate = indicate;
+    cursor->user_data = user_data;
+    rt_hw_interrupt_enable(level);
+}
+
+/* move the cursor forward to the oldest data not overwritten, the interrupt is disabled */
+static void _cursor_resync(struct rt_sensor_cursor *cursor, struct rt_sensor_stream *stream)
+{
+    rt_uint32_t lost;
+
+    lost = stream->head + stream->reserved - cursor->tail;
+    if (lost > stream->size)
+    {
+        lost -= stream->size;
+        cursor->tail += lost;
+        cursor->overruns += lost;
+    }
+}
+
+/**
+ * This function gets the data available for the cursor without copy, the data
+ * is valid until rt_sensor_cursor_advance returns RT_EOK.
+ *
+ * @param cursor the cursor.
+ * @param data the first data available.
+ *
+ * @return the number of data contiguous in ring.
+ */
+rt_size_t rt_sensor_cursor_peek(struct rt_sensor_cursor *cursor, struct rt_sensor_data **data)
+{
+    struct rt_sensor_stream *stream;
+    rt_uint32_t index, length;
+    rt_base_t level;
+
+    RT_ASSERT(cursor != RT_NULL);
+    RT_ASSERT(data != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (cursor->sensor == RT_NULL || cursor->sensor->stream == RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        return 0;
+    }
+
+    stream = cursor->sensor->stream;
+    _cursor_resync(cursor, stream);
+    length = stream->head - cursor->tail;
+    rt_hw_interrupt_enable(level);
+
+    index = STREAM_INDEX(stream, cursor->tail);
+    if (length > stream->size - index)
+        length = stream->size - index;
+    *data = &stream->buffer[index];
+
+    return length;
+}
+
+/**
+ * This function moves the cursor after the data peeked, and checks whether
+ * the data is overwritten by driver during reading.
+ *
+ * @param cursor the cursor.
+ * @param count the number of data read.
+ *
+ * @return RT_EOK on the data read is valid, -RT_EFULL on some of them is
+ *         overwritten and the cursor moves to the oldest data.
+ */
+rt_err_t rt_sensor_cursor_advance(struct rt_sensor_cursor *cursor, rt_size_t count)
+{
+    struct rt_sensor_stream *stream;
+    rt_err_t result = RT_EOK;
+    rt_base_t level;
+
+    RT_ASSERT(cursor != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (cursor->sensor == RT_NULL || cursor->sensor->stream == RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_ERROR;
+    }
+
+    stream = cursor->sensor->stream;
+    if (stream->head + stream->reserved - cursor->tail > stream->size)
+    {
+        _cursor_resync(cursor, stream);
+        result = -RT_EFULL;
+    }
+    else
+    {
+        cursor->tail += count;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+/**
+ * This function copies the data available for the cursor.
+ *
+ * @param cursor the cursor.
+ * @param data the buffer of data.
+ * @param count the number of data in buffer.
+ *
+ * @return the number of data read.
+ */
+rt_size_t rt_sensor_cursor_read(struct rt_sensor_cursor *cursor, struct rt_sensor_data *data, rt_size_t count)
+{
+    struct rt_sensor_data *ptr;
+    rt_size_t length, index = 0;
+
+    while (index < count)
+    {
+        length = rt_sensor_cursor_peek(cursor, &ptr);
+        if (length == 0)
+            break;
+        if (length > count - index)
+            length = count - index;
+
+        rt_memcpy(&data[index], ptr, length * sizeof(struct rt_sensor_data));
+
+        /* the copy is dropped if the driver overwrites it */
+        if (rt_sensor_cursor_advance(cursor, length) == RT_EOK)
+            index += length;
+    }
+
+    return index;
+}
@@ -22,6 +22,9 @@
  * 2017-11-15     JasonJia     fix poll rx issue when data is full.
  *                             add TCFLSH and FIONREAD support.
  * 2018-12-08     Ernest Chen  add DMA choice
+ * 2026-10-19     agent        copy rx data in block, add idle event and rx statistics
+ * 2026-10-19     agent        coalesce DMA tx writes, add scatter-gather and async write
+ * 2026-10-19     agent        always copy the small DMA tx write
  */
 
 #include <rthw.h>
@@ -251,54 +254,111 @@ rt_inline int _serial_poll_tx(struct rt_serial_device *serial, const rt_uint8_t
 }
 
 /*
- * Serial interrupt routines
+ * Serial software fifo routines, the data is copied in block.
  */
-rt_inline int _serial_int_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
+static rt_size_t _serial_fifo_calc_recved_len(struct rt_serial_device *serial)
 {
-    int size;
-    struct rt_serial_rx_fifo* rx_fifo;
+    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
 
-    RT_ASSERT(serial != RT_NULL);
-    size = length;
+    RT_ASSERT(rx_fifo != RT_NULL);
+
+    if (rx_fifo->put_index == rx_fifo->get_index)
+    {
+        return (rx_fifo->is_full == RT_FALSE ? 0 : serial->config.bufsz);
+    }
+    else
+    {
+        if (rx_fifo->put_index > rx_fifo->get_index)
+        {
+            return rx_fifo->put_index - rx_fifo->get_index;
+        }
+        else
+        {
+            return serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index);
+        }
+    }
+}
+
+/* put the received data into fifo, it's called with interrupt disabled */
+static void _serial_fifo_put(struct rt_serial_device *serial, const rt_uint8_t *data, rt_size_t length)
+{
+    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
+    rt_size_t bufsz = serial->config.bufsz;
+    rt_size_t recved, len;
 
-    rx_fifo = (struct rt_serial_rx_fifo*) serial->serial_rx;
     RT_ASSERT(rx_fifo != RT_NULL);
 
-    /* read from software FIFO */
-    while (length)
+    serial->rx_stat.rx_bytes += length;
+    recved = _serial_fifo_calc_recved_len(serial);
+
+    /* the oldest data is discarded when fifo is full */
+    if (recved + length > bufsz)
+        serial->rx_stat.fifo_overrun += recved + length - bufsz;
+    if (length > bufsz)
     {
-        int ch;
-        rt_base_t level;
+        data += length - bufsz;
+        length = bufsz;
+    }
+
+    len = bufsz - rx_fifo->put_index;
+    if (len > length) len = length;
+    rt_memcpy(rx_fifo->buffer + rx_fifo->put_index, data, len);
+    rt_memcpy(rx_fifo->buffer, data + len, length - len);
+
+    rx_fifo->put_index = (rx_fifo->put_index + length) % bufsz;
+    if (recved + length >= bufsz)
+    {
+        rx_fifo->get_index = rx_fifo->put_index;
+        rx_fifo->is_full = RT_TRUE;
+    }
+}
+
+/* get data from fifo, the interrupt is disabled for at most RT_SERIAL_RX_COPY_MAX bytes copied */
+static rt_size_t _serial_fifo_get(struct rt_serial_device *serial, rt_uint8_t *data, rt_size_t length)
+{
+    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
+    rt_size_t size = 0, len;
+    rt_base_t level;
 
-        /* disable interrupt */
+    RT_ASSERT(rx_fifo != RT_NULL);
+
+    while (size < length)
+    {
         level = rt_hw_interrupt_disable();
 
-        /* there's no data: */
-        if ((rx_fifo->get_index == rx_fifo->put_index) && (rx_fifo->is_full == RT_FALSE))
+        len = _serial_fifo_calc_recved_len(serial);
+        if (len == 0)
         {
-            /* no data, enable interrupt and break out */
             rt_hw_interrupt_enable(level);
             break;
         }
 
-        /* otherwise there's the data: */
-        ch = rx_fifo->buffer[rx_fifo->get_index];
-        rx_fifo->get_index += 1;
-        if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
+        if (len > length - size) len = length - size;
+        if (len > serial->config.bufsz - rx_fifo->get_index)
+            len = serial->config.bufsz - rx_fifo->get_index;
+        if (len > RT_SERIAL_RX_COPY_MAX) len = RT_SERIAL_RX_COPY_MAX;
 
-        if (rx_fifo->is_full == RT_TRUE)
-        {
-            rx_fifo->is_full = RT_FALSE;
-        }
+        rt_memcpy(data + size, rx_fifo->buffer + rx_fifo->get_index, len);
+        rx_fifo->get_index = (rx_fifo->get_index + len) % serial->config.bufsz;
+        rx_fifo->is_full = RT_FALSE;
 
-        /* enable interrupt */
         rt_hw_interrupt_enable(level);
 
-        *data = ch & 0xff;
-        data ++; length --;
+        size += len;
     }
 
-    return size - length;
+    return size;
+}
+
+/*
+ * Serial interrupt routines
+ */
+rt_inline int _serial_int_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
+{
+    RT_ASSERT(serial != RT_NULL);
+
+    /* read from software FIFO */
+    return _serial_fifo_get(serial, data, length);
 }
 
 rt_inline int _serial_int_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
@@ -326,30 +386,6 @@ rt_inline int _serial_int_tx(struct rt_serial_device *serial, const rt_uint8_t *
     return size - length;
 }
 
-#if defined(RT_USING_POSIX) || defined(RT_SERIAL_USING_DMA)
-static rt_size_t _serial_fifo_calc_recved_len(struct rt_serial_device *serial)
-{
-    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
-
-    RT_ASSERT(rx_fifo != RT_NULL);
-
-    if (rx_fifo->put_index == rx_fifo->get_index)
-    {
-        return (rx_fifo->is_full == RT_FALSE ? 0 : serial->config.bufsz);
-    }
-    else
-    {
-        if (rx_fifo->put_index > rx_fifo->get_index)
-        {
-            return rx_fifo->put_index - rx_fifo->get_index;
-        }
-        else
-        {
-            return serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index);
-        }
-    }
-}
-#endif /* RT_USING_POSIX || RT_SERIAL_USING_DMA */
 
 #ifdef RT_SERIAL_USING_DMA
 /**
@@ -364,28 +400,6 @@ static rt_size_t rt_dma_calc_recved_len(struct rt_serial_device *serial)
     return _serial_fifo_calc_recved_len(serial);
 }
 
-/**
- * Read data finish by DMA mode then update the get index for receive fifo.
- *
- * @param serial serial device
- * @param len get data length for this operate
- */
-static void rt_dma_recv_update_get_index(struct rt_serial_device *serial, rt_size_t len)
-{
-    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
-
-    RT_ASSERT(rx_fifo != RT_NULL);
-    RT_ASSERT(len <= rt_dma_calc_recved_len(serial));
-
-    if (rx_fifo->is_full && len != 0) rx_fifo->is_full = RT_FALSE;
-
-    rx_fifo->get_index += len;
-    if (rx_fifo->get_index >= serial->config.bufsz)
-    {
-        rx_fifo->get_index %= serial->config.bufsz;
-    }
-}
-
 /**
  * DMA received finish then update put index for receive fifo.
  *
@@ -395,9 +409,16 @@ static void rt_dma_recv_update_get_index(struct rt_serial_device *serial, rt_siz
 static void rt_dma_recv_update_put_index(struct rt_serial_device *serial, rt_size_t len)
 {
     struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *)serial->serial_rx;
+    rt_size_t recved;
 
     RT_ASSERT(rx_fifo != RT_NULL);
 
+    /* the DMA overwrites the data not read */
+    recved = rt_dma_calc_recved_len(serial);
+    if (recved + len > serial->config.bufsz)
+        serial->rx_stat.fifo_overrun += recved + len - serial->config.bufsz;
+    serial->rx_stat.rx_bytes += len;
+
     if (rx_fifo->get_index <= rx_fifo->put_index)
     {
         rx_fifo->put_index += len;
@@ -468,64 +489,204 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
     }
     else
     {
-        struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
-        rt_size_t recv_len = 0, fifo_recved_len = rt_dma_calc_recved_len(serial);
+        rt_hw_interrupt_enable(level);
 
-        RT_ASSERT(rx_fifo != RT_NULL);
+        return _serial_fifo_get(serial, data, length);
+    }
+}
 
-        if (length < (int)fifo_recved_len)
-            recv_len = length;
-        else
-            recv_len = fifo_recved_len;
+/* start the DMA transfer of queued requests, it's called with interrupt disabled */
+static void _serial_dma_tx_kick(struct rt_serial_device *serial)
+{
+    struct rt_serial_tx_dma *tx_dma = (struct rt_serial_tx_dma *)serial->serial_tx;
+    struct rt_serial_tx_req *req;
+    rt_uint16_t index;
+    int sg_num = 0;
+
+    if (tx_dma->activated == RT_TRUE || tx_dma->get_index == tx_dma->put_index)
+        return;
 
-        if (rx_fifo->get_index + recv_len < serial->config.bufsz)
-            rt_memcpy(data, rx_fifo->buffer + rx_fifo->get_index, recv_len);
+    /* the adjacent requests are merged into one segment */
+    for (index = tx_dma->get_index; index != tx_dma->put_index; index ++)
+    {
+        req = &tx_dma->reqs[index % RT_SERIAL_DMA_TX_QUEUE];
+
+        if (sg_num > 0 && tx_dma->sg[sg_num - 1].buf + tx_dma->sg[sg_num - 1].size == req->dma_buf)
+        {
+            tx_dma->sg[sg_num - 1].size += req->size;
+        }
         else
         {
-            rt_memcpy(data, rx_fifo->buffer + rx_fifo->get_index,
-                    serial->config.bufsz - rx_fifo->get_index);
-            rt_memcpy(data + serial->config.bufsz - rx_fifo->get_index, rx_fifo->buffer,
-                    recv_len + rx_fifo->get_index - serial->config.bufsz);
+            /* the driver without scatter-gather sends one segment only */
+            if (sg_num == (serial->ops->dma_transmit_sg ? RT_SERIAL_DMA_TX_SG_MAX : 1))
+                break;
+
+            tx_dma->sg[sg_num].buf  = req->dma_buf;
+            tx_dma->sg[sg_num].size = req->size;
+            sg_num ++;
         }
-        rt_dma_recv_update_get_index(serial, recv_len);
-        rt_hw_interrupt_enable(level);
-        return recv_len;
     }
+
+    tx_dma->inflight  = index - tx_dma->get_index;
+    tx_dma->activated = RT_TRUE;
+
+    /* make a DMA transfer */
+    if (serial->ops->dma_transmit_sg)
+        serial->ops->dma_transmit_sg(serial, tx_dma->sg, sg_num);
+    else
+        serial->ops->dma_transmit(serial, tx_dma->sg[0].buf, tx_dma->sg[0].size, RT_SERIAL_DMA_TX);
 }
 
-rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+/* queue a tx request, the small write is copied into bounce buffer */
+static rt_err_t _serial_dma_tx_push(struct rt_serial_device *serial, const rt_uint8_t *data, rt_size_t length,
+                                    rt_serial_tx_done_t done, void *param, rt_int32_t timeout)
 {
+    struct rt_serial_tx_dma *tx_dma = (struct rt_serial_tx_dma *)serial->serial_tx;
+    struct rt_serial_tx_req *req;
+    rt_size_t offset, skip = 0;
     rt_base_t level;
-    rt_err_t result;
-    struct rt_serial_tx_dma *tx_dma;
 
-    tx_dma = (struct rt_serial_tx_dma*)(serial->serial_tx);
+    if (rt_sem_take(&(tx_dma->free_sem), timeout) != RT_EOK)
+        return -RT_EFULL;
+
+    level = rt_hw_interrupt_disable();
 
-    result = rt_data_queue_push(&(tx_dma->data_queue), data, length, RT_WAITING_FOREVER);
-    if (result == RT_EOK)
+    /* the small write is always copied, the writer may reuse its buffer at
+     * once. Wait for the bounce buffer released by the transfer in flight. */
+    while (length <= RT_SERIAL_DMA_TX_COALESCE)
     {
-        level = rt_hw_interrupt_disable();
-        if (tx_dma->activated != RT_TRUE)
-        {
-            tx_dma->activated = RT_TRUE;
-            rt_hw_interrupt_enable(level);
+        /* the data in bounce buffer doesn't wrap around */
+        offset = tx_dma->bounce_put % RT_SERIAL_DMA_TX_BUFSZ;
+        skip = (offset + length > RT_SERIAL_DMA_TX_BUFSZ) ? RT_SERIAL_DMA_TX_BUFSZ - offset : 0;
 
-            /* make a DMA transfer */
-            serial->ops->dma_transmit(serial, (rt_uint8_t *)data, length, RT_SERIAL_DMA_TX);
-        }
-        else
+        if (tx_dma->bounce_put - tx_dma->bounce_get + skip + length <= RT_SERIAL_DMA_TX_BUFSZ)
+            break;
+
+        if (timeout == 0)
         {
             rt_hw_interrupt_enable(level);
+            rt_sem_release(&(tx_dma->free_sem));
+            return -RT_EFULL;
         }
 
-        return length;
+        tx_dma->bounce_waiting ++;
+        rt_hw_interrupt_enable(level);
+        rt_sem_take(&(tx_dma->bounce_sem), RT_WAITING_FOREVER);
+        level = rt_hw_interrupt_disable();
     }
-    else
+
+    req = &tx_dma->reqs[tx_dma->put_index % RT_SERIAL_DMA_TX_QUEUE];
+    req->data    = data;
+    req->dma_buf = (rt_uint8_t *)data;
+    req->size    = length;
+    req->done    = done;
+    req->param   = param;
+
+    if (length <= RT_SERIAL_DMA_TX_COALESCE)
+    {
+        tx_dma->bounce_put += skip;
+        req->dma_buf = tx_dma->bounce + tx_dma->bounce_put % RT_SERIAL_DMA_TX_BUFSZ;
+        rt_memcpy(req->dma_buf, data, length);
+        tx_dma->bounce_put += length;
+        req->bounce_end = tx_dma->bounce_put;
+    }
+
+    tx_dma->put_index ++;
+    _serial_dma_tx_kick(serial);
+
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/* the DMA transfer done, complete the requests and start the next transfer */
+static void _serial_dma_tx_done(struct rt_serial_device *serial)
+{
+    struct rt_serial_tx_dma *tx_dma = (struct rt_serial_tx_dma *)serial->serial_tx;
+    struct rt_serial_tx_req *req;
+    rt_uint16_t index, first, count;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+
+    first = tx_dma->get_index;
+    count = tx_dma->inflight;
+    tx_dma->get_index += count;
+    tx_dma->inflight  = 0;
+    tx_dma->activated = RT_FALSE;
+
+    /* release the bounce buffer */
+    for (index = first; index != tx_dma->get_index; index ++)
+    {
+        req = &tx_dma->reqs[index % RT_SERIAL_DMA_TX_QUEUE];
+        if (req->dma_buf != req->data)
+            tx_dma->bounce_get = req->bounce_end;
+    }
+    while (tx_dma->bounce_waiting > 0)
+    {
+        tx_dma->bounce_waiting --;
+        rt_sem_release(&(tx_dma->bounce_sem));
+    }
+
+    _serial_dma_tx_kick(serial);
+
+    rt_hw_interrupt_enable(level);
+
+    /* the request is free after the completion invoked */
+    for (index = first; count > 0; index ++, count --)
+    {
+        req = &tx_dma->reqs[index % RT_SERIAL_DMA_TX_QUEUE];
+
+        if (req->done)
+            req->done(serial, req->data, req->param);
+        else if (serial->parent.tx_complete != RT_NULL)
+            serial->parent.tx_complete(&serial->parent, (void *)req->data);
+
+        rt_sem_release(&(tx_dma->free_sem));
+    }
+}
+
+rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+{
+    rt_err_t result;
+
+    result = _serial_dma_tx_push(serial, data, length, RT_NULL, RT_NULL, RT_WAITING_FOREVER);
+    if (result != RT_EOK)
     {
         rt_set_errno(result);
         return 0;
     }
+
+    return length;
 }
+
+/**
+ * This function writes data to serial in DMA tx mode without blocking.
+ *
+ * @param serial the serial device opened with RT_DEVICE_FLAG_DMA_TX.
+ * @param buffer the data to write, the data larger than RT_SERIAL_DMA_TX_COALESCE
+ * is sent from this buffer, so it should be kept until done.
+ * @param size the size of data.
+ * @param done the completion invoked in ISR, or RT_NULL to invoke tx_complete
+ * of device.
+ * @param param the parameter of completion.
+ *
+ * @return RT_EOK on queued, -RT_EFULL on the queue or the bounce buffer is full,
+ * -RT_ENOSYS on the device isn't in DMA tx mode.
+ */
+rt_err_t rt_serial_write_async(struct rt_serial_device *serial, const void *buffer, rt_size_t size,
+                               rt_serial_tx_done_t done, void *param)
+{
+    RT_ASSERT(serial != RT_NULL);
+
+    if (!(serial->parent.open_flag & RT_DEVICE_FLAG_DMA_TX) || serial->serial_tx == RT_NULL)
+        return -RT_ENOSYS;
+    if (size == 0)
+        return -RT_EINVAL;
+
+    return _serial_dma_tx_push(serial, (const rt_uint8_t *)buffer, size, done, param, 0);
+}
+RTM_EXPORT(rt_serial_write_async);
 #endif /* RT_SERIAL_USING_DMA */
 
 /* RT-Thread Device Interface */
@@ -666,9 +827,11 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
 
             tx_dma = (struct rt_serial_tx_dma*) rt_malloc (sizeof(struct rt_serial_tx_dma));
             RT_ASSERT(tx_dma != RT_NULL);
+            rt_memset(tx_dma, 0, sizeof(struct rt_serial_tx_dma));
             tx_dma->activated = RT_FALSE;
 
-            rt_data_queue_init(&(tx_dma->data_queue), 8, 4, RT_NULL);
+            rt_sem_init(&(tx_dma->free_sem), "stx", RT_SERIAL_DMA_TX_QUEUE, RT_IPC_FLAG_FIFO);
+            rt_sem_init(&(tx_dma->bounce_sem), "stxb", 0, RT_IPC_FLAG_FIFO);
             serial->serial_tx = tx_dma;
 
             dev->open_flag |= RT_DEVICE_FLAG_DMA_TX;
@@ -766,6 +929,8 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
         tx_dma = (struct rt_serial_tx_dma*)serial->serial_tx;
         RT_ASSERT(tx_dma != RT_NULL);
 
+        rt_sem_detach(&(tx_dma->free_sem));
+        rt_sem_detach(&(tx_dma->bounce_sem));
         rt_free(tx_dma);
         serial->serial_tx = RT_NULL;
         dev->open_flag &= ~RT_DEVICE_FLAG_DMA_TX;
@@ -1059,6 +1224,17 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
         case TCXONC:
             break;
 #endif
+        case RT_SERIAL_CTRL_GET_RX_STAT:
+            {
+                rt_base_t level;
+
+                if (args == RT_NULL) return -RT_EINVAL;
+
+                level = rt_hw_interrupt_disable();
+                *(struct rt_serial_rx_stat *)args = serial->rx_stat;
+                rt_hw_interrupt_enable(level);
+            }
+            break;
 #ifdef RT_USING_POSIX
         case FIONREAD:
             {
@@ -1124,6 +1300,8 @@ rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
 #endif
     device->user_data   = data;
 
+    rt_memset(&serial->rx_stat, 0, sizeof(serial->rx_stat));
+
     /* register a character device */
     ret = rt_device_register(device, name, flag);
 
@@ -1142,38 +1320,32 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
     {
         case RT_SERIAL_EVENT_RX_IND:
         {
-            int ch = -1;
+            int ch = -1, count;
             rt_base_t level;
-            struct rt_serial_rx_fifo* rx_fifo;
+            rt_uint8_t batch[RT_SERIAL_RX_BATCH];
 
             /* interrupt mode receive */
-            rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
-            RT_ASSERT(rx_fifo != RT_NULL);
+            RT_ASSERT(serial->serial_rx != RT_NULL);
+            serial->rx_stat.events ++;
 
-            while (1)
+            /* get a batch of data from hardware, then put it into fifo at once */
+            do
             {
-                ch = serial->ops->getc(serial);
-                if (ch == -1) break;
-
-
-                /* disable interrupt */
-                level = rt_hw_interrupt_disable();
+                for (count = 0; count < RT_SERIAL_RX_BATCH; count ++)
+                {
+                    ch = serial->ops->getc(serial);
+                    if (ch == -1) break;
 
-                rx_fifo->buffer[rx_fifo->put_index] = ch;
-                rx_fifo->put_index += 1;
-                if (rx_fifo->put_index >= serial->config.bufsz) rx_fifo->put_index = 0;
+                    batch[count] = ch;
+                }
 
-                /* if the next position is read index, discard this 'read char' */
-                if (rx_fifo->put_index == rx_fifo->get_index)
+                if (count > 0)
                 {
-                    rx_fifo->get_index += 1;
-                    rx_fifo->is_full = RT_TRUE;
-                    if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
+                    level = rt_hw_interrupt_disable();
+                    _serial_fifo_put(serial, batch, count);
+                    rt_hw_interrupt_enable(level);
                 }
-
-                /* enable interrupt */
-                rt_hw_interrupt_enable(level);
-            }
+            } while (ch != -1);
 
             /* invoke callback */
             if (serial->parent.rx_indicate != RT_NULL)
@@ -1182,8 +1354,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 
                 /* get rx length */
                 level = rt_hw_interrupt_disable();
-                rx_length = (rx_fifo->put_index >= rx_fifo->get_index)? (rx_fifo->put_index - rx_fifo->get_index):
-                    (serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index));
+                rx_length = _serial_fifo_calc_recved_len(serial);
                 rt_hw_interrupt_enable(level);
 
                 if (rx_length)
@@ -1193,6 +1364,12 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
             }
             break;
         }
+        case RT_SERIAL_EVENT_RX_OVERRUN:
+        {
+            /* the number of overrun may be given in high bits */
+            serial->rx_stat.hw_overrun += (event >> 8) ? (event >> 8) : 1;
+            break;
+        }
         case RT_SERIAL_EVENT_TX_DONE:
         {
             struct rt_serial_tx_fifo* tx_fifo;
@@ -1204,32 +1381,12 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 #ifdef RT_SERIAL_USING_DMA
         case RT_SERIAL_EVENT_TX_DMADONE:
         {
-            const void *data_ptr;
-            rt_size_t data_size;
-            const void *last_data_ptr;
-            struct rt_serial_tx_dma *tx_dma;
-
-            tx_dma = (struct rt_serial_tx_dma*) serial->serial_tx;
-
-            rt_data_queue_pop(&(tx_dma->data_queue), &last_data_ptr, &data_size, 0);
-            if (rt_data_queue_peak(&(tx_dma->data_queue), &data_ptr, &data_size) == RT_EOK)
-            {
-                /* transmit next data node */
-                tx_dma->activated = RT_TRUE;
-                serial->ops->dma_transmit(serial, (rt_uint8_t *)data_ptr, data_size, RT_SERIAL_DMA_TX);
-            }
-            else
-            {
-                tx_dma->activated = RT_FALSE;
-            }
-
-            /* invoke callback */
-            if (serial->parent.tx_complete != RT_NULL)
-            {
-                serial->parent.tx_complete(&serial->parent, (void*)last_data_ptr);
-            }
+            /* complete the requests and transmit the next */
+            _serial_dma_tx_done(serial);
             break;
         }
+        case RT_SERIAL_EVENT_RX_TIMEOUT:
+            /* the line is idle before the DMA half or full, it's handled as DMA done */
         case RT_SERIAL_EVENT_RX_DMADONE:
         {
             int length;
@@ -1237,6 +1394,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 
             /* get DMA rx length */
             length = (event & (~0xff)) >> 8;
+            serial->rx_stat.events ++;
 
             if (serial->config.bufsz == 0)
             {
@@ -11,10 +11,16 @@
  * 2012-05-18     bernard      Changed SPI message to message list.
  *                             Added take/release SPI device/bus interface.
  * 2012-09-28     aozima       fixed rt_spi_release_bus assert error.
+ * 2026-10-19     agent        add asynchronous transfer queue.
  */
 
+#include <rthw.h>
 #include <drivers/spi.h>
 
+#ifdef RT_SPI_USING_ASYNC
+#include <ipc/completion.h>
+#endif
+
 extern rt_err_t rt_spi_bus_device_init(struct rt_spi_bus *bus, const char *name);
 extern rt_err_t rt_spidev_device_init(struct rt_spi_device *dev, const char *name);
 
@@ -36,6 +42,9 @@ rt_err_t rt_spi_bus_register(struct rt_spi_bus       *bus,
     bus->owner = RT_NULL;
     /* set bus mode */
     bus->mode = RT_SPI_BUS_MODE_SPI;
+#ifdef RT_SPI_USING_ASYNC
+    bus->async = RT_NULL;
+#endif
 
     return RT_EOK;
 }
@@ -458,3 +467,239 @@ rt_err_t rt_spi_release(struct rt_spi_device *device)
 
     return result;
 }
+
+#ifdef RT_SPI_USING_ASYNC
+
+#ifndef RT_SPI_ASYNC_STACK_SIZE
+#define RT_SPI_ASYNC_STACK_SIZE     1024
+#endif
+
+#ifndef RT_SPI_ASYNC_BATCH_MAX
+#define RT_SPI_ASYNC_BATCH_MAX      8
+#endif
+
+/*
+ * The asynchronous transfers are queued in the bus and transmitted by the
+ * queue thread. After a transfer, the next queued one of the same device is
+ * preferred, so the batch runs without releasing the bus lock and without
+ * reconfiguring the bus. The batch is limited to keep the other devices from
+ * starving.
+ */
+struct rt_spi_async_queue
+{
+    struct rt_spi_bus *bus;
+    struct rt_spi_async_stat stat;
+
+    rt_list_t pending_list;
+    struct rt_semaphore work_sem;       /* number of pending transfers */
+
+    rt_thread_t thread;
+};
+
+/* pick the next transfer, RT_NULL to end the batch */
+static struct rt_spi_async *_async_next(struct rt_spi_async_queue *queue, int batch)
+{
+    struct rt_spi_async *async = RT_NULL, *item;
+    rt_list_t *node;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+
+    if (batch == 0)
+    {
+        if (!rt_list_isempty(&queue->pending_list))
+            async = rt_list_entry(queue->pending_list.next, struct rt_spi_async, list);
+    }
+    else if (batch < RT_SPI_ASYNC_BATCH_MAX)
+    {
+        /* the earliest transfer of current owner */
+        rt_list_for_each(node, &queue->pending_list)
+        {
+            item = rt_list_entry(node, struct rt_spi_async, list);
+            if (item->device == queue->bus->owner)
+            {
+                async = item;
+                break;
+            }
+        }
+    }
+
+    if (async != RT_NULL)
+        rt_list_remove(&async->list);
+
+    rt_hw_interrupt_enable(level);
+
+    return async;
+}
+
+/* transmit the message list with bus lock taken */
+static void _async_xfer(struct rt_spi_async_queue *queue, struct rt_spi_async *async)
+{
+    struct rt_spi_device *device = async->device;
+    struct rt_spi_message *index = async->message;
+
+    async->result = RT_EOK;
+
+    if (queue->bus->owner != device)
+    {
+        /* not the same owner as current, re-configure SPI bus */
+        if (queue->bus->ops->configure(device, &device->config) != RT_EOK)
+        {
+            async->result = -RT_EIO;
+            async->failed = index;
+            return;
+        }
+
+        queue->bus->owner = device;
+        queue->stat.configured ++;
+    }
+
+    while (index != RT_NULL)
+    {
+        if (queue->bus->ops->xfer(device, index) == 0)
+        {
+            async->result = -RT_EIO;
+            break;
+        }
+
+        index = index->next;
+    }
+
+    async->failed = index;
+}
+
+static void _async_entry(void *parameter)
+{
+    struct rt_spi_async_queue *queue = (struct rt_spi_async_queue *)parameter;
+    struct rt_spi_async *async;
+    struct rt_completion *completion;
+    rt_list_t done_list, *node;
+    int batch;
+
+    while (1)
+    {
+        rt_sem_take(&queue->work_sem, RT_WAITING_FOREVER);
+
+        rt_list_init(&done_list);
+
+        rt_mutex_take(&(queue->bus->lock), RT_WAITING_FOREVER);
+        for (batch = 0; (async = _async_next(queue, batch)) != RT_NULL; batch ++)
+        {
+            /* the semaphore of first transfer has been taken */
+            if (batch > 0)
+            {
+                rt_sem_trytake(&queue->work_sem);
+                queue->stat.batched ++;
+            }
+
+            _async_xfer(queue, async);
+            rt_list_insert_before(&done_list, &async->list);
+        }
+        rt_mutex_release(&(queue->bus->lock));
+
+        /* invoke the callbacks without bus lock, they may submit again */
+        while (!rt_list_isempty(&done_list))
+        {
+            node = done_list.next;
+            rt_list_remove(node);
+            async = rt_list_entry(node, struct rt_spi_async, list);
+
+            /* the transfer may be reused after done invoked */
+            completion = async->completion;
+
+            queue->stat.completed ++;
+            if (async->done != RT_NULL)
+                async->done(async);
+            if (completion != RT_NULL)
+                rt_completion_done(completion);
+        }
+    }
+}
+
+rt_err_t rt_spi_bus_async_init(struct rt_spi_bus *bus, rt_uint8_t priority)
+{
+    struct rt_spi_async_queue *queue;
+
+    RT_ASSERT(bus != RT_NULL);
+
+    if (bus->async != RT_NULL)
+        return RT_EOK;
+
+    queue = (struct rt_spi_async_queue *)rt_calloc(1, sizeof(struct rt_spi_async_queue));
+    if (queue == RT_NULL)
+        return -RT_ENOMEM;
+
+    queue->thread = rt_thread_create(bus->parent.parent.name, _async_entry, queue,
+                                     RT_SPI_ASYNC_STACK_SIZE, priority, 10);
+    if (queue->thread == RT_NULL)
+    {
+        rt_free(queue);
+        return -RT_ENOMEM;
+    }
+
+    queue->bus = bus;
+    rt_list_init(&queue->pending_list);
+    rt_sem_init(&queue->work_sem, "spiasync", 0, RT_IPC_FLAG_FIFO);
+
+    bus->async = queue;
+    rt_thread_startup(queue->thread);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_spi_bus_async_stat(struct rt_spi_bus *bus, struct rt_spi_async_stat *stat)
+{
+    RT_ASSERT(bus != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    if (bus->async == RT_NULL)
+        return -RT_ENOSYS;
+
+    *stat = bus->async->stat;
+
+    return RT_EOK;
+}
+
+void rt_spi_async_init(struct rt_spi_async   *async,
+                       struct rt_spi_message *message,
+                       rt_spi_async_done_t    done,
+                       void                  *user_data)
+{
+    RT_ASSERT(async != RT_NULL);
+
+    rt_memset(async, 0, sizeof(struct rt_spi_async));
+    rt_list_init(&async->list);
+    async->message   = message;
+    async->done      = done;
+    async->user_data = user_data;
+}
+
+rt_err_t rt_spi_transfer_async(struct rt_spi_device *device,
+                               struct rt_spi_async  *async)
+{
+    struct rt_spi_async_queue *queue;
+    rt_base_t level;
+
+    RT_ASSERT(device != RT_NULL);
+    RT_ASSERT(device->bus != RT_NULL);
+    RT_ASSERT(async != RT_NULL);
+
+    queue = device->bus->async;
+    if (queue == RT_NULL)
+        return -RT_ENOSYS;
+
+    async->device = device;
+    async->result = RT_EOK;
+    async->failed = RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_before(&queue->pending_list, &async->list);
+    queue->stat.submitted ++;
+    rt_hw_interrupt_enable(level);
+
+    rt_sem_release(&queue->work_sem);
+
+    return RT_EOK;
+}
+
+#endif /* RT_SPI_USING_ASYNC */
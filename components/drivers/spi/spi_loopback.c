@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+/*
+ * The software SPI bus with MOSI connected to MISO, the data sent is received
+ * at the same time. The configurations and chip selects are counted, so the
+ * SPI device drivers and the transfer queue can be tested without hardware.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <drivers/spi.h>
+
+#ifdef RT_SPI_USING_LOOPBACK
+
+struct spi_loopback
+{
+    struct rt_spi_bus parent;
+    struct rt_spi_loopback_stat stat;
+};
+
+static rt_err_t _loopback_configure(struct rt_spi_device *device, struct rt_spi_configuration *configuration)
+{
+    struct spi_loopback *loopback = (struct spi_loopback *)device->bus;
+
+    loopback->stat.configured ++;
+
+    return RT_EOK;
+}
+
+static rt_uint32_t _loopback_xfer(struct rt_spi_device *device, struct rt_spi_message *message)
+{
+    struct spi_loopback *loopback = (struct spi_loopback *)device->bus;
+    rt_size_t size;
+
+    /* the length is in frame of data width */
+    size = message->length;
+    if (device->config.data_width > 8)
+        size *= (device->config.data_width + 7) / 8;
+
+    if (message->cs_take)
+        loopback->stat.cs_taken ++;
+
+    if (message->recv_buf != RT_NULL)
+    {
+        if (message->send_buf != RT_NULL)
+            rt_memmove(message->recv_buf, message->send_buf, size);
+        else
+            rt_memset(message->recv_buf, 0xff, size);
+    }
+
+    loopback->stat.messages ++;
+    loopback->stat.bytes += size;
+
+    return message->length;
+}
+
+static const struct rt_spi_ops _loopback_ops =
+{
+    _loopback_configure,
+    _loopback_xfer,
+};
+
+/**
+ * This function creates a loopback SPI bus.
+ *
+ * @param name the name of SPI bus.
+ *
+ * @return the SPI bus, or RT_NULL on failed.
+ */
+struct rt_spi_bus *rt_spi_loopback_create(const char *name)
+{
+    struct spi_loopback *loopback;
+
+    loopback = (struct spi_loopback *)rt_calloc(1, sizeof(struct spi_loopback));
+    if (loopback == RT_NULL)
+        return RT_NULL;
+
+    if (rt_spi_bus_register(&loopback->parent, name, &_loopback_ops) != RT_EOK)
+    {
+        rt_free(loopback);
+        return RT_NULL;
+    }
+
+    return &loopback->parent;
+}
+
+/**
+ * This function gets the statistics of loopback SPI bus.
+ *
+ * @param bus the loopback SPI bus.
+ * @param stat the statistics.
+ */
+void rt_spi_loopback_get_stat(struct rt_spi_bus *bus, struct rt_spi_loopback_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(bus != RT_NULL);
+    RT_ASSERT(bus->ops == &_loopback_ops);
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    *stat = ((struct spi_loopback *)bus)->stat;
+    rt_hw_interrupt_enable(level);
+}
+
+#endif /* RT_SPI_USING_LOOPBACK */
@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ * 2026-10-19     agent        add the irq thread drained in slack time
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_IRQ_THREAD) && defined(RT_USING_HEAP)
+
+/* wake up the thread once for all of events before it runs */
+static rt_bool_t _irq_thread_signal(struct rt_irq_thread *irq_thread)
+{
+    if (irq_thread->signaled)
+        return RT_FALSE;
+
+    irq_thread->signaled = RT_TRUE;
+    return RT_TRUE;
+}
+
+/* the one drained in slack is polled by the idle hook */
+rt_inline void _irq_thread_wake(struct rt_irq_thread *irq_thread)
+{
+    if (irq_thread->thread != RT_NULL)
+        rt_sem_release(&irq_thread->sem);
+}
+
+/* start the timer for the deadline, unless it expires earlier, the interrupt is disabled */
+static void _irq_thread_arm(struct rt_irq_thread *irq_thread, rt_tick_t deadline)
+{
+    rt_tick_t tick;
+
+    if ((irq_thread->timer.parent.flag & RT_TIMER_FLAG_ACTIVATED) &&
+        (rt_int32_t)(deadline - irq_thread->deadline) >= 0)
+        return;
+
+    tick = deadline - rt_tick_get();
+    if ((rt_int32_t)tick <= 0)
+        tick = 1;
+
+    irq_thread->deadline = deadline;
+    rt_timer_control(&irq_thread->timer, RT_TIMER_CTRL_SET_TIME, &tick);
+    rt_timer_start(&irq_thread->timer);
+}
+
+static void _irq_thread_timeout(void *parameter)
+{
+    struct rt_irq_thread *irq_thread = (struct rt_irq_thread *)parameter;
+    rt_base_t level;
+    rt_bool_t wake;
+
+    level = rt_hw_interrupt_disable();
+    wake = _irq_thread_signal(irq_thread);
+    rt_hw_interrupt_enable(level);
+
+    if (wake)
+        _irq_thread_wake(irq_thread);
+}
+
+static void _irq_source_account(struct rt_irq_source *source, rt_uint32_t events, rt_tick_t first)
+{
+    rt_tick_t now = rt_tick_get();
+
+    source->stat.batches ++;
+    if (events > source->stat.batch_max)
+        source->stat.batch_max = events;
+    if (now - first > source->stat.latency_max)
+        source->stat.latency_max = now - first;
+
+    /* the rate is updated in window of one second at least */
+    if (now - source->window >= RT_TICK_PER_SECOND)
+    {
+        source->stat.rate = (rt_uint32_t)((rt_uint64_t)(source->stat.posted - source->window_posted) *
+                                          RT_TICK_PER_SECOND / (now - source->window));
+        source->window = now;
+        source->window_posted = source->stat.posted;
+    }
+}
+
+/* move all of the nodes in list to the head of another, the list is emptied */
+rt_inline void _irq_list_splice(rt_list_t *list, rt_list_t *head)
+{
+    if (rt_list_isempty(list))
+        return;
+
+    list->next->prev = head;
+    list->prev->next = head->next;
+    head->next->prev = list->prev;
+    head->next = list->next;
+    rt_list_init(list);
+}
+
+/* invoke the handler of sources which are due, and arm the timer for the rest */
+static void _irq_thread_dispatch(struct rt_irq_thread *irq_thread)
+{
+    struct rt_irq_source *source;
+    rt_uint32_t events, value;
+    rt_tick_t now, first, deadline = 0;
+    rt_bool_t deferred = RT_FALSE;
+    rt_list_t todo, later;
+    rt_base_t level;
+
+    rt_list_init(&todo);
+    rt_list_init(&later);
+
+    level = rt_hw_interrupt_disable();
+    irq_thread->signaled = RT_FALSE;
+
+    /* Each source pending now is visited once. The ones posted while the
+     * handlers run are left in pending list, the thread has been signaled
+     * for them. */
+    _irq_list_splice(&irq_thread->pending, &todo);
+
+    now = rt_tick_get();
+    while (!rt_list_isempty(&todo))
+    {
+        source = rt_list_entry(todo.next, struct rt_irq_source, list);
+        rt_list_remove(&source->list);
+
+        if (source->events < source->threshold && now - source->first < source->timeout)
+        {
+            if (!deferred || (rt_int32_t)(source->first + source->timeout - deadline) < 0)
+                deadline = source->first + source->timeout;
+            deferred = RT_TRUE;
+            rt_list_insert_before(&later, &source->list);
+            continue;
+        }
+
+        /* take all of events, the new one goes to the next batch */
+        events = source->events;
+        value  = source->value;
+        first  = source->first;
+        source->events = 0;
+        rt_hw_interrupt_enable(level);
+
+        _irq_source_account(source, events, first);
+        source->handler(source, events, value);
+
+        /* the sources in lists may be detached by handler */
+        level = rt_hw_interrupt_disable();
+        now = rt_tick_get();
+    }
+
+    /* the deferred sources may be detached by handler */
+    if (rt_list_isempty(&later))
+        deferred = RT_FALSE;
+
+    /* the deferred sources are the earlier ones */
+    _irq_list_splice(&later, &irq_thread->pending);
+
+    if (deferred)
+        _irq_thread_arm(irq_thread, deadline);
+    rt_hw_interrupt_enable(level);
+}
+
+static void _irq_thread_entry(void *parameter)
+{
+    struct rt_irq_thread *irq_thread = (struct rt_irq_thread *)parameter;
+
+    while (1)
+    {
+        rt_sem_take(&irq_thread->sem, RT_WAITING_FOREVER);
+        _irq_thread_dispatch(irq_thread);
+    }
+}
+
+#ifdef RT_IRQ_THREAD_USING_SLACK
+static rt_list_t _irq_slack_list = RT_LIST_OBJECT_INIT(_irq_slack_list);
+static rt_bool_t _irq_slack_hooked = RT_FALSE;
+
+/*
+ * The idle thread runs when no TT thread is in its window and no thread is
+ * ready, the irq threads in slack are drained here. A TT thread or any ready
+ * thread preempts the handlers.
+ *
+ * Only this hook removes the nodes from list, so the next node is still valid
+ * after the handlers are invoked with interrupt enabled.
+ */
+static void _irq_thread_slack(void)
+{
+    struct rt_irq_thread *irq_thread;
+    rt_list_t *node;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    node = _irq_slack_list.next;
+    while (node != &_irq_slack_list)
+    {
+        irq_thread = rt_list_entry(node, struct rt_irq_thread, slack);
+        node = node->next;
+
+        if (irq_thread->defunct)
+        {
+            rt_list_remove(&irq_thread->slack);
+            rt_hw_interrupt_enable(level);
+            RT_KERNEL_FREE(irq_thread);
+        }
+        else if (irq_thread->signaled)
+        {
+            rt_hw_interrupt_enable(level);
+            _irq_thread_dispatch(irq_thread);
+        }
+        else
+        {
+            continue;
+        }
+
+        level = rt_hw_interrupt_disable();
+    }
+    rt_hw_interrupt_enable(level);
+}
+#endif
+
+static void _irq_thread_init(struct rt_irq_thread *irq_thread)
+{
+    rt_list_init(&irq_thread->sources);
+    rt_list_init(&irq_thread->pending);
+    irq_thread->signaled = RT_FALSE;
+    irq_thread->deadline = 0;
+    irq_thread->thread = RT_NULL;
+#ifdef RT_IRQ_THREAD_USING_SLACK
+    rt_list_init(&irq_thread->slack);
+    irq_thread->defunct = RT_FALSE;
+#endif
+    rt_sem_init(&irq_thread->sem, "irqthd", 0, RT_IPC_FLAG_FIFO);
+    rt_timer_init(&irq_thread->timer, "irqthd", _irq_thread_timeout, irq_thread,
+                  1, RT_TIMER_FLAG_ONE_SHOT);
+}
+
+/**
+ * This function creates the thread to handle the events of sources.
+ *
+ * @param name the name of thread.
+ * @param stack_size the stack size of thread.
+ * @param priority the priority of thread.
+ *
+ * @return the irq thread, or RT_NULL on failed.
+ */
+struct rt_irq_thread *rt_irq_thread_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority)
+{
+    struct rt_irq_thread *irq_thread;
+
+    irq_thread = (struct rt_irq_thread *)RT_KERNEL_MALLOC(sizeof(struct rt_irq_thread));
+    if (irq_thread == RT_NULL)
+        return RT_NULL;
+
+    _irq_thread_init(irq_thread);
+
+    irq_thread->thread = rt_thread_create(name, _irq_thread_entry, irq_thread, stack_size, priority, 10);
+    if (irq_thread->thread == RT_NULL)
+    {
+        rt_timer_detach(&irq_thread->timer);
+        rt_sem_detach(&irq_thread->sem);
+        RT_KERNEL_FREE(irq_thread);
+        return RT_NULL;
+    }
+
+    rt_thread_startup(irq_thread->thread);
+
+    return irq_thread;
+}
+RTM_EXPORT(rt_irq_thread_create);
+
+#ifdef RT_IRQ_THREAD_USING_SLACK
+/**
+ * This function creates the irq thread drained in the slack time. It has no
+ * thread, the handlers are invoked in the idle hook when no TT thread is in its
+ * window and no thread is ready, so they must never be blocked.
+ *
+ * @return the irq thread, or RT_NULL on failed.
+ */
+struct rt_irq_thread *rt_irq_thread_create_slack(void)
+{
+    struct rt_irq_thread *irq_thread;
+    rt_base_t level;
+
+    irq_thread = (struct rt_irq_thread *)RT_KERNEL_MALLOC(sizeof(struct rt_irq_thread));
+    if (irq_thread == RT_NULL)
+        return RT_NULL;
+
+    _irq_thread_init(irq_thread);
+
+    level = rt_hw_interrupt_disable();
+    if (!_irq_slack_hooked)
+    {
+        if (rt_thread_idle_sethook(_irq_thread_slack) != RT_EOK)
+        {
+            rt_hw_interrupt_enable(level);
+            rt_timer_detach(&irq_thread->timer);
+            rt_sem_detach(&irq_thread->sem);
+            RT_KERNEL_FREE(irq_thread);
+            return RT_NULL;
+        }
+        _irq_slack_hooked = RT_TRUE;
+    }
+    rt_list_insert_before(&_irq_slack_list, &irq_thread->slack);
+    rt_hw_interrupt_enable(level);
+
+    return irq_thread;
+}
+RTM_EXPORT(rt_irq_thread_create_slack);
+#endif
+
+/**
+ * This function destroys the irq thread, the sources attached are detached.
+ *
+ * @param irq_thread the irq thread.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_irq_thread_destroy(struct rt_irq_thread *irq_thread)
+{
+    struct rt_irq_source *source;
+
+    RT_ASSERT(irq_thread != RT_NULL);
+
+    while (!rt_list_isempty(&irq_thread->sources))
+    {
+        source = rt_list_entry(irq_thread->sources.next, struct rt_irq_source, node);
+        rt_irq_source_detach(source);
+    }
+
+#ifdef RT_IRQ_THREAD_USING_SLACK
+    if (irq_thread->thread == RT_NULL)
+    {
+        rt_base_t level;
+
+        rt_timer_detach(&irq_thread->timer);
+        rt_sem_detach(&irq_thread->sem);
+
+        /* the idle hook may be draining it, it's freed there */
+        level = rt_hw_interrupt_disable();
+        irq_thread->defunct = RT_TRUE;
+        rt_hw_interrupt_enable(level);
+
+        return RT_EOK;
+    }
+#endif
+
+    rt_thread_delete(irq_thread->thread);
+    rt_timer_detach(&irq_thread->timer);
+    rt_sem_detach(&irq_thread->sem);
+    RT_KERNEL_FREE(irq_thread);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_irq_thread_destroy);
+
+/**
+ * This function initializes the source, the handler is invoked for each event
+ * by default.
+ *
+ * @param source the source.
+ * @param name the name of source.
+ * @param handler the handler invoked in thread with the number of events and
+ *        the value of latest event.
+ * @param user_data the user data of source.
+ */
+void rt_irq_source_init(struct rt_irq_source *source, const char *name,
+                        rt_irq_handler_t handler, void *user_data)
+{
+    RT_ASSERT(source != RT_NULL);
+    RT_ASSERT(handler != RT_NULL);
+
+    rt_memset(source, 0, sizeof(struct rt_irq_source));
+    rt_list_init(&source->node);
+    rt_list_init(&source->list);
+    source->name = name;
+    source->handler = handler;
+    source->user_data = user_data;
+    source->threshold = 1;
+}
+RTM_EXPORT(rt_irq_source_init);
+
+/**
+ * This function sets the coalescing of source, the handler is invoked when the
+ * events reach the threshold or the first event waits for timeout.
+ *
+ * @param source the source.
+ * @param threshold the number of events, 1 for no coalescing.
+ * @param timeout the ticks to wait, it must be larger than 0 for the threshold
+ *        larger than 1.
+ */
+void rt_irq_source_set_coalesce(struct rt_irq_source *source, rt_uint32_t threshold, rt_tick_t timeout)
+{
+    rt_base_t level;
+
+    RT_ASSERT(source != RT_NULL);
+    RT_ASSERT(threshold > 0);
+    RT_ASSERT(threshold == 1 || timeout > 0);
+
+    level = rt_hw_interrupt_disable();
+    source->threshold = threshold;
+    source->timeout = timeout;
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_irq_source_set_coalesce);
+
+/**
+ * This function attaches the source to irq thread.
+ *
+ * @param irq_thread the irq thread.
+ * @param source the source.
+ *
+ * @return RT_EOK on successful, -RT_EBUSY on the source has been attached.
+ */
+rt_err_t rt_irq_source_attach(struct rt_irq_thread *irq_thread, struct rt_irq_source *source)
+{
+    rt_base_t level;
+
+    RT_ASSERT(irq_thread != RT_NULL);
+    RT_ASSERT(source != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (source->irq_thread != RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_EBUSY;
+    }
+
+    source->irq_thread = irq_thread;
+    source->events = 0;
+    source->window = rt_tick_get();
+    source->window_posted = source->stat.posted;
+    rt_list_insert_before(&irq_thread->sources, &source->node);
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_irq_source_attach);
+
+/**
+ * This function detaches the source from irq thread, the events pending are
+ * dropped.
+ *
+ * @param source the source.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_irq_source_detach(struct rt_irq_source *source)
+{
+    rt_base_t level;
+
+    RT_ASSERT(source != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_list_remove(&source->node);
+    rt_list_remove(&source->list);
+    source->irq_thread = RT_NULL;
+    source->events = 0;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_irq_source_detach);
+
+/**
+ * This function posts an event of source, it's used in ISR. The thread is
+ * woken up when the events reach the threshold.
+ *
+ * @param source the source.
+ * @param value the value of event, such as the size of data received.
+ */
+void rt_irq_source_post(struct rt_irq_source *source, rt_uint32_t value)
+{
+    struct rt_irq_thread *irq_thread;
+    rt_bool_t wake = RT_FALSE;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    irq_thread = source->irq_thread;
+    if (irq_thread == RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    source->stat.posted ++;
+    source->value = value;
+    if (source->events ++ == 0)
+    {
+        source->first = rt_tick_get();
+        rt_list_insert_before(&irq_thread->pending, &source->list);
+
+        if (source->threshold > 1)
+            _irq_thread_arm(irq_thread, source->first + source->timeout);
+    }
+
+    if (source->events >= source->threshold)
+        wake = _irq_thread_signal(irq_thread);
+    rt_hw_interrupt_enable(level);
+
+    if (wake)
+        _irq_thread_wake(irq_thread);
+}
+RTM_EXPORT(rt_irq_source_post);
+
+/**
+ * This function gets the statistics of source.
+ *
+ * @param source the source.
+ * @param stat the statistics.
+ */
+void rt_irq_source_get_stat(struct rt_irq_source *source, struct rt_irq_source_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(source != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    *stat = source->stat;
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_irq_source_get_stat);
+
+#endif /* RT_USING_IRQ_THREAD && RT_USING_HEAP */
@@ -8,6 +8,8 @@
  * 2012-09-30     Bernard      first version.
  * 2013-05-08     Grissiom     reimplement
  * 2016-08-18     heyuanjie    add interface
+ * 2026-10-19     agent        add lock-free single producer single consumer ring buffer
+ * 2026-10-19     agent        fix the bound of size in rt_spsc_ringbuffer_init
  */
 
 #include <rtthread.h>
@@ -360,3 +362,293 @@ void rt_ringbuffer_destroy(struct rt_ringbuffer *rb)
 RTM_EXPORT(rt_ringbuffer_destroy);
 
 #endif
+
+/*
+ * The barrier between the access of data and the update of index. On single
+ * core the other side is an ISR or thread on the same CPU, so it only needs to
+ * stop the compiler from reordering; the BSP could override the weak function
+ * for the compiler has no builtin barrier.
+ */
+#if defined(__CC_ARM)
+#define _spsc_barrier()         __schedule_barrier()
+#elif defined(__GNUC__)
+#define _spsc_barrier()         __sync_synchronize()
+#else
+RT_WEAK void rt_spsc_ringbuffer_barrier(void)
+{
+}
+#define _spsc_barrier()         rt_spsc_ringbuffer_barrier()
+#endif
+
+rt_inline rt_uint32_t _spsc_offset(struct rt_spsc_ringbuffer *rb, rt_uint32_t index)
+{
+    return index < rb->buffer_size ? index : index - rb->buffer_size;
+}
+
+rt_inline rt_uint32_t _spsc_advance(struct rt_spsc_ringbuffer *rb, rt_uint32_t index, rt_size_t length)
+{
+    index += length;
+    if (index >= 2 * rb->buffer_size)
+        index -= 2 * rb->buffer_size;
+
+    return index;
+}
+
+rt_inline rt_size_t _spsc_data_len(struct rt_spsc_ringbuffer *rb, rt_uint32_t read_index, rt_uint32_t write_index)
+{
+    if (write_index >= read_index)
+        return write_index - read_index;
+
+    return 2 * rb->buffer_size - read_index + write_index;
+}
+
+/**
+ * This function initializes the lock-free ring buffer.
+ *
+ * @param rb the ring buffer object.
+ * @param pool the buffer.
+ * @param size the size of buffer, it should be less than 2GiB.
+ */
+void rt_spsc_ringbuffer_init(struct rt_spsc_ringbuffer *rb, rt_uint8_t *pool, rt_uint32_t size)
+{
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(size > 0 && size < 0x80000000UL);
+
+    rb->buffer_ptr  = pool;
+    rb->buffer_size = size;
+    rb->read_index  = 0;
+    rb->write_index = 0;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_init);
+
+/**
+ * This function drops all of data, neither of producer and consumer should be
+ * accessing the ring buffer.
+ */
+void rt_spsc_ringbuffer_reset(struct rt_spsc_ringbuffer *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    rb->read_index  = 0;
+    rb->write_index = 0;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_reset);
+
+/**
+ * This function gets the length of data, it's exact for consumer and the
+ * minimum for others.
+ */
+rt_size_t rt_spsc_ringbuffer_data_len(struct rt_spsc_ringbuffer *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    return _spsc_data_len(rb, rb->read_index, rb->write_index);
+}
+RTM_EXPORT(rt_spsc_ringbuffer_data_len);
+
+/**
+ * This function gets the length of empty space, it's exact for producer and
+ * the minimum for others.
+ */
+rt_size_t rt_spsc_ringbuffer_space_len(struct rt_spsc_ringbuffer *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    return rb->buffer_size - _spsc_data_len(rb, rb->read_index, rb->write_index);
+}
+RTM_EXPORT(rt_spsc_ringbuffer_space_len);
+
+/**
+ * This function gets the contiguous empty space from the write position, it's
+ * called by producer only.
+ *
+ * @param rb the ring buffer object.
+ * @param ptr the pointer to save the start of space.
+ *
+ * @return the length of contiguous space, the rest of space is at the start of
+ * buffer when the space wraps around.
+ */
+rt_size_t rt_spsc_ringbuffer_put_peek(struct rt_spsc_ringbuffer *rb, rt_uint8_t **ptr)
+{
+    rt_uint32_t read_index, write_index, offset;
+    rt_size_t space;
+
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(ptr != RT_NULL);
+
+    write_index = rb->write_index;
+    read_index  = rb->read_index;
+    /* the data is read by consumer before read_index is seen */
+    _spsc_barrier();
+
+    space  = rb->buffer_size - _spsc_data_len(rb, read_index, write_index);
+    offset = _spsc_offset(rb, write_index);
+    if (space > rb->buffer_size - offset)
+        space = rb->buffer_size - offset;
+
+    *ptr = rb->buffer_ptr + offset;
+
+    return space;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_put_peek);
+
+/**
+ * This function publishes the data written into the space of put_peek, it's
+ * called by producer only.
+ *
+ * @param rb the ring buffer object.
+ * @param length the length of data, it shouldn't exceed the length of space.
+ */
+void rt_spsc_ringbuffer_put_commit(struct rt_spsc_ringbuffer *rb, rt_size_t length)
+{
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(length <= rt_spsc_ringbuffer_space_len(rb));
+
+    /* the data is written before write_index is updated */
+    _spsc_barrier();
+    rb->write_index = _spsc_advance(rb, rb->write_index, length);
+}
+RTM_EXPORT(rt_spsc_ringbuffer_put_commit);
+
+/**
+ * This function puts a block of data into ring buffer, it's called by
+ * producer only.
+ *
+ * @return the length of data put, the data exceeds the space is dropped.
+ */
+rt_size_t rt_spsc_ringbuffer_put(struct rt_spsc_ringbuffer *rb, const rt_uint8_t *ptr, rt_size_t length)
+{
+    rt_uint8_t *buf;
+    rt_size_t size, count = 0;
+
+    RT_ASSERT(rb != RT_NULL);
+
+    /* the space wraps around at most once */
+    while (count < length)
+    {
+        size = rt_spsc_ringbuffer_put_peek(rb, &buf);
+        if (size == 0)
+            break;
+
+        if (size > length - count)
+            size = length - count;
+        memcpy(buf, ptr + count, size);
+        rt_spsc_ringbuffer_put_commit(rb, size);
+        count += size;
+    }
+
+    return count;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_put);
+
+/**
+ * This function gets the contiguous data from the read position, it's called
+ * by consumer only.
+ *
+ * @param rb the ring buffer object.
+ * @param ptr the pointer to save the start of data.
+ *
+ * @return the length of contiguous data, the rest of data is at the start of
+ * buffer when the data wraps around.
+ */
+rt_size_t rt_spsc_ringbuffer_get_peek(struct rt_spsc_ringbuffer *rb, rt_uint8_t **ptr)
+{
+    rt_uint32_t read_index, write_index, offset;
+    rt_size_t length;
+
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(ptr != RT_NULL);
+
+    read_index  = rb->read_index;
+    write_index = rb->write_index;
+    /* the data is written by producer before write_index is seen */
+    _spsc_barrier();
+
+    length = _spsc_data_len(rb, read_index, write_index);
+    offset = _spsc_offset(rb, read_index);
+    if (length > rb->buffer_size - offset)
+        length = rb->buffer_size - offset;
+
+    *ptr = rb->buffer_ptr + offset;
+
+    return length;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_get_peek);
+
+/**
+ * This function releases the data got by get_peek, it's called by consumer
+ * only.
+ *
+ * @param rb the ring buffer object.
+ * @param length the length of data, it shouldn't exceed the length of data.
+ */
+void rt_spsc_ringbuffer_get_commit(struct rt_spsc_ringbuffer *rb, rt_size_t length)
+{
+    RT_ASSERT(rb != RT_NULL);
+    RT_ASSERT(length <= rt_spsc_ringbuffer_data_len(rb));
+
+    /* the data is read before the space is given back to producer */
+    _spsc_barrier();
+    rb->read_index = _spsc_advance(rb, rb->read_index, length);
+}
+RTM_EXPORT(rt_spsc_ringbuffer_get_commit);
+
+/**
+ * This function gets a block of data from ring buffer, it's called by
+ * consumer only.
+ *
+ * @return the length of data got.
+ */
+rt_size_t rt_spsc_ringbuffer_get(struct rt_spsc_ringbuffer *rb, rt_uint8_t *ptr, rt_size_t length)
+{
+    rt_uint8_t *buf;
+    rt_size_t size, count = 0;
+
+    RT_ASSERT(rb != RT_NULL);
+
+    /* the data wraps around at most once */
+    while (count < length)
+    {
+        size = rt_spsc_ringbuffer_get_peek(rb, &buf);
+        if (size == 0)
+            break;
+
+        if (size > length - count)
+            size = length - count;
+        memcpy(ptr + count, buf, size);
+        rt_spsc_ringbuffer_get_commit(rb, size);
+        count += size;
+    }
+
+    return count;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_get);
+
+#ifdef RT_USING_HEAP
+
+struct rt_spsc_ringbuffer *rt_spsc_ringbuffer_create(rt_uint32_t size)
+{
+    struct rt_spsc_ringbuffer *rb;
+
+    RT_ASSERT(size > 0);
+
+    /* the pool follows the object */
+    rb = (struct rt_spsc_ringbuffer *)rt_malloc(sizeof(struct rt_spsc_ringbuffer) + size);
+    if (rb == RT_NULL)
+        return RT_NULL;
+
+    rt_spsc_ringbuffer_init(rb, (rt_uint8_t *)(rb + 1), size);
+
+    return rb;
+}
+RTM_EXPORT(rt_spsc_ringbuffer_create);
+
+void rt_spsc_ringbuffer_destroy(struct rt_spsc_ringbuffer *rb)
+{
+    RT_ASSERT(rb != RT_NULL);
+
+    rt_free(rb);
+}
+RTM_EXPORT(rt_spsc_ringbuffer_destroy);
+
+#endif
@@ -6,10 +6,24 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/12/30     Bernard      The first version.
+ * 2026-10-19     agent        Add per-device workers with request coalescing,
+ *                             implement aio_suspend and lio_listio.
+ * 2026-10-19     agent        Only coalesce the adjacent requests in queue,
+ *                             check op of aio_fsync.
+ * 2026-10-19     agent        aio_cancel reports the requests being performed.
+ */
+
+/*
+ * The requests are queued to the worker of the device which the file is on,
+ * so the requests to different devices are performed in parallel while the
+ * requests to one device keep their order. The worker merges the queued reads
+ * or writes of the same file at adjacent offsets into one transfer through a
+ * bounce buffer.
  */
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <rthw.h>
 #include <rtdevice.h>
@@ -19,7 +33,401 @@
 
 #include "posix_aio.h"
 
-struct rt_workqueue* aio_queue = NULL;
+#ifndef AIO_WORKER_NUM_MAX
+#define AIO_WORKER_NUM_MAX          2
+#endif
+
+#ifndef AIO_WORKER_STACK_SIZE
+#define AIO_WORKER_STACK_SIZE       2048
+#endif
+
+#ifndef AIO_WORKER_PRIORITY
+#define AIO_WORKER_PRIORITY         (RT_THREAD_PRIORITY_MAX / 2)
+#endif
+
+/* the maximal size of coalesced transfer, 0 to disable coalescing */
+#ifndef AIO_COALESCE_SIZE
+#define AIO_COALESCE_SIZE           4096
+#endif
+
+#define AIO_COALESCE_COUNT          8
+
+/* the operations of request */
+#define AIO_OP_READ                 LIO_READ
+#define AIO_OP_WRITE                LIO_WRITE
+#define AIO_OP_FSYNC                (LIO_NOP + 1)
+
+struct aio_worker
+{
+    rt_list_t queue;                    /* the pending requests */
+    void *key;                          /* the device served, RT_NULL if idle */
+    rt_bool_t busy;
+    int fildes;                         /* the file of requests performed, -1 if none */
+
+    rt_thread_t thread;
+    struct rt_semaphore sem;
+    rt_uint8_t *bounce;                 /* the buffer of coalesced transfer */
+};
+
+/* the waiter of aio_suspend */
+struct aio_waiter
+{
+    rt_list_t list;
+    struct rt_semaphore sem;
+};
+
+/* the list submitted by lio_listio with notification */
+struct aio_lio
+{
+    int pending;
+    struct sigevent sig;
+    rt_thread_t thread;
+};
+
+static struct rt_mutex aio_lock;
+static rt_list_t aio_waiter_list;
+static struct aio_worker aio_workers[AIO_WORKER_NUM_MAX];
+
+static void aio_notify(struct sigevent *sig, rt_thread_t thread)
+{
+    if (sig == RT_NULL)
+        return;
+
+#ifdef SIGEV_THREAD
+    if (sig->sigev_notify == SIGEV_THREAD && sig->sigev_notify_function)
+    {
+        sig->sigev_notify_function(sig->sigev_value);
+        return;
+    }
+#endif
+#if defined(SIGEV_SIGNAL) && defined(RT_USING_SIGNALS)
+    if (sig->sigev_notify == SIGEV_SIGNAL && thread != RT_NULL)
+    {
+        rt_thread_kill(thread, sig->sigev_signo);
+    }
+#endif
+}
+
+/* complete a request, it should be invoked with aio lock */
+static void aio_complete(struct aiocb *cb, int result)
+{
+    rt_ubase_t level;
+    rt_list_t *node;
+    struct aio_lio *lio;
+
+    level = rt_hw_interrupt_disable();
+    cb->aio_result = result;
+    rt_hw_interrupt_enable(level);
+
+    /* wake up all of the waiters to check their lists */
+    for (node = aio_waiter_list.next; node != &aio_waiter_list; node = node->next)
+    {
+        rt_sem_release(&(rt_list_entry(node, struct aio_waiter, list)->sem));
+    }
+
+    if (result != -ECANCELED)
+        aio_notify(&(cb->aio_sigevent), cb->aio_thread);
+
+    lio = cb->aio_lio;
+    cb->aio_lio = RT_NULL;
+    if (lio != RT_NULL && --lio->pending == 0)
+    {
+        aio_notify(&(lio->sig), lio->thread);
+        rt_free(lio);
+    }
+}
+
+/* get the worker of the device which the file is on, it should be invoked with aio lock */
+static struct aio_worker *aio_worker_get(struct dfs_fd *d)
+{
+    struct aio_worker *worker;
+    void *key;
+    int index;
+
+    /* the file systems on block device are keyed by device, otherwise the
+     * file itself, such as the device file in devfs */
+    if (d->fs != RT_NULL && d->fs->dev_id != RT_NULL)
+        key = d->fs->dev_id;
+    else if (d->data != RT_NULL)
+        key = d->data;
+    else
+        key = d;
+
+    for (index = 0; index < AIO_WORKER_NUM_MAX; index ++)
+    {
+        if (aio_workers[index].key == key)
+            return &aio_workers[index];
+    }
+
+    /* take over an idle worker */
+    for (index = 0; index < AIO_WORKER_NUM_MAX; index ++)
+    {
+        worker = &aio_workers[index];
+        if (!worker->busy && rt_list_isempty(&(worker->queue)))
+        {
+            worker->key = key;
+            return worker;
+        }
+    }
+
+    /* share a worker with other devices */
+    return &aio_workers[((rt_ubase_t)key >> 4) % AIO_WORKER_NUM_MAX];
+}
+
+static int aio_transfer(struct dfs_fd *d, int op, off_t offset, void *buf, size_t nbytes)
+{
+    size_t length = 0;
+    int result = 0;
+
+    if (!(op == AIO_OP_WRITE && (d->flags & O_APPEND)))
+    {
+        result = dfs_file_lseek(d, offset);
+        /* the offset is ignored on the file can't seek, such as device */
+        if (result == -ENOSYS)
+            result = 0;
+    }
+
+    while (result >= 0 && length < nbytes)
+    {
+        if (op == AIO_OP_READ)
+            result = dfs_file_read(d, (rt_uint8_t *)buf + length, nbytes - length);
+        else
+            result = dfs_file_write(d, (rt_uint8_t *)buf + length, nbytes - length);
+        if (result <= 0)
+            break;
+        length += result;
+    }
+
+    if (result < 0 && length == 0)
+        return result;
+
+    return length;
+}
+
+/* take the requests following the first one in queue out of queue while each
+ * of them continues the previous one in file. A request which can't be merged
+ * stops the search, so the requests keep their order. */
+static int aio_coalesce(struct aio_worker *worker, struct aiocb *list[])
+{
+    struct aiocb *cb;
+    rt_list_t *node;
+    size_t total = list[0]->aio_nbytes;
+    int count = 1;
+
+    if (worker->bounce == RT_NULL || list[0]->aio_op == AIO_OP_FSYNC ||
+        (list[0]->aio_op == AIO_OP_WRITE && list[0]->aio_nbytes > AIO_COALESCE_SIZE))
+        return count;
+
+    node = worker->queue.next;
+    while (node != &(worker->queue) && count < AIO_COALESCE_COUNT)
+    {
+        cb = rt_list_entry(node, struct aiocb, aio_node);
+        node = node->next;
+
+        if (cb->aio_fildes != list[0]->aio_fildes || cb->aio_op != list[0]->aio_op ||
+            total + cb->aio_nbytes > AIO_COALESCE_SIZE)
+            break;
+
+        /* only the one continues the last one in file */
+        if (cb->aio_offset != list[count - 1]->aio_offset + (off_t)list[count - 1]->aio_nbytes)
+            break;
+
+        list[count] = cb;
+        rt_list_remove(&(cb->aio_node));
+        rt_list_init(&(cb->aio_node));
+        total += cb->aio_nbytes;
+        count ++;
+    }
+
+    return count;
+}
+
+static int aio_perform(struct aio_worker *worker, struct aiocb *list[], int count, int result[])
+{
+    struct dfs_fd *d;
+    size_t total, length;
+    int index, ret;
+
+    d = fd_get(list[0]->aio_fildes);
+    if (d == RT_NULL)
+    {
+        for (index = 0; index < count; index ++)
+            result[index] = -EBADF;
+        return count;
+    }
+
+    if (list[0]->aio_op == AIO_OP_FSYNC)
+    {
+        result[0] = dfs_file_flush(d);
+    }
+    else if (count == 1)
+    {
+        result[0] = aio_transfer(d, list[0]->aio_op, list[0]->aio_offset,
+                                 (void *)list[0]->aio_buf, list[0]->aio_nbytes);
+    }
+    else
+    {
+        total = 0;
+        if (list[0]->aio_op == AIO_OP_WRITE)
+        {
+            for (index = 0; index < count; index ++)
+            {
+                rt_memcpy(worker->bounce + total, (void *)list[index]->aio_buf, list[index]->aio_nbytes);
+                total += list[index]->aio_nbytes;
+            }
+        }
+        else
+        {
+            for (index = 0; index < count; index ++)
+                total += list[index]->aio_nbytes;
+        }
+
+        ret = aio_transfer(d, list[0]->aio_op, list[0]->aio_offset, worker->bounce, total);
+
+        /* distribute the transferred bytes to requests in order */
+        total = 0;
+        for (index = 0; index < count; index ++)
+        {
+            if (ret < 0)
+            {
+                result[index] = ret;
+                continue;
+            }
+
+            length = list[index]->aio_nbytes;
+            if (total + length > (size_t)ret)
+                length = (size_t)ret > total ? (size_t)ret - total : 0;
+            if (list[0]->aio_op == AIO_OP_READ)
+                rt_memcpy((void *)list[index]->aio_buf, worker->bounce + total, length);
+            result[index] = length;
+            total += length;
+        }
+    }
+
+    fd_put(d);
+
+    return count;
+}
+
+static void aio_worker_entry(void *parameter)
+{
+    struct aio_worker *worker = (struct aio_worker *)parameter;
+    struct aiocb *list[AIO_COALESCE_COUNT];
+    int result[AIO_COALESCE_COUNT];
+    int count, index;
+
+    while (1)
+    {
+        rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+        if (rt_list_isempty(&(worker->queue)))
+        {
+            worker->busy = RT_FALSE;
+            rt_mutex_release(&aio_lock);
+
+            rt_sem_take(&(worker->sem), RT_WAITING_FOREVER);
+            continue;
+        }
+
+        worker->busy = RT_TRUE;
+        list[0] = rt_list_entry(worker->queue.next, struct aiocb, aio_node);
+        rt_list_remove(&(list[0]->aio_node));
+        rt_list_init(&(list[0]->aio_node));
+        count = aio_coalesce(worker, list);
+        worker->fildes = list[0]->aio_fildes;
+        rt_mutex_release(&aio_lock);
+
+        aio_perform(worker, list, count, result);
+
+        rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+        for (index = 0; index < count; index ++)
+            aio_complete(list[index], result[index]);
+        worker->fildes = -1;
+        rt_mutex_release(&aio_lock);
+    }
+}
+
+static int aio_worker_startup(struct aio_worker *worker)
+{
+    char name[RT_NAME_MAX];
+
+    if (worker->thread != RT_NULL)
+        return 0;
+
+#if AIO_COALESCE_SIZE > 0
+    worker->bounce = (rt_uint8_t *)rt_malloc(AIO_COALESCE_SIZE);
+#endif
+
+    rt_snprintf(name, sizeof(name), "aio%d", (int)(worker - aio_workers));
+    worker->thread = rt_thread_create(name, aio_worker_entry, worker,
+                                      AIO_WORKER_STACK_SIZE, AIO_WORKER_PRIORITY, 10);
+    if (worker->thread == RT_NULL)
+    {
+        rt_free(worker->bounce);
+        worker->bounce = RT_NULL;
+        return -ENOMEM;
+    }
+    rt_thread_startup(worker->thread);
+
+    return 0;
+}
+
+/* queue a request, it should be invoked with aio lock */
+static int aio_enqueue(struct aiocb *cb, int op, struct aio_worker **worker)
+{
+    struct dfs_fd *d;
+    int result;
+
+    d = fd_get(cb->aio_fildes);
+    if (d == RT_NULL)
+        return -EBADF;
+
+    if (op == AIO_OP_READ && (d->flags & O_ACCMODE) == O_WRONLY)
+        result = -EBADF;
+    else if (op == AIO_OP_WRITE && (d->flags & O_ACCMODE) == O_RDONLY)
+        result = -EBADF;
+    else
+    {
+        *worker = aio_worker_get(d);
+        result = aio_worker_startup(*worker);
+    }
+    fd_put(d);
+
+    if (result < 0)
+        return result;
+
+    cb->aio_op = op;
+    cb->aio_result = -EINPROGRESS;
+    cb->aio_thread = rt_thread_self();
+    rt_list_insert_before(&((*worker)->queue), &(cb->aio_node));
+
+    return 0;
+}
+
+static int aio_submit(struct aiocb *cb, int op)
+{
+    struct aio_worker *worker;
+    int result;
+
+    if (!cb) return -EINVAL;
+    if (op != AIO_OP_FSYNC && (cb->aio_offset < 0 || cb->aio_buf == RT_NULL))
+        return -EINVAL;
+
+    cb->aio_lio = RT_NULL;
+
+    rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+    result = aio_enqueue(cb, op, &worker);
+    rt_mutex_release(&aio_lock);
+
+    if (result < 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    rt_sem_release(&(worker->sem));
+
+    return 0;
+}
 
 /**
  * The aio_cancel() function shall attempt to cancel one or more asynchronous I/O 
@@ -45,19 +453,55 @@ struct rt_workqueue* aio_queue = NULL;
  */
 int aio_cancel(int fd, struct aiocb *cb)
 {
-    rt_err_t ret;
+    int index, result = AIO_ALLDONE;
+    rt_list_t *node;
+    struct aiocb *iter;
 
-    if (!cb) return -EINVAL;
-    if (cb->aio_fildes != fd) return -EINVAL;
-
-    ret = rt_workqueue_cancel_work_sync(aio_queue, &(cb->aio_work));
-    if (ret == RT_EOK)
+    if (cb && cb->aio_fildes != fd)
     {
-        errno = -ECANCELED;
+        rt_set_errno(-EINVAL);
         return -1;
     }
 
-    return 0;
+    rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+
+    for (index = 0; index < AIO_WORKER_NUM_MAX; index ++)
+    {
+        node = aio_workers[index].queue.next;
+        while (node != &(aio_workers[index].queue))
+        {
+            iter = rt_list_entry(node, struct aiocb, aio_node);
+            node = node->next;
+
+            if (iter->aio_fildes != fd || (cb && iter != cb))
+                continue;
+
+            rt_list_remove(&(iter->aio_node));
+            rt_list_init(&(iter->aio_node));
+            aio_complete(iter, -ECANCELED);
+            if (result == AIO_ALLDONE)
+                result = AIO_CANCELED;
+        }
+    }
+
+    /* the requests being performed can't be canceled */
+    if (cb)
+    {
+        if (cb->aio_result == -EINPROGRESS)
+            result = AIO_NOTCANCELED;
+    }
+    else
+    {
+        for (index = 0; index < AIO_WORKER_NUM_MAX; index ++)
+        {
+            if (aio_workers[index].fildes == fd)
+                result = AIO_NOTCANCELED;
+        }
+    }
+
+    rt_mutex_release(&aio_lock);
+
+    return result;
 }
 
 /**
@@ -70,10 +514,13 @@ int aio_error (const struct aiocb *cb)
 {
     if (cb)
     {
-        return cb->aio_result;
+        if (cb->aio_result < 0)
+            return -cb->aio_result;
+
+        return 0;
     }
 
-    return -EINVAL;
+    return EINVAL;
 }
 
 /**
@@ -117,63 +564,19 @@ int aio_error (const struct aiocb *cb)
  * If the aio_fsync() function fails or aiocbp indicates an error condition, 
  * data is not guaranteed to have been successfully transferred.
  */
-static void aio_fync_work(struct rt_work* work, void* work_data)
-{
-    int result;
-    rt_ubase_t level;
-    struct aiocb *cb = (struct aiocb*)work_data;
-
-    RT_ASSERT(cb != RT_NULL);
-
-    result = fsync(cb->aio_fildes);
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (result < 0)
-        cb->aio_result = errno;
-    else
-        cb->aio_result = 0;
-    rt_hw_interrupt_enable(level);
-
-    return ;
-}
-
 int aio_fsync(int op, struct aiocb *cb)
 {
-    rt_ubase_t level;
-    if (!cb) return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    rt_work_init(&(cb->aio_work), aio_fync_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
-}
-
-static void aio_read_work(struct rt_work* work, void* work_data)
-{
-    int len;
-    rt_ubase_t level;
-    uint8_t *buf_ptr;
-    struct aiocb *cb = (struct aiocb*)work_data;
-
-    buf_ptr = (uint8_t*)cb->aio_buf;
-
-    /* seek to offset */
-    lseek(cb->aio_fildes, cb->aio_offset, SEEK_SET);
-    len = read(cb->aio_fildes, &buf_ptr[cb->aio_offset], cb->aio_nbytes);
-
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (len <= 0)
-        cb->aio_result = errno;
-    else 
-        cb->aio_result = len;
-    rt_hw_interrupt_enable(level);
+#ifdef O_DSYNC
+    if (op != O_SYNC && op != O_DSYNC)
+#else
+    if (op != O_SYNC)
+#endif
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
 
-    return ;
+    return aio_submit(cb, AIO_OP_FSYNC);
 }
 
 /**
@@ -225,20 +628,7 @@ static void aio_read_work(struct rt_work* work, void* work_data)
  */
 int aio_read(struct aiocb *cb)
 {
-    rt_ubase_t level;
-
-    if (!cb) return -EINVAL;
-    if (cb->aio_offset < 0) return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    /* en-queue read work */
-    rt_work_init(&(cb->aio_work), aio_read_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
+    return aio_submit(cb, AIO_OP_READ);
 }
 
 /**
@@ -259,12 +649,16 @@ ssize_t  aio_return(struct aiocb *cb)
     if (cb)
     {
         if (cb->aio_result < 0)
+        {
             rt_set_errno(cb->aio_result);
+            return -1;
+        }
 
         return cb->aio_result;
     }
 
-    return -EINVAL;
+    rt_set_errno(-EINVAL);
+    return -1;
 }
 
 /**
@@ -290,36 +684,59 @@ ssize_t  aio_return(struct aiocb *cb)
 int aio_suspend(const struct aiocb *const list[], int nent,
              const struct timespec *timeout)
 {
-    return -ENOSYS;
-}
+    struct aio_waiter waiter;
+    rt_int32_t tick = RT_WAITING_FOREVER;
+    rt_tick_t start;
+    int index, result = -EAGAIN;
 
-static void aio_write_work(struct rt_work* work, void* work_data)
-{
-    int len, oflags, level;
-    uint8_t *buf_ptr;
-    struct aiocb *cb = (struct aiocb*)work_data;
+    if (timeout)
+    {
+        tick = timeout->tv_sec * RT_TICK_PER_SECOND +
+               (rt_int64_t)timeout->tv_nsec * RT_TICK_PER_SECOND / 1000000000;
+    }
 
-    buf_ptr = (uint8_t*)cb->aio_buf;
+    rt_sem_init(&(waiter.sem), "aio", 0, RT_IPC_FLAG_FIFO);
+    rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+    rt_list_insert_before(&aio_waiter_list, &(waiter.list));
+    rt_mutex_release(&aio_lock);
 
-    /* whether seek offset */
-    oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
-    if ((oflags & O_APPEND) == 0)
+    start = rt_tick_get();
+    while (1)
     {
-        lseek(cb->aio_fildes, SEEK_SET, cb->aio_offset);
+        for (index = 0; index < nent; index ++)
+        {
+            if (list[index] && list[index]->aio_result != -EINPROGRESS)
+            {
+                result = 0;
+                break;
+            }
+        }
+        if (result == 0)
+            break;
+
+        if (tick != RT_WAITING_FOREVER)
+        {
+            tick -= rt_tick_get() - start;
+            start = rt_tick_get();
+            if (tick <= 0)
+                break;
+        }
+
+        rt_sem_take(&(waiter.sem), tick);
     }
 
-    /* write data */
-    len = write(cb->aio_fildes, buf_ptr, cb->aio_nbytes);
+    rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+    rt_list_remove(&(waiter.list));
+    rt_mutex_release(&aio_lock);
+    rt_sem_detach(&(waiter.sem));
 
-    /* modify result */
-    level = rt_hw_interrupt_disable();
-    if (len <= 0)
-        cb->aio_result = errno;
-    else 
-        cb->aio_result = len;
-    rt_hw_interrupt_enable(level);
+    if (result < 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
 
-    return;
+    return 0;
 }
 
 /**
@@ -363,25 +780,7 @@ static void aio_write_work(struct rt_work* work, void* work_data)
  */
 int aio_write(struct aiocb *cb)
 {
-    int oflags;
-    rt_ubase_t level;
-
-    if (!cb || (cb->aio_buf == NULL)) return -EINVAL;
-
-    /* check access mode */
-    oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
-    if ((oflags & O_ACCMODE) != O_WRONLY ||
-        (oflags & O_ACCMODE) != O_RDWR)
-        return -EINVAL;
-
-    level = rt_hw_interrupt_disable();
-    cb->aio_result = -EINPROGRESS;
-    rt_hw_interrupt_enable(level);
-
-    rt_work_init(&(cb->aio_work), aio_write_work, cb);
-    rt_workqueue_dowork(aio_queue, &(cb->aio_work));
-
-    return 0;
+    return aio_submit(cb, AIO_OP_WRITE);
 }
 
 /**
@@ -452,13 +851,120 @@ int aio_write(struct aiocb *cb)
 int lio_listio(int mode, struct aiocb * const list[], int nent,
             struct sigevent *sig)
 {
-    return -ENOSYS;
+    struct aio_worker *worker, *woken[AIO_WORKER_NUM_MAX];
+    struct aio_lio *lio = RT_NULL;
+    int index, count, woken_count = 0, result = 0;
+
+    if ((mode != LIO_WAIT && mode != LIO_NOWAIT) || nent < 0)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    if (mode == LIO_NOWAIT && sig != RT_NULL)
+    {
+        lio = (struct aio_lio *)rt_malloc(sizeof(struct aio_lio));
+        if (lio == RT_NULL)
+        {
+            rt_set_errno(-EAGAIN);
+            return -1;
+        }
+        lio->pending = 1;
+        lio->sig = *sig;
+        lio->thread = rt_thread_self();
+    }
+
+    /* queue the whole list at once, then wake up the workers */
+    rt_mutex_take(&aio_lock, RT_WAITING_FOREVER);
+    for (index = 0; index < nent; index ++)
+    {
+        if (list[index] == RT_NULL || list[index]->aio_lio_opcode == LIO_NOP)
+            continue;
+
+        list[index]->aio_lio = RT_NULL;
+        if ((list[index]->aio_lio_opcode != LIO_READ &&
+             list[index]->aio_lio_opcode != LIO_WRITE) ||
+            list[index]->aio_offset < 0 || list[index]->aio_buf == RT_NULL)
+        {
+            list[index]->aio_result = -EINVAL;
+            result = -EIO;
+            continue;
+        }
+
+        if (aio_enqueue(list[index], list[index]->aio_lio_opcode, &worker) < 0)
+        {
+            list[index]->aio_result = -EAGAIN;
+            result = -EIO;
+            continue;
+        }
+
+        if (lio)
+        {
+            list[index]->aio_lio = lio;
+            lio->pending ++;
+        }
+
+        for (count = 0; count < woken_count; count ++)
+        {
+            if (woken[count] == worker)
+                break;
+        }
+        if (count == woken_count)
+            woken[woken_count ++] = worker;
+    }
+
+    /* drop the reference held during submission */
+    if (lio && --lio->pending == 0)
+    {
+        aio_notify(&(lio->sig), lio->thread);
+        rt_free(lio);
+    }
+    rt_mutex_release(&aio_lock);
+
+    for (count = 0; count < woken_count; count ++)
+        rt_sem_release(&(woken[count]->sem));
+
+    if (mode == LIO_WAIT)
+    {
+        /* wait for all of the requests completed */
+        for (index = 0; index < nent; index ++)
+        {
+            const struct aiocb *const *entry = (const struct aiocb *const *)&list[index];
+
+            if (list[index] == RT_NULL || list[index]->aio_lio_opcode == LIO_NOP)
+                continue;
+
+            while (list[index]->aio_result == -EINPROGRESS)
+                aio_suspend(entry, 1, RT_NULL);
+
+            if (list[index]->aio_result < 0)
+                result = -EIO;
+        }
+    }
+
+    if (result < 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    return 0;
 }
 
 int aio_system_init(void)
 {
-    aio_queue = rt_workqueue_create("aio", 2048, RT_THREAD_PRIORITY_MAX/2);
-    RT_ASSERT(aio_queue != NULL);
+    int index;
+
+    rt_mutex_init(&aio_lock, "aio", RT_IPC_FLAG_FIFO);
+    rt_list_init(&aio_waiter_list);
+
+    for (index = 0; index < AIO_WORKER_NUM_MAX; index ++)
+    {
+        rt_memset(&aio_workers[index], 0, sizeof(struct aio_worker));
+        rt_list_init(&(aio_workers[index].queue));
+        aio_workers[index].fildes = -1;
+        rt_sem_init(&(aio_workers[index].sem), "aio", 0, RT_IPC_FLAG_FIFO);
+    }
 
     return 0;
 }
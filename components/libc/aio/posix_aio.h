@@ -6,11 +6,34 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/12/30     Bernard      The first version.
+ * 2026-10-19     agent        Add per-device workers, aio_suspend and lio_listio.
  */
 
 #ifndef POSIX_AIO_H__
 #define POSIX_AIO_H__
 
+/* the operations of lio_listio */
+#ifndef LIO_READ
+#define LIO_READ        0
+#define LIO_WRITE       1
+#define LIO_NOP         2
+#endif
+
+/* the modes of lio_listio */
+#ifndef LIO_WAIT
+#define LIO_WAIT        0
+#define LIO_NOWAIT      1
+#endif
+
+/* the results of aio_cancel */
+#ifndef AIO_CANCELED
+#define AIO_CANCELED    0
+#define AIO_NOTCANCELED 1
+#define AIO_ALLDONE     2
+#endif
+
+struct aio_lio;
+
 struct aiocb
 {
     int aio_fildes;         /* File descriptor. */
@@ -22,8 +45,11 @@ struct aiocb
     struct sigevent aio_sigevent; /* Signal number and value. */
     int aio_lio_opcode;     /* Operation to be performed. */
 
-    int aio_result;
-    struct rt_work aio_work;
+    int aio_result;         /* bytes transferred, or negative error code */
+    int aio_op;             /* the operation in progress */
+    rt_list_t aio_node;     /* node in the queue of worker */
+    rt_thread_t aio_thread; /* the thread submitted request */
+    struct aio_lio *aio_lio;/* the list submitted by lio_listio */
 };
 
 int aio_cancel(int fd, struct aiocb *cb);
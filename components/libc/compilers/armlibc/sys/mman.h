@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/11/30     Bernard      The first version.
+ * 2026-10-19     agent        Add msync.
  */
 
 #ifndef _SYS_MMAN_H
@@ -51,6 +52,7 @@ extern "C" {
 
 void *mmap (void *start, size_t len, int prot, int flags, int fd, off_t off);
 int munmap (void *start, size_t len);
+int msync (void *start, size_t len, int flags);
 
 #ifdef __cplusplus
 }
@@ -6,62 +6,337 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/11/30     Bernard      The first version.
+ * 2026-10-19     agent        Map file content in place through DFS, add msync.
+ * 2026-10-19     agent        Don't write back beyond the end of file.
+ * 2026-10-19     agent        Check the access mode and type of file before mapping.
  */
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <rtthread.h>
 #include <dfs_posix.h>
+#include <dfs_file.h>
 
 #include <sys/mman.h>
 
+#define MMAP_REGION_ALLOCATED   0x01    /* the memory is allocated by mmap */
+#define MMAP_REGION_WRITE_BACK  0x02    /* the memory is written back to file */
+
+struct mmap_region
+{
+    rt_list_t list;
+
+    uint8_t *addr;
+    size_t length;
+    off_t offset;
+    off_t file_size;                    /* the size of file when it's mapped */
+    int flags;
+
+    struct dfs_fd *fd;                  /* the file opened for write back */
+};
+
+static rt_list_t _mmap_region_list = RT_LIST_OBJECT_INIT(_mmap_region_list);
+
+/* find the region which contains the memory range, it should be invoked with dfs lock */
+static struct mmap_region *_mmap_region_find(void *addr, size_t length)
+{
+    rt_list_t *node;
+    struct mmap_region *region;
+
+    for (node = _mmap_region_list.next; node != &_mmap_region_list; node = node->next)
+    {
+        region = rt_list_entry(node, struct mmap_region, list);
+        if ((uint8_t *)addr >= region->addr &&
+            (uint8_t *)addr + length <= region->addr + region->length)
+        {
+            return region;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* open the mapped file again, the mapping keeps after the descriptor closed */
+static int _mmap_open_write_back(struct mmap_region *region, struct dfs_fd *d)
+{
+    struct dfs_filesystem *fs = d->fs;
+    char *fullpath;
+    int result;
+
+    if (fs->ops->flags & DFS_FS_FLAG_FULLPATH)
+        fullpath = rt_strdup(d->path);
+    else if (fs->path[0] == '/' && fs->path[1] == '\0')
+        fullpath = rt_strdup(d->path);
+    else if (d->path[0] == '/' && d->path[1] == '\0')
+        fullpath = rt_strdup(fs->path);
+    else
+    {
+        fullpath = (char *)rt_malloc(strlen(fs->path) + strlen(d->path) + 1);
+        if (fullpath != RT_NULL)
+        {
+            strcpy(fullpath, fs->path);
+            strcat(fullpath, d->path);
+        }
+    }
+    if (fullpath == RT_NULL)
+        return -ENOMEM;
+
+    region->fd = (struct dfs_fd *)rt_calloc(1, sizeof(struct dfs_fd));
+    if (region->fd == RT_NULL)
+    {
+        rt_free(fullpath);
+        return -ENOMEM;
+    }
+
+    result = dfs_file_open(region->fd, fullpath, O_WRONLY);
+    rt_free(fullpath);
+    if (result < 0)
+    {
+        rt_free(region->fd);
+        region->fd = RT_NULL;
+        return result;
+    }
+
+    region->flags |= MMAP_REGION_WRITE_BACK;
+
+    return 0;
+}
+
+/* copy the file content into memory, the content beyond the end of file is zero */
+static int _mmap_copy(struct mmap_region *region, struct dfs_fd *d)
+{
+    off_t cur;
+    size_t length = 0;
+    int result;
+
+    cur = d->pos;
+    result = dfs_file_lseek(d, region->offset);
+    while (result >= 0 && length < region->length)
+    {
+        result = dfs_file_read(d, region->addr + length, region->length - length);
+        if (result <= 0)
+            break;
+        length += result;
+    }
+    dfs_file_lseek(d, cur);
+
+    if (result < 0)
+        return result;
+
+    memset(region->addr + length, 0, region->length - length);
+
+    return 0;
+}
+
+/* write back the memory range, the part beyond the end of file is not written */
+static int _mmap_write_back(struct mmap_region *region, uint8_t *addr, size_t length)
+{
+    off_t pos = region->offset + (addr - region->addr);
+    int result;
+
+    if (pos >= region->file_size)
+        return 0;
+    if (length > (size_t)(region->file_size - pos))
+        length = region->file_size - pos;
+
+    result = dfs_file_lseek(region->fd, region->offset + (addr - region->addr));
+    if (result >= 0)
+        result = dfs_file_write(region->fd, addr, length);
+    if (result >= 0)
+        result = dfs_file_flush(region->fd);
+
+    return result < 0 ? result : 0;
+}
+
+static void _mmap_region_free(struct mmap_region *region)
+{
+    if (region->fd != RT_NULL)
+    {
+        dfs_file_close(region->fd);
+        rt_free(region->fd);
+    }
+    if (region->flags & MMAP_REGION_ALLOCATED)
+        free(region->addr);
+
+    rt_free(region);
+}
+
 void *mmap(void *addr, size_t length, int prot, int flags,
     int fd, off_t offset)
 {
-    uint8_t *mem;
+    struct mmap_region *region;
+    struct dfs_fd *d = RT_NULL;
+    void *mem = RT_NULL;
+    int result = 0;
 
-    if (addr)
+    if (length == 0 || offset < 0)
     {
-        mem = addr;
+        errno = EINVAL;
+
+        return MAP_FAILED;
     }
-    else mem = (uint8_t *)malloc(length);
 
-    if (mem)
+    region = (struct mmap_region *)rt_calloc(1, sizeof(struct mmap_region));
+    if (region == RT_NULL)
     {
-        off_t cur;
-        size_t read_bytes;
+        errno = ENOMEM;
 
-        cur = lseek(fd, 0, SEEK_SET);
+        return MAP_FAILED;
+    }
+    region->length = length;
+    region->offset = offset;
 
-        lseek(fd, offset, SEEK_SET);
-        read_bytes = read(fd, mem, length);
-        if (read_bytes != length)
+    if (!(flags & MAP_ANONYMOUS))
+    {
+        d = fd_get(fd);
+        if (d == RT_NULL)
         {
-            if (addr == RT_NULL)
-            {
-                /* read failed */
-                free(mem);
+            result = -EBADF;
+            goto __exit;
+        }
+
+        /* only the file of file system could be mapped */
+        if (d->type != FT_REGULAR || d->fs == RT_NULL)
+        {
+            result = -ENODEV;
+            goto __exit;
+        }
+
+        /* the file should be readable, and writable for the shared writable
+         * mapping as it's written back */
+        if ((d->flags & O_ACCMODE) == O_WRONLY ||
+            ((prot & PROT_WRITE) && (flags & MAP_SHARED) &&
+             (d->flags & O_ACCMODE) != O_RDWR))
+        {
+            result = -EACCES;
+            goto __exit;
+        }
+
+        /* use the content stored in memory by file system, but the private
+         * writable mapping needs its own copy */
+        if (addr == RT_NULL && (!(prot & PROT_WRITE) || (flags & MAP_SHARED)))
+        {
+            if (dfs_file_mmap(d, offset, length,
+                              (prot & PROT_WRITE) ? DFS_MMAP_WRITE : 0, &mem) < 0)
                 mem = RT_NULL;
+        }
+    }
+
+    if (mem == RT_NULL)
+    {
+        if (addr)
+        {
+            mem = addr;
+        }
+        else
+        {
+            mem = malloc(length);
+            if (mem == RT_NULL)
+            {
+                result = -ENOMEM;
+                goto __exit;
             }
+            region->flags |= MMAP_REGION_ALLOCATED;
         }
-        lseek(fd, cur, SEEK_SET);
+        region->addr = (uint8_t *)mem;
 
-        return mem;
+        if (d == RT_NULL)
+        {
+            memset(mem, 0, length);
+        }
+        else
+        {
+            region->file_size = d->size;
+            result = _mmap_copy(region, d);
+            if (result == 0 && (prot & PROT_WRITE) && (flags & MAP_SHARED))
+                result = _mmap_open_write_back(region, d);
+        }
+    }
+    else
+    {
+        region->addr = (uint8_t *)mem;
     }
 
-    errno = ENOMEM;
+__exit:
+    if (d != RT_NULL)
+        fd_put(d);
 
-    return MAP_FAILED;
+    if (result < 0)
+    {
+        _mmap_region_free(region);
+        errno = -result;
+
+        return MAP_FAILED;
+    }
+
+    dfs_lock();
+    rt_list_insert_before(&_mmap_region_list, &region->list);
+    dfs_unlock();
+
+    return mem;
 }
 
 int munmap(void *addr, size_t length)
 {
-    if (addr)
+    struct mmap_region *region;
+    int result = 0;
+
+    dfs_lock();
+    region = _mmap_region_find(addr, 0);
+    if (region == RT_NULL || region->addr != addr)
     {
-        free(addr);
-        return 0;
+        dfs_unlock();
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    /* write back with dfs lock as msync does, the region is not freed under it */
+    if (region->flags & MMAP_REGION_WRITE_BACK)
+        result = _mmap_write_back(region, region->addr, region->length);
+    rt_list_remove(&region->list);
+    dfs_unlock();
+
+    _mmap_region_free(region);
+
+    if (result < 0)
+    {
+        errno = -result;
+
+        return -1;
+    }
+
+    return 0;
+}
+
+int msync(void *addr, size_t length, int flags)
+{
+    struct mmap_region *region;
+    int result = 0;
+
+    dfs_lock();
+    region = _mmap_region_find(addr, length);
+    if (region == RT_NULL)
+    {
+        dfs_unlock();
+        errno = ENOMEM;
+
+        return -1;
+    }
+
+    /* the mapping in place is synchronized with file already */
+    if (region->flags & MMAP_REGION_WRITE_BACK)
+        result = _mmap_write_back(region, (uint8_t *)addr, length);
+    dfs_unlock();
+
+    if (result < 0)
+    {
+        errno = -result;
+
+        return -1;
     }
 
-    return -1;
+    return 0;
 }
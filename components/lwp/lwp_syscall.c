@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-06-10     Bernard      first version
+ * 2026-10-19     agent        close the files of process by fd number
  */
 
 /* RT-Thread System call */
@@ -31,12 +32,13 @@
 static void __exit_files(rt_thread_t tid)
 {
     struct rt_lwp *lwp;
+    int index;
 
     lwp = (struct rt_lwp *)tid->lwp;
-    while (lwp->fdt.maxfd > 0)
+    for (index = (int)lwp->fdt.maxfd - 1; index >= 0; index --)
     {
-        lwp->fdt.maxfd --;
-        close(lwp->fdt.maxfd);
+        if (lwp->fdt.fds[index] != RT_NULL)
+            close(index + DFS_FD_OFFSET);
     }
 }
 
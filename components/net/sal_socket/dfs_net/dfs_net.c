@@ -9,6 +9,7 @@
  * 2016-05-07     Bernard      Rename dfs_lwip to dfs_net
  * 2018-03-09     Bernard      Fix the last data issue in poll.
  * 2018-05-24     ChenYong     Add socket abstraction layer
+ * 2026-10-19     agent        Add readv/writev
  */
 
 #include <rtthread.h>
@@ -68,6 +69,20 @@ static int dfs_net_poll(struct dfs_fd *file, struct rt_pollreq *req)
     return sal_poll(file, req);
 }
 
+static int dfs_net_readv(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    int socket = (int) file->data;
+
+    return sal_readv(socket, iov, iovcnt);
+}
+
+static int dfs_net_writev(struct dfs_fd *file, const struct iovec *iov, int iovcnt)
+{
+    int socket = (int) file->data;
+
+    return sal_writev(socket, iov, iovcnt);
+}
+
 const struct dfs_file_ops _net_fops = 
 {
     NULL,    /* open     */
@@ -79,6 +94,9 @@ const struct dfs_file_ops _net_fops =
     NULL,    /* lseek    */
     NULL,    /* getdents */
     dfs_net_poll,
+    NULL,    /* mmap     */
+    dfs_net_readv,
+    dfs_net_writev,
 };
 
 const struct dfs_file_ops *dfs_net_get_fops(void)
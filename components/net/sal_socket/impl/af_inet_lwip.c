@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     ChenYong     First version
+ * 2026-10-19     agent        Map readv/writev to lwIP
  */
 
 #include <rtthread.h>
@@ -303,6 +304,13 @@ static const struct sal_socket_ops lwip_socket_ops =
 #ifdef SAL_USING_POSIX
     inet_poll,
 #endif
+#if LWIP_VERSION >= 0x20100ff
+    (int (*)(int, const struct iovec *, int))lwip_readv,
+    (int (*)(int, const struct iovec *, int))lwip_writev,
+#else
+    NULL,
+    NULL,
+#endif
 };
 
 static const struct sal_netdb_ops lwip_netdb_ops =
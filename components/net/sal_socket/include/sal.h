@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     ChenYong     First version
+ * 2026-10-19     agent        Add readv/writev socket operations
  */
 
 #ifndef SAL_H__
@@ -80,6 +81,8 @@ struct sal_socket_ops
 #ifdef SAL_USING_POSIX
     int (*poll)       (struct dfs_fd *file, struct rt_pollreq *req);
 #endif
+    int (*readv)      (int s, const struct iovec *iov, int iovcnt);
+    int (*writev)     (int s, const struct iovec *iov, int iovcnt);
 };
 
 /* sal network database name resolving */
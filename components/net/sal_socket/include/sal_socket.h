@@ -209,6 +209,8 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
 int sal_socket(int domain, int type, int protocol);
 int sal_closesocket(int socket);
 int sal_ioctlsocket(int socket, long cmd, void *arg);
+int sal_readv(int socket, const struct iovec *iov, int iovcnt);
+int sal_writev(int socket, const struct iovec *iov, int iovcnt);
 
 #ifdef __cplusplus
 }
@@ -7,12 +7,16 @@
  * Date           Author       Notes
  * 2015-02-17     Bernard      First version
  * 2018-05-17     ChenYong     Add socket abstraction layer
+ * 2026-10-19     agent        Remove the closed socket from epoll instances
  */
 
 #include <dfs.h>
 #include <dfs_file.h>
 #include <dfs_poll.h>
 #include <dfs_net.h>
+#ifdef RT_USING_POSIX_EPOLL
+#include <dfs_epoll.h>
+#endif
 
 #include <sys/socket.h>
 
@@ -268,6 +272,10 @@ int closesocket(int s)
         return -1;
     }
 
+#ifdef RT_USING_POSIX_EPOLL
+    dfs_epoll_release(d);
+#endif
+
     if (sal_closesocket(socket) == 0)
     {
         error = 0;
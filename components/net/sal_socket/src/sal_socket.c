@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2018-05-23     ChenYong     First version
  * 2018-11-12     ChenYong     Add TLS support
+ * 2026-10-19     agent        Add readv/writev
  */
 
 #include <rtthread.h>
@@ -881,6 +882,87 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
 #endif
 }
 
+int sal_readv(int socket, const struct iovec *iov, int iovcnt)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+    int index, result, length = 0;
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+
+    pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+#ifdef SAL_USING_TLS
+    if (pf->skt_ops->readv && !SAL_SOCKOPS_PROTO_TLS_VALID(sock, recv))
+#else
+    if (pf->skt_ops->readv)
+#endif
+    {
+        return pf->skt_ops->readv((int) sock->user_data, iov, iovcnt);
+    }
+
+    /* receive buffer by buffer until the data is less than buffer */
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        result = sal_recvfrom(socket, iov[index].iov_base, iov[index].iov_len,
+                              length > 0 ? MSG_DONTWAIT : 0, NULL, NULL);
+        if (result <= 0)
+            return length > 0 ? length : result;
+
+        length += result;
+        if ((size_t)result < iov[index].iov_len)
+            break;
+    }
+
+    return length;
+}
+
+int sal_writev(int socket, const struct iovec *iov, int iovcnt)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+    int index, result, length = 0;
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+
+    pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+#ifdef SAL_USING_TLS
+    if (pf->skt_ops->writev && !SAL_SOCKOPS_PROTO_TLS_VALID(sock, send))
+#else
+    if (pf->skt_ops->writev)
+#endif
+    {
+        return pf->skt_ops->writev((int) sock->user_data, iov, iovcnt);
+    }
+
+    /* send buffer by buffer */
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        result = sal_sendto(socket, iov[index].iov_base, iov[index].iov_len, 0, NULL, 0);
+        if (result < 0)
+            return length > 0 ? length : result;
+
+        length += result;
+        if ((size_t)result < iov[index].iov_len)
+            break;
+    }
+
+    return length;
+}
+
 int sal_socket(int domain, int type, int protocol)
 {
     int retval;
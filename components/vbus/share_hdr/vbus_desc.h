@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+#ifndef __VBUS_DESC_H__
+#define __VBUS_DESC_H__
+
+/* The descriptor ring shared by both sides of VBus. Unlike the block ring in
+ * vbus_api.h, the data is not copied into the ring. The buffers are allocated
+ * in the shared memory, the producer fills the buffer in place and posts the
+ * descriptor of it, the consumer reads the buffer in place and gives it back
+ * to the producer on released.
+ *
+ * There is one ring for each direction. Each ring has one producer and one
+ * consumer, so no lock is shared between the two sides. Only the offsets are
+ * recorded in the shared memory, so the ring could be mapped at different
+ * addresses on each side.
+ *
+ * This file is shared with the other side, it should only depend on the
+ * compiler. Define rt_vbus_desc_mb/wmb/rmb before including this file if the
+ * barriers of the compiler are not suitable. */
+
+#define RT_VBUS_DESC_MAGIC   0x56444553 /* "VDES" */
+
+#define RT_VBUS_DESC_ALIGN   64
+
+/* flags of descriptor */
+#define RT_VBUS_DESC_F_MORE  0x01 /* more fragments of the packet follow */
+
+#ifndef __ASSEMBLY__
+#include <stddef.h> /* For size_t */
+
+#ifndef rt_vbus_desc_mb
+#define rt_vbus_desc_mb()    __sync_synchronize()
+#endif
+#ifndef rt_vbus_desc_wmb
+#define rt_vbus_desc_wmb()   __sync_synchronize()
+#endif
+#ifndef rt_vbus_desc_rmb
+#define rt_vbus_desc_rmb()   __sync_synchronize()
+#endif
+
+struct rt_vbus_desc
+{
+    unsigned int idx;       /* index of buffer */
+    unsigned int len;       /* length of data in buffer */
+    unsigned char chnr;
+    unsigned char flags;
+    unsigned short reserved;
+};
+
+struct rt_vbus_desc_ring
+{
+    unsigned int magic;
+    unsigned int buf_nr;    /* number of buffers, it must be power of 2 */
+    unsigned int buf_sz;    /* size of buffer, it must be aligned to RT_VBUS_DESC_ALIGN */
+    unsigned int buf_off;   /* offset of the first buffer to the ring */
+
+    /* Written by producer only. The indexes are free running. */
+    struct
+    {
+        volatile unsigned int avail_put;
+        volatile unsigned int free_get;
+        /* The producer is waiting for the buffer released. */
+        volatile unsigned int waiting;
+    } prod __attribute__((aligned(RT_VBUS_DESC_ALIGN)));
+
+    /* Written by consumer only. */
+    struct
+    {
+        volatile unsigned int avail_get;
+        volatile unsigned int free_put;
+        /* The consumer is waiting for the descriptor posted. */
+        volatile unsigned int waiting;
+    } cons __attribute__((aligned(RT_VBUS_DESC_ALIGN)));
+
+    /* Followed by:
+     *
+     * struct rt_vbus_desc avail[buf_nr];
+     * unsigned int free[buf_nr];
+     * buffers, starts at buf_off
+     */
+} __attribute__((aligned(RT_VBUS_DESC_ALIGN)));
+
+#define _VBUS_DESC_ROUNDUP(x) (((x) + RT_VBUS_DESC_ALIGN - 1) & ~(size_t)(RT_VBUS_DESC_ALIGN - 1))
+
+static inline struct rt_vbus_desc *_rt_vbus_desc_avail(struct rt_vbus_desc_ring *ring)
+{
+    return (struct rt_vbus_desc *)(ring + 1);
+}
+
+static inline unsigned int *_rt_vbus_desc_free(struct rt_vbus_desc_ring *ring)
+{
+    return (unsigned int *)(_rt_vbus_desc_avail(ring) + ring->buf_nr);
+}
+
+/** Get the size of memory needed by the ring of @buf_nr buffers of @buf_sz. */
+static inline size_t rt_vbus_desc_ring_size(unsigned int buf_nr, unsigned int buf_sz)
+{
+    return _VBUS_DESC_ROUNDUP(sizeof(struct rt_vbus_desc_ring) +
+                              buf_nr * (sizeof(struct rt_vbus_desc) + sizeof(unsigned int))) +
+           (size_t)buf_nr * _VBUS_DESC_ROUNDUP(buf_sz);
+}
+
+/** Format the ring in memory @mem, all the buffers are free.
+ *
+ * It should be done by one side before the other side touches the ring.
+ *
+ * @return the ring, or NULL if @buf_nr is not power of 2.
+ */
+static inline struct rt_vbus_desc_ring *rt_vbus_desc_ring_format(void *mem,
+                                                                 unsigned int buf_nr,
+                                                                 unsigned int buf_sz)
+{
+    struct rt_vbus_desc_ring *ring = (struct rt_vbus_desc_ring *)mem;
+    unsigned int i;
+
+    if (buf_nr == 0 || (buf_nr & (buf_nr - 1)))
+        return NULL;
+
+    ring->buf_nr  = buf_nr;
+    ring->buf_sz  = (unsigned int)_VBUS_DESC_ROUNDUP(buf_sz);
+    ring->buf_off = (unsigned int)_VBUS_DESC_ROUNDUP(sizeof(struct rt_vbus_desc_ring) +
+                                                     buf_nr * (sizeof(struct rt_vbus_desc) + sizeof(unsigned int)));
+
+    ring->prod.avail_put = 0;
+    ring->prod.free_get  = 0;
+    ring->prod.waiting   = 0;
+    ring->cons.avail_get = 0;
+    ring->cons.free_put  = buf_nr;
+    ring->cons.waiting   = 0;
+    for (i = 0; i < buf_nr; i++)
+        _rt_vbus_desc_free(ring)[i] = i;
+
+    rt_vbus_desc_wmb();
+    ring->magic = RT_VBUS_DESC_MAGIC;
+    rt_vbus_desc_mb();
+
+    return ring;
+}
+
+/** Get the address of buffer @idx on this side. */
+static inline void *rt_vbus_desc_buf(struct rt_vbus_desc_ring *ring, unsigned int idx)
+{
+    return (char *)ring + ring->buf_off + (size_t)idx * ring->buf_sz;
+}
+
+/** Allocate a buffer, called by producer.
+ *
+ * @return the index of buffer, or -1 if all the buffers are in use.
+ */
+static inline int rt_vbus_desc_alloc(struct rt_vbus_desc_ring *ring)
+{
+    unsigned int get = ring->prod.free_get;
+    unsigned int idx;
+
+    if (get == ring->cons.free_put)
+        return -1;
+
+    rt_vbus_desc_rmb();
+    idx = _rt_vbus_desc_free(ring)[get & (ring->buf_nr - 1)];
+    ring->prod.free_get = get + 1;
+
+    return (int)idx;
+}
+
+/** Post the buffer @idx filled with @len bytes to the consumer.
+ *
+ * There is always room in the ring for the buffer allocated, so it never
+ * fails.
+ */
+static inline void rt_vbus_desc_post(struct rt_vbus_desc_ring *ring, unsigned int idx,
+                                     unsigned int len, unsigned char chnr,
+                                     unsigned char flags)
+{
+    unsigned int put = ring->prod.avail_put;
+    struct rt_vbus_desc *desc = &_rt_vbus_desc_avail(ring)[put & (ring->buf_nr - 1)];
+
+    desc->idx   = idx;
+    desc->len   = len;
+    desc->chnr  = chnr;
+    desc->flags = flags;
+
+    /* the data and descriptor should be seen before the index */
+    rt_vbus_desc_wmb();
+    ring->prod.avail_put = put + 1;
+}
+
+/** Pop a descriptor posted, called by consumer.
+ *
+ * @return 0 on success, -1 if the ring is empty.
+ */
+static inline int rt_vbus_desc_pop(struct rt_vbus_desc_ring *ring, struct rt_vbus_desc *desc)
+{
+    unsigned int get = ring->cons.avail_get;
+
+    if (get == ring->prod.avail_put)
+        return -1;
+
+    rt_vbus_desc_rmb();
+    *desc = _rt_vbus_desc_avail(ring)[get & (ring->buf_nr - 1)];
+    ring->cons.avail_get = get + 1;
+
+    return 0;
+}
+
+/** Give the buffer @idx back to the producer, called by consumer.
+ *
+ * The buffers could be released in any order.
+ */
+static inline void rt_vbus_desc_release(struct rt_vbus_desc_ring *ring, unsigned int idx)
+{
+    unsigned int put = ring->cons.free_put;
+
+    _rt_vbus_desc_free(ring)[put & (ring->buf_nr - 1)] = idx;
+    rt_vbus_desc_wmb();
+    ring->cons.free_put = put + 1;
+}
+
+/** Get the free running position after the last buffer released, called by
+ * producer.
+ *
+ * The free entries are kept until the producer allocates them, so the buffers
+ * released since a position not allocated yet could be found by
+ * rt_vbus_desc_released, up to the position returned.
+ */
+static inline unsigned int rt_vbus_desc_released_end(struct rt_vbus_desc_ring *ring)
+{
+    unsigned int end = ring->cons.free_put;
+
+    /* the entries should be read after the index */
+    rt_vbus_desc_rmb();
+    return end;
+}
+
+/** Get the buffer released at the free running position @pos. */
+static inline unsigned int rt_vbus_desc_released(struct rt_vbus_desc_ring *ring, unsigned int pos)
+{
+    return _rt_vbus_desc_free(ring)[pos & (ring->buf_nr - 1)];
+}
+
+/** Get the number of descriptors to be popped. */
+static inline unsigned int rt_vbus_desc_pending(struct rt_vbus_desc_ring *ring)
+{
+    return ring->prod.avail_put - ring->cons.avail_get;
+}
+
+/** Get the number of buffers could be allocated. */
+static inline unsigned int rt_vbus_desc_free_nr(struct rt_vbus_desc_ring *ring)
+{
+    return ring->cons.free_put - ring->prod.free_get;
+}
+
+/* The side going to sleep sets the waiting flag and checks the ring again, the
+ * other side only notifies it when the flag is set. So the notification is
+ * suppressed while the peer is busy on the ring. The flag is cleared by the
+ * side set it, when there is no one waiting on that side any more. */
+
+/** Mark the consumer waiting.
+ *
+ * @return non-zero if the ring is still empty and the consumer could sleep.
+ */
+static inline int rt_vbus_desc_cons_wait(struct rt_vbus_desc_ring *ring)
+{
+    ring->cons.waiting = 1;
+    rt_vbus_desc_mb();
+    return rt_vbus_desc_pending(ring) == 0;
+}
+
+static inline void rt_vbus_desc_cons_wake(struct rt_vbus_desc_ring *ring)
+{
+    ring->cons.waiting = 0;
+}
+
+/** Whether the consumer should be notified for the descriptors posted. */
+static inline int rt_vbus_desc_cons_need_notify(struct rt_vbus_desc_ring *ring)
+{
+    rt_vbus_desc_mb();
+    return ring->cons.waiting != 0;
+}
+
+/** Mark the producer waiting.
+ *
+ * @return non-zero if there is still no free buffer and the producer could
+ * sleep.
+ */
+static inline int rt_vbus_desc_prod_wait(struct rt_vbus_desc_ring *ring)
+{
+    ring->prod.waiting = 1;
+    rt_vbus_desc_mb();
+    return rt_vbus_desc_free_nr(ring) == 0;
+}
+
+static inline void rt_vbus_desc_prod_wake(struct rt_vbus_desc_ring *ring)
+{
+    ring->prod.waiting = 0;
+}
+
+/** Whether the producer should be notified for the buffers released. */
+static inline int rt_vbus_desc_prod_need_notify(struct rt_vbus_desc_ring *ring)
+{
+    rt_vbus_desc_mb();
+    return ring->prod.waiting != 0;
+}
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* end of include guard: __VBUS_DESC_H__ */
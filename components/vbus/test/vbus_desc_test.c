@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+/* Host test of the descriptor rings in share_hdr/vbus_desc.h.
+ *
+ * Two Linux processes stand for the two sides of VBus. The rings are in the
+ * memory shared by mmap, and the doorbells are pipes. The parent posts the
+ * packets on ring "down", the child echoes them back on ring "up" and the
+ * parent checks what comes back. The rings are kept small so both sides have
+ * to wait for each other, which exercises the notification suppression.
+ *
+ * Build and run it by "make test" in this directory.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "vbus_desc.h"
+
+#define BUF_NR      8
+#define BUF_SZ      200
+#define PKG_NR      100000
+#define CHN_NR      32
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            fprintf(stderr, "%d: %s:%d: %s failed\n", (int)getpid(),        \
+                    __FILE__, __LINE__, #cond);                             \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+struct side
+{
+    struct rt_vbus_desc_ring *tx, *rx;
+    int bell_in;    /* notified by the other side */
+    int bell_out;   /* notify the other side */
+    unsigned int kicks, kicks_saved;
+};
+
+static void _kick(struct side *side)
+{
+    char c = 0;
+
+    /* The pipe full means the other side has not read the last one yet. */
+    if (write(side->bell_out, &c, 1) < 0)
+        CHECK(errno == EAGAIN);
+    side->kicks++;
+}
+
+static void _wait_bell(struct side *side)
+{
+    char c[16];
+
+    CHECK(read(side->bell_in, c, sizeof(c)) > 0);
+}
+
+static void _post(struct side *side, int idx, unsigned int len,
+                  unsigned char chnr, unsigned char flags)
+{
+    rt_vbus_desc_post(side->tx, (unsigned int)idx, len, chnr, flags);
+    if (rt_vbus_desc_cons_need_notify(side->tx))
+        _kick(side);
+    else
+        side->kicks_saved++;
+}
+
+static void _release(struct side *side, unsigned int idx)
+{
+    rt_vbus_desc_release(side->rx, idx);
+    if (rt_vbus_desc_prod_need_notify(side->rx))
+        _kick(side);
+    else
+        side->kicks_saved++;
+}
+
+static unsigned int _pkg_len(unsigned int seq)
+{
+    return seq % BUF_SZ + 1;
+}
+
+static void _pkg_fill(unsigned char *buf, unsigned int seq)
+{
+    unsigned int i;
+
+    for (i = 0; i < _pkg_len(seq); i++)
+        buf[i] = (unsigned char)(seq * 7 + i);
+}
+
+static int _pkg_check(const unsigned char *buf, unsigned int seq)
+{
+    unsigned int i;
+
+    for (i = 0; i < _pkg_len(seq); i++)
+    {
+        if (buf[i] != (unsigned char)(seq * 7 + i))
+            return 0;
+    }
+    return 1;
+}
+
+/* Echo the packets from rx to tx. */
+static void _run_echo(struct side *side)
+{
+    struct rt_vbus_desc desc;
+    int held = 0;
+    unsigned int nr = 0;
+
+    while (nr < PKG_NR)
+    {
+        int idx;
+
+        if (!held)
+        {
+            if (rt_vbus_desc_pop(side->rx, &desc) == 0)
+            {
+                rt_vbus_desc_cons_wake(side->rx);
+                CHECK(desc.idx < BUF_NR);
+                held = 1;
+            }
+            else if (rt_vbus_desc_cons_wait(side->rx))
+            {
+                _wait_bell(side);
+            }
+            continue;
+        }
+
+        idx = rt_vbus_desc_alloc(side->tx);
+        if (idx < 0)
+        {
+            if (rt_vbus_desc_prod_wait(side->tx))
+                _wait_bell(side);
+            continue;
+        }
+        rt_vbus_desc_prod_wake(side->tx);
+
+        CHECK(desc.len <= side->rx->buf_sz);
+        memcpy(rt_vbus_desc_buf(side->tx, (unsigned int)idx),
+               rt_vbus_desc_buf(side->rx, desc.idx), desc.len);
+        _post(side, idx, desc.len, desc.chnr, desc.flags);
+        _release(side, desc.idx);
+        held = 0;
+        nr++;
+    }
+
+    printf("echo:   kicks %u, saved %u\n", side->kicks, side->kicks_saved);
+}
+
+/* Post the packets to tx and check the echoes from rx. */
+static void _run_post(struct side *side)
+{
+    struct rt_vbus_desc desc;
+    unsigned int sent = 0, recvd = 0;
+
+    while (recvd < PKG_NR)
+    {
+        int progress = 0;
+
+        if (sent < PKG_NR)
+        {
+            int idx = rt_vbus_desc_alloc(side->tx);
+
+            if (idx >= 0)
+            {
+                _pkg_fill(rt_vbus_desc_buf(side->tx, (unsigned int)idx), sent);
+                _post(side, idx, _pkg_len(sent), (unsigned char)(sent % CHN_NR),
+                      sent & 1 ? RT_VBUS_DESC_F_MORE : 0);
+                sent++;
+                progress = 1;
+            }
+        }
+
+        if (rt_vbus_desc_pop(side->rx, &desc) == 0)
+        {
+            CHECK(desc.idx < BUF_NR);
+            CHECK(desc.len == _pkg_len(recvd));
+            CHECK(desc.chnr == recvd % CHN_NR);
+            CHECK(desc.flags == (recvd & 1 ? RT_VBUS_DESC_F_MORE : 0));
+            CHECK(_pkg_check(rt_vbus_desc_buf(side->rx, desc.idx), recvd));
+            _release(side, desc.idx);
+            recvd++;
+            progress = 1;
+        }
+
+        if (progress)
+            continue;
+
+        /* Nothing to do, sleep if both rings are still blocked after marked
+         * waiting. */
+        if ((sent == PKG_NR || rt_vbus_desc_prod_wait(side->tx)) &&
+            rt_vbus_desc_cons_wait(side->rx))
+        {
+            _wait_bell(side);
+        }
+        rt_vbus_desc_prod_wake(side->tx);
+        rt_vbus_desc_cons_wake(side->rx);
+    }
+
+    CHECK(rt_vbus_desc_pending(side->rx) == 0);
+    printf("post:   kicks %u, saved %u\n", side->kicks, side->kicks_saved);
+}
+
+static void _test_format(void)
+{
+    static char mem[4096] __attribute__((aligned(RT_VBUS_DESC_ALIGN)));
+    struct rt_vbus_desc_ring *ring;
+    unsigned int i;
+
+    CHECK(rt_vbus_desc_ring_format(mem, 0, 64) == NULL);
+    CHECK(rt_vbus_desc_ring_format(mem, 6, 64) == NULL);
+
+    CHECK(rt_vbus_desc_ring_size(4, 100) <= sizeof(mem));
+    ring = rt_vbus_desc_ring_format(mem, 4, 100);
+    CHECK(ring != NULL);
+    CHECK(ring->magic == RT_VBUS_DESC_MAGIC);
+    CHECK(ring->buf_sz == 128);
+    CHECK(rt_vbus_desc_free_nr(ring) == 4);
+    CHECK(rt_vbus_desc_pending(ring) == 0);
+    for (i = 0; i < 4; i++)
+    {
+        char *buf = rt_vbus_desc_buf(ring, i);
+
+        CHECK(((size_t)buf & (RT_VBUS_DESC_ALIGN - 1)) == 0);
+        CHECK(buf + ring->buf_sz <= (char *)ring + rt_vbus_desc_ring_size(4, 100));
+    }
+
+    /* the released entries stay until allocated */
+    CHECK(rt_vbus_desc_alloc(ring) == 0);
+    CHECK(rt_vbus_desc_alloc(ring) == 1);
+    rt_vbus_desc_release(ring, 1);
+    CHECK(rt_vbus_desc_released_end(ring) == 5);
+    CHECK(rt_vbus_desc_released(ring, 4) == 1);
+}
+
+int main(void)
+{
+    size_t ring_sz = rt_vbus_desc_ring_size(BUF_NR, BUF_SZ);
+    int down[2], up[2];
+    char *mem;
+    pid_t pid;
+    int status;
+    struct side side;
+
+    _test_format();
+
+    mem = mmap(NULL, ring_sz * 2, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK(mem != MAP_FAILED);
+    CHECK(rt_vbus_desc_ring_format(mem, BUF_NR, BUF_SZ) != NULL);
+    CHECK(rt_vbus_desc_ring_format(mem + ring_sz, BUF_NR, BUF_SZ) != NULL);
+
+    CHECK(pipe2(down, O_NONBLOCK) == 0);
+    CHECK(pipe2(up, O_NONBLOCK) == 0);
+    /* only the write end is non-blocking */
+    CHECK(fcntl(down[0], F_SETFL, 0) == 0);
+    CHECK(fcntl(up[0], F_SETFL, 0) == 0);
+
+    /* the test should not hang on a lost notification */
+    alarm(60);
+
+    pid = fork();
+    CHECK(pid >= 0);
+    memset(&side, 0, sizeof(side));
+    if (pid == 0)
+    {
+        side.rx = (struct rt_vbus_desc_ring *)mem;
+        side.tx = (struct rt_vbus_desc_ring *)(mem + ring_sz);
+        side.bell_in  = down[0];
+        side.bell_out = up[1];
+        _run_echo(&side);
+        return 0;
+    }
+
+    side.tx = (struct rt_vbus_desc_ring *)mem;
+    side.rx = (struct rt_vbus_desc_ring *)(mem + ring_sz);
+    side.bell_in  = up[0];
+    side.bell_out = down[1];
+    _run_post(&side);
+
+    CHECK(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    printf("%d packages echoed\n", PKG_NR);
+    return 0;
+}
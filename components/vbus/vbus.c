@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-11-04     Grissiom     add comment
+ * 2026-10-19     agent        batch the doorbell, add channel statistics and
+ *                             adaptive post water mark
+ * 2026-10-19     agent        lock the state of adaptive post water mark
  */
 
 #include <rthw.h>
@@ -21,6 +24,12 @@
 #define RT_VBUS_RB_LOW_TICK   (RT_VMM_RB_BLK_NR * 2 / 3)
 #define RT_VBUS_RB_TICK_STEP  (100)
 
+/* The number of packages written into ring before notify the guest, the guest
+ * is notified anyway when the out queue is drained. */
+#ifndef RT_VBUS_DOORBELL_BATCH
+#define RT_VBUS_DOORBELL_BATCH  8
+#endif
+
 /* console could be run on vbus. If we log on it, there will be oops. */
 #define vbus_debug(...)
 #define vbus_verbose(...)
@@ -104,8 +113,33 @@ struct rt_vbus_pkg {
     rt_uint8_t finished;
     rt_uint8_t len;
     const void *data;
+    rt_tick_t tick;
 };
 
+static struct rt_vbus_chn_stat _chn_stat[RT_VBUS_CHANNEL_NR];
+
+void rt_vbus_get_chn_stat(unsigned char chnr, struct rt_vbus_chn_stat *stat)
+{
+    rt_ubase_t lvl;
+
+    RT_ASSERT(chnr < RT_VBUS_CHANNEL_NR);
+
+    lvl = rt_hw_interrupt_disable();
+    *stat = _chn_stat[chnr];
+    rt_hw_interrupt_enable(lvl);
+}
+
+void rt_vbus_reset_chn_stat(unsigned char chnr)
+{
+    rt_ubase_t lvl;
+
+    RT_ASSERT(chnr < RT_VBUS_CHANNEL_NR);
+
+    lvl = rt_hw_interrupt_disable();
+    rt_memset(&_chn_stat[chnr], 0, sizeof(_chn_stat[chnr]));
+    rt_hw_interrupt_enable(lvl);
+}
+
 /* chn0 is always connected */
 static enum rt_vbus_chn_status _chn_status[RT_VBUS_CHANNEL_NR];
 
@@ -124,6 +158,73 @@ void rt_vbus_set_post_wm(unsigned char chnr, unsigned int low, unsigned int high
     rt_wm_que_set_mark(&_chn_wm_que[chnr], low, high);
 }
 
+/* The high mark follows the packages drained in a window, so the queue holds
+ * about one window of data. The slow channel keeps a short queue for latency
+ * and the busy one gets a deep queue for throughput. */
+#define _POST_WM_WINDOW  (RT_TICK_PER_SECOND / 10 > 0 ? RT_TICK_PER_SECOND / 10 : 1)
+
+/* Protected by interrupt lock, it's updated by the out thread and the
+ * setter. */
+static struct
+{
+    unsigned int min, max;
+    unsigned int drained;
+    rt_tick_t start;
+} _chn_post_wm_adapt[RT_VBUS_CHANNEL_NR];
+
+void rt_vbus_set_post_wm_adaptive(unsigned char chnr, unsigned int min, unsigned int max)
+{
+    rt_base_t level;
+
+    RT_ASSERT((0 < chnr) && (chnr < ARRAY_SIZE(_chn_post_wm_adapt)));
+    RT_ASSERT(min <= max);
+
+    level = rt_hw_interrupt_disable();
+    _chn_post_wm_adapt[chnr].min = min;
+    _chn_post_wm_adapt[chnr].max = max;
+    _chn_post_wm_adapt[chnr].drained = 0;
+    _chn_post_wm_adapt[chnr].start = rt_tick_get();
+    if (max != 0)
+        rt_wm_que_set_mark(&_chn_wm_que[chnr], min / 2, min);
+    rt_hw_interrupt_enable(level);
+}
+
+/* Called in the out thread on the package of @chnr drained. */
+static void _post_wm_adapt(unsigned char chnr)
+{
+    rt_tick_t elapsed;
+    unsigned int high;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (_chn_post_wm_adapt[chnr].max == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    _chn_post_wm_adapt[chnr].drained++;
+    elapsed = rt_tick_get() - _chn_post_wm_adapt[chnr].start;
+    if (elapsed < _POST_WM_WINDOW)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    high = _chn_post_wm_adapt[chnr].drained * _POST_WM_WINDOW / elapsed;
+    if (high < _chn_post_wm_adapt[chnr].min)
+        high = _chn_post_wm_adapt[chnr].min;
+    if (high > _chn_post_wm_adapt[chnr].max)
+        high = _chn_post_wm_adapt[chnr].max;
+
+    rt_wm_que_set_mark(&_chn_wm_que[chnr], high / 2, high);
+    _chn_stat[chnr].post_wm = high;
+
+    _chn_post_wm_adapt[chnr].drained = 0;
+    _chn_post_wm_adapt[chnr].start += elapsed;
+    rt_hw_interrupt_enable(level);
+}
+
 /* Threads suspended by the flow control of other side. */
 rt_list_t _chn_suspended_threads[RT_VBUS_CHANNEL_NR];
 
@@ -150,6 +251,8 @@ void rt_vbus_set_recv_wm(unsigned char chnr, unsigned int low, unsigned int high
 {}
 void rt_vbus_set_post_wm(unsigned char chnr, unsigned int low, unsigned int high)
 {}
+void rt_vbus_set_post_wm_adaptive(unsigned char chnr, unsigned int min, unsigned int max)
+{}
 #endif
 
 struct {
@@ -188,6 +291,7 @@ struct rt_prio_queue *_bus_out_que;
 static void _bus_out_entry(void *param)
 {
     struct rt_vbus_pkg dpkg;
+    int batched = 0;
 
     _bus_out_que = rt_prio_queue_create("vbus",
                                         _BUS_OUT_PKG_NR,
@@ -199,15 +303,31 @@ static void _bus_out_entry(void *param)
         return;
     }
 
-    while (rt_prio_queue_pop(_bus_out_que, &dpkg,
-                             RT_WAITING_FOREVER) == RT_EOK)
+    while (1)
     {
         int sp;
         rt_uint32_t nxtidx;
-        const int dnr = LEN2BNR(dpkg.len);
+        int dnr;
+
+        if (rt_prio_queue_pop(_bus_out_que, &dpkg, 0) != RT_EOK)
+        {
+            /* The queue is drained, notify the guest once for the batch. */
+            if (batched)
+            {
+                rt_vbus_smp_wmb();
+                rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+                batched = 0;
+            }
+
+            if (rt_prio_queue_pop(_bus_out_que, &dpkg,
+                                  RT_WAITING_FOREVER) != RT_EOK)
+                break;
+        }
+        dnr = LEN2BNR(dpkg.len);
 
 #ifdef RT_VBUS_USING_FLOW_CONTROL
         rt_wm_que_dec(&_chn_wm_que[dpkg.id]);
+        _post_wm_adapt(dpkg.id);
 #endif
 
         if (!_chn_connected(dpkg.id))
@@ -275,8 +395,20 @@ static void _bus_out_entry(void *param)
             RT_VBUS_OUT_RING->put_idx = nxtidx;
         }
 
-        rt_vbus_smp_wmb();
-        rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+        dpkg.tick = rt_tick_get() - dpkg.tick;
+        _chn_stat[dpkg.id].tx_pkgs++;
+        _chn_stat[dpkg.id].tx_bytes += dpkg.len;
+        _chn_stat[dpkg.id].tx_latency_sum += dpkg.tick;
+        if (dpkg.tick > _chn_stat[dpkg.id].tx_latency_max)
+            _chn_stat[dpkg.id].tx_latency_max = dpkg.tick;
+
+        /* Don't keep the guest waiting for more than a batch on the burst. */
+        if (++batched >= RT_VBUS_DOORBELL_BATCH)
+        {
+            rt_vbus_smp_wmb();
+            rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+            batched = 0;
+        }
 
         if (dpkg.finished)
         {
@@ -358,6 +490,7 @@ rt_err_t rt_vbus_post(rt_uint8_t id,
     dp       = data;
     pkg.id   = id;
     pkg.prio = prio;
+    pkg.tick = rt_tick_get();
     for (putsz = 0; size; size -= putsz)
     {
         pkg.data = dp;
@@ -1062,6 +1195,8 @@ static void _bus_in_entry(void *param)
 #ifdef RT_VBUS_STATISTICS
             _total_data_sz += size;
 #endif
+            _chn_stat[id].rx_pkgs++;
+            _chn_stat[id].rx_bytes += size;
 
             act = rt_malloc(sizeof(*act) + size);
             if (act == RT_NULL)
@@ -1263,6 +1398,26 @@ unsigned int rt_vbus_total_data_sz(void)
 #endif
 }
 
+void rt_vbus_chn_stat_dump(void)
+{
+    int i;
+
+    rt_kprintf("chn  tx pkgs    tx bytes   rx pkgs    rx bytes   lat avg lat max  post wm\n");
+    for (i = 0; i < ARRAY_SIZE(_chn_stat); i++)
+    {
+        struct rt_vbus_chn_stat stat;
+
+        if (!_chn_connected(i))
+            continue;
+
+        rt_vbus_get_chn_stat(i, &stat);
+        rt_kprintf("%2d %10u %10u %10u %10u %8u %8u %8u\n", i,
+                   stat.tx_pkgs, stat.tx_bytes, stat.rx_pkgs, stat.rx_bytes,
+                   stat.tx_pkgs ? stat.tx_latency_sum / stat.tx_pkgs : 0,
+                   stat.tx_latency_max, stat.post_wm);
+    }
+}
+
 void rt_vbus_data_pkt_dump(void)
 {
     int i;
@@ -1314,6 +1469,7 @@ FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_sess_dump, vbses, dump vbus session status);
 FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_que_dump,  vbque, dump vbus out queue status);
 FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_total_data_sz,  vbtsz, total in data);
 FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_data_pkt_dump,  vbdq, dump the data queue);
+FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_chn_stat_dump,  vbstat, dump vbus channel statistics);
 #ifdef RT_VBUS_USING_FLOW_CONTROL
 FINSH_FUNCTION_EXPORT_ALIAS(rt_vbus_chm_wm_dump, vbwm, dump vbus water mark status);
 #endif
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2014-06-09     Grissiom     version 2.0.2; add comment
  * 2015-01-06     Grissiom     version 2.0.3; API change, no functional changes
+ * 2026-10-19     agent        add channel statistics and adaptive water mark
  */
 #ifndef __VBUS_H__
 #define __VBUS_H__
@@ -74,6 +75,122 @@ void rt_vbus_close_chn(unsigned char chnr);
 void rt_vbus_set_post_wm(unsigned char chnr, unsigned int low, unsigned int high);
 /** Set the water mark level for receiving from the channel @chnr. */
 void rt_vbus_set_recv_wm(unsigned char chnr, unsigned int low, unsigned int high);
+/** Adapt the post water mark of channel @chnr to the throughput.
+ *
+ * The high mark is set to the number of packages drained in a window of 100ms,
+ * bounded by @min and @max, and the low mark is the half of it. The @max of 0
+ * disables the adaption, and the water mark is kept as it is.
+ */
+void rt_vbus_set_post_wm_adaptive(unsigned char chnr, unsigned int min, unsigned int max);
+
+struct rt_vbus_chn_stat {
+    unsigned int tx_pkgs, tx_bytes;
+    unsigned int rx_pkgs, rx_bytes;
+    /* Ticks from rt_vbus_post to the data written into ring. */
+    unsigned int tx_latency_max, tx_latency_sum;
+    /* The high post water mark adapted. */
+    unsigned int post_wm;
+};
+
+/** Get the statistics of channel @chnr. */
+void rt_vbus_get_chn_stat(unsigned char chnr, struct rt_vbus_chn_stat *stat);
+/** Reset the statistics of channel @chnr. */
+void rt_vbus_reset_chn_stat(unsigned char chnr);
+
+#ifdef RT_VBUS_USING_DESC
+struct rt_vbus_desc_ring;
+struct rt_vbus_desc;
+
+/* The port of descriptor rings, the data is shared in place instead of copied
+ * into the block ring. See share_hdr/vbus_desc.h for the layout. */
+struct rt_vbus_desc_port {
+    struct rt_vbus_desc_ring *tx, *rx;
+
+    /* Notify the other side, it's called in thread context. */
+    void (*kick)(struct rt_vbus_desc_port *port);
+    void *user_data;
+
+    /* The number of descriptors posted before notify the other side. */
+    unsigned int kick_batch;
+    unsigned int pending;
+
+    struct rt_mutex tx_lock, rx_lock;
+    struct rt_semaphore tx_sem, rx_sem;
+    unsigned int tx_waiting, rx_waiting;
+
+    /* The tick and channel of buffers posted, indexed by buffer. */
+    rt_tick_t *post_tick;
+    unsigned char *post_chnr;
+    /* The position of free ring sampled for the latency. */
+    unsigned int tx_reaped;
+
+    struct {
+        /* The notifications for the descriptors posted. */
+        unsigned int kicks;
+        /* The notifications for the buffers released. */
+        unsigned int release_kicks;
+        /* The notifications saved as the other side is busy on the ring. */
+        unsigned int kicks_saved;
+        /* The times waited for the buffer released by the other side. */
+        unsigned int alloc_waits;
+    } stat;
+    struct rt_vbus_chn_stat chn_stat[RT_VBUS_CHANNEL_NR];
+};
+
+/** Init the port on the rings formatted by rt_vbus_desc_ring_format.
+ *
+ * @param tx the ring to the other side.
+ * @param rx the ring from the other side.
+ * @param kick the function to notify the other side.
+ * @param kick_batch the number of descriptors posted before notify, the rest
+ * are notified by rt_vbus_desc_port_flush.
+ *
+ * @return -RT_ERROR if the rings are not formatted, -RT_ENOMEM on no memory.
+ */
+rt_err_t rt_vbus_desc_port_init(struct rt_vbus_desc_port *port,
+                                void *tx, void *rx,
+                                void (*kick)(struct rt_vbus_desc_port *port),
+                                unsigned int kick_batch);
+void rt_vbus_desc_port_detach(struct rt_vbus_desc_port *port);
+
+/** Allocate a buffer of tx ring to be filled in place.
+ *
+ * @return the buffer, or RT_NULL on timeout.
+ */
+void *rt_vbus_desc_port_alloc(struct rt_vbus_desc_port *port, rt_int32_t timeout);
+/** Get the size of buffer allocated. */
+rt_size_t rt_vbus_desc_port_buf_sz(struct rt_vbus_desc_port *port);
+/** Post the buffer allocated with @len bytes on channel @chnr.
+ *
+ * The buffer is owned by the other side after posted, it comes back to
+ * rt_vbus_desc_port_alloc when the other side released it.
+ */
+void rt_vbus_desc_port_post(struct rt_vbus_desc_port *port, void *buf,
+                            rt_size_t len, unsigned char chnr, unsigned char flags);
+/** Notify the other side for the descriptors posted less than the batch. */
+void rt_vbus_desc_port_flush(struct rt_vbus_desc_port *port);
+
+/** Receive a descriptor from the other side.
+ *
+ * @return the buffer of descriptor @desc, or RT_NULL on timeout. The buffer
+ * should be released by rt_vbus_desc_port_release after used.
+ */
+void *rt_vbus_desc_port_recv(struct rt_vbus_desc_port *port,
+                             struct rt_vbus_desc *desc, rt_int32_t timeout);
+void rt_vbus_desc_port_release(struct rt_vbus_desc_port *port, void *buf);
+
+/** Should be called by BSP on the port notified by the other side. */
+void rt_vbus_desc_port_isr(struct rt_vbus_desc_port *port);
+
+/** Get the statistics of channel @chnr on port.
+ *
+ * The tx latency is the ticks from the buffer posted to it released by the
+ * other side. The release is sampled on the notification from the other side,
+ * or on the next allocation if the notification is saved.
+ */
+void rt_vbus_desc_port_get_chn_stat(struct rt_vbus_desc_port *port,
+                                    unsigned char chnr, struct rt_vbus_chn_stat *stat);
+#endif
 
 typedef void (*rt_vbus_event_listener)(void *ctx);
 
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "vbus.h"
+#include "vbus_hw.h"
+
+#ifdef RT_VBUS_USING_DESC
+
+#define rt_vbus_desc_wmb()  rt_vbus_smp_wmb()
+#define rt_vbus_desc_rmb()  rt_vbus_smp_rmb()
+#include "vbus_desc.h"
+
+#define _NO_CHNR  0xFF
+
+rt_err_t rt_vbus_desc_port_init(struct rt_vbus_desc_port *port,
+                                void *tx, void *rx,
+                                void (*kick)(struct rt_vbus_desc_port *port),
+                                unsigned int kick_batch)
+{
+    struct rt_vbus_desc_ring *txr = tx, *rxr = rx;
+
+    RT_ASSERT(port);
+    RT_ASSERT(kick);
+
+    if (txr->magic != RT_VBUS_DESC_MAGIC || rxr->magic != RT_VBUS_DESC_MAGIC)
+        return -RT_ERROR;
+    rt_vbus_smp_rmb();
+
+    rt_memset(port, 0, sizeof(*port));
+    port->post_tick = rt_malloc(txr->buf_nr * sizeof(rt_tick_t));
+    port->post_chnr = rt_malloc(txr->buf_nr);
+    if (port->post_tick == RT_NULL || port->post_chnr == RT_NULL)
+    {
+        rt_free(port->post_tick);
+        rt_free(port->post_chnr);
+        return -RT_ENOMEM;
+    }
+    rt_memset(port->post_chnr, _NO_CHNR, txr->buf_nr);
+
+    port->tx = txr;
+    port->rx = rxr;
+    port->tx_reaped = txr->prod.free_get;
+    port->kick = kick;
+    port->kick_batch = kick_batch ? kick_batch : 1;
+
+    rt_mutex_init(&port->tx_lock, "vdtx", RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&port->rx_lock, "vdrx", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&port->tx_sem, "vdtx", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&port->rx_sem, "vdrx", 0, RT_IPC_FLAG_FIFO);
+
+    return RT_EOK;
+}
+
+void rt_vbus_desc_port_detach(struct rt_vbus_desc_port *port)
+{
+    RT_ASSERT(port);
+
+    rt_sem_detach(&port->rx_sem);
+    rt_sem_detach(&port->tx_sem);
+    rt_mutex_detach(&port->rx_lock);
+    rt_mutex_detach(&port->tx_lock);
+    rt_free(port->post_chnr);
+    rt_free(port->post_tick);
+}
+
+/* Notify the other side only if it's waiting on the ring. Called with the
+ * tx_lock held. */
+static void _port_kick_tx(struct rt_vbus_desc_port *port)
+{
+    port->pending = 0;
+    if (rt_vbus_desc_cons_need_notify(port->tx))
+    {
+        port->stat.kicks++;
+        port->kick(port);
+    }
+    else
+    {
+        port->stat.kicks_saved++;
+    }
+}
+
+/* Sample the latency of the buffers released by the other side since the last
+ * time. The free entries are overwritten once allocated, so it should be
+ * called before allocation, besides on the notification from the other
+ * side. */
+static void _port_reap_tx(struct rt_vbus_desc_port *port)
+{
+    rt_base_t level;
+    rt_tick_t now = rt_tick_get();
+    unsigned int end;
+
+    level = rt_hw_interrupt_disable();
+    end = rt_vbus_desc_released_end(port->tx);
+    for (; port->tx_reaped != end; port->tx_reaped++)
+    {
+        unsigned int idx = rt_vbus_desc_released(port->tx, port->tx_reaped);
+        unsigned char chnr;
+        rt_tick_t lat;
+
+        RT_ASSERT(idx < port->tx->buf_nr);
+        chnr = port->post_chnr[idx];
+        if (chnr == _NO_CHNR)
+            continue;
+
+        lat = now - port->post_tick[idx];
+        port->chn_stat[chnr].tx_latency_sum += lat;
+        if (lat > port->chn_stat[chnr].tx_latency_max)
+            port->chn_stat[chnr].tx_latency_max = lat;
+        port->post_chnr[idx] = _NO_CHNR;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+void *rt_vbus_desc_port_alloc(struct rt_vbus_desc_port *port, rt_int32_t timeout)
+{
+    int idx;
+
+    RT_ASSERT(port);
+
+    rt_mutex_take(&port->tx_lock, RT_WAITING_FOREVER);
+    while (1)
+    {
+        rt_err_t err;
+
+        _port_reap_tx(port);
+        idx = rt_vbus_desc_alloc(port->tx);
+        if (idx >= 0 || timeout == 0)
+            break;
+
+        if (!rt_vbus_desc_prod_wait(port->tx))
+            continue;
+
+        /* The other side would wait for the descriptors we posted. */
+        if (port->pending)
+            _port_kick_tx(port);
+
+        port->tx_waiting++;
+        port->stat.alloc_waits++;
+        rt_mutex_release(&port->tx_lock);
+
+        /* All the waiting threads are resumed with -RT_ERROR by the reset in
+         * rt_vbus_desc_port_isr. */
+        err = rt_sem_take(&port->tx_sem, timeout);
+
+        rt_mutex_take(&port->tx_lock, RT_WAITING_FOREVER);
+        port->tx_waiting--;
+        if (err == -RT_ETIMEOUT)
+            break;
+    }
+    if (port->tx_waiting == 0)
+        rt_vbus_desc_prod_wake(port->tx);
+
+    rt_mutex_release(&port->tx_lock);
+
+    if (idx < 0)
+        return RT_NULL;
+    return rt_vbus_desc_buf(port->tx, idx);
+}
+
+rt_size_t rt_vbus_desc_port_buf_sz(struct rt_vbus_desc_port *port)
+{
+    RT_ASSERT(port);
+
+    return port->tx->buf_sz;
+}
+
+void rt_vbus_desc_port_post(struct rt_vbus_desc_port *port, void *buf,
+                            rt_size_t len, unsigned char chnr, unsigned char flags)
+{
+    unsigned int idx;
+
+    RT_ASSERT(port);
+    RT_ASSERT(chnr < RT_VBUS_CHANNEL_NR);
+    RT_ASSERT(len <= port->tx->buf_sz);
+
+    idx = ((char *)buf - (char *)rt_vbus_desc_buf(port->tx, 0)) / port->tx->buf_sz;
+    RT_ASSERT(idx < port->tx->buf_nr);
+
+    rt_mutex_take(&port->tx_lock, RT_WAITING_FOREVER);
+    /* It could be released by the other side as soon as posted. */
+    port->post_tick[idx] = rt_tick_get();
+    port->post_chnr[idx] = chnr;
+    rt_vbus_desc_post(port->tx, idx, len, chnr, flags);
+
+    port->chn_stat[chnr].tx_pkgs++;
+    port->chn_stat[chnr].tx_bytes += len;
+
+    if (++port->pending >= port->kick_batch)
+        _port_kick_tx(port);
+    rt_mutex_release(&port->tx_lock);
+}
+
+void rt_vbus_desc_port_flush(struct rt_vbus_desc_port *port)
+{
+    RT_ASSERT(port);
+
+    rt_mutex_take(&port->tx_lock, RT_WAITING_FOREVER);
+    if (port->pending)
+        _port_kick_tx(port);
+    rt_mutex_release(&port->tx_lock);
+}
+
+void *rt_vbus_desc_port_recv(struct rt_vbus_desc_port *port,
+                             struct rt_vbus_desc *desc, rt_int32_t timeout)
+{
+    int res;
+
+    RT_ASSERT(port);
+    RT_ASSERT(desc);
+
+    rt_mutex_take(&port->rx_lock, RT_WAITING_FOREVER);
+    while ((res = rt_vbus_desc_pop(port->rx, desc)) < 0)
+    {
+        rt_err_t err;
+
+        if (timeout == 0)
+            break;
+
+        if (!rt_vbus_desc_cons_wait(port->rx))
+            continue;
+
+        port->rx_waiting++;
+        rt_mutex_release(&port->rx_lock);
+
+        err = rt_sem_take(&port->rx_sem, timeout);
+
+        rt_mutex_take(&port->rx_lock, RT_WAITING_FOREVER);
+        port->rx_waiting--;
+        if (err == -RT_ETIMEOUT)
+            break;
+    }
+    if (port->rx_waiting == 0)
+        rt_vbus_desc_cons_wake(port->rx);
+
+    if (res < 0)
+    {
+        rt_mutex_release(&port->rx_lock);
+        return RT_NULL;
+    }
+
+    RT_ASSERT(desc->idx < port->rx->buf_nr);
+    if (desc->chnr < RT_VBUS_CHANNEL_NR)
+    {
+        port->chn_stat[desc->chnr].rx_pkgs++;
+        port->chn_stat[desc->chnr].rx_bytes += desc->len;
+    }
+    rt_mutex_release(&port->rx_lock);
+
+    return rt_vbus_desc_buf(port->rx, desc->idx);
+}
+
+void rt_vbus_desc_port_release(struct rt_vbus_desc_port *port, void *buf)
+{
+    unsigned int idx;
+
+    RT_ASSERT(port);
+
+    idx = ((char *)buf - (char *)rt_vbus_desc_buf(port->rx, 0)) / port->rx->buf_sz;
+    RT_ASSERT(idx < port->rx->buf_nr);
+
+    rt_mutex_take(&port->rx_lock, RT_WAITING_FOREVER);
+    rt_vbus_desc_release(port->rx, idx);
+    if (rt_vbus_desc_prod_need_notify(port->rx))
+    {
+        port->stat.release_kicks++;
+        port->kick(port);
+    }
+    rt_mutex_release(&port->rx_lock);
+}
+
+void rt_vbus_desc_port_isr(struct rt_vbus_desc_port *port)
+{
+    RT_ASSERT(port);
+
+    _port_reap_tx(port);
+
+    /* Resume all the threads waiting, they check the ring again. The value of
+     * 1 is for the thread not in the semaphore yet. */
+    if (rt_vbus_desc_pending(port->rx))
+        rt_sem_control(&port->rx_sem, RT_IPC_CMD_RESET, (void *)1);
+    if (rt_vbus_desc_free_nr(port->tx))
+        rt_sem_control(&port->tx_sem, RT_IPC_CMD_RESET, (void *)1);
+}
+
+void rt_vbus_desc_port_get_chn_stat(struct rt_vbus_desc_port *port,
+                                    unsigned char chnr, struct rt_vbus_chn_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(port);
+    RT_ASSERT(chnr < RT_VBUS_CHANNEL_NR);
+
+    /* The statistics are updated with the locks held, the latency is updated
+     * in the interrupt as well. */
+    rt_mutex_take(&port->tx_lock, RT_WAITING_FOREVER);
+    rt_mutex_take(&port->rx_lock, RT_WAITING_FOREVER);
+    level = rt_hw_interrupt_disable();
+    *stat = port->chn_stat[chnr];
+    rt_hw_interrupt_enable(level);
+    rt_mutex_release(&port->rx_lock);
+    rt_mutex_release(&port->tx_lock);
+}
+
+#endif /* RT_VBUS_USING_DESC */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2014-04-16     Grissiom     first version
+ * 2026-10-19     agent        wake up the threads on the low mark raised
  */
 
 #include <rthw.h>
@@ -16,10 +17,34 @@
 void rt_wm_que_set_mark(struct rt_watermark_queue *wg,
                              unsigned int low, unsigned int high)
 {
+    int need_sched = 0;
+    rt_base_t ilvl;
+
     RT_ASSERT(low <= high);
 
+    ilvl = rt_hw_interrupt_disable();
     wg->high_mark = high;
     wg->low_mark = low;
+
+    /* The level may never drop to the new low mark, wake up the threads
+     * suspended on the old one. */
+    if (wg->level <= wg->low_mark)
+    {
+        while (!rt_list_isempty(&wg->suspended_threads))
+        {
+            rt_thread_t thread;
+
+            thread = rt_list_entry(wg->suspended_threads.next,
+                                   struct rt_thread,
+                                   tlist);
+            rt_thread_resume(thread);
+            need_sched = 1;
+        }
+    }
+    rt_hw_interrupt_enable(ilvl);
+
+    if (need_sched)
+        rt_schedule();
 }
 
 void rt_wm_que_init(struct rt_watermark_queue *wg,
@@ -10,10 +10,14 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-02-10     Bernard      first version
+ * 2026-10-19     agent        show the statistics of block cache
  */
 
 #include <rtthread.h>
 #include <dfs_posix.h>
+#ifdef RT_USING_DFS_BCACHE
+#include <dfs_bcache.h>
+#endif
 
 void readspeed(const char* filename, int block_size)
 {
@@ -38,6 +42,10 @@ void readspeed(const char* filename, int block_size)
         return;
     }
 
+#ifdef RT_USING_DFS_BCACHE
+    dfs_bcache_reset_stat();
+#endif
+
     tick = rt_tick_get();
     total_length = 0;
     while (1)
@@ -56,6 +64,10 @@ void readspeed(const char* filename, int block_size)
 
     /* calculate read speed */
     rt_kprintf("File read speed: %d byte/s\n", total_length /tick * RT_TICK_PER_SECOND);
+
+#ifdef RT_USING_DFS_BCACHE
+    dfs_bcache_dump();
+#endif
 }
 
 #ifdef RT_USING_FINSH
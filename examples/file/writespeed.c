@@ -10,9 +10,13 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-02-10     Bernard      first version
+ * 2026-10-19     agent        show the statistics of block cache
  */
 #include <rtthread.h>
 #include <dfs_posix.h>
+#ifdef RT_USING_DFS_BCACHE
+#include <dfs_bcache.h>
+#endif
 
 void writespeed(const char* filename, int total_length, int block_size)
 {
@@ -43,6 +47,10 @@ void writespeed(const char* filename, int total_length, int block_size)
 	}
 	index = 0;
 
+#ifdef RT_USING_DFS_BCACHE
+    dfs_bcache_reset_stat();
+#endif
+
 	/* get the beginning tick */
     tick = rt_tick_get();
 	while (index < total_length / block_size)
@@ -56,6 +64,10 @@ void writespeed(const char* filename, int total_length, int block_size)
 
 		index ++;
 	}
+#ifdef RT_USING_DFS_BCACHE
+    /* the delayed sectors shall be written back in the test */
+    fsync(fd);
+#endif
     tick = rt_tick_get() - tick;
 
 	/* close file and release memory */
@@ -64,6 +76,10 @@ void writespeed(const char* filename, int total_length, int block_size)
 
     /* calculate write speed */
     rt_kprintf("File write speed: %d byte/s\n", total_length / tick * RT_TICK_PER_SECOND);
+
+#ifdef RT_USING_DFS_BCACHE
+    dfs_bcache_dump();
+#endif
 }
 
 #ifdef RT_USING_FINSH
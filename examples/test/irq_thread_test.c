@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        the first version
+ */
+
+/*
+ * The testcase of irq thread: the events reaching the threshold are handled in
+ * one batch, the events less than threshold are handled after the timeout, the
+ * events posted by hard timer are coalesced, and the irq thread in slack is
+ * drained when the test thread sleeps.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_IRQ_THREAD) && defined(RT_USING_HEAP)
+
+#define IRQ_TEST_THRESHOLD  8
+#define IRQ_TEST_TIMEOUT    (RT_TICK_PER_SECOND / 10 + 1)
+#define IRQ_TEST_EVENTS     32
+#define IRQ_TEST_TIMER_THRESHOLD 5
+
+static struct rt_irq_source irq_source;
+static struct rt_timer irq_timer;
+static rt_uint32_t irq_events;
+static rt_uint32_t irq_batches;
+static rt_uint32_t irq_value;
+static volatile rt_uint32_t irq_timer_left;
+
+static void irq_test_handler(struct rt_irq_source *source, rt_uint32_t events, rt_uint32_t value)
+{
+    irq_events += events;
+    irq_batches ++;
+    irq_value = value;
+}
+
+/* post the events in interrupt context */
+static void irq_test_timer(void *parameter)
+{
+    if (irq_timer_left == 0)
+        return;
+
+    rt_irq_source_post(&irq_source, irq_timer_left);
+    if (-- irq_timer_left == 0)
+        rt_timer_stop(&irq_timer);
+}
+
+void irq_thread_test(void)
+{
+    struct rt_irq_thread *irq_thread;
+    struct rt_irq_source_stat stat;
+    rt_thread_t self = rt_thread_self();
+    rt_uint32_t events, batches, index;
+
+    /* the handlers run before the post returns */
+    if (self->current_priority == 0)
+    {
+        rt_kprintf("Test error: run the test in thread with priority larger than 0.\n");
+        return;
+    }
+    irq_thread = rt_irq_thread_create("irqtest", 1024, self->current_priority - 1);
+    if (irq_thread == RT_NULL)
+    {
+        rt_kprintf("Test error: create irq thread failed.\n");
+        return;
+    }
+    rt_irq_source_init(&irq_source, "irqtest", irq_test_handler, RT_NULL);
+    rt_irq_source_set_coalesce(&irq_source, IRQ_TEST_THRESHOLD, IRQ_TEST_TIMEOUT);
+    rt_irq_source_attach(irq_thread, &irq_source);
+    rt_timer_init(&irq_timer, "irqtest", irq_test_timer, RT_NULL, 1,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+    irq_events = 0;
+    irq_batches = 0;
+
+    rt_kprintf("\n====================== irq thread threshold test =====================\n");
+    for (index = 0; index < IRQ_TEST_EVENTS; index ++)
+        rt_irq_source_post(&irq_source, index);
+
+    rt_irq_source_get_stat(&irq_source, &stat);
+    if (irq_events != IRQ_TEST_EVENTS || irq_batches != IRQ_TEST_EVENTS / IRQ_TEST_THRESHOLD ||
+        irq_value != IRQ_TEST_EVENTS - 1 || stat.batch_max != IRQ_TEST_THRESHOLD)
+    {
+        rt_kprintf("Test error: %d events in %d batches, the max batch is %d.\n",
+                   irq_events, irq_batches, stat.batch_max);
+        goto __exit;
+    }
+    rt_kprintf("%d events in %d batches.\n", irq_events, irq_batches);
+
+    rt_kprintf("\n====================== irq thread timeout test =====================\n");
+    for (index = 0; index < IRQ_TEST_THRESHOLD - 1; index ++)
+        rt_irq_source_post(&irq_source, index);
+    if (irq_events != IRQ_TEST_EVENTS)
+    {
+        rt_kprintf("Test error: the events less than threshold are handled at once.\n");
+        goto __exit;
+    }
+
+    rt_thread_delay(IRQ_TEST_TIMEOUT * 2);
+    rt_irq_source_get_stat(&irq_source, &stat);
+    if (irq_events != IRQ_TEST_EVENTS + IRQ_TEST_THRESHOLD - 1 ||
+        irq_batches != IRQ_TEST_EVENTS / IRQ_TEST_THRESHOLD + 1 ||
+        stat.latency_max < IRQ_TEST_TIMEOUT)
+    {
+        rt_kprintf("Test error: %d events in %d batches, the latency is %d.\n",
+                   irq_events, irq_batches, stat.latency_max);
+        goto __exit;
+    }
+    rt_kprintf("%d events handled after %d ticks.\n", IRQ_TEST_THRESHOLD - 1, stat.latency_max);
+
+    rt_kprintf("\n====================== irq thread hard timer test =====================\n");
+    events = irq_events;
+    batches = irq_batches;
+    rt_irq_source_set_coalesce(&irq_source, IRQ_TEST_TIMER_THRESHOLD, IRQ_TEST_TIMEOUT);
+    irq_timer_left = IRQ_TEST_EVENTS;
+    rt_timer_start(&irq_timer);
+    rt_thread_delay(IRQ_TEST_EVENTS + IRQ_TEST_TIMEOUT * 2);
+
+    /* the last events less than threshold are handled after timeout */
+    rt_irq_source_get_stat(&irq_source, &stat);
+    if (irq_timer_left != 0 || irq_events - events != IRQ_TEST_EVENTS || irq_value != 1 ||
+        irq_batches - batches > (IRQ_TEST_EVENTS + IRQ_TEST_TIMER_THRESHOLD - 1) / IRQ_TEST_TIMER_THRESHOLD)
+    {
+        rt_kprintf("Test error: %d events in %d batches, %d left.\n",
+                   irq_events - events, irq_batches - batches, irq_timer_left);
+        goto __exit;
+    }
+    rt_kprintf("%d events in %d batches, %d events per second.\n",
+               irq_events - events, irq_batches - batches, stat.rate);
+
+#ifdef RT_IRQ_THREAD_USING_SLACK
+    rt_kprintf("\n====================== irq thread slack test =====================\n");
+    rt_irq_source_detach(&irq_source);
+    rt_irq_thread_destroy(irq_thread);
+    irq_thread = rt_irq_thread_create_slack();
+    if (irq_thread == RT_NULL)
+    {
+        rt_kprintf("Test error: create irq thread in slack failed.\n");
+        goto __exit;
+    }
+    rt_irq_source_set_coalesce(&irq_source, 1, 0);
+    rt_irq_source_attach(irq_thread, &irq_source);
+
+    /* the idle hook runs after the test thread sleeps */
+    events = irq_events;
+    batches = irq_batches;
+    for (index = 0; index < IRQ_TEST_THRESHOLD; index ++)
+        rt_irq_source_post(&irq_source, index);
+    if (irq_events != events)
+    {
+        rt_kprintf("Test error: the events are handled before the slack.\n");
+        goto __exit;
+    }
+    rt_thread_delay(2);
+    if (irq_events - events != IRQ_TEST_THRESHOLD || irq_batches - batches != 1)
+    {
+        rt_kprintf("Test error: %d events in %d batches in the slack.\n",
+                   irq_events - events, irq_batches - batches);
+        goto __exit;
+    }
+    rt_kprintf("%d events in one batch in the slack.\n", IRQ_TEST_THRESHOLD);
+#endif
+
+    rt_kprintf("\n====================== irq thread test SUCCESS =====================\n");
+
+__exit:
+    rt_timer_detach(&irq_timer);
+    rt_irq_source_detach(&irq_source);
+    if (irq_thread != RT_NULL)
+        rt_irq_thread_destroy(irq_thread);
+}
+MSH_CMD_EXPORT(irq_thread_test, run irq thread coalescing testcase);
+
+#endif /* RT_USING_IRQ_THREAD && RT_USING_HEAP */
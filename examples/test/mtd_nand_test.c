@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        the first version
+ */
+
+/*
+ * The testcase of MTD Nand background service on the RAM simulated device:
+ * the queued writes are programmed in batch, the reads see the queued writes,
+ * the garbage collection hook queues the operations without deadlock and the
+ * erase count of blocks is recorded.
+ */
+
+#include <string.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_MTD_NAND_USING_SERVICE) && defined(RT_MTD_NAND_USING_RAM)
+
+#define TEST_PAGE_SIZE      512
+#define TEST_OOB_SIZE       16
+#define TEST_PAGES          8   /* pages per block */
+#define TEST_BLOCKS         8
+#define TEST_QUEUE          4
+#define TEST_GC_BLOCK       7
+
+static rt_uint8_t page_buf[TEST_PAGE_SIZE];
+static rt_uint32_t gc_times;
+
+/* erase the last block and rewrite all of its pages, the pages are more than the queue */
+static rt_err_t test_gc(struct rt_mtd_nand_device *nand, void *param)
+{
+    rt_uint32_t index;
+    rt_uint8_t data = (rt_uint8_t)(rt_ubase_t)param;
+
+    if (gc_times == 0)
+        return -RT_EEMPTY;
+    gc_times --;
+
+    if (rt_mtd_nand_erase_async(nand, TEST_GC_BLOCK) != RT_EOK)
+        return -RT_ERROR;
+    for (index = 0; index < TEST_PAGES; index ++)
+    {
+        if (rt_mtd_nand_write_async(nand, TEST_GC_BLOCK * TEST_PAGES + index, &data, 1, RT_NULL, 0) != RT_EOK)
+            return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+static rt_bool_t test_check_page(struct rt_mtd_nand_device *nand, rt_off_t page, rt_uint8_t data)
+{
+    rt_uint32_t index;
+
+    rt_memset(page_buf, 0, sizeof(page_buf));
+    if (rt_mtd_nand_read_sync(nand, page, page_buf, TEST_PAGE_SIZE, RT_NULL, 0) != RT_EOK)
+        return RT_FALSE;
+
+    for (index = 0; index < TEST_PAGE_SIZE; index ++)
+    {
+        if (page_buf[index] != data)
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+void mtd_nand_test(void)
+{
+    struct rt_mtd_nand_device *nand;
+    struct rt_mtd_nand_stat stat_old, stat;
+    rt_uint32_t erase_old, index;
+    rt_thread_t self = rt_thread_self();
+
+    nand = RT_MTD_NAND_DEVICE(rt_device_find("nandtest"));
+    if (nand == RT_NULL)
+        nand = rt_mtd_nand_ram_create("nandtest", TEST_PAGE_SIZE, TEST_OOB_SIZE, TEST_PAGES, TEST_BLOCKS);
+    if (nand == RT_NULL)
+    {
+        rt_kprintf("Test error: create RAM nand device failed.\n");
+        return;
+    }
+
+    /* the service runs in the slack time of test thread */
+    if (rt_mtd_nand_service_init(nand, TEST_QUEUE,
+                                 self->current_priority + 1 < RT_THREAD_PRIORITY_MAX ?
+                                 self->current_priority + 1 : self->current_priority) != RT_EOK)
+    {
+        rt_kprintf("Test error: init nand service failed.\n");
+        return;
+    }
+    rt_mtd_nand_get_stat(nand, &stat_old);
+
+    rt_kprintf("\n====================== nand service write test =====================\n");
+    for (index = 0; index < TEST_BLOCKS - 1; index ++)
+        rt_mtd_nand_erase_async(nand, index);
+    for (index = 0; index < TEST_PAGES * 2; index ++)
+    {
+        rt_memset(page_buf, index, sizeof(page_buf));
+        if (rt_mtd_nand_write_async(nand, index, page_buf, TEST_PAGE_SIZE, RT_NULL, 0) != RT_EOK)
+        {
+            rt_kprintf("Test error: queue page %d failed.\n", index);
+            return;
+        }
+    }
+
+    /* the queued write is done before read */
+    if (!test_check_page(nand, TEST_PAGES * 2 - 1, TEST_PAGES * 2 - 1))
+    {
+        rt_kprintf("Test error: read the queued page failed.\n");
+        return;
+    }
+    if (rt_mtd_nand_sync(nand) != RT_EOK)
+    {
+        rt_kprintf("Test error: sync failed.\n");
+        return;
+    }
+    for (index = 0; index < TEST_PAGES * 2; index ++)
+    {
+        if (!test_check_page(nand, index, index))
+        {
+            rt_kprintf("Test error: page %d mismatch.\n", index);
+            return;
+        }
+    }
+
+    rt_mtd_nand_get_stat(nand, &stat);
+    if (stat.page_write - stat_old.page_write != TEST_PAGES * 2 ||
+        stat.block_erase - stat_old.block_erase != TEST_BLOCKS - 1 ||
+        stat.batch_write == stat_old.batch_write)
+    {
+        rt_kprintf("Test error: write %d, erase %d, batch %d.\n",
+                   stat.page_write - stat_old.page_write,
+                   stat.block_erase - stat_old.block_erase,
+                   stat.batch_write - stat_old.batch_write);
+        return;
+    }
+    rt_kprintf("%d pages written in %d batches.\n", TEST_PAGES * 2, stat.batch_write - stat_old.batch_write);
+
+    rt_kprintf("\n====================== nand service gc test =====================\n");
+    erase_old = rt_mtd_nand_erase_count(nand, TEST_GC_BLOCK);
+    stat_old = stat;
+    gc_times = 3;
+    rt_mtd_nand_set_gc(nand, test_gc, (void *)0x5a, RT_TICK_PER_SECOND / 10);
+    for (index = 0; index < 10 && gc_times; index ++)
+        rt_thread_mdelay(100);
+    /* unset the hook, it's not running after return */
+    rt_mtd_nand_set_gc(nand, RT_NULL, RT_NULL, RT_WAITING_FOREVER);
+
+    rt_mtd_nand_get_stat(nand, &stat);
+    if (gc_times != 0 || rt_mtd_nand_sync(nand) != RT_EOK ||
+        rt_mtd_nand_erase_count(nand, TEST_GC_BLOCK) - erase_old != 3 ||
+        stat.page_gc - stat_old.page_gc != TEST_PAGES * 3 ||
+        stat.page_write != stat_old.page_write)
+    {
+        rt_kprintf("Test error: gc left %d, erase %d, gc pages %d.\n", gc_times,
+                   rt_mtd_nand_erase_count(nand, TEST_GC_BLOCK) - erase_old,
+                   stat.page_gc - stat_old.page_gc);
+        return;
+    }
+    rt_memset(page_buf, 0, sizeof(page_buf));
+    rt_mtd_nand_read(nand, TEST_GC_BLOCK * TEST_PAGES, page_buf, 2, RT_NULL, 0);
+    if (page_buf[0] != 0x5a || page_buf[1] != 0xff)
+    {
+        rt_kprintf("Test error: gc page mismatch.\n");
+        return;
+    }
+
+    rt_kprintf("\n====================== nand service test SUCCESS =====================\n");
+}
+MSH_CMD_EXPORT(mtd_nand_test, run MTD nand background service testcase);
+
+#endif /* RT_MTD_NAND_USING_SERVICE && RT_MTD_NAND_USING_RAM */
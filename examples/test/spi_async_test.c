@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        the first version
+ */
+
+/*
+ * The testcase of SPI asynchronous transfer queue on the loopback bus. The
+ * transfers of two devices are queued before the queue thread runs, then the
+ * order of callbacks, the completion and the data echoed are checked.
+ */
+
+#include <string.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+#if defined(RT_SPI_USING_ASYNC) && defined(RT_SPI_USING_LOOPBACK)
+
+#define SPI_TEST_DEVICES    2
+#define SPI_TEST_TRANSFERS  16
+#define SPI_TEST_LENGTH     32
+
+struct spi_test_xfer
+{
+    struct rt_spi_async async;
+    struct rt_spi_message message[2];   /* the command and the data */
+    rt_uint8_t cmd;
+    rt_uint8_t send[SPI_TEST_LENGTH];
+    rt_uint8_t recv[SPI_TEST_LENGTH + 1];
+};
+
+static struct rt_spi_bus *spi_bus;
+static struct rt_spi_device spi_dev[SPI_TEST_DEVICES];
+static struct spi_test_xfer spi_xfer[SPI_TEST_TRANSFERS];
+static int spi_last[SPI_TEST_DEVICES];
+static rt_uint32_t spi_done_count;
+static rt_bool_t spi_error;
+
+static void spi_test_done(struct rt_spi_async *async)
+{
+    struct spi_test_xfer *xfer = rt_container_of(async, struct spi_test_xfer, async);
+    int index = xfer - spi_xfer;
+    int dev = (int)(rt_ubase_t)async->user_data;
+
+    /* the transfers of same device are done in order of submitted */
+    if (index <= spi_last[dev])
+    {
+        rt_kprintf("Error: transfer %d of device %d is done after %d!\n", index, dev, spi_last[dev]);
+        spi_error = RT_TRUE;
+    }
+    spi_last[dev] = index;
+
+    if (async->result != RT_EOK || async->failed != RT_NULL)
+    {
+        rt_kprintf("Error: transfer %d failed!\n", index);
+        spi_error = RT_TRUE;
+    }
+    else if (xfer->recv[0] != xfer->cmd ||
+             rt_memcmp(xfer->recv + 1, xfer->send, SPI_TEST_LENGTH) != 0)
+    {
+        rt_kprintf("Error: transfer %d echoed data mismatch!\n", index);
+        spi_error = RT_TRUE;
+    }
+
+    spi_done_count ++;
+}
+
+void spi_async_test(void)
+{
+    struct rt_spi_configuration cfg;
+    struct rt_spi_loopback_stat lb_old, lb;
+    struct rt_spi_async_stat stat_old, stat;
+    struct rt_completion completion;
+    struct spi_test_xfer *xfer;
+    rt_thread_t self = rt_thread_self();
+    char name[RT_NAME_MAX];
+    int index, dev, i;
+
+    if (spi_bus == RT_NULL)
+    {
+        spi_bus = rt_spi_loopback_create("spilb");
+        if (spi_bus == RT_NULL)
+        {
+            rt_kprintf("Test error: create loopback bus failed.\n");
+            return;
+        }
+
+        for (dev = 0; dev < SPI_TEST_DEVICES; dev ++)
+        {
+            rt_snprintf(name, sizeof(name), "spilb%d", dev);
+            rt_spi_bus_attach_device(&spi_dev[dev], name, "spilb", RT_NULL);
+
+            cfg.data_width = 8;
+            cfg.mode = dev ? RT_SPI_MODE_3 : RT_SPI_MODE_0;
+            cfg.max_hz = 1000000 * (dev + 1);
+            rt_spi_configure(&spi_dev[dev], &cfg);
+        }
+    }
+
+    /* the queue thread runs after all of transfers are submitted */
+    if (rt_spi_bus_async_init(spi_bus,
+                              self->current_priority + 1 < RT_THREAD_PRIORITY_MAX ?
+                              self->current_priority + 1 : self->current_priority) != RT_EOK)
+    {
+        rt_kprintf("Test error: start async queue failed.\n");
+        return;
+    }
+
+    rt_kprintf("\n====================== spi async test =====================\n");
+    rt_spi_bus_async_stat(spi_bus, &stat_old);
+    rt_spi_loopback_get_stat(spi_bus, &lb_old);
+    rt_completion_init(&completion);
+    spi_done_count = 0;
+    spi_error = RT_FALSE;
+    for (dev = 0; dev < SPI_TEST_DEVICES; dev ++)
+        spi_last[dev] = -1;
+
+    for (index = 0; index < SPI_TEST_TRANSFERS; index ++)
+    {
+        xfer = &spi_xfer[index];
+        /* the transfers of devices are interleaved */
+        dev = index % 3 ? 0 : 1;
+
+        xfer->cmd = (rt_uint8_t)index;
+        for (i = 0; i < SPI_TEST_LENGTH; i ++)
+            xfer->send[i] = (rt_uint8_t)rand();
+        rt_memset(xfer->recv, 0, sizeof(xfer->recv));
+
+        /* the command and the data in one chip select */
+        rt_memset(xfer->message, 0, sizeof(xfer->message));
+        xfer->message[0].send_buf = &xfer->cmd;
+        xfer->message[0].recv_buf = xfer->recv;
+        xfer->message[0].length = 1;
+        xfer->message[0].cs_take = 1;
+        xfer->message[0].next = &xfer->message[1];
+        xfer->message[1].send_buf = xfer->send;
+        xfer->message[1].recv_buf = xfer->recv + 1;
+        xfer->message[1].length = SPI_TEST_LENGTH;
+        xfer->message[1].cs_release = 1;
+
+        rt_spi_async_init(&xfer->async, xfer->message, spi_test_done, (void *)(rt_ubase_t)dev);
+        /* the completion of last one is notified after all of callbacks */
+        if (index == SPI_TEST_TRANSFERS - 1)
+            xfer->async.completion = &completion;
+
+        if (rt_spi_transfer_async(&spi_dev[dev], &xfer->async) != RT_EOK)
+        {
+            rt_kprintf("Test error: submit transfer %d failed.\n", index);
+            return;
+        }
+    }
+
+    if (rt_completion_wait(&completion, RT_TICK_PER_SECOND) != RT_EOK)
+    {
+        rt_kprintf("Test error: wait for completion timeout, %d done.\n", spi_done_count);
+        return;
+    }
+    /* the transfers of other device may be done after the last one */
+    for (index = 0; index < 10 && spi_done_count < SPI_TEST_TRANSFERS; index ++)
+        rt_thread_mdelay(10);
+
+    rt_spi_bus_async_stat(spi_bus, &stat);
+    rt_spi_loopback_get_stat(spi_bus, &lb);
+    rt_kprintf("submitted %d, completed %d, batched %d, configured %d\n",
+               stat.submitted - stat_old.submitted, stat.completed - stat_old.completed,
+               stat.batched - stat_old.batched, stat.configured - stat_old.configured);
+
+    if (spi_error || spi_done_count != SPI_TEST_TRANSFERS ||
+        stat.submitted - stat_old.submitted != SPI_TEST_TRANSFERS ||
+        stat.completed - stat_old.completed != SPI_TEST_TRANSFERS ||
+        lb.cs_taken - lb_old.cs_taken != SPI_TEST_TRANSFERS ||
+        lb.messages - lb_old.messages != SPI_TEST_TRANSFERS * 2 ||
+        lb.bytes - lb_old.bytes != SPI_TEST_TRANSFERS * (SPI_TEST_LENGTH + 1))
+    {
+        rt_kprintf("Test error: %d done, %d chip selects, %d messages, %d bytes.\n", spi_done_count,
+                   lb.cs_taken - lb_old.cs_taken, lb.messages - lb_old.messages, lb.bytes - lb_old.bytes);
+        return;
+    }
+
+    /* the transfers of same device run in batch, the bus is configured less */
+    if (stat.batched == stat_old.batched || stat.configured - stat_old.configured > SPI_TEST_DEVICES * 2)
+    {
+        rt_kprintf("Test error: the transfers of same device are not batched.\n");
+        return;
+    }
+
+    rt_kprintf("\n====================== spi async test SUCCESS =====================\n");
+}
+MSH_CMD_EXPORT(spi_async_test, run SPI async transfer queue testcase on loopback bus);
+
+#endif /* RT_SPI_USING_ASYNC && RT_SPI_USING_LOOPBACK */
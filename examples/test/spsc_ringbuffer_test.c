@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        the first version
+ */
+
+#include <string.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+
+/* the size isn't power of 2, the index wraps in the mirror */
+#define SPSC_TEST_SIZE      7
+#define SPSC_TEST_BYTES     100000
+
+static struct rt_spsc_ringbuffer spsc;
+static rt_uint8_t spsc_pool[SPSC_TEST_SIZE];
+static rt_bool_t spsc_error;
+static struct rt_semaphore spsc_done;
+
+static void put_thread(void *param)
+{
+    rt_uint8_t *ptr;
+    rt_size_t length, index;
+    rt_uint32_t seq = 0;
+
+    while (seq < SPSC_TEST_BYTES && !spsc_error)
+    {
+        /* the copy API and the peek/commit API in turn */
+        if (seq & 1)
+        {
+            rt_uint8_t buf[3];
+
+            length = rand() % sizeof(buf) + 1;
+            if (length > SPSC_TEST_BYTES - seq)
+                length = SPSC_TEST_BYTES - seq;
+            for (index = 0; index < length; index ++)
+                buf[index] = (rt_uint8_t)(seq + index);
+            seq += rt_spsc_ringbuffer_put(&spsc, buf, length);
+        }
+        else
+        {
+            length = rt_spsc_ringbuffer_put_peek(&spsc, &ptr);
+            if (length > SPSC_TEST_BYTES - seq)
+                length = SPSC_TEST_BYTES - seq;
+            for (index = 0; index < length; index ++)
+                ptr[index] = (rt_uint8_t)(seq + index);
+            rt_spsc_ringbuffer_put_commit(&spsc, length);
+            seq += length;
+        }
+
+        if (rand() % 4 == 0)
+            rt_thread_yield();
+    }
+
+    rt_sem_release(&spsc_done);
+}
+
+static void get_thread(void *param)
+{
+    rt_uint8_t *ptr, buf[4];
+    rt_size_t length, index;
+    rt_uint32_t seq = 0;
+
+    while (seq < SPSC_TEST_BYTES && !spsc_error)
+    {
+        if (seq & 1)
+        {
+            length = rt_spsc_ringbuffer_get(&spsc, buf, rand() % sizeof(buf) + 1);
+            ptr = buf;
+        }
+        else
+        {
+            length = rt_spsc_ringbuffer_get_peek(&spsc, &ptr);
+        }
+
+        for (index = 0; index < length; index ++)
+        {
+            if (ptr[index] != (rt_uint8_t)(seq + index))
+            {
+                rt_kprintf("Error: get data (byte %d) has an error!\n", seq + index);
+                spsc_error = RT_TRUE;
+                break;
+            }
+        }
+
+        if (!(seq & 1))
+            rt_spsc_ringbuffer_get_commit(&spsc, length);
+        seq += length;
+
+        if (rand() % 4 == 0)
+            rt_thread_yield();
+    }
+
+    rt_sem_release(&spsc_done);
+}
+
+void spsc_ringbuffer_test(void)
+{
+    rt_uint8_t buf[SPSC_TEST_SIZE + 1], *ptr;
+    rt_size_t length, index;
+    rt_thread_t thread;
+    rt_tick_t tick;
+
+    rt_kprintf("\n====================== spsc ringbuffer static test =====================\n");
+    rt_spsc_ringbuffer_init(&spsc, spsc_pool, SPSC_TEST_SIZE);
+
+    /* empty */
+    if (rt_spsc_ringbuffer_data_len(&spsc) != 0 ||
+        rt_spsc_ringbuffer_space_len(&spsc) != SPSC_TEST_SIZE ||
+        rt_spsc_ringbuffer_get(&spsc, buf, sizeof(buf)) != 0 ||
+        rt_spsc_ringbuffer_get_peek(&spsc, &ptr) != 0)
+    {
+        rt_kprintf("Test error: the empty ring buffer isn't empty.\n");
+        return;
+    }
+    rt_kprintf("Empty test success.\n");
+
+    /* full, all of the buffer is used */
+    for (index = 0; index < sizeof(buf); index ++)
+        buf[index] = index;
+    if (rt_spsc_ringbuffer_put(&spsc, buf, sizeof(buf)) != SPSC_TEST_SIZE ||
+        rt_spsc_ringbuffer_data_len(&spsc) != SPSC_TEST_SIZE ||
+        rt_spsc_ringbuffer_space_len(&spsc) != 0 ||
+        rt_spsc_ringbuffer_put(&spsc, buf, 1) != 0 ||
+        rt_spsc_ringbuffer_put_peek(&spsc, &ptr) != 0)
+    {
+        rt_kprintf("Test error: the full ring buffer isn't full.\n");
+        return;
+    }
+    rt_kprintf("Full test success.\n");
+
+    /* wrap: get 5, put 4, the data crosses the end of buffer */
+    rt_memset(buf, 0, sizeof(buf));
+    if (rt_spsc_ringbuffer_get(&spsc, buf, 5) != 5 || buf[0] != 0 || buf[4] != 4)
+    {
+        rt_kprintf("Test error: get the head of ring buffer failed.\n");
+        return;
+    }
+    for (index = 0; index < 4; index ++)
+        buf[index] = SPSC_TEST_SIZE + index;
+    if (rt_spsc_ringbuffer_put(&spsc, buf, 4) != 4 || rt_spsc_ringbuffer_data_len(&spsc) != 6)
+    {
+        rt_kprintf("Test error: put across the end of ring buffer failed.\n");
+        return;
+    }
+    rt_memset(buf, 0, sizeof(buf));
+    if (rt_spsc_ringbuffer_get(&spsc, buf, sizeof(buf)) != 6)
+    {
+        rt_kprintf("Test error: get across the end of ring buffer failed.\n");
+        return;
+    }
+    for (index = 0; index < 6; index ++)
+    {
+        if (buf[index] != index + 5)
+        {
+            rt_kprintf("Test error: the data across the end of ring buffer mismatch.\n");
+            return;
+        }
+    }
+    rt_kprintf("Wrap test success.\n");
+
+    /* peek/commit: the region ends at the end of buffer, the rest is at the head */
+    length = rt_spsc_ringbuffer_put_peek(&spsc, &ptr);
+    if (length != SPSC_TEST_SIZE - 4 || ptr != spsc_pool + 4)
+    {
+        rt_kprintf("Test error: put peek %d bytes at offset %d.\n", length, ptr - spsc_pool);
+        return;
+    }
+    rt_memset(ptr, 0xa5, length);
+    rt_spsc_ringbuffer_put_commit(&spsc, length);
+    length = rt_spsc_ringbuffer_put_peek(&spsc, &ptr);
+    if (length != 4 || ptr != spsc_pool)
+    {
+        rt_kprintf("Test error: put peek %d bytes after wrap.\n", length);
+        return;
+    }
+    rt_memset(ptr, 0x5a, length);
+    rt_spsc_ringbuffer_put_commit(&spsc, length);
+
+    length = rt_spsc_ringbuffer_get_peek(&spsc, &ptr);
+    if (length != SPSC_TEST_SIZE - 4 || ptr[0] != 0xa5 || ptr[length - 1] != 0xa5)
+    {
+        rt_kprintf("Test error: get peek %d bytes.\n", length);
+        return;
+    }
+    rt_spsc_ringbuffer_get_commit(&spsc, length);
+    length = rt_spsc_ringbuffer_get_peek(&spsc, &ptr);
+    if (length != 4 || ptr[0] != 0x5a || ptr[3] != 0x5a)
+    {
+        rt_kprintf("Test error: get peek %d bytes after wrap.\n", length);
+        return;
+    }
+    rt_spsc_ringbuffer_get_commit(&spsc, 1);
+    if (rt_spsc_ringbuffer_data_len(&spsc) != 3)
+    {
+        rt_kprintf("Test error: partial commit failed.\n");
+        return;
+    }
+    rt_spsc_ringbuffer_reset(&spsc);
+    if (rt_spsc_ringbuffer_data_len(&spsc) != 0)
+    {
+        rt_kprintf("Test error: reset failed.\n");
+        return;
+    }
+    rt_kprintf("Peek and commit test success.\n");
+
+    rt_kprintf("\n====================== spsc ringbuffer static test SUCCESS =====================\n");
+
+    rt_kprintf("\n====================== spsc ringbuffer dynamic test =====================\n");
+    spsc_error = RT_FALSE;
+    rt_sem_init(&spsc_done, "spsc", 0, RT_IPC_FLAG_FIFO);
+
+    thread = rt_thread_create("spsc_put", put_thread, RT_NULL, 1024, 10, 5);
+    if (thread)
+        rt_thread_startup(thread);
+    thread = rt_thread_create("spsc_get", get_thread, RT_NULL, 1024, 10, 5);
+    if (thread)
+        rt_thread_startup(thread);
+
+    tick = rt_tick_get();
+    if (rt_sem_take(&spsc_done, RT_TICK_PER_SECOND * 30) != RT_EOK ||
+        rt_sem_take(&spsc_done, RT_TICK_PER_SECOND * 30) != RT_EOK)
+    {
+        rt_kprintf("Test error: timeout.\n");
+    }
+    else if (!spsc_error)
+    {
+        rt_kprintf("%d bytes passed in %d ticks.\n", SPSC_TEST_BYTES, rt_tick_get() - tick);
+        rt_kprintf("\n====================== spsc ringbuffer dynamic test SUCCESS =====================\n");
+    }
+    rt_sem_detach(&spsc_done);
+}
+MSH_CMD_EXPORT(spsc_ringbuffer_test, run lock-free spsc ring buffer testcase);
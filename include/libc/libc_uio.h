@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     agent        The first version
+ */
+
+#ifndef LIBC_UIO_H__
+#define LIBC_UIO_H__
+
+#include <stddef.h>
+
+/* HAVE_SYS_UIO_H could be defined by the BSP. Otherwise ask the compiler
+ * whether the toolchain ships sys/uio.h, the compilers without
+ * __has_include (armcc, IAR) don't. */
+#if !defined(HAVE_SYS_UIO_H) && defined(__has_include)
+#if __has_include(<sys/uio.h>)
+#define HAVE_SYS_UIO_H
+#endif
+#endif
+
+#if defined(HAVE_SYS_UIO_H)
+#include <sys/uio.h>
+#else
+
+struct iovec
+{
+    void  *iov_base;    /* base address of buffer */
+    size_t iov_len;     /* length of buffer */
+};
+
+#endif
+
+/* the network stack (lwIP) skips its own definition if it's defined */
+#ifndef iovec
+#define iovec iovec
+#endif
+
+#endif
@@ -421,6 +421,8 @@ struct rt_object_information
 #define RT_TIMER_CTRL_GET_TIME          0x1             /**< get timer control command */
 #define RT_TIMER_CTRL_SET_ONESHOT       0x2             /**< change timer to one shot */
 #define RT_TIMER_CTRL_SET_PERIODIC      0x3             /**< change timer to periodic */
+#define RT_TIMER_CTRL_SET_SLACK         0x4             /**< set the slack tick of timer */
+#define RT_TIMER_CTRL_GET_SLACK         0x5             /**< get the slack tick of timer */
 
 #ifndef RT_TIMER_SKIP_LIST_LEVEL
 #define RT_TIMER_SKIP_LIST_LEVEL          1
@@ -445,6 +447,9 @@ struct rt_timer
 
     rt_tick_t        init_tick;                         /**< timer timeout tick */
     rt_tick_t        timeout_tick;                      /**< timeout tick */
+#ifdef RT_USING_TIMER_SLACK
+    rt_tick_t        slack;                             /**< the ticks timeout can be delayed */
+#endif
 };
 typedef struct rt_timer *rt_timer_t;
 
@@ -542,6 +547,17 @@ struct rt_thread
     rt_uint8_t  event_info;
 #endif
 
+#if defined(RT_USING_IPC_PRIO_INDEX)
+    /* priority index of the IPC list which thread suspended on */
+    struct rt_ipc_prio_index *suspend_index;
+    rt_uint8_t  suspend_priority;
+#endif
+
+#if defined(RT_USING_IPC_BATCH)
+    /* the number of messages which thread is waiting for in batch receiving */
+    rt_uint16_t ipc_batch_count;
+#endif
+
 #if defined(RT_USING_SIGNALS)
     rt_sigset_t     sig_pending;                        /**< the pending signals */
     rt_sigset_t     sig_mask;                           /**< the mask bits of signal */
@@ -606,6 +622,29 @@ typedef struct rt_thread *rt_thread_t;
 #define RT_WAITING_FOREVER              -1              /**< Block forever until get resource. */
 #define RT_WAITING_NO                   0               /**< Non-block. */
 
+#ifdef RT_USING_IPC_PRIO_INDEX
+/**
+ * Priority index of an IPC suspended thread list. The list is still ordered
+ * by priority, the index records the first thread of each priority level,
+ * so a thread can be inserted to its position without scanning the list.
+ */
+struct rt_ipc_prio_index
+{
+    rt_list_t           *list;                          /**< the indexed suspend list */
+
+#if RT_THREAD_PRIORITY_MAX > 32
+    rt_uint32_t          priority_group;                /**< bitmap of priority groups */
+    rt_uint8_t           priority_table[32];            /**< bitmap of priorities in each group */
+#else
+    rt_uint32_t          priority_group;                /**< bitmap of priorities */
+#endif
+
+    struct rt_thread    *first[RT_THREAD_PRIORITY_MAX + 1]; /**< first thread of each priority */
+};
+#else
+struct rt_ipc_prio_index;
+#endif
+
 /**
  * Base structure of IPC object
  */
@@ -614,6 +653,9 @@ struct rt_ipc_object
     struct rt_object parent;                            /**< inherit from rt_object */
 
     rt_list_t        suspend_thread;                    /**< threads pended on this resource */
+#ifdef RT_USING_IPC_PRIO_INDEX
+    struct rt_ipc_prio_index suspend_index;             /**< priority index of suspend_thread */
+#endif
 };
 
 #ifdef RT_USING_SEMAPHORE
@@ -685,6 +727,9 @@ struct rt_mailbox
     rt_uint16_t          out_offset;                    /**< output offset of the message buffer */
 
     rt_list_t            suspend_sender_thread;         /**< sender thread suspended on this mailbox */
+#ifdef RT_USING_IPC_PRIO_INDEX
+    struct rt_ipc_prio_index suspend_sender_index;      /**< priority index of suspend_sender_thread */
+#endif
 };
 typedef struct rt_mailbox *rt_mailbox_t;
 #endif
@@ -703,12 +748,31 @@ struct rt_messagequeue
     rt_uint16_t          max_msgs;                      /**< max number of messages */
 
     rt_uint16_t          entry;                         /**< index of messages in the queue */
+#ifdef RT_USING_MQ_BUFFER
+    rt_uint16_t          buffer_mode;                   /**< messages are references of pool buffer */
+#endif
 
     void                *msg_queue_head;                /**< list head */
     void                *msg_queue_tail;                /**< list tail */
     void                *msg_queue_free;                /**< pointer indicated the free node of queue */
 };
 typedef struct rt_messagequeue *rt_mq_t;
+
+#ifdef RT_USING_MQ_BUFFER
+/**
+ * header of reference counted message buffer, which is allocated from a
+ * memory pool and passed through message queue without copy.
+ */
+struct rt_mq_buf
+{
+    rt_uint16_t          ref_count;                     /**< reference count of buffer */
+    rt_uint16_t          reserved;                      /**< reserved field */
+};
+
+#define RT_MQ_BUF_HEADER_SIZE           RT_ALIGN(sizeof(struct rt_mq_buf), RT_ALIGN_SIZE)
+/* block size of memory pool for message buffer with size bytes payload */
+#define RT_MQ_BUF_BLOCK_SIZE(size)      (RT_MQ_BUF_HEADER_SIZE + (size))
+#endif
 #endif
 
 /**@}*/
@@ -860,6 +924,25 @@ enum rt_device_class_type
 #define RT_DEVICE_CTRL_CLR_INT          0x11            /**< clear interrupt */
 #define RT_DEVICE_CTRL_GET_INT          0x12            /**< get interrupt status */
 
+/* Out of the range of the class commands above, so the drivers of every
+ * class could tell them from their own commands. */
+#define RT_DEVICE_CTRL_READV            0x30            /**< read into scattered buffers */
+#define RT_DEVICE_CTRL_WRITEV           0x31            /**< write from scattered buffers */
+
+struct iovec;
+
+/**
+ * the argument of RT_DEVICE_CTRL_READV and RT_DEVICE_CTRL_WRITEV, the device
+ * which supports them sets the size transferred.
+ */
+struct rt_device_iov
+{
+    rt_off_t            pos;                            /**< position of transfer */
+    const struct iovec *iov;                            /**< scattered buffers */
+    int                 iovcnt;                         /**< number of buffers */
+    rt_size_t           size;                           /**< size transferred */
+};
+
 /**
  * special device commands
  */
@@ -138,6 +138,9 @@ rt_err_t rt_thread_delete(rt_thread_t thread);
 rt_err_t rt_thread_yield(void);
 rt_err_t rt_thread_delay(rt_tick_t tick);
 rt_err_t rt_thread_mdelay(rt_int32_t ms);
+#ifdef RT_USING_TIMER_SLACK
+rt_err_t rt_thread_delay_slack(rt_tick_t tick, rt_tick_t slack);
+#endif
 rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg);
 rt_err_t rt_thread_suspend(rt_thread_t thread);
 rt_err_t rt_thread_resume(rt_thread_t thread);
@@ -354,6 +357,14 @@ rt_err_t rt_mb_send_wait(rt_mailbox_t mb,
                          rt_int32_t   timeout);
 rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout);
 rt_err_t rt_mb_control(rt_mailbox_t mb, int cmd, void *arg);
+#ifdef RT_USING_IPC_BATCH
+rt_size_t rt_mb_send_batch(rt_mailbox_t mb, const rt_uint32_t *value, rt_size_t count);
+rt_size_t rt_mb_recv_batch(rt_mailbox_t mb,
+                           rt_uint32_t *value,
+                           rt_size_t    count,
+                           rt_size_t    min_count,
+                           rt_int32_t   timeout);
+#endif
 #endif
 
 #ifdef RT_USING_MESSAGEQUEUE
@@ -380,6 +391,45 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
                     rt_size_t  size,
                     rt_int32_t timeout);
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
+#ifdef RT_USING_IPC_BATCH
+rt_size_t rt_mq_send_batch(rt_mq_t mq, const void *buffer, rt_size_t size, rt_size_t count);
+rt_size_t rt_mq_recv_batch(rt_mq_t    mq,
+                           void      *buffer,
+                           rt_size_t  size,
+                           rt_size_t  count,
+                           rt_size_t  min_count,
+                           rt_int32_t timeout);
+#endif
+
+#ifdef RT_USING_MQ_BUFFER
+/*
+ * zero-copy message queue interface
+ */
+rt_err_t rt_mq_init_buf(rt_mq_t     mq,
+                        const char *name,
+                        void       *msgpool,
+                        rt_size_t   pool_size,
+                        rt_uint8_t  flag);
+#ifdef RT_USING_HEAP
+rt_mq_t rt_mq_create_buf(const char *name, rt_size_t max_msgs, rt_uint8_t flag);
+#endif
+
+void *rt_mq_buf_alloc(rt_mp_t mp, rt_int32_t time);
+void rt_mq_buf_ref(void *buf);
+void rt_mq_buf_release(void *buf);
+
+rt_err_t rt_mq_send_buf(rt_mq_t mq, void *buf);
+rt_err_t rt_mq_recv_buf(rt_mq_t mq, void **buf, rt_int32_t timeout);
+rt_size_t rt_mq_send_buf_batch(rt_mq_t mq, void *buf[], rt_size_t count);
+rt_size_t rt_mq_recv_buf_batch(rt_mq_t     mq,
+                               void       *buf[],
+                               rt_size_t   count,
+                               rt_int32_t  timeout);
+#endif
+#endif
+
+#ifdef RT_USING_IPC_PRIO_INDEX
+void rt_ipc_prio_index_remove(struct rt_thread *thread);
 #endif
 
 /**@}*/
@@ -446,6 +446,10 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
     {
         /* remove thread from ready list */
         rt_base_t i;
+#ifdef RT_USING_IPC_PRIO_INDEX
+        /* the thread may be removed when it's suspended on an IPC object */
+        rt_ipc_prio_index_remove(thread);
+#endif
         for(i = 0; i < RT_TT_THREAD_SKIP_LIST_LEVEL; i++)
         {
             rt_list_remove(thread->thread_skip_list_nodes[i]);
@@ -464,6 +468,10 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
     }
     else
     {
+#ifdef RT_USING_IPC_PRIO_INDEX
+        /* the thread may be removed when it's suspended on an IPC object */
+        rt_ipc_prio_index_remove(thread);
+#endif
         /* remove thread from ready list */
         rt_list_remove(&(thread->tlist));
         if (rt_list_isempty(&(rt_thread_priority_table[thread->current_priority])))
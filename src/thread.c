@@ -211,6 +211,13 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
     thread->lwp = RT_NULL;
 #endif
 
+#ifdef RT_USING_IPC_PRIO_INDEX
+    thread->suspend_index = RT_NULL;
+#endif
+#ifdef RT_USING_IPC_BATCH
+    thread->ipc_batch_count = 0;
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_thread_inited_hook, (thread));
     
     /* Ĭ̶߳ͨ߳ */
@@ -674,6 +681,52 @@ rt_err_t rt_thread_mdelay(rt_int32_t ms)
 }
 RTM_EXPORT(rt_thread_mdelay);
 
+#ifdef RT_USING_TIMER_SLACK
+/**
+ * This function will let current thread delay for some ticks, the wakeup can
+ * be delayed at most slack ticks, so it can be coalesced with other timers.
+ *
+ * @param tick the delay ticks
+ * @param slack the maximum ticks the wakeup can be delayed
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_thread_delay_slack(rt_tick_t tick, rt_tick_t slack)
+{
+    register rt_base_t temp;
+    struct rt_thread *thread;
+    rt_tick_t no_slack = 0;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+    /* set to current thread */
+    thread = rt_current_thread;
+    RT_ASSERT(thread != RT_NULL);
+    RT_ASSERT(rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread);
+
+    /* suspend thread */
+    rt_thread_suspend(thread);
+
+    /* the slack is applied at start, restore it for the other timeouts */
+    rt_timer_control(&(thread->thread_timer), RT_TIMER_CTRL_SET_TIME, &tick);
+    rt_timer_control(&(thread->thread_timer), RT_TIMER_CTRL_SET_SLACK, &slack);
+    rt_timer_start(&(thread->thread_timer));
+    rt_timer_control(&(thread->thread_timer), RT_TIMER_CTRL_SET_SLACK, &no_slack);
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    rt_schedule();
+
+    /* clear error number of this thread to RT_EOK */
+    if (thread->error == -RT_ETIMEOUT)
+        thread->error = RT_EOK;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_thread_delay_slack);
+#endif
+
 /**
  * This function will control thread behaviors according to control command.
  *
@@ -829,6 +882,9 @@ rt_err_t rt_thread_resume(rt_thread_t thread)
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
+#ifdef RT_USING_IPC_PRIO_INDEX
+    rt_ipc_prio_index_remove(thread);
+#endif
     rt_list_remove(&(thread->tlist));
     
     rt_timer_stop(&thread->thread_timer);
@@ -875,6 +931,9 @@ void rt_thread_timeout(void *parameter)
     }
     else
     {
+#ifdef RT_USING_IPC_PRIO_INDEX
+        rt_ipc_prio_index_remove(thread);
+#endif
         rt_list_remove(&(thread->tlist));
     }
 
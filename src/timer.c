@@ -16,13 +16,47 @@
  * 2012-12-15     Bernard      fix the next timeout issue in soft timer
  * 2014-07-12     Bernard      does not lock scheduler when invoking soft-timer
  *                             timeout function.
+ * 2026-10-19     agent        add hierarchical timer wheel backend
+ * 2026-10-19     agent        add timer slack to coalesce timeouts
+ * 2026-10-19     agent        advance the wheel step by step, resume the idle timer thread only
  */
 
 #include <rtthread.h>
 #include <rthw.h>
 
+#ifdef RT_USING_TIMER_WHEEL
+#ifndef RT_TIMER_WHEEL_BITS
+#define RT_TIMER_WHEEL_BITS            6
+#endif
+
+#define RT_TIMER_WHEEL_LEVEL           4
+#define RT_TIMER_WHEEL_SIZE            (1UL << RT_TIMER_WHEEL_BITS)
+#define RT_TIMER_WHEEL_MASK            (RT_TIMER_WHEEL_SIZE - 1)
+/* the maximum delta tick can be hold by the wheel */
+#define RT_TIMER_WHEEL_RANGE           ((1UL << (RT_TIMER_WHEEL_BITS * RT_TIMER_WHEEL_LEVEL)) - 1)
+
+/*
+ * hierarchical timer wheel. The timers will expire in next RT_TIMER_WHEEL_SIZE
+ * ticks are put to the slots of level 0 by its timeout tick, the farther ones
+ * are put to upper levels and cascaded down when level 0 wraps around. Both of
+ * hard and soft timers are kept in the wheel, the row[0] of timer is the node.
+ */
+static struct
+{
+    rt_tick_t current;                                  /* the next tick to be processed */
+    rt_list_t slot[RT_TIMER_WHEEL_LEVEL][RT_TIMER_WHEEL_SIZE];
+} rt_timer_wheel;
+
+#ifdef RT_USING_TIMER_SOFT
+/* the expired soft timers, which are processed in timer thread */
+static rt_list_t rt_soft_timer_pending;
+/* the timer thread suspends itself for no pending soft timer */
+static rt_uint8_t rt_soft_timer_idle;
+#endif
+#else
 /* hard timer list */
 static rt_list_t rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif
 
 #ifdef RT_USING_TIMER_SOFT
 #ifndef RT_TIMER_THREAD_STACK_SIZE
@@ -33,8 +67,10 @@ static rt_list_t rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
 #define RT_TIMER_THREAD_PRIO           0
 #endif
 
+#ifndef RT_USING_TIMER_WHEEL
 /* soft timer list */
 static rt_list_t rt_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif
 static struct rt_thread timer_thread;
 ALIGN(RT_ALIGN_SIZE)
 static rt_uint8_t timer_thread_stack[RT_TIMER_THREAD_STACK_SIZE];
@@ -96,6 +132,9 @@ static void _rt_timer_init(rt_timer_t timer,
 
     timer->timeout_tick = 0;
     timer->init_tick    = time;
+#ifdef RT_USING_TIMER_SLACK
+    timer->slack        = 0;
+#endif
 
     /* initialize timer list */
     for (i = 0; i < RT_TIMER_SKIP_LIST_LEVEL; i++)
@@ -104,6 +143,214 @@ static void _rt_timer_init(rt_timer_t timer,
     }
 }
 
+#ifdef RT_USING_TIMER_SLACK
+/*
+ * delay the timeout tick within the slack to a round tick. The timers whose
+ * slack windows overlap are likely to be rounded to the same tick, so they
+ * expire in one batch and the wakeups are reduced.
+ */
+static rt_tick_t _rt_timer_apply_slack(rt_tick_t timeout_tick, rt_tick_t slack)
+{
+    rt_tick_t limit, mask;
+
+    if (slack == 0)
+        return timeout_tick;
+
+    limit = timeout_tick + slack;
+
+    /* get the highest bit differs between timeout tick and limit */
+    mask = timeout_tick ^ limit;
+    while (mask & (mask - 1))
+        mask &= mask - 1;
+
+    /* clear the lower bits of limit */
+    return limit & ~(mask - 1);
+}
+#endif
+
+#ifdef RT_USING_TIMER_WHEEL
+rt_inline void _rt_timer_remove(rt_timer_t timer)
+{
+    rt_list_remove(&timer->row[0]);
+}
+
+/* put timer to the slot of wheel by its timeout tick */
+static void _rt_timer_wheel_insert(rt_timer_t timer)
+{
+    rt_tick_t timeout_tick, delta;
+    rt_list_t *slot;
+    int level;
+
+    timeout_tick = timer->timeout_tick;
+    delta = timeout_tick - rt_timer_wheel.current;
+
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        /* already expired, process it in the next tick */
+        slot = &rt_timer_wheel.slot[0][rt_timer_wheel.current & RT_TIMER_WHEEL_MASK];
+    }
+    else
+    {
+        for (level = 0; level < RT_TIMER_WHEEL_LEVEL - 1; level ++)
+        {
+            if (delta < (1UL << (RT_TIMER_WHEEL_BITS * (level + 1))))
+                break;
+        }
+
+        /* out of range, it will be cascaded again */
+        if (delta > RT_TIMER_WHEEL_RANGE)
+            timeout_tick = rt_timer_wheel.current + RT_TIMER_WHEEL_RANGE;
+
+        slot = &rt_timer_wheel.slot[level]
+               [(timeout_tick >> (RT_TIMER_WHEEL_BITS * level)) & RT_TIMER_WHEEL_MASK];
+    }
+
+    /* the timers timeout at the same tick are called in the order of start */
+    rt_list_insert_before(slot, &(timer->row[0]));
+}
+
+/* re-distribute the timers in one slot of upper level */
+static void _rt_timer_wheel_cascade(int level, int index)
+{
+    struct rt_timer *timer;
+    rt_list_t list;
+
+    /* move timers out firstly, the out of range ones may go back to the slot */
+    rt_list_init(&list);
+    while (!rt_list_isempty(&rt_timer_wheel.slot[level][index]))
+    {
+        timer = rt_list_entry(rt_timer_wheel.slot[level][index].next,
+                              struct rt_timer, row[0]);
+        rt_list_remove(&(timer->row[0]));
+        rt_list_insert_before(&list, &(timer->row[0]));
+    }
+
+    while (!rt_list_isempty(&list))
+    {
+        timer = rt_list_entry(list.next, struct rt_timer, row[0]);
+        rt_list_remove(&(timer->row[0]));
+        _rt_timer_wheel_insert(timer);
+    }
+}
+
+/*
+ * advance the wheel one step to the current tick, the step ends at the next
+ * non-empty slot or the wrap around of level 0, so it takes a bounded time
+ * after a large tick jump. The expired hard timers are moved to expired list
+ * and the expired soft timers are moved to the pending list of timer thread.
+ * It shall be invoked with interrupt disabled.
+ *
+ * @return RT_TRUE if the wheel doesn't reach the current tick yet.
+ */
+static rt_bool_t _rt_timer_wheel_advance(rt_tick_t current_tick, rt_list_t *expired)
+{
+    struct rt_timer *timer;
+    rt_list_t *slot;
+    int level, index;
+
+    if ((current_tick - rt_timer_wheel.current) >= RT_TICK_MAX / 2)
+        return RT_FALSE;
+
+    index = rt_timer_wheel.current & RT_TIMER_WHEEL_MASK;
+
+    /* level 0 wraps around, cascade the upper levels */
+    if (index == 0)
+    {
+        for (level = 1; level < RT_TIMER_WHEEL_LEVEL; level ++)
+        {
+            index = (rt_timer_wheel.current >> (RT_TIMER_WHEEL_BITS * level)) &
+                    RT_TIMER_WHEEL_MASK;
+            _rt_timer_wheel_cascade(level, index);
+            if (index != 0)
+                break;
+        }
+        index = 0;
+    }
+
+    slot = &rt_timer_wheel.slot[0][index];
+    while (!rt_list_isempty(slot))
+    {
+        timer = rt_list_entry(slot->next, struct rt_timer, row[0]);
+        rt_list_remove(&(timer->row[0]));
+
+#ifdef RT_USING_TIMER_SOFT
+        if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
+            rt_list_insert_before(&rt_soft_timer_pending, &(timer->row[0]));
+        else
+#endif
+            rt_list_insert_before(expired, &(timer->row[0]));
+    }
+    rt_timer_wheel.current ++;
+
+    /* skip the empty slots before the wrap around */
+    while ((current_tick - rt_timer_wheel.current) < RT_TICK_MAX / 2)
+    {
+        index = rt_timer_wheel.current & RT_TIMER_WHEEL_MASK;
+        if (index == 0 || !rt_list_isempty(&rt_timer_wheel.slot[0][index]))
+            return RT_TRUE;
+
+        rt_timer_wheel.current ++;
+    }
+
+    return RT_FALSE;
+}
+
+/* get the timeout tick of the first timer in wheel */
+static rt_tick_t _rt_timer_wheel_next_timeout(void)
+{
+    struct rt_timer *timer;
+    rt_list_t *slot, *node;
+    rt_tick_t next_timeout;
+    int level, index, i;
+
+    next_timeout = RT_TICK_MAX;
+
+    /* the timers in slot of level 0 timeout at the same tick */
+    index = rt_timer_wheel.current & RT_TIMER_WHEEL_MASK;
+    for (i = 0; i < RT_TIMER_WHEEL_SIZE; i ++)
+    {
+        if (!rt_list_isempty(&rt_timer_wheel.slot[0][(index + i) & RT_TIMER_WHEEL_MASK]))
+        {
+            next_timeout = rt_timer_wheel.current + i;
+            break;
+        }
+    }
+
+    /*
+     * the upper levels may hold the timers are not cascaded down yet. The slots
+     * of top level are all checked, for the out of range timers are put to
+     * different slots.
+     */
+    for (level = 1; level < RT_TIMER_WHEEL_LEVEL; level ++)
+    {
+        index = (rt_timer_wheel.current >> (RT_TIMER_WHEEL_BITS * level)) &
+                RT_TIMER_WHEEL_MASK;
+        /* skip the current slot if it has been cascaded */
+        if (rt_timer_wheel.current & ((1UL << (RT_TIMER_WHEEL_BITS * level)) - 1))
+            index ++;
+
+        for (i = 0; i < RT_TIMER_WHEEL_SIZE; i ++)
+        {
+            slot = &rt_timer_wheel.slot[level][(index + i) & RT_TIMER_WHEEL_MASK];
+            if (rt_list_isempty(slot))
+                continue;
+
+            for (node = slot->next; node != slot; node = node->next)
+            {
+                timer = rt_list_entry(node, struct rt_timer, row[0]);
+                if (next_timeout == RT_TICK_MAX ||
+                    (next_timeout - timer->timeout_tick) < RT_TICK_MAX / 2)
+                    next_timeout = timer->timeout_tick;
+            }
+
+            if (level != RT_TIMER_WHEEL_LEVEL - 1)
+                break;
+        }
+    }
+
+    return next_timeout;
+}
+#else
 /* the fist timer always in the last row */
 static rt_tick_t rt_timer_list_next_timeout(rt_list_t timer_list[])
 {
@@ -157,6 +404,7 @@ void rt_timer_dump(rt_list_t timer_heads[])
     rt_kprintf("\n");
 }
 #endif
+#endif
 
 /**
  * @addtogroup Clock
@@ -295,12 +543,14 @@ RTM_EXPORT(rt_timer_delete);
  */
 rt_err_t rt_timer_start(rt_timer_t timer)
 {
+#ifndef RT_USING_TIMER_WHEEL
     unsigned int row_lvl;
     rt_list_t *timer_list;
-    register rt_base_t level;
     rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
     unsigned int tst_nr;
     static unsigned int random_nr;
+#endif
+    register rt_base_t level;
 
     /* timer check */
     RT_ASSERT(timer != RT_NULL);
@@ -322,10 +572,25 @@ rt_err_t rt_timer_start(rt_timer_t timer)
      */
     RT_ASSERT(timer->init_tick < RT_TICK_MAX / 2);
     timer->timeout_tick = rt_tick_get() + timer->init_tick;
+#ifdef RT_USING_TIMER_SLACK
+    RT_ASSERT(timer->slack < RT_TICK_MAX / 2 - timer->init_tick);
+    timer->timeout_tick = _rt_timer_apply_slack(timer->timeout_tick, timer->slack);
+#endif
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
+#ifdef RT_USING_TIMER_WHEEL
+    _rt_timer_wheel_insert(timer);
+
+    timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    /* the expired soft timer will be handed to timer thread in tick isr */
+    return RT_EOK;
+#else
 #ifdef RT_USING_TIMER_SOFT
     if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
     {
@@ -409,6 +674,7 @@ rt_err_t rt_timer_start(rt_timer_t timer)
 #endif
 
     return RT_EOK;
+#endif
 }
 RTM_EXPORT(rt_timer_start);
 
@@ -479,6 +745,16 @@ rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg)
     case RT_TIMER_CTRL_SET_PERIODIC:
         timer->parent.flag |= RT_TIMER_FLAG_PERIODIC;
         break;
+
+#ifdef RT_USING_TIMER_SLACK
+    case RT_TIMER_CTRL_SET_SLACK:
+        timer->slack = *(rt_tick_t *)arg;
+        break;
+
+    case RT_TIMER_CTRL_GET_SLACK:
+        *(rt_tick_t *)arg = timer->slack;
+        break;
+#endif
     }
 
     return RT_EOK;
@@ -496,6 +772,10 @@ void rt_timer_check(void)
     struct rt_timer *t;
     rt_tick_t current_tick;
     register rt_base_t level;
+#ifdef RT_USING_TIMER_WHEEL
+    rt_list_t expired;
+    rt_bool_t more;
+#endif
 
     RT_DEBUG_LOG(RT_DEBUG_TIMER, ("timer check enter\n"));
 
@@ -504,6 +784,70 @@ void rt_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
+#ifdef RT_USING_TIMER_WHEEL
+    rt_list_init(&expired);
+    do
+    {
+        /* take the expired timers of one step in a batch */
+        more = _rt_timer_wheel_advance(current_tick, &expired);
+
+        while (!rt_list_isempty(&expired))
+        {
+            t = rt_list_entry(expired.next, struct rt_timer, row[0]);
+
+            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+
+            /* remove timer from expired list firstly */
+            _rt_timer_remove(t);
+
+            /* call timeout function */
+            t->timeout_func(t->parameter);
+
+            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+
+            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+            {
+                /* start it */
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+                rt_timer_start(t);
+            }
+            else
+            {
+                /* stop timer */
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            }
+        }
+
+        if (more)
+        {
+            /* let the pending interrupts in between the steps */
+            rt_hw_interrupt_enable(level);
+            level = rt_hw_interrupt_disable();
+        }
+    } while (more);
+
+#ifdef RT_USING_TIMER_SOFT
+    /*
+     * hand the expired soft timers to timer thread. It's resumed only when it
+     * suspends itself, the soft timer may be blocked on IPC in timeout function.
+     */
+    if (!rt_list_isempty(&rt_soft_timer_pending) && rt_soft_timer_idle)
+    {
+        rt_soft_timer_idle = 0;
+        rt_thread_resume(&timer_thread);
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        rt_schedule();
+
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("timer check leave\n"));
+
+        return;
+    }
+#endif
+#else
     while (!rt_list_isempty(&rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
     {
         t = rt_list_entry(rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
@@ -545,6 +889,7 @@ void rt_timer_check(void)
         else
             break;
     }
+#endif
 
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
@@ -559,7 +904,22 @@ void rt_timer_check(void)
  */
 rt_tick_t rt_timer_next_timeout_tick(void)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    register rt_base_t level;
+    rt_tick_t timeout_tick;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    timeout_tick = _rt_timer_wheel_next_timeout();
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    return timeout_tick;
+#else
     return rt_timer_list_next_timeout(rt_timer_list);
+#endif
 }
 
 #ifdef RT_USING_TIMER_SOFT
@@ -569,6 +929,55 @@ rt_tick_t rt_timer_next_timeout_tick(void)
  */
 void rt_soft_timer_check(void)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    struct rt_timer *t;
+    register rt_base_t level;
+
+    RT_DEBUG_LOG(RT_DEBUG_TIMER, ("software timer check enter\n"));
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    while (!rt_list_isempty(&rt_soft_timer_pending))
+    {
+        t = rt_list_entry(rt_soft_timer_pending.next, struct rt_timer, row[0]);
+
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+
+        /* remove timer from pending list firstly */
+        _rt_timer_remove(t);
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        /* call timeout function */
+        t->timeout_func(t->parameter);
+
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
+
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
+        }
+        else
+        {
+            /* stop timer */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    RT_DEBUG_LOG(RT_DEBUG_TIMER, ("software timer check leave\n"));
+}
+#else
     rt_tick_t current_tick;
     rt_list_t *n;
     struct rt_timer *t;
@@ -634,10 +1043,40 @@ void rt_soft_timer_check(void)
 
     RT_DEBUG_LOG(RT_DEBUG_TIMER, ("software timer check leave\n"));
 }
+#endif
 
 /* system timer thread entry */
 static void rt_thread_timer_entry(void *parameter)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    register rt_base_t level;
+
+    while (1)
+    {
+        /* check software timer */
+        rt_soft_timer_check();
+
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
+
+        if (rt_list_isempty(&rt_soft_timer_pending))
+        {
+            /* no expired software timer, wait for tick isr to resume self */
+            rt_soft_timer_idle = 1;
+            rt_thread_suspend(rt_thread_self());
+
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
+
+            rt_schedule();
+        }
+        else
+        {
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
+        }
+    }
+#else
     rt_tick_t next_timeout;
 
     while (1)
@@ -668,6 +1107,7 @@ static void rt_thread_timer_entry(void *parameter)
         /* check software timer */
         rt_soft_timer_check();
     }
+#endif
 }
 #endif
 
@@ -680,10 +1120,18 @@ void rt_system_timer_init(void)
 {
     int i;
 
+#ifdef RT_USING_TIMER_WHEEL
+    for (i = 0; i < RT_TIMER_WHEEL_LEVEL * RT_TIMER_WHEEL_SIZE; i++)
+    {
+        rt_list_init(&rt_timer_wheel.slot[0][0] + i);
+    }
+    rt_timer_wheel.current = rt_tick_get();
+#else
     for (i = 0; i < sizeof(rt_timer_list) / sizeof(rt_timer_list[0]); i++)
     {
         rt_list_init(rt_timer_list + i);
     }
+#endif
 }
 
 /**
@@ -694,6 +1142,9 @@ void rt_system_timer_init(void)
 void rt_system_timer_thread_init(void)
 {
 #ifdef RT_USING_TIMER_SOFT
+#ifdef RT_USING_TIMER_WHEEL
+    rt_list_init(&rt_soft_timer_pending);
+#else
     int i;
 
     for (i = 0;
@@ -702,6 +1153,7 @@ void rt_system_timer_thread_init(void)
     {
         rt_list_init(rt_soft_timer_list + i);
     }
+#endif
 
     /* start software timer thread */
     rt_thread_init(&timer_thread,
@@ -14,11 +14,106 @@ parser.add_argument('output', type=argparse.FileType('wb'), nargs='?', help='out
 parser.add_argument('--dump', action='store_true', help='dump the fs hierarchy')
 parser.add_argument('--binary', action='store_true', help='output binary file')
 parser.add_argument('--addr', default='0', help='set the base address of the binary file, default to 0.')
+parser.add_argument('--compress', action='store_true', help='compress the files in blocks (ROMFS_DIRENT_ZFILE)')
+parser.add_argument('--block-size', type=int, default=4096, help='the block size of compressed file, default to 4096.')
+
+# the options of compression, set by the arguments
+zfile_opts = {'compress': False, 'block_size': 4096}
+
+ZFILE_MAGIC = 0x5a4d4f52
+
+def lz4_compress_block(src):
+    '''Compress the data in LZ4 block format.'''
+    src = bytearray(src)
+    n = len(src)
+    out = bytearray()
+
+    def put_length(length):
+        while length >= 255:
+            out.append(255)
+            length -= 255
+        out.append(length)
+
+    def put_sequence(literals, match_len, offset):
+        lit_len = len(literals)
+        token = min(lit_len, 15) << 4
+        if match_len:
+            token |= min(match_len - 4, 15)
+        out.append(token)
+        if lit_len >= 15:
+            put_length(lit_len - 15)
+        out.extend(literals)
+        if match_len:
+            out.append(offset & 0xff)
+            out.append(offset >> 8)
+            if match_len - 4 >= 15:
+                put_length(match_len - 4 - 15)
+
+    # the last match starts 12 bytes before the end, the last 5 bytes are literals
+    match_limit = n - 12
+    match_end = n - 5
+    table = {}
+    anchor = 0
+    i = 0
+    while i < match_limit:
+        key = bytes(src[i:i + 4])
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > 65535:
+            i += 1
+            continue
+
+        length = 4
+        while i + length < match_end and src[ref + length] == src[i + length]:
+            length += 1
+
+        put_sequence(src[anchor:i], length, i - ref)
+        i += length
+        anchor = i
+
+    put_sequence(src[anchor:], 0, 0)
+    return bytes(out)
+
+def zfile_data(data, block_size):
+    '''Compress the file in independent blocks with an offset table.
+
+       It returns None if the compression doesn't save space.'''
+    blocks = []
+    for pos in range(0, len(data), block_size):
+        raw = data[pos:pos + block_size]
+        comp = lz4_compress_block(raw)
+        # store the block as is if it's not compressible
+        blocks.append(comp if len(comp) < len(raw) else raw)
+
+    header_size = 12 + 4 * (len(blocks) + 1)
+    offsets = [header_size]
+    for b in blocks:
+        offsets.append(offsets[-1] + len(b))
+
+    zdata = struct.pack('<III', ZFILE_MAGIC, block_size, len(blocks)) + \
+            struct.pack('<%dI' % len(offsets), *offsets) + bytes().join(blocks)
+
+    # keep the small gains in plain file, which can be mapped in place
+    if len(zdata) >= len(data) * 9 // 10:
+        return None
+    return zdata
 
 class File(object):
     def __init__(self, name):
         self._name = name
         self._data = open(name, 'rb').read()
+        self._zdata = None
+        if zfile_opts['compress'] and len(self._data) > 0:
+            self._zdata = zfile_data(self._data, zfile_opts['block_size'])
+
+    @property
+    def compressed(self):
+        return self._zdata is not None
+
+    @property
+    def payload(self):
+        '''the data stored in image'''
+        return self._zdata if self.compressed else self._data
 
     @property
     def name(self):
@@ -44,14 +139,14 @@ class File(object):
         if self.entry_size == 0:
             return ''
 
-        return head + ','.join(('0x%02x' % ord(i) for i in self._data)) + tail
+        return head + ','.join(('0x%02x' % ord(i) for i in self.payload)) + tail
 
     @property
     def entry_size(self):
         return len(self._data)
 
     def bin_data(self, base_addr=0x0):
-        return bytes(self._data)
+        return bytes(self.payload)
 
     def dump(self, indent=0):
         print('%s%s' % (' ' * indent, self._name))
@@ -129,6 +224,7 @@ class Folder(object):
         dtail = '\n};'
         body_fmt = '    {{{type}, "{name}", (rt_uint8_t *){data}, sizeof({data})/sizeof({data}[0])}}'
         body_fmt0= '    {{{type}, "{name}", RT_NULL, 0}}'
+        body_fmtz= '    {{{type}, "{name}", (rt_uint8_t *){data}, {size}}}'
         # prefix of children
         cpf = prefix+self.c_name
         body_li = []
@@ -136,13 +232,19 @@ class Folder(object):
         for c in self._children:
             entry_size = c.entry_size
             if isinstance(c, File):
-                tp = 'ROMFS_DIRENT_FILE'
+                tp = 'ROMFS_DIRENT_ZFILE' if c.compressed else 'ROMFS_DIRENT_FILE'
             elif isinstance(c, Folder):
                 tp = 'ROMFS_DIRENT_DIR'
             else:
                 assert False, 'Unkown instance:%s' % str(c)
             if entry_size == 0:
                 body_li.append(body_fmt0.format(type=tp, name = c.name))
+            elif isinstance(c, File) and c.compressed:
+                # the size of compressed file is the uncompressed size
+                body_li.append(body_fmtz.format(type=tp,
+                                             name=c.name,
+                                             data=cpf+c.c_name,
+                                             size=entry_size))
             else:
                 body_li.append(body_fmt.format(type=tp,
                                             name=c.name,
@@ -180,8 +282,8 @@ class Folder(object):
         p_li = []
         for c in self._children:
             if isinstance(c, File):
-                # ROMFS_DIRENT_FILE
-                tp = 0
+                # ROMFS_DIRENT_FILE or ROMFS_DIRENT_ZFILE
+                tp = 2 if c.compressed else 0
             elif isinstance(c, Folder):
                 # ROMFS_DIRENT_DIR
                 tp = 1
@@ -242,6 +344,8 @@ def get_bin_data(tree, base_addr):
 
 if __name__ == '__main__':
     args = parser.parse_args()
+    zfile_opts['compress'] = args.compress
+    zfile_opts['block_size'] = args.block_size
 
     os.chdir(args.rootdir)
 